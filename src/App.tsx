@@ -1,13 +1,18 @@
 import { useState } from 'react';
-import { Radio, Waves, Activity, Signal } from 'lucide-react';
+import { Radio, Waves, Activity, Signal, Gauge, TrendingUp, Repeat, Layers } from 'lucide-react';
 import { DigitalToDigitalMode } from './components/DigitalToDigitalMode';
 import { DigitalToAnalogMode } from './components/DigitalToAnalogMode';
 import { AnalogToDigitalMode } from './components/AnalogToDigitalMode';
 import { AnalogToAnalogMode } from './components/AnalogToAnalogMode';
+import { BenchmarkSection } from './components/BenchmarkSection';
+import { LinkAdaptationSection } from './components/LinkAdaptationSection';
+import { ArqSection } from './components/ArqSection';
+import { ComparisonSection } from './components/ComparisonSection';
+import { PerformanceOverlay } from './components/PerformanceOverlay';
 import { SimulationMode } from './types';
 
 function App() {
-  const [activeMode, setActiveMode] = useState<SimulationMode | 'benchmark'>('digital-to-digital');
+  const [activeMode, setActiveMode] = useState<SimulationMode | 'link-adaptation' | 'arq' | 'compare' | 'benchmark'>('digital-to-digital');
 
   const modes = [
     {
@@ -34,6 +39,30 @@ function App() {
       icon: Signal,
       description: 'Carrier Mod.',
     },
+    {
+      id: 'link-adaptation' as const,
+      name: 'Link Adaptation',
+      icon: TrendingUp,
+      description: 'Adaptive Mod.',
+    },
+    {
+      id: 'arq' as const,
+      name: 'ARQ',
+      icon: Repeat,
+      description: 'Data Link',
+    },
+    {
+      id: 'compare' as const,
+      name: 'Compare',
+      icon: Layers,
+      description: 'Side by Side',
+    },
+    {
+      id: 'benchmark' as const,
+      name: 'Benchmark',
+      icon: Gauge,
+      description: 'Precision & Speed',
+    },
   ];
 
   return (
@@ -83,6 +112,10 @@ function App() {
           {activeMode === 'digital-to-analog' && <DigitalToAnalogMode />}
           {activeMode === 'analog-to-digital' && <AnalogToDigitalMode />}
           {activeMode === 'analog-to-analog' && <AnalogToAnalogMode />}
+          {activeMode === 'link-adaptation' && <LinkAdaptationSection />}
+          {activeMode === 'arq' && <ArqSection />}
+          {activeMode === 'compare' && <ComparisonSection />}
+          {activeMode === 'benchmark' && <BenchmarkSection />}
         </div>
       </div>
 
@@ -93,6 +126,8 @@ function App() {
           </p>
         </div>
       </footer>
+
+      <PerformanceOverlay />
     </div>
   );
 }
@@ -1,36 +1,51 @@
 import { useState, useEffect } from 'react';
 import { SignalChart } from './SignalChart';
-import { generateAnalogToAnalogSignal } from '../utils/analogToAnalog';
-import { AnalogToAnalogAlgorithm, SignalData } from '../types';
+import { generateAnalogToAnalogBaseband, generateAnalogToAnalogSignal } from '../utils/analogToAnalog';
+import { amplitudeSpectrum, occupiedBandwidth } from '../utils/fft';
+import { countPoints, timed } from '../utils/instrumentation';
+import { AnalogToAnalogAlgorithm, BasebandSignalData, SignalData, SimulationDomain } from '../types';
 import { Play } from 'lucide-react';
 
 export function AnalogToAnalogMode() {
   const [frequency, setFrequency] = useState(2);
   const [amplitude, setAmplitude] = useState(1);
   const [algorithm, setAlgorithm] = useState<AnalogToAnalogAlgorithm>('AM');
-  const [signalData, setSignalData] = useState<SignalData | null>(null);
+  const [domain, setDomain] = useState<SimulationDomain>('passband');
+  const [signalData, setSignalData] = useState<SignalData | BasebandSignalData | null>(null);
 
-  const algorithms: AnalogToAnalogAlgorithm[] = ['AM', 'FM', 'PM'];
+  const algorithms: AnalogToAnalogAlgorithm[] = ['AM', 'FM', 'PM', 'DSB-SC', 'SSB-USB', 'SSB-LSB', 'VSB'];
+  const carrierFrequency = frequency * 5;
+
+  const simulate = () =>
+    domain === 'baseband'
+      ? timed('generateAnalogToAnalogBaseband', () => generateAnalogToAnalogBaseband(frequency, amplitude, algorithm), countPoints)
+      : timed('generateAnalogToAnalogSignal', () => generateAnalogToAnalogSignal(frequency, amplitude, algorithm), countPoints);
 
   const handleSimulate = () => {
-    const data = generateAnalogToAnalogSignal(frequency, amplitude, algorithm);
-    setSignalData(data);
+    setSignalData(simulate());
   };
 
+  // Spectrum of the displayed carrier; the chart stops at twice the carrier unless the band reaches further
+  const transmitted = signalData?.transmitted ?? [];
+  const displayRate = transmitted.length > 1 ? 1 / (transmitted[1].x - transmitted[0].x) : 0;
+  const spectrum = displayRate > 0 ? amplitudeSpectrum(transmitted.map(point => point.y), displayRate) : [];
+  const band = occupiedBandwidth(spectrum, 0.99, carrierFrequency);
+  const spectrumLimit = Math.max(2 * carrierFrequency, band.high + frequency);
+  const visibleSpectrum = spectrum.filter(point => point.x <= spectrumLimit);
+
   // Auto-regenerate signal when parameters change (if valid data exists)
   useEffect(() => {
     if (signalData) {
-      const data = generateAnalogToAnalogSignal(frequency, amplitude, algorithm);
-      setSignalData(data);
+      setSignalData(simulate());
     }
-  }, [algorithm, frequency, amplitude]);
+  }, [algorithm, frequency, amplitude, domain]);
 
   return (
     <div className="space-y-6">
       <div className="bg-white rounded-lg shadow-md p-6">
         <h2 className="text-xl font-bold text-gray-800 mb-4">Analog-to-Analog Modulation</h2>
 
-        <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
+        <div className="grid grid-cols-1 md:grid-cols-5 gap-4 mb-4">
           <div>
             <label className="block text-sm font-medium text-gray-700 mb-2">
               Message Frequency (Hz): {frequency}
@@ -78,6 +93,20 @@ export function AnalogToAnalogMode() {
             </select>
           </div>
 
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Simulation
+            </label>
+            <select
+              value={domain}
+              onChange={(e) => setDomain(e.target.value as SimulationDomain)}
+              className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+            >
+              <option value="passband">Passband</option>
+              <option value="baseband">Complex baseband (I/Q)</option>
+            </select>
+          </div>
+
           <div className="flex items-end">
             <button
               onClick={handleSimulate}
@@ -93,8 +122,23 @@ export function AnalogToAnalogMode() {
           <strong>Technique:</strong> {algorithm} (
           {algorithm === 'AM' && 'Amplitude Modulation'}
           {algorithm === 'FM' && 'Frequency Modulation'}
-          {algorithm === 'PM' && 'Phase Modulation'}) |{' '}
-          <strong>Carrier Frequency:</strong> {frequency * 5} Hz
+          {algorithm === 'PM' && 'Phase Modulation'}
+          {algorithm === 'DSB-SC' && 'Double Sideband Suppressed Carrier'}
+          {algorithm === 'SSB-USB' && 'Single Sideband, Upper'}
+          {algorithm === 'SSB-LSB' && 'Single Sideband, Lower'}
+          {algorithm === 'VSB' && 'Vestigial Sideband, 25% vestige'}) |{' '}
+          <strong>Carrier Frequency:</strong> {carrierFrequency} Hz
+          {signalData && (
+            <>
+              {' '}| <strong>Occupied Bandwidth (99% power):</strong> {band.bandwidth.toFixed(1)} Hz
+            </>
+          )}
+          {signalData && 'basebandSamples' in signalData && (
+            <>
+              {' '}| <strong>Simulated Samples:</strong> {signalData.basebandSamples.toLocaleString()} complex
+              (passband: {signalData.passbandSamples.toLocaleString()} real)
+            </>
+          )}
         </div>
       </div>
 
@@ -110,6 +154,13 @@ export function AnalogToAnalogMode() {
             title={`Transmitted Signal - ${algorithm} Modulated Carrier s(t)`}
             color="#3b82f6"
           />
+          <SignalChart
+            data={visibleSpectrum}
+            title={`Transmitted Spectrum - ${band.low.toFixed(1)} to ${band.high.toFixed(1)} Hz occupied`}
+            color="#8b5cf6"
+            xLabel="Frequency (Hz)"
+            yLabel="Amplitude"
+          />
           <SignalChart
             data={signalData.output}
             title="Output Signal - Demodulated Message"
@@ -1,9 +1,21 @@
-import { useState, useEffect } from 'react';
+import { useState, useEffect, useMemo } from 'react';
 import { SignalChart } from './SignalChart';
+import { ParameterSweepPanel } from './ParameterSweepPanel';
+import { LongCapturePanel } from './LongCapturePanel';
 import { generateAnalogToDigitalSignal } from '../utils/analogToDigital';
-import { AnalogToDigitalAlgorithm, SignalData } from '../types';
+import { SweepEvaluator, toneSweepInput } from '../utils/sweep';
+import { OptimizationGoal, OptimizedConfig, optimizeConfig } from '../utils/optimizer';
+import { countPoints, timed } from '../utils/instrumentation';
+import { markInteraction } from '../utils/responsiveness';
+import { AnalogToDigitalAlgorithm, AnalogToDigitalConfig, ReconstructionMethod, SignalData } from '../types';
 import { Play, Lightbulb } from 'lucide-react';
 
+// Delta modulation tops out far below PCM, so each keeps its own target, starting from one it can reach
+const defaultTargetSqnrDb: Record<AnalogToDigitalAlgorithm, number> = {
+  PCM: 30,
+  'Delta Modulation': 10,
+};
+
 export function AnalogToDigitalMode() {
   const [frequency, setFrequency] = useState(2);
   const [amplitude, setAmplitude] = useState(1);
@@ -12,79 +24,98 @@ export function AnalogToDigitalMode() {
   // PCM settings
   const [pcmSamplingRate, setPcmSamplingRate] = useState(10);
   const [quantizationLevels, setQuantizationLevels] = useState(16);
+  const [antiAlias, setAntiAlias] = useState(false);
+  const [reconstruction, setReconstruction] = useState<ReconstructionMethod>('sinc');
   
   // Delta Modulation settings
   const [dmSamplingRate, setDmSamplingRate] = useState(32);
   const [deltaStepSize, setDeltaStepSize] = useState(0.15);
   
-  // Helper to get optimal config based on current frequency
+  // Optimiser goal: lowest bit rate reaching a target SQNR, or best SQNR within a bit-rate budget
+  const [goalKind, setGoalKind] = useState<OptimizationGoal['kind']>('min bit rate');
+  const [targetSqnrDb, setTargetSqnrDb] = useState(defaultTargetSqnrDb);
+  const [maxBitRate, setMaxBitRate] = useState(60);
+  const [optimized, setOptimized] = useState<OptimizedConfig | null>(null);
+
+  // Scores candidate configurations against the current tone; keeps each sampling rate's samples
+  const evaluator = useMemo(
+    () => new SweepEvaluator(toneSweepInput(frequency, amplitude), { reconstruction }),
+    [frequency, amplitude, reconstruction]
+  );
+
+  // Searches the configuration that best meets the goal for the current tone and applies it
   const getOptimalConfig = () => {
+    const goal: OptimizationGoal = goalKind === 'min bit rate'
+      ? { kind: goalKind, targetSqnrDb: targetSqnrDb[algorithm] }
+      : { kind: goalKind, maxBitRate };
+    const best = timed('optimizeConfig', () => optimizeConfig(evaluator, algorithm, goal));
+    setOptimized(best);
     if (algorithm === 'PCM') {
-      // Nyquist: at least 2x frequency, recommend 4-5x for good quality
-      const optimalSampling = Math.max(10, Math.round(frequency * 5));
-      setPcmSamplingRate(optimalSampling);
-      setQuantizationLevels(16); // 4-bit encoding, good balance
+      setPcmSamplingRate(best.rate);
+      setQuantizationLevels(best.value);
     } else {
-      // Delta Modulation needs higher sampling rate, recommend 8-10x
-      const optimalSampling = Math.max(20, Math.round(frequency * 10));
-      setDmSamplingRate(optimalSampling);
-      setDeltaStepSize(0.15); // 15% of amplitude is usually good
+      setDmSamplingRate(best.rate);
+      setDeltaStepSize(best.value);
     }
   };
-  
-  // Update optimal config when frequency or algorithm changes
+
+  // Re-optimise when the tone, the receiver or the goal changes
   useEffect(() => {
     getOptimalConfig();
-  }, [frequency, algorithm]);
-  
+  }, [evaluator, algorithm, goalKind, targetSqnrDb, maxBitRate]);
+
   const [signalData, setSignalData] = useState<SignalData | null>(null);
 
   const algorithms: AnalogToDigitalAlgorithm[] = ['PCM', 'Delta Modulation'];
+  // Every power of two the optimiser and the sweep can choose
+  const levelOptions = [2, 4, 8, 16, 32, 64, 128, 256];
+
+  // Adopts a configuration picked from the parameter sweep
+  const applySweepCell = (rate: number, value: number) => {
+    const roundedRate = Math.round(rate * 100) / 100;
+    if (algorithm === 'PCM') {
+      setPcmSamplingRate(roundedRate);
+      setQuantizationLevels(value);
+    } else {
+      setDmSamplingRate(roundedRate);
+      setDeltaStepSize(Math.round(value * 1000) / 1000);
+    }
+  };
+
+  // The converter as currently set, for the simulation and the long capture
+  const conversion = useMemo<AnalogToDigitalConfig>(() => (algorithm === 'PCM'
+    ? {
+        algorithm,
+        pcm: {
+          samplingRate: pcmSamplingRate,
+          quantizationLevels,
+          antiAlias,
+          reconstruction,
+        },
+      }
+    : {
+        algorithm,
+        deltaModulation: {
+          samplingRate: dmSamplingRate,
+          deltaStepSize,
+        },
+      }), [algorithm, pcmSamplingRate, quantizationLevels, antiAlias, reconstruction, dmSamplingRate, deltaStepSize]);
 
   const handleSimulate = () => {
-    const config = algorithm === 'PCM'
-      ? {
-          algorithm,
-          pcm: {
-            samplingRate: pcmSamplingRate,
-            quantizationLevels,
-          },
-        }
-      : {
-          algorithm,
-          deltaModulation: {
-            samplingRate: dmSamplingRate,
-            deltaStepSize,
-          },
-        };
-    
-    const data = generateAnalogToDigitalSignal(frequency, amplitude, config);
+    const data = timed('generateAnalogToDigitalSignal', () => generateAnalogToDigitalSignal(frequency, amplitude, conversion), countPoints);
     setSignalData(data);
   };
 
   // Auto-regenerate signal when parameters change (if valid data exists)
   useEffect(() => {
     if (signalData) {
-      const config = algorithm === 'PCM'
-        ? {
-            algorithm,
-            pcm: {
-              samplingRate: pcmSamplingRate,
-              quantizationLevels,
-            },
-          }
-        : {
-            algorithm,
-            deltaModulation: {
-              samplingRate: dmSamplingRate,
-              deltaStepSize,
-            },
-          };
-      
-      const data = generateAnalogToDigitalSignal(frequency, amplitude, config);
+      const data = timed('generateAnalogToDigitalSignal', () => generateAnalogToDigitalSignal(frequency, amplitude, conversion), countPoints);
       setSignalData(data);
     }
-  }, [algorithm, frequency, amplitude, pcmSamplingRate, quantizationLevels, dmSamplingRate, deltaStepSize]);
+  }, [conversion, frequency, amplitude]);
+
+  // Frequency the sampled tone folds back to when the sampling rate is below Nyquist
+  const aliasFrequency = Math.abs(frequency - Math.round(frequency / pcmSamplingRate) * pcmSamplingRate);
 
   return (
     <div className="space-y-6">
@@ -102,7 +133,10 @@ export function AnalogToDigitalMode() {
               max="5"
               step="0.5"
               value={frequency}
-              onChange={(e) => setFrequency(parseFloat(e.target.value))}
+              onChange={(e) => {
+                markInteraction('A/D frequency', e.target.value, e.timeStamp);
+                setFrequency(parseFloat(e.target.value));
+              }}
               className="w-full"
             />
           </div>
@@ -117,7 +151,10 @@ export function AnalogToDigitalMode() {
               max="2"
               step="0.1"
               value={amplitude}
-              onChange={(e) => setAmplitude(parseFloat(e.target.value))}
+              onChange={(e) => {
+                markInteraction('A/D amplitude', e.target.value, e.timeStamp);
+                setAmplitude(parseFloat(e.target.value));
+              }}
               className="w-full"
             />
           </div>
@@ -128,7 +165,10 @@ export function AnalogToDigitalMode() {
             </label>
             <select
               value={algorithm}
-              onChange={(e) => setAlgorithm(e.target.value as AnalogToDigitalAlgorithm)}
+              onChange={(e) => {
+                markInteraction('A/D algorithm', e.target.value, e.timeStamp);
+                setAlgorithm(e.target.value as AnalogToDigitalAlgorithm);
+              }}
               className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
             >
               {algorithms.map((alg) => (
@@ -143,7 +183,7 @@ export function AnalogToDigitalMode() {
             <button
               onClick={getOptimalConfig}
               className="flex-1 bg-green-600 hover:bg-green-700 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
-              title="Set optimal configuration based on frequency"
+              title="Search the configuration that best meets the goal"
             >
               <Lightbulb size={18} />
               Optimal
@@ -158,18 +198,79 @@ export function AnalogToDigitalMode() {
           </div>
         </div>
 
-        {/* Optimal Configuration Guide */}
+        {/* Optimiser goal */}
         <div className="mb-4 p-3 bg-green-50 border-l-4 border-green-500 text-sm text-gray-700">
           <div className="flex items-start gap-2">
             <Lightbulb size={16} className="text-green-600 mt-0.5 flex-shrink-0" />
-            <div>
-              <strong>Configuration Guide:</strong>
-              {algorithm === 'PCM' ? (
-                <span> For PCM, use sampling rate ≥ 2× frequency (Nyquist), recommend 4-5× for quality. 
-                Higher quantization levels (16-32) provide better fidelity but use more bandwidth.</span>
-              ) : (
-                <span> For Delta Modulation, use sampling rate ≥ 8-10× frequency. 
-                Balance delta step: too small causes granular noise, too large causes slope overload.</span>
+            <div className="flex-1">
+              <div className="grid grid-cols-1 md:grid-cols-2 gap-4">
+                <div>
+                  <label className="block text-sm font-medium text-gray-700 mb-2">
+                    Optimiser Goal
+                  </label>
+                  <select
+                    value={goalKind}
+                    onChange={(e) => {
+                      markInteraction('A/D optimiser goal', e.target.value, e.timeStamp);
+                      setGoalKind(e.target.value as OptimizationGoal['kind']);
+                    }}
+                    className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+                  >
+                    <option value="min bit rate">Lowest bit rate for a target SQNR</option>
+                    <option value="max sqnr">Best SQNR within a bit-rate budget</option>
+                  </select>
+                </div>
+
+                {goalKind === 'min bit rate' ? (
+                  <div>
+                    <label className="block text-sm font-medium text-gray-700 mb-2">
+                      Target SQNR (dB): {targetSqnrDb[algorithm]}
+                    </label>
+                    <input
+                      type="range"
+                      min="2"
+                      max={algorithm === 'PCM' ? 50 : 30}
+                      step="1"
+                      value={targetSqnrDb[algorithm]}
+                      onChange={(e) => {
+                        markInteraction('A/D target SQNR', e.target.value, e.timeStamp);
+                        setTargetSqnrDb({ ...targetSqnrDb, [algorithm]: parseFloat(e.target.value) });
+                      }}
+                      className="w-full"
+                    />
+                  </div>
+                ) : (
+                  <div>
+                    <label className="block text-sm font-medium text-gray-700 mb-2">
+                      Bit-Rate Budget (bit/s): {maxBitRate}
+                    </label>
+                    <input
+                      type="range"
+                      min="10"
+                      max="320"
+                      step="5"
+                      value={maxBitRate}
+                      onChange={(e) => {
+                        markInteraction('A/D bit-rate budget', e.target.value, e.timeStamp);
+                        setMaxBitRate(parseFloat(e.target.value));
+                      }}
+                      className="w-full"
+                    />
+                  </div>
+                )}
+              </div>
+
+              {optimized && (
+                <p className="mt-2">
+                  <strong>{optimized.feasible ? 'Optimal:' : 'Closest:'}</strong>{' '}
+                  {optimized.rate} Hz,{' '}
+                  {algorithm === 'PCM' ? `${optimized.value} levels` : `step ${optimized.value.toFixed(3)}`}{' '}
+                  → {optimized.sqnrDb.toFixed(1)} dB SQNR at {optimized.bitRate.toFixed(0)} bit/s
+                  {!optimized.feasible && (goalKind === 'min bit rate' ? ' (target out of reach)' : ' (budget too small)')}
+                  <span className="text-gray-500">
+                    {' '}| {optimized.evaluations} evaluations in {optimized.elapsedMs.toFixed(1)} ms
+                  </span>
+                </p>
               )}
             </div>
           </div>
@@ -186,13 +287,16 @@ export function AnalogToDigitalMode() {
                 type="range"
                 min="4"
                 max="40"
-                step="1"
+                step="0.01"
                 value={pcmSamplingRate}
-                onChange={(e) => setPcmSamplingRate(parseFloat(e.target.value))}
+                onChange={(e) => {
+                  markInteraction('A/D PCM sampling rate', e.target.value, e.timeStamp);
+                  setPcmSamplingRate(parseFloat(e.target.value));
+                }}
                 className="w-full"
               />
               <p className="text-xs text-gray-500 mt-1">
-                Optimal: {Math.round(frequency * 5)} Hz (5× frequency) | Min: {Math.round(frequency * 2)} Hz
+                Nyquist minimum: {frequency * 2} Hz | Higher rates need more bits per second
               </p>
             </div>
 
@@ -202,9 +306,18 @@ export function AnalogToDigitalMode() {
               </label>
               <select
                 value={quantizationLevels}
-                onChange={(e) => setQuantizationLevels(parseInt(e.target.value))}
+                onChange={(e) => {
+                  markInteraction('A/D quantization levels', e.target.value, e.timeStamp);
+                  setQuantizationLevels(parseInt(e.target.value));
+                }}
                 className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
               >
+                {!levelOptions.includes(quantizationLevels) && (
+                  <option value={quantizationLevels}>
+                    {quantizationLevels} ({Math.ceil(Math.log2(quantizationLevels))} bits - from sweep)
+                  </option>
+                )}
+                <option value="2">2 (1 bit - Minimal)</option>
                 <option value="4">4 (2 bits - Low)</option>
                 <option value="8">8 (3 bits - Basic)</option>
                 <option value="16">16 (4 bits - Good)</option>
@@ -215,6 +328,43 @@ export function AnalogToDigitalMode() {
               </select>
               <p className="text-xs text-gray-500 mt-1">More levels = better quality but higher bandwidth</p>
             </div>
+
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Reconstruction Filter
+              </label>
+              <select
+                value={reconstruction}
+                onChange={(e) => {
+                  markInteraction('A/D reconstruction', e.target.value, e.timeStamp);
+                  setReconstruction(e.target.value as ReconstructionMethod);
+                }}
+                className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+              >
+                <option value="zero-order">Zero-Order Hold (staircase)</option>
+                <option value="first-order">First-Order Hold (linear)</option>
+                <option value="sinc">Ideal (windowed sinc)</option>
+              </select>
+              <p className="text-xs text-gray-500 mt-1">How the receiver turns samples back into a continuous waveform</p>
+            </div>
+
+            <div>
+              <label className="flex items-center gap-2 text-sm font-medium text-gray-700 mb-2">
+                <input
+                  type="checkbox"
+                  checked={antiAlias}
+                  onChange={(e) => {
+                    markInteraction('A/D anti-alias filter', e.target.checked, e.timeStamp);
+                    setAntiAlias(e.target.checked);
+                  }}
+                />
+                Anti-Alias Prefilter
+              </label>
+              <p className="text-xs text-gray-500 mt-1">
+                Low-pass the input at {(pcmSamplingRate / 2).toFixed(1)} Hz before sampling. Without it, content above
+                Nyquist folds back as an alias.
+              </p>
+            </div>
           </div>
         )}
 
@@ -228,31 +378,37 @@ export function AnalogToDigitalMode() {
                 type="range"
                 min="10"
                 max="80"
-                step="2"
+                step="0.01"
                 value={dmSamplingRate}
-                onChange={(e) => setDmSamplingRate(parseFloat(e.target.value))}
+                onChange={(e) => {
+                  markInteraction('A/D DM sampling rate', e.target.value, e.timeStamp);
+                  setDmSamplingRate(parseFloat(e.target.value));
+                }}
                 className="w-full"
               />
               <p className="text-xs text-gray-500 mt-1">
-                Optimal: {Math.round(frequency * 10)} Hz (10× frequency) | Higher reduces slope overload
+                One bit per sample | Higher reduces slope overload
               </p>
             </div>
 
             <div>
               <label className="block text-sm font-medium text-gray-700 mb-2">
-                Delta Step Size: {deltaStepSize.toFixed(2)} ({(deltaStepSize * 100).toFixed(0)}% of amplitude)
+                Delta Step Size: {deltaStepSize.toFixed(3)} ({(deltaStepSize * 100).toFixed(0)}% of amplitude)
               </label>
               <input
                 type="range"
-                min="0.05"
+                min="0.01"
                 max="0.4"
-                step="0.01"
+                step="0.001"
                 value={deltaStepSize}
-                onChange={(e) => setDeltaStepSize(parseFloat(e.target.value))}
+                onChange={(e) => {
+                  markInteraction('A/D delta step size', e.target.value, e.timeStamp);
+                  setDeltaStepSize(parseFloat(e.target.value));
+                }}
                 className="w-full"
               />
               <p className="text-xs text-gray-500 mt-1">
-                Optimal: 0.10-0.20 | Too small = granular noise, too large = slope overload
+                Too small = granular noise, too large = slope overload
               </p>
             </div>
           </div>
@@ -262,10 +418,23 @@ export function AnalogToDigitalMode() {
           <strong>Algorithm:</strong> {algorithm} |{' '}
           <strong>Sampling Rate:</strong> {algorithm === 'PCM' ? `${pcmSamplingRate} Hz` : `${dmSamplingRate} Hz`}
           {algorithm === 'PCM' && <> | <strong>Quantization Levels:</strong> {quantizationLevels}</>}
-          {algorithm === 'Delta Modulation' && <> | <strong>Delta Step:</strong> {deltaStepSize.toFixed(2)}</>}
+          {algorithm === 'PCM' && pcmSamplingRate < 2 * frequency && (
+            <> | <strong>Aliased to:</strong> {antiAlias ? 'removed by prefilter' : `${aliasFrequency.toFixed(1)} Hz`}</>
+          )}
+          {algorithm === 'Delta Modulation' && <> | <strong>Delta Step:</strong> {deltaStepSize.toFixed(3)}</>}
         </div>
       </div>
 
+      <ParameterSweepPanel
+        algorithm={algorithm}
+        frequency={frequency}
+        amplitude={amplitude}
+        reconstruction={reconstruction}
+        onApply={applySweepCell}
+      />
+
+      <LongCapturePanel frequency={frequency} amplitude={amplitude} conversion={conversion} />
+
       {signalData && (
         <div className="space-y-4">
           <SignalChart
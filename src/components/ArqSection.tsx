@@ -0,0 +1,352 @@
+import { useEffect, useRef, useState } from 'react';
+import { CartesianGrid, Legend, Line, LineChart, ResponsiveContainer, Tooltip, XAxis, YAxis } from 'recharts';
+import { Play } from 'lucide-react';
+import { ArqProtocol, DigitalToAnalogAlgorithm, DigitalToDigitalAlgorithm } from '../types';
+import { ArqConfig, ArqResult, frameErrorRate, simulateArq, theoreticalEfficiency } from '../utils/arq';
+import { fromDecibels, modulationModel, modulationModels } from '../utils/berModels';
+import { measureLineCodeBer } from '../utils/presets';
+
+type BerSource = 'line code' | 'modulation';
+
+interface SweepRow {
+  window: number;
+  gbn?: number;
+  sr?: number;
+  gbnTheory: number;
+  srTheory: number;
+}
+
+const lineCodes: DigitalToDigitalAlgorithm[] = [
+  'NRZ-L', 'NRZ-I', 'Manchester', 'Differential Manchester', 'AMI', 'Pseudoternary', 'B8ZS', 'HDB3',
+];
+const windowSizes = [1, 2, 4, 8, 16, 32, 64, 128];
+// Frames one run may put on the link; Go-Back-N resends whole windows, so it is also each run's cap
+const transmissionBudget = 30000000;
+
+export function ArqSection() {
+  const [berSource, setBerSource] = useState<BerSource>('modulation');
+  const [lineCode, setLineCode] = useState<DigitalToDigitalAlgorithm>('NRZ-L');
+  const [noiseSigma, setNoiseSigma] = useState(0.3);
+  const [modulation, setModulation] = useState<DigitalToAnalogAlgorithm>('QPSK');
+  const [snrDb, setSnrDb] = useState(10);
+  const [frameBits, setFrameBits] = useState(1000);
+  const [propagationMs, setPropagationMs] = useState(5);
+  const [frames, setFrames] = useState(100000);
+  const [rows, setRows] = useState<SweepRow[]>([]);
+  const [results, setResults] = useState<ArqResult[]>([]);
+  const [linkErrors, setLinkErrors] = useState<{ ber: number; fer: number; expected: number } | null>(null);
+  const [running, setRunning] = useState(false);
+  const timer = useRef<number | null>(null);
+
+  // Cancel a sweep in progress when the section unmounts
+  useEffect(() => () => {
+    if (timer.current !== null) clearTimeout(timer.current);
+  }, []);
+
+  const handleRun = () => {
+    if (timer.current !== null) clearTimeout(timer.current);
+    setRunning(true);
+    setRows([]);
+    setResults([]);
+
+    timer.current = window.setTimeout(() => {
+      const ber = berSource === 'line code'
+        ? measureLineCodeBer(lineCode, noiseSigma, 100000, 1)
+        : modulationModel(modulation).bitErrorRate(fromDecibels(snrDb));
+      const ackBits = 64;
+      const base: Omit<ArqConfig, 'protocol' | 'windowSize'> = {
+        frames,
+        frameBits,
+        ackBits,
+        bitRate: 1e6,
+        propagationDelay: propagationMs / 1000,
+        frameErrorRate: frameErrorRate(ber, frameBits),
+        ackErrorRate: frameErrorRate(ber, ackBits),
+        maxTransmissions: transmissionBudget,
+        seed: 1,
+      };
+      // Each frame is sent until one copy and its ACK get through
+      const success = (1 - base.frameErrorRate) * (1 - base.ackErrorRate);
+      const expected = success > 0 ? frames / success : Infinity;
+      setLinkErrors({ ber, fer: base.frameErrorRate, expected });
+      if (expected > transmissionBudget) {
+        timer.current = null;
+        setRunning(false);
+        return;
+      }
+
+      const sweepRows: SweepRow[] = windowSizes.map((size) => ({
+        window: size,
+        gbnTheory: theoreticalEfficiency({ ...base, protocol: 'Go-Back-N', windowSize: size }),
+        srTheory: theoreticalEfficiency({ ...base, protocol: 'Selective Repeat', windowSize: size }),
+      }));
+      const runs: [ArqProtocol, number][] = [['Stop-and-Wait', 0]];
+      windowSizes.forEach((_size, index) => {
+        runs.push(['Go-Back-N', index], ['Selective Repeat', index]);
+      });
+      const finished: ArqResult[] = [];
+
+      // One simulation per tick so the chart fills in as the sweep streams
+      const runNext = () => {
+        const [protocol, index] = runs[finished.length];
+        const result = simulateArq({ ...base, protocol, windowSize: windowSizes[index] });
+        finished.push(result);
+        if (protocol === 'Go-Back-N') sweepRows[index].gbn = result.efficiency;
+        if (protocol === 'Selective Repeat') sweepRows[index].sr = result.efficiency;
+        setRows(sweepRows.map((row) => ({ ...row })));
+        setResults(finished.slice());
+        if (finished.length < runs.length) {
+          timer.current = window.setTimeout(runNext, 0);
+        } else {
+          timer.current = null;
+          setRunning(false);
+        }
+      };
+      runNext();
+    }, 0);
+  };
+
+  return (
+    <div className="space-y-6">
+      <div className="bg-white rounded-lg shadow-md p-6">
+        <h2 className="text-xl font-bold text-gray-800 mb-4">ARQ Link Efficiency</h2>
+
+        <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Bit Errors From
+            </label>
+            <select
+              value={berSource}
+              onChange={(e) => setBerSource(e.target.value as BerSource)}
+              className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+            >
+              <option value="modulation">Modulation (Es/N0)</option>
+              <option value="line code">Line code (noise σ)</option>
+            </select>
+          </div>
+
+          {berSource === 'line code' ? (
+            <>
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Line Code
+                </label>
+                <select
+                  value={lineCode}
+                  onChange={(e) => setLineCode(e.target.value as DigitalToDigitalAlgorithm)}
+                  className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+                >
+                  {lineCodes.map((code) => (
+                    <option key={code} value={code}>
+                      {code}
+                    </option>
+                  ))}
+                </select>
+              </div>
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Noise σ: {noiseSigma.toFixed(2)}
+                </label>
+                <input
+                  type="range"
+                  min="0.1"
+                  max="0.6"
+                  step="0.01"
+                  value={noiseSigma}
+                  onChange={(e) => setNoiseSigma(parseFloat(e.target.value))}
+                  className="w-full"
+                />
+              </div>
+            </>
+          ) : (
+            <>
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Modulation
+                </label>
+                <select
+                  value={modulation}
+                  onChange={(e) => setModulation(e.target.value as DigitalToAnalogAlgorithm)}
+                  className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+                >
+                  {modulationModels.map((model) => (
+                    <option key={model.algorithm} value={model.algorithm}>
+                      {model.algorithm}
+                    </option>
+                  ))}
+                </select>
+              </div>
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Es/N0: {snrDb} dB
+                </label>
+                <input
+                  type="range"
+                  min="0"
+                  max="20"
+                  step="0.5"
+                  value={snrDb}
+                  onChange={(e) => setSnrDb(parseFloat(e.target.value))}
+                  className="w-full"
+                />
+              </div>
+            </>
+          )}
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Frame Size: {frameBits} bits
+            </label>
+            <input
+              type="range"
+              min="100"
+              max="12000"
+              step="100"
+              value={frameBits}
+              onChange={(e) => setFrameBits(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Propagation Delay: {propagationMs} ms
+            </label>
+            <input
+              type="range"
+              min="0"
+              max="270"
+              step="1"
+              value={propagationMs}
+              onChange={(e) => setPropagationMs(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Frames per Run
+            </label>
+            <select
+              value={frames}
+              onChange={(e) => setFrames(parseInt(e.target.value))}
+              className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+            >
+              {[10000, 100000, 1000000, 10000000].map((count) => (
+                <option key={count} value={count}>
+                  {count.toLocaleString()}
+                </option>
+              ))}
+            </select>
+          </div>
+
+          <div className="flex items-end">
+            <button
+              onClick={handleRun}
+              disabled={running}
+              className="w-full bg-blue-600 hover:bg-blue-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+            >
+              <Play size={18} />
+              {running ? 'Running…' : 'Run Sweep'}
+            </button>
+          </div>
+        </div>
+
+        <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
+          1 Mbit/s link with 64-bit ACKs. Frames and ACKs are lost whenever any of their bits is in error.
+          {linkErrors && (
+            <>
+              {' '}| <strong>BER:</strong> {linkErrors.ber.toExponential(2)} | <strong>Frame Error Rate:</strong>{' '}
+              {linkErrors.fer.toExponential(2)}
+            </>
+          )}
+        </div>
+        {linkErrors && linkErrors.expected > transmissionBudget && (
+          <p className="mt-3 text-sm text-red-600">
+            Link unusable: {isFinite(linkErrors.expected)
+              ? `about ${linkErrors.expected.toExponential(1)} transmissions`
+              : 'no frame can get through, so no number of transmissions'}{' '}
+            would be needed to deliver {frames.toLocaleString()} frames, over the budget of{' '}
+            {transmissionBudget.toLocaleString()} per run.
+          </p>
+        )}
+      </div>
+
+      {rows.length > 0 && (
+        <div className="bg-white rounded-lg shadow-md p-4">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">Efficiency vs Window Size</h3>
+          <ResponsiveContainer width="100%" height={300}>
+            <LineChart data={rows} margin={{ top: 5, right: 20, left: 0, bottom: 5 }}>
+              <CartesianGrid strokeDasharray="3 3" stroke="#e0e0e0" />
+              <XAxis
+                dataKey="window"
+                scale="log"
+                type="number"
+                domain={[1, 128]}
+                ticks={windowSizes}
+                stroke="#64748b"
+                style={{ fontSize: '12px' }}
+              />
+              <YAxis domain={[0, 1]} stroke="#64748b" style={{ fontSize: '12px' }} />
+              <Tooltip />
+              <Legend />
+              <Line dataKey="gbn" name="Go-Back-N" stroke="#3b82f6" strokeWidth={2} isAnimationActive={false} />
+              <Line dataKey="sr" name="Selective Repeat" stroke="#10b981" strokeWidth={2} isAnimationActive={false} />
+              <Line
+                dataKey="gbnTheory"
+                name="Go-Back-N (analytic)"
+                stroke="#3b82f6"
+                strokeDasharray="5 5"
+                dot={false}
+                isAnimationActive={false}
+              />
+              <Line
+                dataKey="srTheory"
+                name="Selective Repeat (analytic)"
+                stroke="#10b981"
+                strokeDasharray="5 5"
+                dot={false}
+                isAnimationActive={false}
+              />
+            </LineChart>
+          </ResponsiveContainer>
+        </div>
+      )}
+
+      {results.length > 0 && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <table className="w-full text-sm text-left text-gray-700">
+            <thead className="text-xs uppercase text-gray-500 border-b">
+              <tr>
+                <th className="py-2 pr-4">Protocol</th>
+                <th className="py-2 pr-4 text-right">Window</th>
+                <th className="py-2 pr-4 text-right">Transmissions</th>
+                <th className="py-2 pr-4 text-right">Efficiency</th>
+                <th className="py-2 pr-4 text-right">Throughput</th>
+                <th className="py-2 text-right">Events/s</th>
+              </tr>
+            </thead>
+            <tbody>
+              {results.map((result) => (
+                <tr key={`${result.protocol}-${result.windowSize}`} className="border-b last:border-0">
+                  <td className="py-2 pr-4 font-medium">{result.protocol}</td>
+                  <td className="py-2 pr-4 text-right">{result.windowSize}</td>
+                  <td className="py-2 pr-4 text-right">
+                    {result.transmissions.toLocaleString()}
+                    {!result.completed && ` (stopped, ${result.delivered.toLocaleString()} delivered)`}
+                  </td>
+                  <td className="py-2 pr-4 text-right">{(100 * result.efficiency).toFixed(1)}%</td>
+                  <td className="py-2 pr-4 text-right">{(result.throughput / 1000).toFixed(1)} kbit/s</td>
+                  <td className="py-2 text-right">
+                    {result.wallMs > 0 ? ((result.events / result.wallMs) * 1000 / 1e6).toFixed(1) : '—'} M
+                  </td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        </div>
+      )}
+    </div>
+  );
+}
@@ -0,0 +1,328 @@
+import { useEffect, useRef, useState } from 'react';
+import { Gauge, ShieldCheck, Trash2 } from 'lucide-react';
+import { BenchmarkResult, FixedPointResult, runBenchmark, runFixedPointBenchmark, runLdpcBenchmark } from '../utils/benchmark';
+import { LdpcLinkResult } from '../utils/ldpc';
+import { EquivalenceResult, defaultKernelCases, runKernelCase } from '../utils/equivalence';
+import { CacheUsage, resultCache } from '../utils/resultCache';
+
+// One benchmark run, as kept in the result cache
+interface BenchmarkRun {
+  results: BenchmarkResult[];
+  fixedPointResults: FixedPointResult[];
+  ldpcResults: LdpcLinkResult[];
+}
+
+function formatError(value: number): string {
+  if (value === 0) return '0';
+  if (!isFinite(value)) return 'length mismatch';
+  return value.toExponential(2);
+}
+
+function formatSnr(value: number): string {
+  return isFinite(value) ? `${value.toFixed(1)} dB` : '—';
+}
+
+export function BenchmarkSection() {
+  const [repetitions, setRepetitions] = useState(5);
+  const [results, setResults] = useState<BenchmarkResult[] | null>(null);
+  const [fixedPointResults, setFixedPointResults] = useState<FixedPointResult[] | null>(null);
+  const [ldpcResults, setLdpcResults] = useState<LdpcLinkResult[] | null>(null);
+  const [running, setRunning] = useState(false);
+  const [trials, setTrials] = useState(50);
+  const [equivalence, setEquivalence] = useState<EquivalenceResult[]>([]);
+  const [verifying, setVerifying] = useState(false);
+  const verifyTimer = useRef<number | null>(null);
+  // When the timings shown were measured, if they came from the cache rather than this visit
+  const [measuredAt, setMeasuredAt] = useState<number | null>(null);
+  const [cacheUsage, setCacheUsage] = useState<CacheUsage | null>(null);
+
+  const showRun = (run: BenchmarkRun) => {
+    setResults(run.results);
+    setFixedPointResults(run.fixedPointResults);
+    setLdpcResults(run.ldpcResults);
+  };
+
+  const refreshCacheUsage = () => {
+    resultCache.usage().then(setCacheUsage);
+  };
+
+  // Show the last run with these settings, even from before a reload; Run Benchmark always measures anew
+  useEffect(() => {
+    let current = true;
+    resultCache.get<BenchmarkRun>('benchmark', { repetitions }).then((hit) => {
+      if (!current || !hit) return;
+      showRun(hit.value);
+      setMeasuredAt(hit.storedAt);
+    });
+    refreshCacheUsage();
+    return () => {
+      current = false;
+    };
+  }, [repetitions]);
+
+  const handleRun = () => {
+    setRunning(true);
+    // Let the button repaint before the synchronous run blocks the main thread
+    setTimeout(() => {
+      const run: BenchmarkRun = {
+        results: runBenchmark(undefined, { repetitions }),
+        fixedPointResults: runFixedPointBenchmark(undefined, { repetitions }),
+        ldpcResults: runLdpcBenchmark(),
+      };
+      showRun(run);
+      setMeasuredAt(null);
+      setRunning(false);
+      resultCache.put('benchmark', { repetitions }, run).then(refreshCacheUsage);
+    }, 0);
+  };
+
+  const handleClearCache = () => {
+    resultCache.clear().then(refreshCacheUsage);
+  };
+
+  // Cancel a verification in progress when the section unmounts
+  useEffect(() => () => {
+    if (verifyTimer.current !== null) clearTimeout(verifyTimer.current);
+  }, []);
+
+  const handleVerify = () => {
+    if (verifyTimer.current !== null) clearTimeout(verifyTimer.current);
+    setVerifying(true);
+    setEquivalence([]);
+    const kernels = defaultKernelCases();
+    const finished: EquivalenceResult[] = [];
+
+    // One kernel per tick so the table fills in as the harness runs
+    const runNext = () => {
+      finished.push(runKernelCase(kernels[finished.length], { trials }));
+      setEquivalence(finished.slice());
+      if (finished.length < kernels.length) {
+        verifyTimer.current = window.setTimeout(runNext, 0);
+      } else {
+        verifyTimer.current = null;
+        setVerifying(false);
+      }
+    };
+    verifyTimer.current = window.setTimeout(runNext, 0);
+  };
+
+  return (
+    <div className="space-y-6">
+      <div className="bg-white rounded-lg shadow-md p-6">
+        <h2 className="text-xl font-bold text-gray-800 mb-4">Benchmark</h2>
+
+        <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Timed Runs per Case: {repetitions}
+            </label>
+            <input
+              type="range"
+              min="1"
+              max="20"
+              step="1"
+              value={repetitions}
+              onChange={(e) => setRepetitions(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div className="flex items-end">
+            <button
+              onClick={handleRun}
+              disabled={running}
+              className="w-full bg-blue-600 hover:bg-blue-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+            >
+              <Gauge size={18} />
+              {running ? 'Running…' : 'Run Benchmark'}
+            </button>
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Random Trials per Kernel: {trials}
+            </label>
+            <input
+              type="range"
+              min="10"
+              max="500"
+              step="10"
+              value={trials}
+              onChange={(e) => setTrials(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div className="flex items-end">
+            <button
+              onClick={handleVerify}
+              disabled={verifying}
+              className="w-full bg-emerald-600 hover:bg-emerald-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+            >
+              <ShieldCheck size={18} />
+              {verifying ? 'Verifying…' : 'Verify Kernels'}
+            </button>
+          </div>
+        </div>
+
+        <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
+          Each pipeline runs with float64 and float32 sample buffers. Errors and SNR compare the float32
+          output with the float64 output of the same graph. The fixed-point table runs the oscillator,
+          FIR, quantizer and demodulator kernels in Q15 and Q31 against their float64 versions. The LDPC
+          table decodes soft BPSK over AWGN with layered min-sum. Verify Kernels runs each kernel on random
+          inputs, lengths and pipeline block sizes and compares it with its frozen reference implementation:
+          bit-exact for coders and interleavers, within float rounding for modulators and the FFT.
+        </div>
+
+        <div className="mt-3 flex flex-wrap items-center gap-x-4 gap-y-2 text-xs text-gray-500">
+          {measuredAt !== null && (
+            <span>Timings from the run of {new Date(measuredAt).toLocaleString()}, kept in the result cache.</span>
+          )}
+          {cacheUsage && (
+            <span>
+              Result cache: {cacheUsage.entries} {cacheUsage.entries === 1 ? 'entry' : 'entries'},{' '}
+              {(cacheUsage.bytes / (1024 * 1024)).toFixed(1)} of {(cacheUsage.maxBytes / (1024 * 1024)).toFixed(0)} MiB
+            </span>
+          )}
+          <button onClick={handleClearCache} className="flex items-center gap-1 text-blue-600 hover:underline">
+            <Trash2 size={14} />
+            Clear Result Cache
+          </button>
+        </div>
+      </div>
+
+      {results && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <table className="w-full text-sm text-left text-gray-700">
+            <thead className="text-xs uppercase text-gray-500 border-b">
+              <tr>
+                <th className="py-2 pr-4">Pipeline</th>
+                <th className="py-2 pr-4">Precision</th>
+                <th className="py-2 pr-4 text-right">Samples</th>
+                <th className="py-2 pr-4 text-right">Mean Time</th>
+                <th className="py-2 pr-4 text-right">Throughput</th>
+                <th className="py-2 pr-4 text-right">Output Size</th>
+                <th className="py-2 pr-4 text-right">Max |Error|</th>
+                <th className="py-2 text-right">SNR vs float64</th>
+              </tr>
+            </thead>
+            <tbody>
+              {results.map((result) =>
+                result.results.map((row, index) => (
+                  <tr key={`${result.name}-${row.precision}`} className="border-b last:border-0">
+                    <td className="py-2 pr-4 font-medium">{index === 0 ? result.name : ''}</td>
+                    <td className="py-2 pr-4">{row.precision}</td>
+                    <td className="py-2 pr-4 text-right">{result.samples.toLocaleString()}</td>
+                    <td className="py-2 pr-4 text-right">{row.meanMs.toFixed(2)} ms</td>
+                    <td className="py-2 pr-4 text-right">{(row.samplesPerSecond / 1e6).toFixed(2)} MS/s</td>
+                    <td className="py-2 pr-4 text-right">{(row.outputBytes / 1024).toFixed(0)} KiB</td>
+                    <td className="py-2 pr-4 text-right">{formatError(row.maxAbsError)}</td>
+                    <td className="py-2 text-right">{formatSnr(row.snrDb)}</td>
+                  </tr>
+                ))
+              )}
+            </tbody>
+          </table>
+        </div>
+      )}
+
+      {fixedPointResults && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">Fixed-Point Word Length</h3>
+          <table className="w-full text-sm text-left text-gray-700">
+            <thead className="text-xs uppercase text-gray-500 border-b">
+              <tr>
+                <th className="py-2 pr-4">Kernel</th>
+                <th className="py-2 pr-4">Format</th>
+                <th className="py-2 pr-4 text-right">Mean Time</th>
+                <th className="py-2 pr-4 text-right">vs float64</th>
+                <th className="py-2 pr-4 text-right">Saturations</th>
+                <th className="py-2 text-right">32-bit Overflows</th>
+              </tr>
+            </thead>
+            <tbody>
+              {fixedPointResults.map((result) =>
+                result.results.map((row, index) => (
+                  <tr key={`${result.name}-${row.format}`} className="border-b last:border-0">
+                    <td className="py-2 pr-4 font-medium">{index === 0 ? result.name : ''}</td>
+                    <td className="py-2 pr-4">{row.format}</td>
+                    <td className="py-2 pr-4 text-right">{row.meanMs.toFixed(2)} ms</td>
+                    <td className="py-2 pr-4 text-right">
+                      {result.metric === 'snr'
+                        ? formatSnr(row.snrDb)
+                        : `${row.mismatches} / ${result.samples} differ`}
+                    </td>
+                    <td className="py-2 pr-4 text-right">{row.saturations}</td>
+                    <td className="py-2 text-right">{row.overflows}</td>
+                  </tr>
+                ))
+              )}
+            </tbody>
+          </table>
+        </div>
+      )}
+
+      {equivalence.length > 0 && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">Kernel Equivalence</h3>
+          <table className="w-full text-sm text-left text-gray-700">
+            <thead className="text-xs uppercase text-gray-500 border-b">
+              <tr>
+                <th className="py-2 pr-4">Kernel</th>
+                <th className="py-2 pr-4 text-right">Trials</th>
+                <th className="py-2 pr-4 text-right">Max |Error|</th>
+                <th className="py-2">Result</th>
+              </tr>
+            </thead>
+            <tbody>
+              {equivalence.map((row) => (
+                <tr key={row.kernel} className="border-b last:border-0">
+                  <td className="py-2 pr-4 font-medium">{row.kernel}</td>
+                  <td className="py-2 pr-4 text-right">{row.trials}</td>
+                  <td className="py-2 pr-4 text-right">{formatError(row.maxError)}</td>
+                  <td className={`py-2 ${row.firstMismatch ? 'text-red-600' : 'text-green-700'}`}>
+                    {row.firstMismatch
+                      ? `${row.failures} failed — ${row.firstMismatch.description}: [${row.firstMismatch.index}] expected ${row.firstMismatch.expected}, got ${row.firstMismatch.actual}`
+                      : 'matches reference'}
+                  </td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        </div>
+      )}
+
+      {ldpcResults && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">
+            LDPC Decoding (n = {ldpcResults[0].n}, k = {ldpcResults[0].k})
+          </h3>
+          <table className="w-full text-sm text-left text-gray-700">
+            <thead className="text-xs uppercase text-gray-500 border-b">
+              <tr>
+                <th className="py-2 pr-4">Eb/N0</th>
+                <th className="py-2 pr-4 text-right">Codewords</th>
+                <th className="py-2 pr-4 text-right">Mean Iterations</th>
+                <th className="py-2 pr-4 text-right">Decoded Throughput</th>
+                <th className="py-2 pr-4 text-right">BER</th>
+                <th className="py-2 text-right">Unconverged</th>
+              </tr>
+            </thead>
+            <tbody>
+              {ldpcResults.map((row) => (
+                <tr key={row.ebN0Db} className="border-b last:border-0">
+                  <td className="py-2 pr-4 font-medium">{row.ebN0Db} dB</td>
+                  <td className="py-2 pr-4 text-right">{row.codewords}</td>
+                  <td className="py-2 pr-4 text-right">{row.meanIterations.toFixed(1)}</td>
+                  <td className="py-2 pr-4 text-right">{row.decodedMbps.toFixed(2)} Mbit/s</td>
+                  <td className="py-2 pr-4 text-right">{formatError(row.bitErrorRate)}</td>
+                  <td className="py-2 text-right">{(100 * row.frameErrorRate).toFixed(1)}%</td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        </div>
+      )}
+    </div>
+  );
+}
@@ -0,0 +1,201 @@
+import { useEffect, useRef, useState } from 'react';
+import { Layers } from 'lucide-react';
+import { SignalChart } from './SignalChart';
+import { ComparisonAlgorithm, ComparisonPool, ComparisonResult, comparisonAlgorithms, comparisonPoints } from '../utils/comparison';
+import { ComparisonFamily, DataPoint } from '../types';
+
+const defaultSelection: Record<ComparisonFamily, ComparisonAlgorithm[]> = {
+  'line coding': ['NRZ-L', 'Manchester', 'HDB3'],
+  modulation: ['BPSK', 'QPSK', 'QAM'],
+};
+
+const colors = ['#2563eb', '#dc2626', '#059669', '#d97706', '#7c3aed', '#db2777', '#0891b2', '#65a30d'];
+
+interface ComparisonRun {
+  family: ComparisonFamily;
+  results: ComparisonResult[];
+  points: DataPoint[][];
+  /** Shared time axis: from 0 to the end of the longest waveform */
+  timeDomain: [number, number];
+  wallMs: number;
+  shared: boolean;
+}
+
+export function ComparisonSection() {
+  const [family, setFamily] = useState<ComparisonFamily>('line coding');
+  const [binaryInput, setBinaryInput] = useState('1000010110000011');
+  const [selected, setSelected] = useState<ComparisonAlgorithm[]>(defaultSelection['line coding']);
+  const [run, setRun] = useState<ComparisonRun | null>(null);
+  const [running, setRunning] = useState(false);
+  const [error, setError] = useState<string | null>(null);
+  const pool = useRef(new ComparisonPool());
+
+  // Stop the workers when the section unmounts
+  useEffect(() => () => pool.current.terminate(), []);
+
+  const handleFamily = (value: ComparisonFamily) => {
+    setFamily(value);
+    setSelected(defaultSelection[value]);
+  };
+
+  const toggle = (algorithm: ComparisonAlgorithm) => {
+    setSelected(current =>
+      current.includes(algorithm) ? current.filter(a => a !== algorithm) : [...current, algorithm]
+    );
+  };
+
+  const handleCompare = () => {
+    if (!/^[01]+$/.test(binaryInput)) {
+      alert('Please enter a valid binary string (only 0s and 1s)');
+      return;
+    }
+    // Keep the list order, whatever order the boxes were ticked in
+    const algorithms = comparisonAlgorithms[family].filter(algorithm => selected.includes(algorithm));
+    if (algorithms.length === 0) {
+      alert('Please select at least one algorithm');
+      return;
+    }
+    const bits = new Uint8Array(binaryInput.length);
+    for (let i = 0; i < binaryInput.length; i++) bits[i] = binaryInput.charCodeAt(i) === 49 ? 1 : 0;
+
+    setRunning(true);
+    setError(null);
+    const start = performance.now();
+    pool.current
+      .run(bits, family, algorithms)
+      .then(results => {
+        const points = results.map(comparisonPoints);
+        let end = 0;
+        for (const series of points) if (series.length > 0) end = Math.max(end, series[series.length - 1].x);
+        setRun({
+          family,
+          results,
+          points,
+          timeDomain: [0, end],
+          wallMs: performance.now() - start,
+          shared: pool.current.sharedInput,
+        });
+      })
+      .catch((reason: unknown) => setError(reason instanceof Error ? reason.message : String(reason)))
+      .finally(() => setRunning(false));
+  };
+
+  return (
+    <div className="space-y-6">
+      <div className="bg-white rounded-lg shadow-md p-6">
+        <h2 className="text-xl font-bold text-gray-800 mb-4">Algorithm Comparison</h2>
+
+        <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Family
+            </label>
+            <select
+              value={family}
+              onChange={(e) => handleFamily(e.target.value as ComparisonFamily)}
+              className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+            >
+              <option value="line coding">Line Coding</option>
+              <option value="modulation">Modulation</option>
+            </select>
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Binary Input
+            </label>
+            <input
+              type="text"
+              value={binaryInput}
+              onChange={(e) => setBinaryInput(e.target.value)}
+              className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+              placeholder="1000010110000011"
+            />
+          </div>
+
+          <div className="flex items-end">
+            <button
+              onClick={handleCompare}
+              disabled={running}
+              className="w-full bg-blue-600 hover:bg-blue-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+            >
+              <Layers size={18} />
+              {running ? 'Comparing…' : 'Compare'}
+            </button>
+          </div>
+        </div>
+
+        <div className="flex flex-wrap gap-x-4 gap-y-2 mb-4">
+          {comparisonAlgorithms[family].map((algorithm) => (
+            <label key={algorithm} className="flex items-center gap-2 text-sm text-gray-700">
+              <input
+                type="checkbox"
+                checked={selected.includes(algorithm)}
+                onChange={() => toggle(algorithm)}
+              />
+              {algorithm}
+            </label>
+          ))}
+        </div>
+
+        <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
+          Each selected algorithm encodes the same input on its own worker thread, and the charts share one
+          time axis. Bandwidth is the occupied bandwidth holding 90% of the power for line codes and 99% for
+          modulated carriers. Transitions count level changes per bit for line codes and symbol changes per
+          bit for modulation. DC level is the mean of the transmitted signal.
+        </div>
+        {error && <p className="mt-3 text-sm text-red-600">{error}</p>}
+      </div>
+
+      {run && (
+        <>
+          <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+            <table className="w-full text-sm text-left text-gray-700">
+              <thead className="text-xs uppercase text-gray-500 border-b">
+                <tr>
+                  <th className="py-2 pr-4">Algorithm</th>
+                  <th className="py-2 pr-4 text-right">Bandwidth</th>
+                  <th className="py-2 pr-4 text-right">Transitions / Bit</th>
+                  <th className="py-2 pr-4 text-right">DC Level</th>
+                  <th className="py-2 text-right">Generation Time</th>
+                </tr>
+              </thead>
+              <tbody>
+                {run.results.map((result) => (
+                  <tr key={result.algorithm} className="border-b last:border-0">
+                    <td className="py-2 pr-4 font-medium">{result.algorithm}</td>
+                    <td className="py-2 pr-4 text-right">
+                      {result.bandwidth.toFixed(2)} Hz ({Math.round(100 * result.bandwidthFraction)}%)
+                    </td>
+                    <td className="py-2 pr-4 text-right">{result.transitionsPerBit.toFixed(2)}</td>
+                    <td className="py-2 pr-4 text-right">{result.dcLevel.toFixed(3)}</td>
+                    <td className="py-2 text-right">{result.generationMs.toFixed(2)} ms</td>
+                  </tr>
+                ))}
+              </tbody>
+            </table>
+            <p className="mt-3 text-xs text-gray-500">
+              {run.results.length} algorithms in {run.wallMs.toFixed(1)} ms wall time; input{' '}
+              {run.shared ? 'shared with the workers' : 'copied to each worker (page not cross-origin isolated)'}.
+            </p>
+          </div>
+
+          {run.results.map((result, index) => (
+            <SignalChart
+              key={result.algorithm}
+              data={run.points[index]}
+              title={result.algorithm}
+              color={colors[index % colors.length]}
+              isDigital={run.family === 'line coding'}
+              isTransmitted={run.family === 'line coding'}
+              domain={run.family === 'line coding' ? [-1.5, 1.5] : undefined}
+              ticks={run.family === 'line coding' ? [-1, 0, 1] : undefined}
+              numBits={result.bits}
+              timeDomain={run.timeDomain}
+            />
+          ))}
+        </>
+      )}
+    </div>
+  );
+}
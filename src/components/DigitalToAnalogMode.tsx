@@ -1,39 +1,130 @@
-import { useState, useEffect } from 'react';
+import { useState, useEffect, useRef } from 'react';
 import { SignalChart } from './SignalChart';
-import { generateDigitalToAnalogSignal } from '../utils/digitalToAnalog';
-import { DigitalToAnalogAlgorithm, SignalData } from '../types';
-import { Play } from 'lucide-react';
+import {
+  SpectralEfficiency,
+  compareSpectralEfficiency,
+  generateDigitalToAnalogBaseband,
+  generateDigitalToAnalogSignal,
+} from '../utils/digitalToAnalog';
+import { ChirpLinkResult, MAX_SPREADING_FACTOR, MIN_SPREADING_FACTOR, evaluateChirpLink } from '../utils/chirp';
+import { CodedLinkResult, blockCodes, evaluateCodedLink } from '../utils/blockCodes';
+import { modulationModels } from '../utils/berModels';
+import { cachedResult } from '../utils/resultCache';
+import { countPoints, timed } from '../utils/instrumentation';
+import { BasebandSignalData, DigitalToAnalogAlgorithm, KeyingConfig, SignalData, SimulationDomain } from '../types';
+import { BarChart3, Play, Radio, ShieldCheck } from 'lucide-react';
 
 export function DigitalToAnalogMode() {
   const [binaryInput, setBinaryInput] = useState('10110');
   const [algorithm, setAlgorithm] = useState<DigitalToAnalogAlgorithm>('ASK');
-  const [signalData, setSignalData] = useState<SignalData | null>(null);
+  const [domain, setDomain] = useState<SimulationDomain>('passband');
+  const [modulationIndex, setModulationIndex] = useState(1);
+  const [bandwidthTime, setBandwidthTime] = useState(0.3);
+  const [spreadingFactor, setSpreadingFactor] = useState(7);
+  const [linkSnr, setLinkSnr] = useState(-10);
+  const [linkSymbols, setLinkSymbols] = useState(100000);
+  const [linkResult, setLinkResult] = useState<ChirpLinkResult | null>(null);
+  const [linkRunning, setLinkRunning] = useState(false);
+  const [signalData, setSignalData] = useState<SignalData | BasebandSignalData | null>(null);
+  const [efficiency, setEfficiency] = useState<SpectralEfficiency[] | null>(null);
+  const [codedEbN0, setCodedEbN0] = useState(6);
+  const [codedBits, setCodedBits] = useState(100000);
+  // Codewords per block interleaver; 0 sends codewords straight to the modulator
+  const [codedInterleave, setCodedInterleave] = useState(0);
+  const [codedResults, setCodedResults] = useState<CodedLinkResult[]>([]);
+  const [codedRunning, setCodedRunning] = useState(false);
+  const codedTimer = useRef<number | null>(null);
+  // Bumped by every new comparison and on unmount, so a cache lookup in flight for an older one is dropped
+  const codedRun = useRef(0);
 
-  const algorithms: DigitalToAnalogAlgorithm[] = ['ASK', 'BFSK', 'MFSK', 'BPSK', 'DPSK', 'QPSK', 'OQPSK', 'MPSK', 'QAM'];
+  const algorithms: DigitalToAnalogAlgorithm[] = [
+    'ASK', 'BFSK', 'MFSK', 'BPSK', 'DPSK', 'QPSK', 'OQPSK', 'MPSK', 'QAM', 'CPFSK', 'MSK', 'GMSK', 'CSS',
+  ];
+  const config: KeyingConfig = { modulationIndex, bandwidthTime, spreadingFactor };
+  const isFrequencyKeying = algorithm === 'BFSK' || algorithm === 'CPFSK' || algorithm === 'MSK' || algorithm === 'GMSK';
+  const hasBerModel = modulationModels.some((model) => model.algorithm === algorithm);
+
+  // CSS is always simulated on its complex envelope at the chip rate
+  const simulate = () =>
+    domain === 'baseband' && algorithm !== 'CSS'
+      ? timed('generateDigitalToAnalogBaseband', () => generateDigitalToAnalogBaseband(binaryInput, algorithm, undefined, config), countPoints)
+      : timed('generateDigitalToAnalogSignal', () => generateDigitalToAnalogSignal(binaryInput, algorithm, config), countPoints);
+
+  const handleCompare = () => {
+    setEfficiency(compareSpectralEfficiency(config));
+  };
+
+  const handleEvaluateLink = () => {
+    setLinkRunning(true);
+    const config = { spreadingFactor, snrDb: linkSnr, symbols: linkSymbols };
+    // An earlier run of the same link comes from the cache; otherwise let the button
+    // repaint before the synchronous run blocks the main thread
+    cachedResult('chirp link', config, () =>
+      new Promise<ChirpLinkResult>((resolve) => {
+        setTimeout(() => resolve(evaluateChirpLink(spreadingFactor, linkSnr, linkSymbols)), 0);
+      })
+    )
+      .then((run) => setLinkResult(run.value))
+      .finally(() => setLinkRunning(false));
+  };
+
+  // Cancel a code comparison in progress when the mode unmounts
+  useEffect(() => () => {
+    if (codedTimer.current !== null) clearTimeout(codedTimer.current);
+    codedRun.current++;
+  }, []);
+
+  const handleCompareCodes = () => {
+    if (codedTimer.current !== null) clearTimeout(codedTimer.current);
+    const run = ++codedRun.current;
+    setCodedRunning(true);
+    setCodedResults([]);
+    const codes = [null, ...blockCodes];
+    const finished: CodedLinkResult[] = [];
+
+    // One code per tick so the table fills in as the comparison runs; codes already
+    // measured at these settings come from the cache
+    const runNext = () => {
+      const code = codes[finished.length];
+      const config = { algorithm, code, ebN0Db: codedEbN0, infoBits: codedBits, interleaveDepth: codedInterleave };
+      cachedResult('coded link', config, () =>
+        evaluateCodedLink(algorithm, code, codedEbN0, codedBits, { interleaveDepth: codedInterleave })
+      ).then((result) => {
+        if (run !== codedRun.current) return;
+        finished.push(result.value);
+        setCodedResults(finished.slice());
+        if (finished.length < codes.length) {
+          codedTimer.current = window.setTimeout(runNext, 0);
+        } else {
+          codedTimer.current = null;
+          setCodedRunning(false);
+        }
+      });
+    };
+    codedTimer.current = window.setTimeout(runNext, 0);
+  };
 
   const handleSimulate = () => {
     if (!/^[01]+$/.test(binaryInput)) {
       alert('Please enter a valid binary string (only 0s and 1s)');
       return;
     }
-    const data = generateDigitalToAnalogSignal(binaryInput, algorithm);
-    setSignalData(data);
+    setSignalData(simulate());
   };
 
   // Auto-regenerate signal when algorithm changes (if valid data exists)
   useEffect(() => {
     if (signalData && /^[01]+$/.test(binaryInput)) {
-      const data = generateDigitalToAnalogSignal(binaryInput, algorithm);
-      setSignalData(data);
+      setSignalData(simulate());
     }
-  }, [algorithm, binaryInput]);
+  }, [algorithm, binaryInput, domain, modulationIndex, bandwidthTime, spreadingFactor]);
 
   return (
     <div className="space-y-6">
       <div className="bg-white rounded-lg shadow-md p-6">
         <h2 className="text-xl font-bold text-gray-800 mb-4">Digital-to-Analog Modulation</h2>
 
-        <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
+        <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
           <div>
             <label className="block text-sm font-medium text-gray-700 mb-2">
               Binary Input
@@ -64,6 +155,20 @@ export function DigitalToAnalogMode() {
             </select>
           </div>
 
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Simulation
+            </label>
+            <select
+              value={domain}
+              onChange={(e) => setDomain(e.target.value as SimulationDomain)}
+              className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+            >
+              <option value="passband">Passband</option>
+              <option value="baseband">Complex baseband (I/Q)</option>
+            </select>
+          </div>
+
           <div className="flex items-end">
             <button
               onClick={handleSimulate}
@@ -75,6 +180,59 @@ export function DigitalToAnalogMode() {
           </div>
         </div>
 
+        {(algorithm === 'CPFSK' || algorithm === 'GMSK' || algorithm === 'CSS') && (
+          <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
+            {algorithm === 'CPFSK' && (
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Modulation Index h: {modulationIndex.toFixed(2)}
+                </label>
+                <input
+                  type="range"
+                  min="0.25"
+                  max="1.5"
+                  step="0.05"
+                  value={modulationIndex}
+                  onChange={(e) => setModulationIndex(parseFloat(e.target.value))}
+                  className="w-full"
+                />
+              </div>
+            )}
+            {algorithm === 'GMSK' && (
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Gaussian BT: {bandwidthTime.toFixed(2)}
+                </label>
+                <input
+                  type="range"
+                  min="0.2"
+                  max="1"
+                  step="0.05"
+                  value={bandwidthTime}
+                  onChange={(e) => setBandwidthTime(parseFloat(e.target.value))}
+                  className="w-full"
+                />
+              </div>
+            )}
+            {algorithm === 'CSS' && (
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Spreading Factor: SF{spreadingFactor} ({2 ** spreadingFactor} chips)
+                </label>
+                <input
+                  type="range"
+                  min={MIN_SPREADING_FACTOR}
+                  max={MAX_SPREADING_FACTOR}
+                  step="1"
+                  value={spreadingFactor}
+                  onChange={(e) => setSpreadingFactor(parseInt(e.target.value))}
+                  className="w-full"
+                />
+              </div>
+            )}
+          </div>
+        )}
+
         <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
           <strong>Technique:</strong> {algorithm} (
           {algorithm === 'ASK' && 'Amplitude Shift Keying'}
@@ -85,10 +243,214 @@ export function DigitalToAnalogMode() {
           {algorithm === 'QPSK' && 'Quadrature Phase Shift Keying'}
           {algorithm === 'OQPSK' && 'Offset Quadrature Phase Shift Keying'}
           {algorithm === 'MPSK' && 'M-ary Phase Shift Keying (8-PSK)'}
-          {algorithm === 'QAM' && 'Quadrature Amplitude Modulation (16-QAM)'})
+          {algorithm === 'QAM' && 'Quadrature Amplitude Modulation (16-QAM)'}
+          {algorithm === 'CPFSK' && `Continuous-Phase FSK, h = ${modulationIndex.toFixed(2)}`}
+          {algorithm === 'MSK' && 'Minimum Shift Keying (CPFSK, h = 0.5)'}
+          {algorithm === 'GMSK' && `Gaussian Minimum Shift Keying, BT = ${bandwidthTime.toFixed(2)}`}
+          {algorithm === 'CSS' && `Chirp Spread Spectrum, SF${spreadingFactor}, in-phase component shown`})
+          {signalData && 'basebandSamples' in signalData && (
+            <>
+              {' '}| <strong>Simulated Samples:</strong> {signalData.basebandSamples.toLocaleString()} complex
+              (passband: {signalData.passbandSamples.toLocaleString()} real)
+            </>
+          )}
         </div>
       </div>
 
+      {isFrequencyKeying && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <div className="flex items-center justify-between mb-3">
+            <h3 className="text-lg font-semibold text-gray-700">Spectral Efficiency vs BFSK</h3>
+            <button
+              onClick={handleCompare}
+              className="bg-blue-600 hover:bg-blue-700 text-white text-sm font-medium py-1.5 px-3 rounded-md flex items-center gap-2 transition-colors"
+            >
+              <BarChart3 size={16} />
+              Compare
+            </button>
+          </div>
+          {efficiency && (
+            <table className="w-full text-sm text-left text-gray-700">
+              <thead className="text-xs uppercase text-gray-500 border-b">
+                <tr>
+                  <th className="py-2 pr-4">Scheme</th>
+                  <th className="py-2 pr-4 text-right">99% Bandwidth</th>
+                  <th className="py-2 text-right">Efficiency</th>
+                </tr>
+              </thead>
+              <tbody>
+                {efficiency.map((row) => (
+                  <tr key={row.algorithm} className="border-b last:border-0">
+                    <td className="py-2 pr-4 font-medium">{row.algorithm}</td>
+                    <td className="py-2 pr-4 text-right">{row.occupiedBandwidth.toFixed(2)} Hz</td>
+                    <td className="py-2 text-right">{row.efficiency.toFixed(2)} bit/s/Hz</td>
+                  </tr>
+                ))}
+              </tbody>
+            </table>
+          )}
+          <p className="text-xs text-gray-500 mt-2">
+            256 pseudo-random bits at 1 bit/s; CPFSK uses the index above and GMSK its BT.
+          </p>
+        </div>
+      )}
+
+      {hasBerModel && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">Forward Error Correction</h3>
+          <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Eb/N0: {codedEbN0} dB
+              </label>
+              <input
+                type="range"
+                min="0"
+                max="12"
+                step="0.5"
+                value={codedEbN0}
+                onChange={(e) => setCodedEbN0(parseFloat(e.target.value))}
+                className="w-full"
+              />
+            </div>
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Information Bits
+              </label>
+              <select
+                value={codedBits}
+                onChange={(e) => setCodedBits(parseInt(e.target.value))}
+                className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+              >
+                {[10000, 100000, 1000000].map((count) => (
+                  <option key={count} value={count}>
+                    {count.toLocaleString()}
+                  </option>
+                ))}
+              </select>
+            </div>
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Interleaving
+              </label>
+              <select
+                value={codedInterleave}
+                onChange={(e) => setCodedInterleave(parseInt(e.target.value))}
+                className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+              >
+                <option value={0}>None</option>
+                {[8, 32].map((depth) => (
+                  <option key={depth} value={depth}>
+                    Block, {depth} codewords deep
+                  </option>
+                ))}
+              </select>
+            </div>
+            <div className="flex items-end">
+              <button
+                onClick={handleCompareCodes}
+                disabled={codedRunning}
+                className="w-full bg-blue-600 hover:bg-blue-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+              >
+                <ShieldCheck size={18} />
+                {codedRunning ? 'Running…' : 'Compare Codes'}
+              </button>
+            </div>
+          </div>
+          {codedResults.length > 0 && (
+            <table className="w-full text-sm text-left text-gray-700">
+              <thead className="text-xs uppercase text-gray-500 border-b">
+                <tr>
+                  <th className="py-2 pr-4">Code</th>
+                  <th className="py-2 pr-4 text-right">Rate</th>
+                  <th className="py-2 pr-4 text-right">Throughput</th>
+                  <th className="py-2 pr-4 text-right">Channel BER</th>
+                  <th className="py-2 pr-4 text-right">Decoded BER</th>
+                  <th className="py-2 pr-4 text-right">Corrected Bits</th>
+                  <th className="py-2 text-right">Uncorrectable</th>
+                </tr>
+              </thead>
+              <tbody>
+                {codedResults.map((result) => (
+                  <tr key={result.code ?? 'uncoded'} className="border-b last:border-0">
+                    <td className="py-2 pr-4 font-medium">{result.code ?? 'Uncoded'}</td>
+                    <td className="py-2 pr-4 text-right">{result.rate.toFixed(3)}</td>
+                    <td className="py-2 pr-4 text-right">{result.throughput.toFixed(2)} bit/symbol</td>
+                    <td className="py-2 pr-4 text-right">{result.channelBitErrorRate.toExponential(2)}</td>
+                    <td className="py-2 pr-4 text-right">{result.bitErrorRate.toExponential(2)}</td>
+                    <td className="py-2 pr-4 text-right">{result.corrected.toLocaleString()}</td>
+                    <td className="py-2 text-right">{result.failures.toLocaleString()}</td>
+                  </tr>
+                ))}
+              </tbody>
+            </table>
+          )}
+          <p className="text-xs text-gray-500 mt-2">
+            Baseband {algorithm} over complex AWGN at equal energy per information bit, so coded links run at a lower
+            Es/N0. Uncorrectable counts codewords whose errors were detected but not corrected. Interleaving writes codewords
+            as rows and sends columns, so a burst of channel errors lands in many codewords; on this memoryless channel
+            it only changes which bits are hit, at the cost of a block of latency. Codes already measured
+            at these settings are read back from the browser's result cache.
+          </p>
+        </div>
+      )}
+
+      {algorithm === 'CSS' && (
+        <div className="bg-white rounded-lg shadow-md p-4">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">Low-SNR Link Evaluation</h3>
+          <div className="grid grid-cols-1 md:grid-cols-4 gap-4 mb-4">
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Chip SNR: {linkSnr} dB
+              </label>
+              <input
+                type="range"
+                min="-30"
+                max="0"
+                step="0.5"
+                value={linkSnr}
+                onChange={(e) => setLinkSnr(parseFloat(e.target.value))}
+                className="w-full"
+              />
+            </div>
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Symbols
+              </label>
+              <select
+                value={linkSymbols}
+                onChange={(e) => setLinkSymbols(parseInt(e.target.value))}
+                className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+              >
+                {[10000, 100000, 1000000].map((count) => (
+                  <option key={count} value={count}>
+                    {count.toLocaleString()}
+                  </option>
+                ))}
+              </select>
+            </div>
+            <div className="flex items-end">
+              <button
+                onClick={handleEvaluateLink}
+                disabled={linkRunning}
+                className="w-full bg-blue-600 hover:bg-blue-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+              >
+                <Radio size={18} />
+                {linkRunning ? 'Running…' : 'Evaluate Link'}
+              </button>
+            </div>
+          </div>
+          {linkResult && (
+            <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
+              <strong>SF{linkResult.spreadingFactor} at {linkResult.snrDb} dB:</strong>{' '}
+              SER {linkResult.symbolErrorRate.toExponential(2)} ({linkResult.symbolErrors.toLocaleString()} /{' '}
+              {linkResult.symbols.toLocaleString()}) | BER {linkResult.bitErrorRate.toExponential(2)} |{' '}
+              {(linkResult.symbolsPerSecond / 1000).toFixed(1)} k symbols/s
+            </div>
+          )}
+        </div>
+      )}
+
       {signalData && (
         <div className="space-y-4">
           <SignalChart
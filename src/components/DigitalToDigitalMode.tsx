@@ -1,13 +1,27 @@
 import { useState, useEffect } from 'react';
 import { SignalChart } from './SignalChart';
-import { generateDigitalToDigitalSignal } from '../utils/digitalToDigital';
-import { DigitalToDigitalAlgorithm, SignalData } from '../types';
+import { generateDigitalToDigitalSignal, generateSourceCodedSignal } from '../utils/digitalToDigital';
+import { SourceCodingReport, compareSourceCodings } from '../utils/sourceCoding';
+import { countPoints, timed } from '../utils/instrumentation';
+import { DigitalToDigitalAlgorithm, SignalData, SourceCoding } from '../types';
 import { Play } from 'lucide-react';
 
+type InputKind = 'binary' | 'text';
+
+interface SourceCodedData extends SignalData {
+  codedBits: number;
+  decodedText: string;
+  reports: SourceCodingReport[];
+}
+
 export function DigitalToDigitalMode() {
+  const [inputKind, setInputKind] = useState<InputKind>('binary');
   const [binaryInput, setBinaryInput] = useState('10110');
+  const [textInput, setTextInput] = useState('HELLO HELLO HELLO');
+  const [sourceCoding, setSourceCoding] = useState<SourceCoding>('Huffman');
   const [algorithm, setAlgorithm] = useState<DigitalToDigitalAlgorithm>('NRZ-L');
   const [signalData, setSignalData] = useState<SignalData | null>(null);
+  const [sourceData, setSourceData] = useState<SourceCodedData | null>(null);
 
   const algorithms: DigitalToDigitalAlgorithm[] = [
     'NRZ-L',
@@ -20,22 +34,46 @@ export function DigitalToDigitalMode() {
     'HDB3',
   ];
 
+  const simulateText = () => {
+    const coded = timed('generateSourceCodedSignal', () => generateSourceCodedSignal(textInput, sourceCoding, algorithm), countPoints);
+    // One second per bit on the line, as in the charts
+    const reports = compareSourceCodings(new TextEncoder().encode(textInput), 1);
+    setSourceData({ ...coded, reports });
+    setSignalData(coded);
+  };
+
   const handleSimulate = () => {
+    if (inputKind === 'text') {
+      if (textInput.length === 0) {
+        alert('Please enter some text');
+        return;
+      }
+      simulateText();
+      return;
+    }
     if (!/^[01]+$/.test(binaryInput)) {
       alert('Please enter a valid binary string (only 0s and 1s)');
       return;
     }
-    const data = generateDigitalToDigitalSignal(binaryInput, algorithm);
+    const data = timed('generateDigitalToDigitalSignal', () => generateDigitalToDigitalSignal(binaryInput, algorithm), countPoints);
+    setSourceData(null);
     setSignalData(data);
   };
 
   // Auto-regenerate signal when algorithm changes (if valid data exists)
   useEffect(() => {
-    if (signalData && /^[01]+$/.test(binaryInput)) {
-      const data = generateDigitalToDigitalSignal(binaryInput, algorithm);
+    if (!signalData) return;
+    if (inputKind === 'text') {
+      if (textInput.length > 0) simulateText();
+    } else if (/^[01]+$/.test(binaryInput)) {
+      const data = timed('generateDigitalToDigitalSignal', () => generateDigitalToDigitalSignal(binaryInput, algorithm), countPoints);
+      setSourceData(null);
       setSignalData(data);
     }
-  }, [algorithm, binaryInput]);
+  }, [algorithm, binaryInput, inputKind, textInput, sourceCoding]);
+
+  const lineBits = inputKind === 'text' && sourceData ? sourceData.codedBits : binaryInput.length;
+  const outputBits = inputKind === 'text' && sourceData ? sourceData.output.length / 2 : binaryInput.length;
 
   return (
     <div className="space-y-6">
@@ -45,17 +83,63 @@ export function DigitalToDigitalMode() {
         <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
           <div>
             <label className="block text-sm font-medium text-gray-700 mb-2">
-              Binary Input
+              Input Type
             </label>
-            <input
-              type="text"
-              value={binaryInput}
-              onChange={(e) => setBinaryInput(e.target.value)}
+            <select
+              value={inputKind}
+              onChange={(e) => setInputKind(e.target.value as InputKind)}
               className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
-              placeholder="10110"
-            />
+            >
+              <option value="binary">Binary</option>
+              <option value="text">Text (UTF-8)</option>
+            </select>
           </div>
 
+          {inputKind === 'binary' ? (
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Binary Input
+              </label>
+              <input
+                type="text"
+                value={binaryInput}
+                onChange={(e) => setBinaryInput(e.target.value)}
+                className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+                placeholder="10110"
+              />
+            </div>
+          ) : (
+            <>
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Text Input
+                </label>
+                <input
+                  type="text"
+                  value={textInput}
+                  onChange={(e) => setTextInput(e.target.value)}
+                  className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+                  placeholder="HELLO"
+                />
+              </div>
+
+              <div>
+                <label className="block text-sm font-medium text-gray-700 mb-2">
+                  Source Coding
+                </label>
+                <select
+                  value={sourceCoding}
+                  onChange={(e) => setSourceCoding(e.target.value as SourceCoding)}
+                  className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+                >
+                  <option value="None">None (8 bits/char)</option>
+                  <option value="Huffman">Huffman</option>
+                  <option value="LZ77">LZ77</option>
+                </select>
+              </div>
+            </>
+          )}
+
           <div>
             <label className="block text-sm font-medium text-gray-700 mb-2">
               Encoding Algorithm
@@ -85,19 +169,56 @@ export function DigitalToDigitalMode() {
         </div>
 
         <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
-          <strong>Algorithm:</strong> {algorithm} | <strong>Input:</strong> {binaryInput} | <strong>*NLS:</strong> <i> No Line Signal</i>
+          <strong>Algorithm:</strong> {algorithm} | <strong>Input:</strong> {inputKind === 'text' ? textInput : binaryInput} | <strong>*NLS:</strong> <i> No Line Signal</i>
+          {inputKind === 'text' && sourceData && (
+            <>
+              <br />
+              <strong>Source Coding:</strong> {sourceCoding} | <strong>Line Bits:</strong> {sourceData.codedBits} of{' '}
+              {sourceData.reports[0].originalBits} | <strong>Decoded:</strong> {sourceData.decodedText}
+            </>
+          )}
         </div>
       </div>
 
+      {inputKind === 'text' && sourceData && (
+        <div className="bg-white rounded-lg shadow-md p-4 overflow-x-auto">
+          <h3 className="text-lg font-semibold text-gray-700 mb-3">Source Coding of This Payload</h3>
+          <table className="w-full text-sm text-left text-gray-700">
+            <thead className="text-xs uppercase text-gray-500 border-b">
+              <tr>
+                <th className="py-2 pr-4">Coding</th>
+                <th className="py-2 pr-4 text-right">Bits</th>
+                <th className="py-2 pr-4 text-right">Ratio</th>
+                <th className="py-2 pr-4 text-right">Channel Time Saved</th>
+                <th className="py-2 text-right">Lossless</th>
+              </tr>
+            </thead>
+            <tbody>
+              {sourceData.reports.map((report) => (
+                <tr key={report.coding} className="border-b last:border-0">
+                  <td className="py-2 pr-4 font-medium">{report.coding}</td>
+                  <td className="py-2 pr-4 text-right">{report.codedBits}</td>
+                  <td className="py-2 pr-4 text-right">{report.ratio.toFixed(2)}×</td>
+                  <td className="py-2 pr-4 text-right">
+                    {report.timeSaved} bit times ({((100 * report.timeSaved) / report.originalBits).toFixed(0)}%)
+                  </td>
+                  <td className="py-2 text-right">{report.lossless ? 'yes' : 'no'}</td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        </div>
+      )}
+
       {signalData && (
         <div className="space-y-4">
           <SignalChart
             data={signalData.input}
-            title="Input Signal - Digital Bits"
+            title={inputKind === 'text' ? `Input Signal - ${sourceCoding} Coded Bits` : 'Input Signal - Digital Bits'}
             color="#10b981"
             domain={[-0.5, 1.5]}
             bitDuration={1}
-            numBits={binaryInput.length}
+            numBits={lineBits}
             ticks={[0, 1]}
           />
           <SignalChart
@@ -106,18 +227,18 @@ export function DigitalToDigitalMode() {
             color="#3b82f6"
             domain={[-1.5, 1.5]}
             bitDuration={1}
-            numBits={binaryInput.length}
+            numBits={lineBits}
             ticks={[-1, 0, 1]}
             isDigital={true}
             isTransmitted={true}
           />
           <SignalChart
             data={signalData.output}
-            title="Output Signal - Decoded Bits"
+            title={inputKind === 'text' ? 'Output Signal - Decoded Text Bits' : 'Output Signal - Decoded Bits'}
             color="#f59e0b"
             domain={[-0.5, 1.5]}
             bitDuration={1}
-            numBits={binaryInput.length}
+            numBits={outputBits}
             ticks={[0, 1]}
           />
         </div>
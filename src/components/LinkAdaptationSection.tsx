@@ -0,0 +1,196 @@
+import { useEffect, useRef, useState } from 'react';
+import { Play, Square } from 'lucide-react';
+import { SignalChart } from './SignalChart';
+import { DataPoint } from '../types';
+import { modulationModels, snrThresholds } from '../utils/berModels';
+import {
+  LinkAdaptationSimulation,
+  LinkAdaptationSummary,
+  defaultLinkAdaptationConfig,
+} from '../utils/linkAdaptation';
+
+// Frames simulated between repaints
+const framesPerChunk = 10;
+
+export function LinkAdaptationSection() {
+  const [meanSnrDb, setMeanSnrDb] = useState(defaultLinkAdaptationConfig.meanSnrDb);
+  const [targetExponent, setTargetExponent] = useState(-3);
+  const [marginDb, setMarginDb] = useState(defaultLinkAdaptationConfig.marginDb);
+  const [coherenceFrames, setCoherenceFrames] = useState(defaultLinkAdaptationConfig.coherenceFrames);
+  const [frameCount, setFrameCount] = useState(500);
+  const [snrPoints, setSnrPoints] = useState<DataPoint[]>([]);
+  const [goodputPoints, setGoodputPoints] = useState<DataPoint[]>([]);
+  const [summary, setSummary] = useState<LinkAdaptationSummary | null>(null);
+  const [running, setRunning] = useState(false);
+  const timer = useRef<number | null>(null);
+
+  const targetBer = 10 ** targetExponent;
+  const thresholds = snrThresholds(targetBer);
+
+  const stop = () => {
+    if (timer.current !== null) clearTimeout(timer.current);
+    timer.current = null;
+    setRunning(false);
+  };
+
+  // Cancel a run in progress when the section unmounts
+  useEffect(() => stop, []);
+
+  const handleRun = () => {
+    stop();
+    const simulation = new LinkAdaptationSimulation({
+      ...defaultLinkAdaptationConfig,
+      meanSnrDb,
+      targetBer,
+      marginDb,
+      coherenceFrames,
+    });
+    const snr: DataPoint[] = [];
+    const goodput: DataPoint[] = [];
+    setRunning(true);
+
+    const runChunk = () => {
+      for (let k = 0; k < framesPerChunk && simulation.summary.frames < frameCount; k++) {
+        const report = simulation.step();
+        snr.push({ x: report.frame, y: report.snrDb });
+        goodput.push({ x: report.frame, y: report.goodput });
+      }
+      setSnrPoints(snr.slice());
+      setGoodputPoints(goodput.slice());
+      setSummary(simulation.summary);
+      if (simulation.summary.frames < frameCount) {
+        timer.current = window.setTimeout(runChunk, 0);
+      } else {
+        timer.current = null;
+        setRunning(false);
+      }
+    };
+    timer.current = window.setTimeout(runChunk, 0);
+  };
+
+  return (
+    <div className="space-y-6">
+      <div className="bg-white rounded-lg shadow-md p-6">
+        <h2 className="text-xl font-bold text-gray-800 mb-4">Link Adaptation</h2>
+
+        <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Mean SNR (Es/N0): {meanSnrDb} dB
+            </label>
+            <input
+              type="range"
+              min="0"
+              max="30"
+              step="1"
+              value={meanSnrDb}
+              onChange={(e) => setMeanSnrDb(parseFloat(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Target BER: 1e{targetExponent}
+            </label>
+            <input
+              type="range"
+              min="-6"
+              max="-1"
+              step="1"
+              value={targetExponent}
+              onChange={(e) => setTargetExponent(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              SNR Margin: {marginDb} dB
+            </label>
+            <input
+              type="range"
+              min="0"
+              max="6"
+              step="0.5"
+              value={marginDb}
+              onChange={(e) => setMarginDb(parseFloat(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Fading Coherence: {coherenceFrames === 0 ? 'static channel' : `${coherenceFrames} frames`}
+            </label>
+            <input
+              type="range"
+              min="0"
+              max="100"
+              step="5"
+              value={coherenceFrames}
+              onChange={(e) => setCoherenceFrames(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div>
+            <label className="block text-sm font-medium text-gray-700 mb-2">
+              Frames: {frameCount}
+            </label>
+            <input
+              type="range"
+              min="100"
+              max="2000"
+              step="100"
+              value={frameCount}
+              onChange={(e) => setFrameCount(parseInt(e.target.value))}
+              className="w-full"
+            />
+          </div>
+
+          <div className="flex items-end">
+            <button
+              onClick={running ? stop : handleRun}
+              className="w-full bg-blue-600 hover:bg-blue-700 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+            >
+              {running ? <Square size={18} /> : <Play size={18} />}
+              {running ? 'Stop' : 'Run'}
+            </button>
+          </div>
+        </div>
+
+        <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700">
+          <strong>Thresholds at BER 1e{targetExponent}:</strong>{' '}
+          {modulationModels.map((model, index) => `${model.algorithm} ${thresholds[index].toFixed(1)} dB`).join(' | ')}
+          {summary && (
+            <>
+              <br />
+              <strong>Frames:</strong> {summary.frames} | <strong>Goodput:</strong> {summary.goodput.toFixed(2)} bit/symbol
+              {' '}| <strong>Capacity:</strong> {summary.capacity.toFixed(2)} bit/symbol (
+              {summary.capacity > 0 ? ((100 * summary.goodput) / summary.capacity).toFixed(0) : 0}%) |{' '}
+              <strong>BER:</strong> {summary.bitErrorRate.toExponential(2)} | <strong>Keyings:</strong>{' '}
+              {Object.entries(summary.usage)
+                .map(([algorithm, frames]) => `${algorithm} ${frames}`)
+                .join(', ')}
+            </>
+          )}
+        </div>
+      </div>
+
+      {snrPoints.length > 0 && (
+        <div className="space-y-4">
+          <SignalChart data={snrPoints} title="Channel SNR per Frame" color="#8b5cf6" xLabel="Frame" yLabel="dB" />
+          <SignalChart
+            data={goodputPoints}
+            title="Goodput per Frame"
+            color="#10b981"
+            domain={[0, 4]}
+            xLabel="Frame"
+            yLabel="bit/symbol"
+          />
+        </div>
+      )}
+    </div>
+  );
+}
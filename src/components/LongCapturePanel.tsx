@@ -0,0 +1,243 @@
+import { useEffect, useRef, useState } from 'react';
+import { HardDrive, Square } from 'lucide-react';
+import { SignalChart } from './SignalChart';
+import { CaptureSummary, CaptureView, LongCapture, captureSampleRate } from '../utils/longCapture';
+import { Envelope } from '../utils/lodPyramid';
+import { AnalogToDigitalConfig, DataPoint } from '../types';
+
+interface LongCapturePanelProps {
+  frequency: number;
+  amplitude: number;
+  conversion: AnalogToDigitalConfig;
+}
+
+const durations = [
+  { label: '10 minutes', seconds: 600 },
+  { label: '1 hour', seconds: 3600 },
+  { label: '1 day', seconds: 86400 },
+];
+
+const windows = [
+  { label: '1 s', seconds: 1 },
+  { label: '10 s', seconds: 10 },
+  { label: '1 min', seconds: 60 },
+  { label: '10 min', seconds: 600 },
+  { label: '1 hour', seconds: 3600 },
+  { label: 'Whole capture', seconds: Infinity },
+];
+
+// Columns per envelope: about one per pixel of a chart
+const viewColumns = 600;
+
+function megabytes(bytes: number): string {
+  return `${(bytes / (1024 * 1024)).toFixed(1)} MB`;
+}
+
+// Each column becomes its minimum then its maximum, so the line sweeps the column's whole range
+function envelopePoints(envelope: Envelope): DataPoint[] {
+  const columnTime = (envelope.end - envelope.start) / envelope.min.length / captureSampleRate;
+  const points: DataPoint[] = [];
+  for (let c = 0; c < envelope.min.length; c++) {
+    const x = envelope.start / captureSampleRate + c * columnTime;
+    points.push({ x, y: envelope.min[c] }, { x: x + columnTime / 2, y: envelope.max[c] });
+  }
+  return points;
+}
+
+export function LongCapturePanel({ frequency, amplitude, conversion }: LongCapturePanelProps) {
+  const [duration, setDuration] = useState(durations[0].seconds);
+  const [running, setRunning] = useState(false);
+  const [progress, setProgress] = useState(0);
+  const [summary, setSummary] = useState<CaptureSummary | null>(null);
+  const [error, setError] = useState<string | null>(null);
+  const [windowLength, setWindowLength] = useState(windows[1].seconds);
+  const [windowStart, setWindowStart] = useState(0);
+  const [view, setView] = useState<CaptureView | null>(null);
+  const capture = useRef(new LongCapture());
+  // Bumped to drop the replies of a capture or view that has been superseded
+  const run = useRef(0);
+  const viewRequest = useRef(0);
+
+  // Stop the worker when the panel unmounts; its files are deleted by the next capture
+  useEffect(() => () => capture.current.terminate(), []);
+
+  // A capture of another tone or converter no longer applies, finished or not
+  useEffect(() => {
+    run.current++;
+    capture.current.terminate();
+    setRunning(false);
+    setSummary(null);
+    setView(null);
+  }, [frequency, amplitude, conversion]);
+
+  const capturedSeconds = summary ? summary.samples / summary.sampleRate : 0;
+  const shownSeconds = Math.min(windowLength, capturedSeconds);
+
+  useEffect(() => {
+    if (!summary) return;
+    const token = ++viewRequest.current;
+    const start = Math.min(windowStart, capturedSeconds - shownSeconds);
+    capture.current
+      .view(start, start + shownSeconds, viewColumns)
+      .then(result => {
+        if (token === viewRequest.current) setView(result);
+      })
+      .catch(() => undefined);
+  }, [summary, windowStart, shownSeconds]);
+
+  const handleCapture = async () => {
+    const token = ++run.current;
+    setRunning(true);
+    setError(null);
+    setSummary(null);
+    setView(null);
+    setProgress(0);
+    setWindowStart(0);
+    try {
+      const result = await capture.current.capture({ frequency, amplitude, duration, conversion }, samples => {
+        if (token === run.current) setProgress(samples / (duration * captureSampleRate));
+      });
+      if (token === run.current) setSummary(result);
+    } catch (e) {
+      if (token === run.current) setError(e instanceof Error ? e.message : String(e));
+    } finally {
+      if (token === run.current) setRunning(false);
+    }
+  };
+
+  const handleCancel = () => {
+    run.current++;
+    capture.current.terminate();
+    setRunning(false);
+  };
+
+  return (
+    <div className="bg-white rounded-lg shadow-md p-6">
+      <h3 className="text-lg font-semibold text-gray-700 mb-3">Long Capture</h3>
+      <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
+        <div>
+          <label className="block text-sm font-medium text-gray-700 mb-2">Duration</label>
+          <select
+            value={duration}
+            onChange={(e) => setDuration(parseFloat(e.target.value))}
+            disabled={running}
+            className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+          >
+            {durations.map(({ label, seconds }) => (
+              <option key={seconds} value={seconds}>
+                {label} ({(seconds * captureSampleRate).toLocaleString()} samples)
+              </option>
+            ))}
+          </select>
+        </div>
+        <div className="flex items-end">
+          <button
+            onClick={running ? handleCancel : handleCapture}
+            className={`w-full ${running ? 'bg-red-600 hover:bg-red-700' : 'bg-blue-600 hover:bg-blue-700'} text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors`}
+          >
+            {running ? <Square size={18} /> : <HardDrive size={18} />}
+            {running ? `Cancel (${(progress * 100).toFixed(0)}%)` : 'Run Capture'}
+          </button>
+        </div>
+      </div>
+      <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700 mb-4">
+        Runs the current converter on the tone for the whole duration at {captureSampleRate.toLocaleString()} samples
+        per second, in a worker. The input and its reconstruction are written in chunks to the browser's private
+        file storage (OPFS), with only the most recently used chunks kept in memory, so a day-long capture needs
+        no more memory than a short one. SQNR and the signal statistics stream through the same chunks; the charts
+        draw each column's minimum and maximum from a level-of-detail pyramid, so every zoom level keeps the peaks.
+        Without OPFS the capture stays in memory, which only the shorter durations fit.
+      </div>
+      {error && <p className="mb-3 text-sm text-red-600">{error}</p>}
+      {summary && (
+        <>
+          <div className="overflow-x-auto mb-4">
+            <table className="w-full text-sm text-left text-gray-700">
+              <tbody>
+                <tr className="border-b">
+                  <th className="py-2 pr-4 font-medium">Samples</th>
+                  <td className="py-2 pr-4">{summary.samples.toLocaleString()} per signal</td>
+                  <th className="py-2 pr-4 font-medium">Storage</th>
+                  <td className="py-2">
+                    {summary.storage === 'opfs' ? 'OPFS' : 'memory'}, {megabytes(summary.storedBytes)} written
+                  </td>
+                </tr>
+                <tr className="border-b">
+                  <th className="py-2 pr-4 font-medium">Peak Resident</th>
+                  <td className="py-2 pr-4">
+                    {megabytes(summary.residentBytes)} + {megabytes(summary.pyramidBytes)} pyramids
+                  </td>
+                  <th className="py-2 pr-4 font-medium">Paging</th>
+                  <td className="py-2">
+                    {summary.pageOuts.toLocaleString()} chunks out, {summary.pageIns.toLocaleString()} in
+                  </td>
+                </tr>
+                <tr className="border-b">
+                  <th className="py-2 pr-4 font-medium">SQNR</th>
+                  <td className="py-2 pr-4">{summary.sqnrDb.toFixed(2)} dB</td>
+                  <th className="py-2 pr-4 font-medium">RMS (in / out)</th>
+                  <td className="py-2">
+                    {summary.input.rms.toFixed(4)} / {summary.output.rms.toFixed(4)}
+                  </td>
+                </tr>
+                <tr>
+                  <th className="py-2 pr-4 font-medium">Generation</th>
+                  <td className="py-2 pr-4">{(summary.generationMs / 1000).toFixed(2)} s</td>
+                  <th className="py-2 pr-4 font-medium">Analysis</th>
+                  <td className="py-2">{(summary.analysisMs / 1000).toFixed(2)} s</td>
+                </tr>
+              </tbody>
+            </table>
+          </div>
+          <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
+            <div>
+              <label className="block text-sm font-medium text-gray-700 mb-2">Window</label>
+              <select
+                value={windowLength}
+                onChange={(e) => setWindowLength(parseFloat(e.target.value))}
+                className="w-full px-3 py-2 border border-gray-300 rounded-md focus:outline-none focus:ring-2 focus:ring-blue-500"
+              >
+                {windows.map(({ label, seconds }) => (
+                  <option key={label} value={seconds}>
+                    {label}
+                  </option>
+                ))}
+              </select>
+            </div>
+            <div className="md:col-span-2">
+              <label className="block text-sm font-medium text-gray-700 mb-2">
+                Start: {Math.min(windowStart, capturedSeconds - shownSeconds).toFixed(1)} s
+              </label>
+              <input
+                type="range"
+                min="0"
+                max={capturedSeconds - shownSeconds}
+                step={shownSeconds / 10 || 1}
+                value={Math.min(windowStart, capturedSeconds - shownSeconds)}
+                onChange={(e) => setWindowStart(parseFloat(e.target.value))}
+                disabled={shownSeconds >= capturedSeconds}
+                className="w-full"
+              />
+            </div>
+          </div>
+          {view && (
+            <div className="space-y-4">
+              <SignalChart
+                data={envelopePoints(view.input)}
+                title="Captured Input - Envelope"
+                color="#10b981"
+                timeDomain={[view.startTime, view.endTime]}
+              />
+              <SignalChart
+                data={envelopePoints(view.output)}
+                title="Captured Output - Envelope"
+                color="#f59e0b"
+                timeDomain={[view.startTime, view.endTime]}
+              />
+            </div>
+          )}
+        </>
+      )}
+    </div>
+  );
+}
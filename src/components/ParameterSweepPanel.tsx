@@ -0,0 +1,280 @@
+import { MouseEvent, useEffect, useRef, useState } from 'react';
+import { LayoutGrid } from 'lucide-react';
+import { SweepPool, SweepResult, axisValues, defaultSweepAxes, toneSweepInput } from '../utils/sweep';
+import { cachedResult, resultCache } from '../utils/resultCache';
+import { AnalogToDigitalAlgorithm, ReconstructionMethod } from '../types';
+
+interface ParameterSweepPanelProps {
+  algorithm: AnalogToDigitalAlgorithm;
+  frequency: number;
+  amplitude: number;
+  reconstruction: ReconstructionMethod;
+  /** Called with a cell's sampling rate and levels (PCM) or step size (DM) to adopt them */
+  onApply: (rate: number, value: number) => void;
+}
+
+const canvasWidth = 640;
+const canvasHeight = 320;
+
+// Dark blue (low SQNR) through teal and green to yellow (high SQNR)
+const palette: [number, number, number][] = [
+  [68, 1, 84],
+  [59, 82, 139],
+  [33, 145, 140],
+  [94, 201, 98],
+  [253, 231, 37],
+];
+
+function heatColor(fraction: number): string {
+  const position = Math.min(1, Math.max(0, fraction)) * (palette.length - 1);
+  const index = Math.min(palette.length - 2, Math.floor(position));
+  const t = position - index;
+  const [r, g, b] = palette[index].map((channel, c) => Math.round(channel + t * (palette[index + 1][c] - channel)));
+  return `rgb(${r}, ${g}, ${b})`;
+}
+
+function formatValue(algorithm: AnalogToDigitalAlgorithm, value: number): string {
+  return algorithm === 'PCM' ? `${value} levels` : `step ${value.toFixed(3)}`;
+}
+
+export function ParameterSweepPanel({ algorithm, frequency, amplitude, reconstruction, onApply }: ParameterSweepPanelProps) {
+  const [rateSteps, setRateSteps] = useState(defaultSweepAxes[algorithm].rate.steps);
+  const [valueSteps, setValueSteps] = useState(defaultSweepAxes[algorithm].value.steps);
+  const [result, setResult] = useState<SweepResult | null>(null);
+  // When a result came from the cache, when it was computed
+  const [cachedAt, setCachedAt] = useState<number | null>(null);
+  const [running, setRunning] = useState(false);
+  const [error, setError] = useState<string | null>(null);
+  const [hovered, setHovered] = useState<number | null>(null);
+  const canvas = useRef<HTMLCanvasElement>(null);
+  const pool = useRef(new SweepPool());
+
+  // Stop the workers when the panel unmounts
+  useEffect(() => () => pool.current.terminate(), []);
+
+  useEffect(() => {
+    setRateSteps(defaultSweepAxes[algorithm].rate.steps);
+    setValueSteps(defaultSweepAxes[algorithm].value.steps);
+  }, [algorithm]);
+
+  // A sweep of the other algorithm, or of another tone or receiver, no longer applies
+  useEffect(() => {
+    setResult(null);
+  }, [algorithm, frequency, amplitude, reconstruction]);
+
+  // Everything a sweep's result depends on; its cache key
+  const sweepConfig = () => {
+    const axes = defaultSweepAxes[algorithm];
+    const rates = axisValues({ ...axes.rate, steps: rateSteps }, 'rate');
+    const values = axisValues({ ...axes.value, steps: valueSteps }, algorithm === 'PCM' ? 'levels' : 'step');
+    return { algorithm, frequency, amplitude, reconstruction, rates, values };
+  };
+
+  // Show an earlier run of exactly this sweep, even from before a reload, without rerunning it
+  useEffect(() => {
+    let current = true;
+    resultCache.get<SweepResult>('parameter sweep', sweepConfig()).then((hit) => {
+      if (!current || !hit) return;
+      setResult(hit.value);
+      setCachedAt(hit.storedAt);
+    });
+    return () => {
+      current = false;
+    };
+  }, [algorithm, frequency, amplitude, reconstruction, rateSteps, valueSteps]);
+
+  const handleSweep = () => {
+    const config = sweepConfig();
+    setRunning(true);
+    setError(null);
+    cachedResult('parameter sweep', config, () =>
+      pool.current.run(algorithm, toneSweepInput(frequency, amplitude), config.rates, config.values, { reconstruction })
+    )
+      .then((run) => {
+        setResult(run.value);
+        setCachedAt(run.cached ? run.storedAt : null);
+      })
+      .catch((reason: unknown) => setError(reason instanceof Error ? reason.message : String(reason)))
+      .finally(() => setRunning(false));
+  };
+
+  // Draw the heatmap: sampling rate upwards, levels or step size to the right, frontier cells ringed
+  useEffect(() => {
+    const context = canvas.current?.getContext('2d');
+    if (!context || !result) return;
+    const { rates, values, sqnrDb, frontier } = result;
+    let low = Infinity;
+    let high = -Infinity;
+    for (const value of sqnrDb) {
+      low = Math.min(low, value);
+      high = Math.max(high, value);
+    }
+    const cellWidth = canvasWidth / values.length;
+    const cellHeight = canvasHeight / rates.length;
+
+    context.clearRect(0, 0, canvasWidth, canvasHeight);
+    for (let r = 0; r < rates.length; r++) {
+      for (let v = 0; v < values.length; v++) {
+        context.fillStyle = heatColor(high > low ? (sqnrDb[r * values.length + v] - low) / (high - low) : 1);
+        context.fillRect(v * cellWidth, canvasHeight - (r + 1) * cellHeight, Math.ceil(cellWidth), Math.ceil(cellHeight));
+      }
+    }
+    context.strokeStyle = '#ffffff';
+    context.lineWidth = 2;
+    for (const cell of frontier) {
+      const r = Math.floor(cell / values.length);
+      const v = cell % values.length;
+      context.strokeRect(v * cellWidth + 1, canvasHeight - (r + 1) * cellHeight + 1, cellWidth - 2, cellHeight - 2);
+    }
+  }, [result]);
+
+  const cellAt = (event: MouseEvent<HTMLCanvasElement>): number | null => {
+    if (!result) return null;
+    const bounds = event.currentTarget.getBoundingClientRect();
+    const v = Math.floor(((event.clientX - bounds.left) / bounds.width) * result.values.length);
+    const r = Math.floor(((bounds.bottom - event.clientY) / bounds.height) * result.rates.length);
+    if (v < 0 || v >= result.values.length || r < 0 || r >= result.rates.length) return null;
+    return r * result.values.length + v;
+  };
+
+  const applyCell = (cell: number) => {
+    if (!result) return;
+    onApply(result.rates[Math.floor(cell / result.values.length)], result.values[cell % result.values.length]);
+  };
+
+  const describe = (cell: number) => {
+    if (!result) return '';
+    const rate = result.rates[Math.floor(cell / result.values.length)];
+    const value = result.values[cell % result.values.length];
+    return `${rate.toFixed(1)} Hz, ${formatValue(result.algorithm, value)}: ${result.sqnrDb[cell].toFixed(1)} dB SQNR at ${result.bitRates[cell].toFixed(0)} bit/s`;
+  };
+
+  return (
+    <div className="bg-white rounded-lg shadow-md p-6">
+      <h3 className="text-lg font-semibold text-gray-700 mb-3">Parameter Sweep</h3>
+
+      <div className="grid grid-cols-1 md:grid-cols-3 gap-4 mb-4">
+        <div>
+          <label className="block text-sm font-medium text-gray-700 mb-2">
+            Sampling Rates: {rateSteps}
+          </label>
+          <input
+            type="range"
+            min="8"
+            max="128"
+            step="8"
+            value={rateSteps}
+            onChange={(e) => setRateSteps(parseInt(e.target.value))}
+            className="w-full"
+          />
+        </div>
+
+        <div>
+          <label className="block text-sm font-medium text-gray-700 mb-2">
+            {algorithm === 'PCM' ? 'Quantization Levels' : 'Step Sizes'}: {valueSteps}
+          </label>
+          <input
+            type="range"
+            min="8"
+            max={algorithm === 'PCM' ? 64 : 96}
+            step="4"
+            value={valueSteps}
+            onChange={(e) => setValueSteps(parseInt(e.target.value))}
+            className="w-full"
+          />
+        </div>
+
+        <div className="flex items-end">
+          <button
+            onClick={handleSweep}
+            disabled={running}
+            className="w-full bg-blue-600 hover:bg-blue-700 disabled:bg-gray-400 text-white font-medium py-2 px-4 rounded-md flex items-center justify-center gap-2 transition-colors"
+          >
+            <LayoutGrid size={18} />
+            {running ? 'Sweeping…' : 'Run Sweep'}
+          </button>
+        </div>
+      </div>
+
+      <div className="bg-blue-50 border-l-4 border-blue-500 p-3 text-sm text-gray-700 mb-4">
+        Every cell runs the {algorithm} transmitter and receiver on the current tone and measures SQNR between
+        the input and the reconstruction, away from the start-up transient. Bit rate is the sampling rate
+        times {algorithm === 'PCM' ? '⌈log2 levels⌉' : 'one bit'}. Ringed cells form the Pareto frontier: no
+        other cell reaches the same SQNR at a lower bit rate. Click a cell to use its settings. Results are kept
+        in the browser, so a sweep already run with these settings shows straight away.
+      </div>
+      {error && <p className="mb-3 text-sm text-red-600">{error}</p>}
+
+      {result && (
+        <>
+          <div className="flex gap-2">
+            <div className="flex flex-col justify-between text-xs text-gray-500 py-1">
+              <span>{result.rates[result.rates.length - 1].toFixed(0)} Hz</span>
+              <span className="[writing-mode:vertical-rl] rotate-180">Sampling rate</span>
+              <span>{result.rates[0].toFixed(0)} Hz</span>
+            </div>
+            <div className="flex-1">
+              <canvas
+                ref={canvas}
+                width={canvasWidth}
+                height={canvasHeight}
+                className="w-full cursor-crosshair rounded"
+                onMouseMove={(e) => setHovered(cellAt(e))}
+                onMouseLeave={() => setHovered(null)}
+                onClick={(e) => {
+                  const cell = cellAt(e);
+                  if (cell !== null) applyCell(cell);
+                }}
+              />
+              <div className="flex justify-between text-xs text-gray-500 mt-1">
+                <span>{formatValue(result.algorithm, result.values[0])}</span>
+                <span>{result.algorithm === 'PCM' ? 'Quantization levels' : 'Delta step size'}</span>
+                <span>{formatValue(result.algorithm, result.values[result.values.length - 1])}</span>
+              </div>
+            </div>
+          </div>
+          <p className="mt-2 text-sm text-gray-600">
+            {hovered !== null
+              ? describe(hovered)
+              : cachedAt !== null
+                ? `${result.sqnrDb.length.toLocaleString()} cells, from the cache (computed ${new Date(cachedAt).toLocaleString()} in ${result.elapsedMs.toFixed(0)} ms)`
+                : `${result.sqnrDb.length.toLocaleString()} cells in ${result.elapsedMs.toFixed(0)} ms`}
+          </p>
+
+          <div className="mt-4 overflow-x-auto">
+            <table className="w-full text-sm text-left text-gray-700">
+              <thead className="text-xs uppercase text-gray-500 border-b">
+                <tr>
+                  <th className="py-2 pr-4">Sampling Rate</th>
+                  <th className="py-2 pr-4">{result.algorithm === 'PCM' ? 'Levels' : 'Step Size'}</th>
+                  <th className="py-2 pr-4 text-right">Bit Rate</th>
+                  <th className="py-2 pr-4 text-right">SQNR</th>
+                  <th className="py-2" />
+                </tr>
+              </thead>
+              <tbody>
+                {result.frontier.map((cell) => (
+                  <tr key={cell} className="border-b last:border-0">
+                    <td className="py-2 pr-4">{result.rates[Math.floor(cell / result.values.length)].toFixed(2)} Hz</td>
+                    <td className="py-2 pr-4">
+                      {result.algorithm === 'PCM'
+                        ? result.values[cell % result.values.length]
+                        : result.values[cell % result.values.length].toFixed(3)}
+                    </td>
+                    <td className="py-2 pr-4 text-right">{result.bitRates[cell].toFixed(0)} bit/s</td>
+                    <td className="py-2 pr-4 text-right">{result.sqnrDb[cell].toFixed(1)} dB</td>
+                    <td className="py-2 text-right">
+                      <button onClick={() => applyCell(cell)} className="text-blue-600 hover:underline">
+                        Use
+                      </button>
+                    </td>
+                  </tr>
+                ))}
+              </tbody>
+            </table>
+          </div>
+        </>
+      )}
+    </div>
+  );
+}
@@ -0,0 +1,261 @@
+import { useEffect, useState } from 'react';
+import { Circle, Download, Timer, Trash2, X } from 'lucide-react';
+import {
+  TimingCategory,
+  TimingSeries,
+  clearTimings,
+  setInstrumentationEnabled,
+  subscribeTimings,
+  timingSnapshot,
+} from '../utils/instrumentation';
+import { HotPathCounters, runCountSnapshot } from '../utils/counters';
+import {
+  ResponsivenessSnapshot,
+  clearResponsiveness,
+  responsivenessSnapshot,
+  startResponsivenessMonitor,
+  stopResponsivenessMonitor,
+  subscribeResponsiveness,
+} from '../utils/responsiveness';
+import { downloadTrace, startTrace, stopTrace } from '../utils/trace';
+
+const categoryColors: Record<TimingCategory, string> = {
+  generate: 'bg-blue-100 text-blue-700',
+  stage: 'bg-emerald-100 text-emerald-700',
+  render: 'bg-amber-100 text-amber-700',
+  commit: 'bg-purple-100 text-purple-700',
+};
+
+// Plain SVG so drawing the history never shows up in the chart timings themselves
+function Sparkline({ values }: { values: number[] }) {
+  const width = 80;
+  const height = 18;
+  if (values.length < 2) return <svg width={width} height={height} />;
+  let max = 0;
+  for (const value of values) max = Math.max(max, value);
+  const points = values
+    .map((value, index) => {
+      const x = (index / (values.length - 1)) * width;
+      const y = height - 1 - (max > 0 ? (value / max) * (height - 2) : 0);
+      return `${x.toFixed(1)},${y.toFixed(1)}`;
+    })
+    .join(' ');
+  return (
+    <svg width={width} height={height}>
+      <polyline points={points} fill="none" stroke="#3b82f6" strokeWidth={1.5} />
+    </svg>
+  );
+}
+
+function formatRate(itemsPerSecond: number): string {
+  if (itemsPerSecond <= 0) return '—';
+  if (itemsPerSecond >= 1e6) return `${(itemsPerSecond / 1e6).toFixed(1)} M/s`;
+  if (itemsPerSecond >= 1e3) return `${(itemsPerSecond / 1e3).toFixed(1)} k/s`;
+  return `${itemsPerSecond.toFixed(0)} /s`;
+}
+
+// Event Timing drops interactions under 16 ms; they are stored as 0
+function formatLatency(ms: number): string {
+  return ms > 0 ? `${ms.toFixed(0)} ms` : '< 16 ms';
+}
+
+/**
+ * Collapsible timing panel. Instrumentation and the responsiveness monitor record only
+ * while the panel is open, so the collapsed button costs nothing beyond its own render.
+ * A trace recording is independent of the panel and keeps going while it is collapsed.
+ */
+export function PerformanceOverlay() {
+  const [open, setOpen] = useState(false);
+  const [rows, setRows] = useState<TimingSeries[]>([]);
+  const [counts, setCounts] = useState<[string, HotPathCounters][]>([]);
+  const [responsiveness, setResponsiveness] = useState<ResponsivenessSnapshot>({ controls: [], incidents: [] });
+  const [tracing, setTracing] = useState(false);
+
+  const toggleTrace = () => {
+    if (tracing) {
+      downloadTrace(stopTrace());
+    } else {
+      startTrace();
+    }
+    setTracing(!tracing);
+  };
+
+  useEffect(() => {
+    if (!open) return;
+    setInstrumentationEnabled(true);
+    const refresh = () => {
+      setRows(timingSnapshot());
+      if (__SIGNAL_COUNTERS__) setCounts(runCountSnapshot());
+    };
+    refresh();
+    const unsubscribe = subscribeTimings(refresh);
+
+    startResponsivenessMonitor();
+    setResponsiveness(responsivenessSnapshot());
+    const unsubscribeResponsiveness = subscribeResponsiveness(() => setResponsiveness(responsivenessSnapshot()));
+    return () => {
+      unsubscribe();
+      unsubscribeResponsiveness();
+      setInstrumentationEnabled(false);
+      stopResponsivenessMonitor();
+    };
+  }, [open]);
+
+  const clearAll = () => {
+    clearTimings();
+    clearResponsiveness();
+  };
+
+  if (!open) {
+    return (
+      <button
+        onClick={() => setOpen(true)}
+        className="fixed bottom-4 right-4 z-50 bg-gray-800 hover:bg-gray-700 text-white text-sm font-medium py-2 px-3 rounded-md shadow-lg flex items-center gap-2 transition-colors"
+      >
+        <Timer size={16} />
+        Timings
+        {tracing && <Circle size={10} className="fill-red-500 text-red-500 animate-pulse" />}
+      </button>
+    );
+  }
+
+  return (
+    <div className="fixed bottom-4 right-4 z-50 w-[36rem] max-w-[calc(100vw-2rem)] max-h-[60vh] bg-white rounded-lg shadow-2xl border border-gray-200 flex flex-col">
+      <div className="flex items-center justify-between px-4 py-2 border-b">
+        <h3 className="text-sm font-semibold text-gray-700 flex items-center gap-2">
+          <Timer size={16} />
+          Timings
+        </h3>
+        <div className="flex items-center gap-1">
+          <button
+            onClick={toggleTrace}
+            title={tracing ? 'Stop recording and download the trace' : 'Record a Chrome trace for Perfetto'}
+            className={`flex items-center gap-1 px-2 py-1 rounded text-xs font-medium ${
+              tracing ? 'bg-red-50 text-red-700 hover:bg-red-100' : 'text-gray-600 hover:bg-gray-100'
+            }`}
+          >
+            {tracing ? <Download size={14} /> : <Circle size={14} />}
+            {tracing ? 'Save trace' : 'Record trace'}
+          </button>
+          <button
+            onClick={clearAll}
+            title="Clear"
+            className="p-1 rounded text-gray-500 hover:bg-gray-100 hover:text-gray-700"
+          >
+            <Trash2 size={16} />
+          </button>
+          <button
+            onClick={() => setOpen(false)}
+            title="Close and stop recording"
+            className="p-1 rounded text-gray-500 hover:bg-gray-100 hover:text-gray-700"
+          >
+            <X size={16} />
+          </button>
+        </div>
+      </div>
+
+      <div className="overflow-auto">
+        {import.meta.env.PROD && !__SIGNAL_COUNTERS__ && (
+          <p className="px-4 py-2 border-b text-xs text-gray-500">
+            Chart render timings need a development or instrumented build; React's production build drops
+            Profiler callbacks.
+          </p>
+        )}
+        {rows.length === 0 ? (
+          <p className="p-4 text-sm text-gray-500">Run a simulation to record timings.</p>
+        ) : (
+          <table className="w-full text-xs text-left text-gray-700">
+            <thead className="uppercase text-gray-500 border-b sticky top-0 bg-white">
+              <tr>
+                <th className="py-1.5 px-2">Span</th>
+                <th className="py-1.5 px-2 text-right">Latest</th>
+                <th className="py-1.5 px-2 text-right">Items/s</th>
+                <th className="py-1.5 px-2">History</th>
+              </tr>
+            </thead>
+            <tbody>
+              {rows.map((row) => (
+                <tr key={`${row.category}:${row.name}`} className="border-b last:border-0">
+                  <td className="py-1 px-2">
+                    <span className={`inline-block rounded px-1 mr-1 ${categoryColors[row.category]}`}>{row.category}</span>
+                    {row.name}
+                  </td>
+                  <td className="py-1 px-2 text-right font-mono">{row.latestMs.toFixed(2)} ms</td>
+                  <td className="py-1 px-2 text-right font-mono">{formatRate(row.itemsPerSecond)}</td>
+                  <td className="py-1 px-2">
+                    <Sparkline values={row.history} />
+                  </td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        )}
+        {responsiveness.controls.length > 0 && (
+          <table className="w-full text-xs text-left text-gray-700 border-t">
+            <thead className="uppercase text-gray-500 border-b bg-white">
+              <tr>
+                <th className="py-1.5 px-2">Control</th>
+                <th className="py-1.5 px-2 text-right">Changes</th>
+                <th className="py-1.5 px-2 text-right">INP p75</th>
+                <th className="py-1.5 px-2 text-right">Worst</th>
+                <th className="py-1.5 px-2 text-right">Long tasks</th>
+                <th className="py-1.5 px-2 text-right">Dropped</th>
+              </tr>
+            </thead>
+            <tbody>
+              {responsiveness.controls.map((row) => (
+                <tr key={row.control} className="border-b last:border-0">
+                  <td className="py-1 px-2">{row.control}</td>
+                  <td className="py-1 px-2 text-right font-mono">{row.interactions}</td>
+                  <td className="py-1 px-2 text-right font-mono">{formatLatency(row.p75Ms)}</td>
+                  <td className={`py-1 px-2 text-right font-mono ${row.worstMs > 200 ? 'text-red-600' : ''}`}>
+                    {formatLatency(row.worstMs)}
+                  </td>
+                  <td className="py-1 px-2 text-right font-mono">
+                    {row.longTasks > 0 ? `${row.longTasks} (${row.longTaskMs.toFixed(0)} ms)` : '—'}
+                  </td>
+                  <td className="py-1 px-2 text-right font-mono">{row.droppedFrames || '—'}</td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        )}
+        {responsiveness.incidents.length > 0 && (
+          <ul className="border-t px-2 py-1.5 space-y-0.5 text-xs text-gray-600">
+            {responsiveness.incidents.slice(0, 5).map((incident, index) => (
+              <li key={index}>
+                <span className="text-red-600">{incident.kind}</span>{' '}
+                {incident.durationMs.toFixed(0)} ms
+                {incident.frames > 0 && ` (${incident.frames} frames)`} after {incident.control} → {incident.value}
+              </li>
+            ))}
+          </ul>
+        )}
+        {__SIGNAL_COUNTERS__ && counts.length > 0 && (
+          <table className="w-full text-xs text-left text-gray-700 border-t">
+            <thead className="uppercase text-gray-500 border-b bg-white">
+              <tr>
+                <th className="py-1.5 px-2">Operations per run</th>
+                <th className="py-1.5 px-2 text-right">Samples</th>
+                <th className="py-1.5 px-2 text-right">sin/cos/atan2</th>
+                <th className="py-1.5 px-2 text-right">Growths</th>
+                <th className="py-1.5 px-2 text-right">Checkpoints</th>
+              </tr>
+            </thead>
+            <tbody>
+              {counts.map(([name, count]) => (
+                <tr key={name} className="border-b last:border-0">
+                  <td className="py-1 px-2">{name}</td>
+                  <td className="py-1 px-2 text-right font-mono">{count.samplesEmitted.toLocaleString()}</td>
+                  <td className="py-1 px-2 text-right font-mono">{count.transcendentals.toLocaleString()}</td>
+                  <td className="py-1 px-2 text-right font-mono">{count.bufferGrowths.toLocaleString()}</td>
+                  <td className="py-1 px-2 text-right font-mono">{count.checkpoints.toLocaleString()}</td>
+                </tr>
+              ))}
+            </tbody>
+          </table>
+        )}
+      </div>
+    </div>
+  );
+}
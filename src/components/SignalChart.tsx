@@ -1,5 +1,7 @@
+import { Profiler } from 'react';
 import { LineChart, Line, XAxis, YAxis, CartesianGrid, Tooltip, ResponsiveContainer, ReferenceLine } from 'recharts';
 import { DataPoint } from '../types';
+import { recordRender } from '../utils/instrumentation';
 
 interface SignalChartProps {
   data: DataPoint[];
@@ -12,9 +14,23 @@ interface SignalChartProps {
   numBits?: number;
   ticks?: number[];
   isTransmitted?: boolean;
+  xLabel?: string;
+  yLabel?: string;
+  /** Fixed time-axis range, so stacked charts line up; defaults to the data's range */
+  timeDomain?: [number, number];
 }
 
-export function SignalChart({ 
+// Profiled from outside so the timing includes the chart's own preparation as well as
+// Recharts, which lays out scales, ticks and paths during render
+export function SignalChart(props: SignalChartProps) {
+  return (
+    <Profiler id={`chart: ${props.title}`} onRender={recordRender}>
+      <SignalChartBody {...props} />
+    </Profiler>
+  );
+}
+
+function SignalChartBody({ 
   data, 
   title, 
   color, 
@@ -24,7 +40,10 @@ export function SignalChart({
   bitDuration = 1,
   numBits = 0,
   ticks,
-  isTransmitted = false
+  isTransmitted = false,
+  xLabel = 'Time (s)',
+  yLabel = 'Voltage',
+  timeDomain
 }: SignalChartProps) {
   // Calculate transition points (bit boundaries) for vertical lines
   const transitionLines = [];
@@ -39,11 +58,16 @@ export function SignalChart({
     ? Array.from({ length: numBits + 1 }, (_, i) => i * bitDuration)
     : undefined;
 
-  // Get min and max x values from data
-  const xValues = data.map(d => d.x);
-  const xDomain = xValues.length > 0 
-    ? [Math.min(...xValues), Math.max(...xValues)]
-    : undefined;
+  // Get min and max x values from data (a single pass, no intermediate array)
+  let xMin = Infinity;
+  let xMax = -Infinity;
+  for (const point of data) {
+    if (point.x < xMin) xMin = point.x;
+    if (point.x > xMax) xMax = point.x;
+  }
+  const xDomain = timeDomain ?? (data.length > 0 
+    ? [xMin, xMax]
+    : undefined);
 
   // Custom tick formatter for digital transmitted signals
   const formatDigitalTick = (value: number) => {
@@ -76,7 +100,7 @@ export function SignalChart({
             dataKey="x"
             stroke="#64748b"
             style={{ fontSize: '12px' }}
-            label={{ value: 'Time (s)', position: 'insideBottom', offset: -5 }}
+            label={{ value: xLabel, position: 'insideBottom', offset: -5 }}
             domain={xDomain}
             ticks={xTicks}
             type="number"
@@ -87,7 +111,7 @@ export function SignalChart({
             style={{ fontSize: '12px' }}
             domain={domain || (isDigital ? [0, 1] : ['auto', 'auto'])}
             ticks={ticks !== undefined ? ticks : (isDigital ? [0, 1] : undefined)}
-            label={{ value: 'Voltage', angle: -90, position: 'insideLeft' }}
+            label={{ value: yLabel, angle: -90, position: 'insideLeft' }}
             tickFormatter={isDigital && isTransmitted ? formatDigitalTick : undefined}
           />
           <Tooltip
@@ -1,9 +1,30 @@
 export type SimulationMode = 'digital-to-digital' | 'digital-to-analog' | 'analog-to-digital' | 'analog-to-analog';
 
 export type DigitalToDigitalAlgorithm = 'NRZ-L' | 'NRZ-I' | 'Manchester' | 'Differential Manchester' | 'AMI' | 'Pseudoternary' | 'B8ZS' | 'HDB3';
-export type DigitalToAnalogAlgorithm = 'ASK' | 'BFSK' | 'MFSK' | 'BPSK' | 'DPSK' | 'QPSK' | 'OQPSK' | 'MPSK' | 'QAM';
+export type DigitalToAnalogAlgorithm = 'ASK' | 'BFSK' | 'MFSK' | 'BPSK' | 'DPSK' | 'QPSK' | 'OQPSK' | 'MPSK' | 'QAM' | 'CPFSK' | 'MSK' | 'GMSK' | 'CSS';
 export type AnalogToDigitalAlgorithm = 'PCM' | 'Delta Modulation';
-export type AnalogToAnalogAlgorithm = 'AM' | 'FM' | 'PM';
+export type AnalogToAnalogAlgorithm = 'AM' | 'FM' | 'PM' | 'DSB-SC' | 'SSB-USB' | 'SSB-LSB' | 'VSB';
+export type ArqProtocol = 'Stop-and-Wait' | 'Go-Back-N' | 'Selective Repeat';
+export type SourceCoding = 'None' | 'Huffman' | 'LZ77';
+// Algorithm families the comparison view can run side by side
+export type ComparisonFamily = 'line coding' | 'modulation';
+// Kinds of result kept in the persistent result cache
+export type ResultCacheKind = 'parameter sweep' | 'coded link' | 'chirp link' | 'benchmark';
+export type BlockCode =
+  | 'Hamming(7,4)'
+  | 'Hamming(15,11)'
+  | 'SECDED(8,4)'
+  | 'SECDED(16,11)'
+  | 'BCH(15,7)'
+  | 'BCH(31,21)'
+  | 'BCH(63,45)';
+// Item kinds carried between pipeline stages
+export type PortType = 'bits' | 'symbols' | 'real' | 'complex';
+export type ReconstructionMethod = 'zero-order' | 'first-order' | 'sinc';
+// Modulators either synthesise the real passband waveform or its complex (I/Q) envelope
+export type SimulationDomain = 'passband' | 'baseband';
+// Storage of real and complex samples on pipeline edges and in stage kernels
+export type SamplePrecision = 'float64' | 'float32';
 
 export interface DataPoint {
   x: number;
@@ -16,9 +37,30 @@ export interface SignalData {
   output: DataPoint[];
 }
 
+export interface BasebandSignalData extends SignalData {
+  // Complex envelope samples simulated
+  basebandSamples: number;
+  // Real samples the passband simulation needs for the same signal
+  passbandSamples: number;
+}
+
+// Parameters of the digital-to-analog keyings that take any
+export interface KeyingConfig {
+  // CPFSK phase change per bit is π·h (MSK and GMSK always use h = 0.5)
+  modulationIndex: number;
+  // GMSK Gaussian filter bandwidth times bit period
+  bandwidthTime: number;
+  // CSS bits per chirp symbol (7–12); a symbol spans 2^SF chips
+  spreadingFactor: number;
+}
+
 export interface PCMConfig {
   samplingRate: number;
   quantizationLevels: number;
+  // Band-limit the input to samplingRate / 2 before sampling
+  antiAlias?: boolean;
+  // When set, the output is reconstructed at the display rate instead of at sample instants
+  reconstruction?: ReconstructionMethod;
 }
 
 export interface DeltaModulationConfig {
@@ -1,92 +1,527 @@
-import { DataPoint, AnalogToAnalogAlgorithm } from '../types';
+import { DataPoint, AnalogToAnalogAlgorithm, BasebandSignalData } from '../types';
+import { InputPort, OutputPort, Pipeline, PipelineOptions, Stage } from './pipeline';
+import {
+  CoherentDetector,
+  CollectSink,
+  OverlapSaveFilterStage,
+  PeriodicSpectralFilterStage,
+  PointSink,
+  SpectralResponse,
+  ToneSource,
+  Upconverter,
+} from './stages';
+import { VisibleWindow, interpolateForDisplay, sinePhasor, upconvert } from './baseband';
+import { hotCounters } from './counters';
+
+const duration = 2;
+const samplesPerSecond = 200;
+// Carrier frequency as a multiple of the message frequency
+const carrierRatio = 5;
+const amModulationIndex = 0.8;
+// FM peak deviation as a fraction of the carrier frequency
+const fmDeviationRatio = 0.5;
+const pmPhaseDeviation = Math.PI / 2;
+// VSB vestige width as a fraction of the message frequency
+const vsbVestigeRatio = 0.25;
 
 export function generateAnalogToAnalogSignal(
   messageFrequency: number,
   messageAmplitude: number,
   algorithm: AnalogToAnalogAlgorithm
 ): { input: DataPoint[]; transmitted: DataPoint[]; output: DataPoint[] } {
-  const duration = 2;
-  const samplesPerSecond = 200;
-  const totalSamples = duration * samplesPerSecond;
-
-  const inputSignal: DataPoint[] = [];
-  for (let i = 0; i < totalSamples; i++) {
-    const t = i / samplesPerSecond;
-    const y = messageAmplitude * Math.sin(2 * Math.PI * messageFrequency * t);
-    inputSignal.push({ x: t, y });
+  const { pipeline, input, transmitted, output } = buildAnalogToAnalogGraph(messageFrequency, messageAmplitude, algorithm);
+  pipeline.run();
+
+  return {
+    input: input.points,
+    transmitted: transmitted.points,
+    // Only the suppressed-carrier modes have a receiver in the passband graph
+    output: output ? output.points : input.points,
+  };
+}
+
+/**
+ * Preset graph for carrier modulation: message tone → modulator → transmitted carrier.
+ * DSB-SC, SSB and VSB add a coherent receiver (product detector → lowpass) on `output`;
+ * SSB and VSB build the carrier from the analytic message (phasing method).
+ */
+export function buildAnalogToAnalogGraph(
+  messageFrequency: number,
+  messageAmplitude: number,
+  algorithm: AnalogToAnalogAlgorithm,
+  options?: PipelineOptions
+): { pipeline: Pipeline; input: PointSink; transmitted: PointSink; output: PointSink | null } {
+  const input = new PointSink('real', samplesPerSecond);
+  const transmitted = new PointSink('real', samplesPerSecond);
+  const carrierFrequency = messageFrequency * carrierRatio;
+  const count = duration * samplesPerSecond;
+  // The carrier is a whole multiple of the message, so whole message periods repeat exactly
+  const period = wholeCycles(messageFrequency * duration) ? count : null;
+
+  const pipeline = new Pipeline(options)
+    .add('message', new ToneSource(messageFrequency, messageAmplitude, samplesPerSecond, count))
+    .add('input', input)
+    .add('transmitted', transmitted)
+    .connect('message', 'input');
+
+  if (isPhasingModulation(algorithm)) {
+    const response = quadratureResponse(algorithm, messageFrequency, samplesPerSecond);
+    pipeline
+      .add('hilbert', spectralFilter(response, period, messageFrequency, samplesPerSecond, true))
+      .add('sideband', new SidebandModulator(algorithm, messageAmplitude))
+      .add('modulator', new Upconverter(carrierFrequency, samplesPerSecond))
+      .connect('message', 'hilbert')
+      .connect('hilbert', 'sideband')
+      .connect('sideband', 'modulator');
+  } else {
+    pipeline
+      .add('modulator', new AnalogModulator(algorithm, messageFrequency, messageAmplitude, samplesPerSecond))
+      .connect('message', 'modulator');
+  }
+  pipeline.connect('modulator', 'transmitted');
+
+  if (algorithm === 'AM' || algorithm === 'FM' || algorithm === 'PM') {
+    return { pipeline, input, transmitted, output: null };
   }
 
-  let transmittedSignal: DataPoint[] = [];
+  // The message images sit at 2fc ± fm, far above a lowpass at 2fm
+  const output = new PointSink('real', samplesPerSecond);
+  const lowpass = messageLowpass(messageFrequency, messageAmplitude, samplesPerSecond);
+  pipeline
+    .add('detector', new CoherentDetector(carrierFrequency, samplesPerSecond))
+    .add('lowpass', spectralFilter(lowpass, period, messageFrequency, samplesPerSecond))
+    .add('output', output)
+    .connect('modulator', 'detector')
+    .connect('detector', 'lowpass')
+    .connect('lowpass', 'output');
+
+  return { pipeline, input, transmitted, output };
+}
+
+function wholeCycles(cycles: number): boolean {
+  return Math.abs(cycles - Math.round(cycles)) < 1e-9;
+}
+
+/**
+ * The exact circular FFT filter when the record repeats every `period` samples, otherwise
+ * the streaming overlap-save one, whose Blackman-windowed edges spread over about a third
+ * of the message frequency either side.
+ */
+function spectralFilter(
+  response: SpectralResponse,
+  period: number | null,
+  messageFrequency: number,
+  sampleRate: number,
+  quadrature = false
+): Stage {
+  if (period !== null) return new PeriodicSpectralFilterStage(period, response, quadrature);
+  const taps = 2 * Math.ceil((4 * sampleRate) / messageFrequency) + 1;
+  return new OverlapSaveFilterStage(response, taps, quadrature);
+}
+
+/** SSB and VSB need the message's Hilbert transform, so they cannot be generated sample by sample. */
+function isPhasingModulation(algorithm: AnalogToAnalogAlgorithm): boolean {
+  return algorithm === 'SSB-USB' || algorithm === 'SSB-LSB' || algorithm === 'VSB';
+}
+
+/**
+ * Gain of the quadrature (Hilbert) branch. SSB uses the full transform; VSB ramps it
+ * linearly from 0 at the carrier to 1 at the vestige edge, which keeps a vestige of the
+ * lower sideband near the carrier and sums to a flat response after coherent detection.
+ */
+function quadratureResponse(algorithm: AnalogToAnalogAlgorithm, messageFrequency: number, sampleRate: number): SpectralResponse {
+  if (algorithm !== 'VSB') return () => 1;
+  const vestige = (vsbVestigeRatio * messageFrequency) / sampleRate;
+  return (frequency) => Math.min(1, frequency / vestige);
+}
 
+/** Receiver lowpass; it also restores the message amplitude the modulators normalised away. */
+function messageLowpass(messageFrequency: number, messageAmplitude: number, sampleRate: number): SpectralResponse {
+  const cutoff = (2 * messageFrequency) / sampleRate;
+  return (frequency) => (frequency <= cutoff ? messageAmplitude : 0);
+}
+
+/** Maps the normalised message m and time t to the modulated carrier sample. */
+type CarrierModulation = (messageSignal: number, t: number) => number;
+
+function createCarrierModulation(
+  algorithm: AnalogToAnalogAlgorithm,
+  messageFrequency: number
+): CarrierModulation {
   switch (algorithm) {
     case 'AM':
-      transmittedSignal = generateAM(inputSignal, messageFrequency, messageAmplitude);
-      break;
+      return amModulation(messageFrequency);
     case 'FM':
-      transmittedSignal = generateFM(inputSignal, messageFrequency, messageAmplitude);
-      break;
+      return fmModulation(messageFrequency);
     case 'PM':
-      transmittedSignal = generatePM(inputSignal, messageFrequency, messageAmplitude);
-      break;
+      return pmModulation(messageFrequency);
+    case 'DSB-SC':
+      return dsbScModulation(messageFrequency);
+    case 'SSB-USB':
+    case 'SSB-LSB':
+    case 'VSB':
+      throw new Error(`${algorithm} needs the analytic message; use SidebandModulator`);
   }
+}
 
-  return {
-    input: inputSignal,
-    transmitted: transmittedSignal,
-    output: inputSignal,
+function amModulation(messageFrequency: number): CarrierModulation {
+  const carrierFrequency = messageFrequency * carrierRatio;
+  const carrierAmplitude = 1;
+  const modulationIndex = amModulationIndex;
+
+  return (messageSignal, t) => {
+    const carrier = Math.sin(2 * Math.PI * carrierFrequency * t);
+    return carrierAmplitude * (1 + modulationIndex * messageSignal) * carrier;
   };
 }
 
-function generateAM(
-  inputSignal: DataPoint[],
-  messageFrequency: number,
-  messageAmplitude: number
-): DataPoint[] {
-  const carrierFrequency = messageFrequency * 5;
+function fmModulation(messageFrequency: number): CarrierModulation {
+  const carrierFrequency = messageFrequency * carrierRatio;
   const carrierAmplitude = 1;
-  const modulationIndex = 0.8;
+  const frequencyDeviation = carrierFrequency * fmDeviationRatio;
 
-  return inputSignal.map(point => {
-    const messageSignal = point.y / messageAmplitude;
-    const carrier = Math.sin(2 * Math.PI * carrierFrequency * point.x);
-    const modulatedSignal = carrierAmplitude * (1 + modulationIndex * messageSignal) * carrier;
-    return { x: point.x, y: modulatedSignal };
-  });
+  return (messageSignal, t) => {
+    const instantaneousPhase =
+      2 * Math.PI * carrierFrequency * t +
+      (2 * Math.PI * frequencyDeviation * messageSignal * t) / messageFrequency;
+    return carrierAmplitude * Math.sin(instantaneousPhase);
+  };
 }
 
-function generateFM(
-  inputSignal: DataPoint[],
-  messageFrequency: number,
-  messageAmplitude: number
-): DataPoint[] {
-  const carrierFrequency = messageFrequency * 5;
+function pmModulation(messageFrequency: number): CarrierModulation {
+  const carrierFrequency = messageFrequency * carrierRatio;
   const carrierAmplitude = 1;
-  const frequencyDeviation = carrierFrequency * 0.5;
+  const phaseDeviation = pmPhaseDeviation;
 
-  return inputSignal.map(point => {
-    const messageSignal = point.y / messageAmplitude;
+  return (messageSignal, t) => {
     const instantaneousPhase =
-      2 * Math.PI * carrierFrequency * point.x +
-      (2 * Math.PI * frequencyDeviation * messageSignal * point.x) / messageFrequency;
-    const modulatedSignal = carrierAmplitude * Math.sin(instantaneousPhase);
-    return { x: point.x, y: modulatedSignal };
-  });
+      2 * Math.PI * carrierFrequency * t + phaseDeviation * messageSignal;
+    return carrierAmplitude * Math.sin(instantaneousPhase);
+  };
+}
+
+function dsbScModulation(messageFrequency: number): CarrierModulation {
+  const carrierFrequency = messageFrequency * carrierRatio;
+
+  return (messageSignal, t) => messageSignal * Math.sin(2 * Math.PI * carrierFrequency * t);
+}
+
+/** Modulates a carrier at five times the message frequency with the incoming message samples. */
+export class AnalogModulator implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly modulate: CarrierModulation;
+  private readonly messageAmplitude: number;
+  private readonly sampleRate: number;
+  private sampleIndex = 0;
+
+  constructor(algorithm: AnalogToAnalogAlgorithm, messageFrequency: number, messageAmplitude: number, sampleRate: number) {
+    this.name = `${algorithm} modulator`;
+    this.modulate = createCarrierModulation(algorithm, messageFrequency);
+    this.messageAmplitude = messageAmplitude;
+    this.sampleRate = sampleRate;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let i = 0; i < count; i++) {
+      const t = this.sampleIndex++ / this.sampleRate;
+      const messageSignal = input.data[input.offset + i] / this.messageAmplitude;
+      output.data[output.length + i] = this.modulate(messageSignal, t);
+    }
+    // Every carrier modulation takes one sine per sample
+    if (__SIGNAL_COUNTERS__) {
+      hotCounters.samplesEmitted += count;
+      hotCounters.transcendentals += count;
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+/**
+ * Phasing-method sideband modulator. Takes the analytic message (I = m, Q = its
+ * Hilbert transform, vestige-shaped for VSB) and emits the complex envelope of
+ * m·sin(2π fc t) ± m̂·cos(2π fc t), i.e. I = ±m̂ and Q = −m; the upper sideband and
+ * VSB take +, the lower sideband −.
+ */
+export class SidebandModulator implements Stage {
+  readonly name: string;
+  readonly inputs = ['complex'] as const;
+  readonly outputs = ['complex'] as const;
+  private readonly sign: number;
+  private readonly messageAmplitude: number;
+
+  constructor(algorithm: AnalogToAnalogAlgorithm, messageAmplitude: number) {
+    if (!isPhasingModulation(algorithm)) {
+      throw new Error(`${algorithm} is not a sideband modulation`);
+    }
+    this.name = `${algorithm} sideband modulator`;
+    this.sign = algorithm === 'SSB-LSB' ? -1 : 1;
+    this.messageAmplitude = messageAmplitude;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    const scale = 1 / this.messageAmplitude;
+    for (let k = 0; k < count; k++) {
+      output.data[output.length + k] = this.sign * scale * input.imag![input.offset + k];
+      output.imag![output.length + k] = -scale * input.data[input.offset + k];
+    }
+    if (__SIGNAL_COUNTERS__) hotCounters.samplesEmitted += count;
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
 }
 
-function generatePM(
-  inputSignal: DataPoint[],
+// ---------------------------------------------------------------------------
+// Complex baseband
+// ---------------------------------------------------------------------------
+
+/**
+ * Envelope sample rate for the baseband path: four times the highest envelope frequency
+ * (the message for AM and the suppressed-carrier modes, Carson's rule for PM, the peak
+ * instantaneous offset for FM).
+ * FM's growing phase term can make this exceed the passband rate, in which case the
+ * baseband path costs more rather than aliasing.
+ */
+export function basebandRate(algorithm: AnalogToAnalogAlgorithm, messageFrequency: number): number {
+  let bandwidth: number;
+  switch (algorithm) {
+    case 'AM':
+    case 'DSB-SC':
+    case 'SSB-USB':
+    case 'SSB-LSB':
+    case 'VSB':
+      bandwidth = messageFrequency;
+      break;
+    case 'PM':
+      bandwidth = (pmPhaseDeviation + 1) * messageFrequency;
+      break;
+    case 'FM': {
+      // The phase term f_d·m(t)·t/f_m sweeps faster as t grows
+      const deviation = messageFrequency * carrierRatio * fmDeviationRatio;
+      bandwidth = (deviation / messageFrequency) * (1 + 2 * Math.PI * messageFrequency * duration);
+      break;
+    }
+  }
+  return Math.ceil(4 * bandwidth);
+}
+
+/**
+ * Simulates the carrier modulation on its complex envelope, demodulates it, and
+ * interpolates/upconverts to the 200 Hz display grid only inside `window`.
+ */
+export function generateAnalogToAnalogBaseband(
   messageFrequency: number,
-  messageAmplitude: number
-): DataPoint[] {
-  const carrierFrequency = messageFrequency * 5;
-  const carrierAmplitude = 1;
-  const phaseDeviation = Math.PI / 2;
+  messageAmplitude: number,
+  algorithm: AnalogToAnalogAlgorithm,
+  window: VisibleWindow = { start: 0, end: duration - 1 / samplesPerSecond }
+): BasebandSignalData {
+  const rate = basebandRate(algorithm, messageFrequency);
+  const { pipeline, message, envelope, output } = buildAnalogToAnalogBasebandGraph(
+    messageFrequency,
+    messageAmplitude,
+    algorithm,
+    rate
+  );
+  pipeline.run();
 
-  return inputSignal.map(point => {
-    const messageSignal = point.y / messageAmplitude;
-    const instantaneousPhase =
-      2 * Math.PI * carrierFrequency * point.x + phaseDeviation * messageSignal;
-    const modulatedSignal = carrierAmplitude * Math.sin(instantaneousPhase);
-    return { x: point.x, y: modulatedSignal };
-  });
+  return {
+    input: interpolateForDisplay(message.values, rate, samplesPerSecond, window),
+    transmitted: upconvert(
+      envelope.values,
+      envelope.imagValues,
+      rate,
+      messageFrequency * carrierRatio,
+      samplesPerSecond,
+      window
+    ),
+    output: interpolateForDisplay(output.values, rate, samplesPerSecond, window),
+    basebandSamples: envelope.values.length,
+    passbandSamples: duration * samplesPerSecond,
+  };
+}
+
+/**
+ * Baseband preset: message tone → I/Q modulator → coherent demodulator. SSB and VSB
+ * pass the message through a Hilbert transformer and the sideband modulator instead.
+ */
+export function buildAnalogToAnalogBasebandGraph(
+  messageFrequency: number,
+  messageAmplitude: number,
+  algorithm: AnalogToAnalogAlgorithm,
+  rate: number,
+  options?: PipelineOptions
+): { pipeline: Pipeline; message: CollectSink; envelope: CollectSink; output: CollectSink } {
+  const message = new CollectSink('real');
+  const envelope = new CollectSink('complex');
+  const output = new CollectSink('real');
+
+  const pipeline = new Pipeline(options)
+    // One sample past the end so interpolation reaches the last display instant
+    .add('source', new ToneSource(messageFrequency, messageAmplitude, rate, Math.ceil(duration * rate) + 1))
+    .add('message', message)
+    .add('envelope', envelope)
+    .add('demodulator', new BasebandCarrierDemodulator(algorithm, messageFrequency, messageAmplitude, rate))
+    .add('output', output)
+    .connect('source', 'message');
+
+  if (isPhasingModulation(algorithm)) {
+    // When the display interval spans whole message periods, the extra final sample repeats the first
+    const repeats = wholeCycles(messageFrequency * duration) && wholeCycles(duration * rate);
+    const response = quadratureResponse(algorithm, messageFrequency, rate);
+    pipeline
+      .add('hilbert', spectralFilter(response, repeats ? Math.round(duration * rate) : null, messageFrequency, rate, true))
+      .add('modulator', new SidebandModulator(algorithm, messageAmplitude))
+      .connect('source', 'hilbert')
+      .connect('hilbert', 'modulator');
+  } else {
+    pipeline
+      .add('modulator', new BasebandCarrierModulator(algorithm, messageFrequency, messageAmplitude, rate))
+      .connect('source', 'modulator');
+  }
+  pipeline
+    .connect('modulator', 'envelope')
+    .connect('modulator', 'demodulator')
+    .connect('demodulator', 'output');
+
+  return { pipeline, message, envelope, output };
+}
+
+/**
+ * Complex envelope of the AM/FM/PM/DSB-SC carriers above. Each is `A(t)·sin(2π fc t + θ(t))`,
+ * so the envelope is A·(sin θ, −cos θ).
+ */
+export class BasebandCarrierModulator implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['complex'] as const;
+  private readonly algorithm: AnalogToAnalogAlgorithm;
+  private readonly messageFrequency: number;
+  private readonly messageAmplitude: number;
+  private readonly sampleRate: number;
+  private readonly envelope = { i: 0, q: 0 };
+  private sampleIndex = 0;
+
+  constructor(algorithm: AnalogToAnalogAlgorithm, messageFrequency: number, messageAmplitude: number, sampleRate: number) {
+    if (isPhasingModulation(algorithm)) {
+      throw new Error(`${algorithm} needs the analytic message; use SidebandModulator`);
+    }
+    this.name = `${algorithm} baseband modulator`;
+    this.algorithm = algorithm;
+    this.messageFrequency = messageFrequency;
+    this.messageAmplitude = messageAmplitude;
+    this.sampleRate = sampleRate;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    const deviation = this.messageFrequency * carrierRatio * fmDeviationRatio;
+
+    for (let k = 0; k < count; k++) {
+      const t = this.sampleIndex++ / this.sampleRate;
+      const m = input.data[input.offset + k] / this.messageAmplitude;
+      switch (this.algorithm) {
+        case 'AM':
+          sinePhasor(0, this.envelope);
+          this.envelope.q *= 1 + amModulationIndex * m;
+          break;
+        case 'FM':
+          sinePhasor((2 * Math.PI * deviation * m * t) / this.messageFrequency, this.envelope);
+          break;
+        case 'PM':
+          sinePhasor(pmPhaseDeviation * m, this.envelope);
+          break;
+        case 'DSB-SC':
+          sinePhasor(0, this.envelope);
+          this.envelope.q *= m;
+          break;
+      }
+      output.data[output.length + k] = this.envelope.i;
+      output.imag![output.length + k] = this.envelope.q;
+    }
+    if (__SIGNAL_COUNTERS__) hotCounters.samplesEmitted += count;
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+/**
+ * Coherent receivers on the envelope: AM by envelope magnitude, PM by phase, and FM by
+ * unwrapped phase divided by the modulator's time-growing phase gain (reported as 0 at
+ * t = 0, where the phase carries no information). The suppressed-carrier modes carry
+ * the message in the component in phase with the sine carrier, −Q.
+ */
+export class BasebandCarrierDemodulator implements Stage {
+  readonly name: string;
+  readonly inputs = ['complex'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly algorithm: AnalogToAnalogAlgorithm;
+  private readonly messageFrequency: number;
+  private readonly messageAmplitude: number;
+  private readonly sampleRate: number;
+  private sampleIndex = 0;
+  private previousPhase = 0;
+  private unwrappedPhase = 0;
+
+  constructor(algorithm: AnalogToAnalogAlgorithm, messageFrequency: number, messageAmplitude: number, sampleRate: number) {
+    this.name = `${algorithm} baseband demodulator`;
+    this.algorithm = algorithm;
+    this.messageFrequency = messageFrequency;
+    this.messageAmplitude = messageAmplitude;
+    this.sampleRate = sampleRate;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    const deviation = this.messageFrequency * carrierRatio * fmDeviationRatio;
+
+    for (let k = 0; k < count; k++) {
+      const i = input.data[input.offset + k];
+      const q = input.imag![input.offset + k];
+      const t = this.sampleIndex++ / this.sampleRate;
+      let m: number;
+      switch (this.algorithm) {
+        case 'AM':
+          m = (Math.hypot(i, q) - 1) / amModulationIndex;
+          break;
+        case 'PM':
+          m = Math.atan2(i, -q) / pmPhaseDeviation;
+          break;
+        case 'FM': {
+          const phase = Math.atan2(i, -q);
+          let step = phase - this.previousPhase;
+          step -= 2 * Math.PI * Math.round(step / (2 * Math.PI));
+          this.unwrappedPhase += step;
+          this.previousPhase = phase;
+          m = t > 0 ? (this.unwrappedPhase * this.messageFrequency) / (2 * Math.PI * deviation * t) : 0;
+          break;
+        }
+        case 'DSB-SC':
+        case 'SSB-USB':
+        case 'SSB-LSB':
+        case 'VSB':
+          m = -q;
+          break;
+      }
+      output.data[output.length + k] = m * this.messageAmplitude;
+    }
+    if (__SIGNAL_COUNTERS__ && (this.algorithm === 'PM' || this.algorithm === 'FM')) hotCounters.transcendentals += count;
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
 }
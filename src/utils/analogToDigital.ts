@@ -1,33 +1,17 @@
 import { DataPoint, AnalogToDigitalConfig, PCMConfig, DeltaModulationConfig } from '../types';
+import { InputPort, OutputPort, Pipeline, PipelineOptions, Stage } from './pipeline';
+import {
+  AntiAliasFilterStage,
+  ArraySource,
+  PointSink,
+  ReconstructionStage,
+  Resampler,
+  StaircaseSink,
+  ToneSource,
+} from './stages';
 
-// Helper function to get input value at exact time (with linear interpolation)
-function getInputValueAtTime(inputSignal: DataPoint[], time: number): number {
-  if (inputSignal.length === 0) return 0;
-  
-  // Find the two points surrounding the target time
-  for (let i = 0; i < inputSignal.length - 1; i++) {
-    if (inputSignal[i].x <= time && inputSignal[i + 1].x >= time) {
-      // Linear interpolation
-      const t1 = inputSignal[i].x;
-      const t2 = inputSignal[i + 1].x;
-      const y1 = inputSignal[i].y;
-      const y2 = inputSignal[i + 1].y;
-      
-      if (t2 === t1) return y1;
-      
-      const ratio = (time - t1) / (t2 - t1);
-      return y1 + ratio * (y2 - y1);
-    }
-  }
-  
-  // If time is at or beyond the end, return last value
-  if (time >= inputSignal[inputSignal.length - 1].x) {
-    return inputSignal[inputSignal.length - 1].y;
-  }
-  
-  // If time is before the start, return first value
-  return inputSignal[0].y;
-}
+const duration = 2;
+const samplesPerSecond = 100;
 
 export function generateAnalogToDigitalSignal(
   frequency: number,
@@ -35,135 +19,266 @@ export function generateAnalogToDigitalSignal(
   config: AnalogToDigitalConfig,
   inputSignal?: DataPoint[]
 ): { input: DataPoint[]; transmitted: DataPoint[]; output: DataPoint[] } {
-  const duration = 2;
-  const samplesPerSecond = 100;
-  const totalSamples = duration * samplesPerSecond;
+  const { pipeline, input, transmitted, output } = buildAnalogToDigitalGraph(frequency, amplitude, config, inputSignal);
+  pipeline.run();
+
+  return {
+    input: inputSignal || input.points,
+    transmitted: transmitted.points,
+    output: output.points,
+  };
+}
 
+/**
+ * Preset graph for sampling: message → sampler → PCM quantiser or delta modulator,
+ * with the receiver's reconstruction as the output.
+ *
+ * A provided `inputSignal` must be uniformly sampled; its spacing sets the display rate.
+ */
+export function buildAnalogToDigitalGraph(
+  frequency: number,
+  amplitude: number,
+  config: AnalogToDigitalConfig,
+  inputSignal?: DataPoint[],
+  options?: PipelineOptions
+): { pipeline: Pipeline; input: PointSink; transmitted: PointSink; output: PointSink | StaircaseSink } {
   // Use provided input signal or generate default sine wave
-  const input = inputSignal || (() => {
-    const signal: DataPoint[] = [];
-    for (let i = 0; i < totalSamples; i++) {
-      const t = i / samplesPerSecond;
-      const y = amplitude * Math.sin(2 * Math.PI * frequency * t);
-      signal.push({ x: t, y });
-    }
-    return signal;
-  })();
+  const displayRate = inputSignal && inputSignal.length > 1
+    ? 1 / (inputSignal[1].x - inputSignal[0].x)
+    : samplesPerSecond;
+  const source = inputSignal
+    ? new ArraySource(inputSignal.map(point => point.y))
+    : new ToneSource(frequency, amplitude, samplesPerSecond, duration * samplesPerSecond);
+  const sampleCount = inputSignal ? inputSignal.length : duration * samplesPerSecond;
+  const endTime = inputSignal
+    ? (inputSignal.length > 0 ? inputSignal[inputSignal.length - 1].x : 2)
+    : (sampleCount - 1) / samplesPerSecond;
 
-  let transmittedSignal: DataPoint[] = [];
-  let outputSignal: DataPoint[] = [];
+  const input = new PointSink('real', displayRate);
+  const pipeline = new Pipeline(options)
+    .add('source', source)
+    .add('input', input)
+    .connect('source', 'input');
 
   switch (config.algorithm) {
-    case 'PCM':
+    case 'PCM': {
       if (!config.pcm) {
         throw new Error('PCM configuration required');
       }
-      ({ transmitted: transmittedSignal, output: outputSignal } = generatePCM(
-        input,
-        amplitude,
-        config.pcm
-      ));
-      break;
-    case 'Delta Modulation':
+      const { transmitted, output } = addPCM(pipeline, amplitude, config.pcm, displayRate, endTime);
+      return { pipeline, input, transmitted, output };
+    }
+    case 'Delta Modulation': {
       if (!config.deltaModulation) {
         throw new Error('Delta Modulation configuration required');
       }
-      ({ transmitted: transmittedSignal, output: outputSignal } = generateDeltaModulation(
-        input,
-        amplitude,
-        config.deltaModulation
-      ));
-      break;
+      const { transmitted, output } = addDeltaModulation(pipeline, amplitude, config.deltaModulation, displayRate, endTime);
+      return { pipeline, input, transmitted, output };
+    }
   }
-
-  return {
-    input,
-    transmitted: transmittedSignal,
-    output: outputSignal,
-  };
 }
 
-function generatePCM(
-  inputSignal: DataPoint[],
+function addPCM(
+  pipeline: Pipeline,
   amplitude: number,
-  config: PCMConfig
-): { transmitted: DataPoint[]; output: DataPoint[] } {
-  const transmitted: DataPoint[] = [];
-  const output: DataPoint[] = [];
-
-  const sampleInterval = 1 / config.samplingRate;
-  const duration = inputSignal.length > 0 ? inputSignal[inputSignal.length - 1].x : 2;
-  
-  for (let i = 0; i * sampleInterval <= duration; i++) {
-    const sampleTime = Math.round(i * sampleInterval * 1000000) / 1000000;
-    
-    // Interpolate or find the closest input value at this exact sample time
-    const inputValue = getInputValueAtTime(inputSignal, sampleTime);
-    
-    const normalizedValue = (inputValue / amplitude + 1) / 2;
-    const quantized = Math.round(normalizedValue * (config.quantizationLevels - 1));
-    const reconstructedValue = (quantized / (config.quantizationLevels - 1)) * 2 - 1;
-    const finalValue = reconstructedValue * amplitude;
-
-    transmitted.push({ x: sampleTime, y: quantized });
-    output.push({ x: sampleTime, y: finalValue });
+  config: PCMConfig,
+  displayRate: number,
+  endTime: number
+): { transmitted: PointSink; output: PointSink } {
+  const transmitted = new PointSink('symbols', config.samplingRate, true);
+  const output = config.reconstruction
+    ? new PointSink('real', displayRate)
+    : new PointSink('real', config.samplingRate, true);
+
+  pipeline
+    .add('sampler', new Resampler(displayRate, config.samplingRate))
+    .add('quantizer', new PcmQuantizer(amplitude, config.quantizationLevels))
+    .add('decoder', new PcmDecoder(amplitude, config.quantizationLevels))
+    .add('transmitted', transmitted)
+    .add('output', output)
+    .connect('quantizer', 'transmitted')
+    .connect('sampler', 'quantizer')
+    .connect('quantizer', 'decoder');
+
+  // Low-pass the input at the sampler's Nyquist frequency so out-of-band content
+  // is removed instead of folding back as an alias
+  if (config.antiAlias) {
+    pipeline
+      .add('antiAlias', new AntiAliasFilterStage(config.samplingRate / 2 / displayRate))
+      .connect('source', 'antiAlias')
+      .connect('antiAlias', 'sampler');
+  } else {
+    pipeline.connect('source', 'sampler');
+  }
+
+  if (config.reconstruction) {
+    pipeline
+      .add('reconstruction', new ReconstructionStage(config.reconstruction, config.samplingRate, displayRate, endTime))
+      .connect('decoder', 'reconstruction')
+      .connect('reconstruction', 'output');
+  } else {
+    pipeline.connect('decoder', 'output');
   }
 
   return { transmitted, output };
 }
 
-function generateDeltaModulation(
-  inputSignal: DataPoint[],
+function addDeltaModulation(
+  pipeline: Pipeline,
   amplitude: number,
-  config: DeltaModulationConfig
-): { transmitted: DataPoint[]; output: DataPoint[] } {
-  const delta = amplitude * config.deltaStepSize;
-  const transmitted: DataPoint[] = [];
-  const output: DataPoint[] = [];
-
-  const sampleInterval = 1 / config.samplingRate;
-  const duration = inputSignal.length > 0 ? inputSignal[inputSignal.length - 1].x : 2;
-  let approximation = 0;
-
-  // Add initial point at t=0
-  output.push({ x: 0, y: approximation });
-
-  for (let i = 0; i * sampleInterval <= duration; i++) {
-    const sampleTime = Math.round(i * sampleInterval * 1000000) / 1000000;
-    
-    // Get input value at exact sample time
-    const inputValue = getInputValueAtTime(inputSignal, sampleTime);
-    
-    // Compare input with current approximation to determine bit
-    const bit = inputValue > approximation ? 1 : 0;
-    
-    // Transmit the bit at the exact sample time
-    transmitted.push({ x: sampleTime, y: bit });
-    
-    // Update approximation based on transmitted bit (receiver side)
-    approximation += bit === 1 ? delta : -delta;
-    
+  config: DeltaModulationConfig,
+  displayRate: number,
+  endTime: number
+): { transmitted: PointSink; output: StaircaseSink } {
+  const transmitted = new PointSink('bits', config.samplingRate, true);
+  const output = new StaircaseSink(config.samplingRate, endTime);
+
+  pipeline
+    .add('sampler', new Resampler(displayRate, config.samplingRate))
+    .add('encoder', new DeltaEncoder(amplitude, config.deltaStepSize))
+    .add('decoder', new DeltaDecoder(amplitude, config.deltaStepSize))
+    .add('transmitted', transmitted)
+    .add('output', output)
+    .connect('source', 'sampler')
+    .connect('sampler', 'encoder')
+    .connect('encoder', 'transmitted')
+    .connect('encoder', 'decoder')
+    .connect('decoder', 'output');
+
+  return { transmitted, output };
+}
+
+/** Index (0 to levels − 1) of the uniform level nearest to a sample in [-amplitude, amplitude]. */
+export function quantizeSample(value: number, amplitude: number, levels: number): number {
+  const normalizedValue = (value / amplitude + 1) / 2;
+  return Math.round(normalizedValue * (levels - 1));
+}
+
+/** Sample value of quantisation level `level`. */
+export function levelValue(level: number, amplitude: number, levels: number): number {
+  const reconstructedValue = (level / (levels - 1)) * 2 - 1;
+  return reconstructedValue * amplitude;
+}
+
+/** Maps each sample in [-amplitude, amplitude] to one of `levels` uniform levels. */
+export class PcmQuantizer implements Stage {
+  readonly name = 'PCM quantizer';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['symbols'] as const;
+  private readonly amplitude: number;
+  private readonly levels: number;
+
+  constructor(amplitude: number, levels: number) {
+    this.amplitude = amplitude;
+    this.levels = levels;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let i = 0; i < count; i++) {
+      output.data[output.length + i] = quantizeSample(input.data[input.offset + i], this.amplitude, this.levels);
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+/** Maps quantisation levels back to sample values. */
+export class PcmDecoder implements Stage {
+  readonly name = 'PCM decoder';
+  readonly inputs = ['symbols'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly amplitude: number;
+  private readonly levels: number;
+
+  constructor(amplitude: number, levels: number) {
+    this.amplitude = amplitude;
+    this.levels = levels;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let i = 0; i < count; i++) {
+      output.data[output.length + i] = levelValue(input.data[input.offset + i], this.amplitude, this.levels);
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+// Delta modulation tracks the input with a staircase approximation that moves by
+// ±delta per sample. Encoder and decoder run the same integrator.
+export class DeltaIntegrator {
+  approximation = 0;
+  private readonly delta: number;
+  private readonly limit: number;
+
+  constructor(amplitude: number, deltaStepSize: number) {
+    this.delta = amplitude * deltaStepSize;
+    this.limit = amplitude * 1.5;
+  }
+
+  step(bit: number): number {
+    this.approximation += bit === 1 ? this.delta : -this.delta;
     // Clamp approximation to prevent excessive drift
-    approximation = Math.max(-amplitude * 1.5, Math.min(amplitude * 1.5, approximation));
-    
-    // Add step transition: hold previous value until step time, then step to new value
-    // This creates the staircase effect
-    if (output.length > 0) {
-      const prevY = output[output.length - 1].y;
-      // Add point just before the step to hold previous value
-      output.push({ x: sampleTime - 0.001, y: prevY });
+    this.approximation = Math.max(-this.limit, Math.min(this.limit, this.approximation));
+    return this.approximation;
+  }
+}
+
+/** Emits 1 when the input is above the running approximation, 0 otherwise. */
+export class DeltaEncoder implements Stage {
+  readonly name = 'delta modulator';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly integrator: DeltaIntegrator;
+
+  constructor(amplitude: number, deltaStepSize: number) {
+    this.integrator = new DeltaIntegrator(amplitude, deltaStepSize);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let i = 0; i < count; i++) {
+      // Compare input with current approximation to determine bit
+      const bit = input.data[input.offset + i] > this.integrator.approximation ? 1 : 0;
+      output.data[output.length + i] = bit;
+      this.integrator.step(bit);
     }
-    
-    // Add reconstructed output point at the new level at exact sample time
-    output.push({ x: sampleTime, y: approximation });
+    input.offset += count;
+    output.length += count;
+    return input.ended;
   }
+}
+
+/** Receiver side of delta modulation: integrates the bit stream back into levels. */
+export class DeltaDecoder implements Stage {
+  readonly name = 'delta demodulator';
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly integrator: DeltaIntegrator;
 
-  // Extend the last value to the end of the signal
-  if (output.length > 0 && inputSignal.length > 0) {
-    const lastY = output[output.length - 1].y;
-    const lastX = inputSignal[inputSignal.length - 1].x;
-    output.push({ x: lastX, y: lastY });
+  constructor(amplitude: number, deltaStepSize: number) {
+    this.integrator = new DeltaIntegrator(amplitude, deltaStepSize);
   }
 
-  return { transmitted, output };
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let i = 0; i < count; i++) {
+      output.data[output.length + i] = this.integrator.step(input.data[input.offset + i]);
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
 }
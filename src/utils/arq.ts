@@ -0,0 +1,333 @@
+import { ArqProtocol } from '../types';
+import { hotCounters } from './counters';
+import { Random } from './random';
+
+/**
+ * Discrete-event simulation of the sliding-window ARQ protocols on a full-duplex link.
+ * The sender hands the link one frame at a time at `bitRate`, retransmissions before
+ * new frames; each frame is lost with probability
+ * `frameErrorRate` and each acknowledgement with `ackErrorRate`. Stop-and-Wait is the
+ * one-frame window. Go-Back-N acknowledges cumulatively and resends the whole window
+ * when its oldest frame times out; Selective Repeat acknowledges and resends frame by
+ * frame. Sequence numbers are not wrapped, so any window size is allowed. A link that
+ * loses every frame or every ACK never finishes, so it returns at once with nothing
+ * delivered, and `maxTransmissions` stops any other run that would outlast its budget.
+ */
+export interface ArqConfig {
+  protocol: ArqProtocol;
+  windowSize: number;
+  frames: number;
+  frameBits: number;
+  ackBits: number;
+  /** Link rate in bit/s */
+  bitRate: number;
+  /** One-way propagation delay in seconds */
+  propagationDelay: number;
+  frameErrorRate: number;
+  ackErrorRate: number;
+  /** Retransmission timer from the start of a frame; defaults to the round trip plus one frame time */
+  timeout?: number;
+  /** Stops the run after this many frames have been put on the link; unlimited by default */
+  maxTransmissions?: number;
+  seed?: number;
+}
+
+export interface ArqResult {
+  protocol: ArqProtocol;
+  windowSize: number;
+  frames: number;
+  /** Frames acknowledged in order; less than `frames` when the run was stopped */
+  delivered: number;
+  /** Whether every frame was acknowledged */
+  completed: boolean;
+  /** Frames put on the link, first sends and retransmissions */
+  transmissions: number;
+  /** Simulated time until the last acknowledgement, in seconds */
+  elapsed: number;
+  /** Transmission time of the delivered frames over the elapsed time */
+  efficiency: number;
+  /** Delivered payload in bit/s */
+  throughput: number;
+  events: number;
+  wallMs: number;
+}
+
+// ---------------------------------------------------------------------------
+// Event queue
+// ---------------------------------------------------------------------------
+
+/**
+ * Binary min-heap of timed events in parallel typed arrays, so a run of millions of
+ * events allocates only when the heap grows. `pop` loads the earliest event into the
+ * public fields; `value` and `token` are 32-bit integers so protocol code indexes its
+ * rings with integer arithmetic. Events at equal times leave in an unspecified but
+ * repeatable order.
+ */
+export class EventQueue {
+  time = 0;
+  kind = 0;
+  value = 0;
+  token = 0;
+  private times = new Float64Array(64);
+  private kinds = new Uint8Array(64);
+  private values = new Int32Array(64);
+  private tokens = new Int32Array(64);
+  private count = 0;
+
+  get size(): number {
+    return this.count;
+  }
+
+  push(time: number, kind: number, value: number, token = 0): void {
+    if (this.count === this.times.length) this.grow();
+    const times = this.times;
+    let index = this.count++;
+    // Sift the hole up, moving later parents down into it
+    while (index > 0) {
+      const parent = (index - 1) >> 1;
+      if (times[parent] <= time) break;
+      this.move(parent, index);
+      index = parent;
+    }
+    this.set(index, time, kind, value, token);
+  }
+
+  pop(): boolean {
+    if (this.count === 0) return false;
+    const times = this.times;
+    this.time = times[0];
+    this.kind = this.kinds[0];
+    this.value = this.values[0];
+    this.token = this.tokens[0];
+
+    const last = --this.count;
+    if (last === 0) return true;
+    const time = times[last];
+    const kind = this.kinds[last];
+    const value = this.values[last];
+    const token = this.tokens[last];
+    let index = 0;
+    for (;;) {
+      let child = 2 * index + 1;
+      if (child >= last) break;
+      if (child + 1 < last && times[child + 1] < times[child]) child++;
+      if (time <= times[child]) break;
+      this.move(child, index);
+      index = child;
+    }
+    this.set(index, time, kind, value, token);
+    return true;
+  }
+
+  private move(from: number, to: number): void {
+    this.times[to] = this.times[from];
+    this.kinds[to] = this.kinds[from];
+    this.values[to] = this.values[from];
+    this.tokens[to] = this.tokens[from];
+  }
+
+  private set(index: number, time: number, kind: number, value: number, token: number): void {
+    this.times[index] = time;
+    this.kinds[index] = kind;
+    this.values[index] = value;
+    this.tokens[index] = token;
+  }
+
+  private grow(): void {
+    if (__SIGNAL_COUNTERS__) hotCounters.bufferGrowths++;
+    const size = this.times.length * 2;
+    const times = new Float64Array(size);
+    const kinds = new Uint8Array(size);
+    const values = new Int32Array(size);
+    const tokens = new Int32Array(size);
+    times.set(this.times);
+    kinds.set(this.kinds);
+    values.set(this.values);
+    tokens.set(this.tokens);
+    this.times = times;
+    this.kinds = kinds;
+    this.values = values;
+    this.tokens = tokens;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Protocols
+// ---------------------------------------------------------------------------
+
+const FRAME_ARRIVAL = 0;
+const ACK_ARRIVAL = 1;
+const TIMEOUT = 2;
+const LINK_READY = 3;
+
+export function simulateArq(config: ArqConfig): ArqResult {
+  const { protocol, frames, frameBits, ackBits, bitRate, propagationDelay } = config;
+  const window = protocol === 'Stop-and-Wait' ? 1 : Math.max(1, Math.floor(config.windowSize));
+  const selective = protocol === 'Selective Repeat';
+  const frameTime = frameBits / bitRate;
+  const ackTime = ackBits / bitRate;
+  const timeout = config.timeout ?? 2 * frameTime + 2 * propagationDelay + ackTime;
+  const maxTransmissions = config.maxTransmissions ?? Infinity;
+
+  if (config.frameErrorRate >= 1 || config.ackErrorRate >= 1) {
+    return {
+      protocol, windowSize: window, frames, delivered: 0, completed: false,
+      transmissions: 0, elapsed: 0, efficiency: 0, throughput: 0, events: 0, wallMs: 0,
+    };
+  }
+
+  const random = new Random(config.seed);
+  const queue = new EventQueue();
+
+  // Sender: frames [base, next) are outstanding; rings are indexed by seq % window
+  let base = 0;
+  let next = 0;
+  let linkBusy = false;
+  let transmissions = 0;
+  let tokenCounter = 0;
+  const acked = new Uint8Array(window);
+  const timerTokens = new Int32Array(window);
+  // Selective Repeat: timed-out frames waiting for the link, oldest first
+  const resend = new Int32Array(window);
+  let resendHead = 0;
+  let resendCount = 0;
+  // Receiver: next in-order frame, plus frames buffered ahead of it (Selective Repeat)
+  let expected = 0;
+  const buffered = new Uint8Array(window);
+
+  const transmit = (seq: number, now: number) => {
+    linkBusy = true;
+    transmissions++;
+    queue.push(now + frameTime, LINK_READY, seq);
+    if (random.next() >= config.frameErrorRate) queue.push(now + frameTime + propagationDelay, FRAME_ARRIVAL, seq);
+    // A new token invalidates the timer of any earlier copy of this frame
+    timerTokens[seq % window] = ++tokenCounter;
+    queue.push(now + timeout, TIMEOUT, seq, tokenCounter);
+  };
+
+  // Hands the idle link its next frame: a pending retransmission first, then a new one
+  const pump = (now: number) => {
+    if (linkBusy) return;
+    while (resendCount > 0) {
+      const seq = resend[resendHead];
+      resendHead = (resendHead + 1) % window;
+      resendCount--;
+      if (seq >= base && acked[seq % window] === 0) {
+        transmit(seq, now);
+        return;
+      }
+    }
+    if (next < base) next = base;
+    if (next < frames && next < base + window) transmit(next++, now);
+  };
+
+  const acknowledge = (value: number, now: number) => {
+    if (random.next() >= config.ackErrorRate) queue.push(now + ackTime + propagationDelay, ACK_ARRIVAL, value);
+  };
+
+  let events = 0;
+  let finishedAt = 0;
+  const wallStart = performance.now();
+  pump(0);
+
+  while (base < frames && transmissions < maxTransmissions && queue.pop()) {
+    events++;
+    const now = queue.time;
+    const seq = queue.value;
+
+    switch (queue.kind) {
+      case LINK_READY:
+        linkBusy = false;
+        pump(now);
+        break;
+      case FRAME_ARRIVAL:
+        if (selective) {
+          if (seq >= expected && seq < expected + window) {
+            buffered[seq % window] = 1;
+            while (buffered[expected % window] === 1) {
+              buffered[expected % window] = 0;
+              expected++;
+            }
+          }
+          // Frames below the window are duplicates whose ACK was lost; ACK them again
+          acknowledge(seq, now);
+        } else {
+          if (seq === expected) expected++;
+          // Cumulative: the next frame wanted, also re-sent after duplicates and gaps
+          acknowledge(expected, now);
+        }
+        break;
+      case ACK_ARRIVAL:
+        if (selective) {
+          if (seq >= base && seq < next && acked[seq % window] === 0) {
+            acked[seq % window] = 1;
+            while (base < next && acked[base % window] === 1) {
+              acked[base % window] = 0;
+              base++;
+            }
+          }
+        } else if (seq > base) {
+          base = seq;
+        }
+        finishedAt = now;
+        pump(now);
+        break;
+      case TIMEOUT:
+        if (seq < base || seq >= next || queue.token !== timerTokens[seq % window]) break;
+        if (selective) {
+          if (acked[seq % window] === 0) {
+            resend[(resendHead + resendCount) % window] = seq;
+            resendCount++;
+          }
+        } else {
+          // The oldest outstanding frame timed out: resend it and everything after it
+          next = base;
+        }
+        pump(now);
+        break;
+    }
+  }
+
+  const elapsed = finishedAt;
+  return {
+    protocol,
+    windowSize: window,
+    frames,
+    delivered: base,
+    completed: base >= frames,
+    transmissions,
+    elapsed,
+    efficiency: elapsed > 0 ? (base * frameTime) / elapsed : 0,
+    throughput: elapsed > 0 ? (base * frameBits) / elapsed : 0,
+    events,
+    wallMs: performance.now() - wallStart,
+  };
+}
+
+/**
+ * Textbook link utilisation with a = propagation / frame time and frame error rate p,
+ * ignoring ACK time and ACK losses:
+ *   Stop-and-Wait  (1 − p) / (1 + 2a)
+ *   Go-Back-N      (1 − p) / (1 + 2ap)            when W ≥ 1 + 2a, else W(1 − p) / ((1 + 2a)(1 − p + Wp))
+ *   Selective Rep. 1 − p                           when W ≥ 1 + 2a, else W(1 − p) / (1 + 2a)
+ */
+export function theoreticalEfficiency(config: ArqConfig): number {
+  const a = config.propagationDelay / (config.frameBits / config.bitRate);
+  const p = config.frameErrorRate;
+  const w = config.protocol === 'Stop-and-Wait' ? 1 : config.windowSize;
+  const fullPipe = w >= 1 + 2 * a;
+  switch (config.protocol) {
+    case 'Stop-and-Wait':
+      return (1 - p) / (1 + 2 * a);
+    case 'Go-Back-N':
+      return fullPipe ? (1 - p) / (1 + 2 * a * p) : (w * (1 - p)) / ((1 + 2 * a) * (1 - p + w * p));
+    case 'Selective Repeat':
+      return fullPipe ? 1 - p : (w * (1 - p)) / (1 + 2 * a);
+  }
+}
+
+/** Probability that at least one of `frameBits` independent bits is in error. */
+export function frameErrorRate(bitErrorRate: number, frameBits: number): number {
+  if (bitErrorRate >= 1) return 1;
+  return -Math.expm1(frameBits * Math.log1p(-bitErrorRate));
+}
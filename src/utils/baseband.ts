@@ -0,0 +1,76 @@
+import { DataPoint } from '../types';
+import { bandlimitedValue } from './filters';
+import { hotCounters } from './counters';
+
+/**
+ * Complex-baseband (I/Q) representation shared by the modulation modes.
+ * A passband signal s(t) is carried as its complex envelope I(t) + jQ(t) with
+ *   s(t) = I(t)·cos(2π fc t) − Q(t)·sin(2π fc t),
+ * so the simulation rate only has to cover the signal bandwidth, not the carrier.
+ * Complex pipeline ports hold I in `data` and Q in `imag`.
+ */
+export interface ComplexSample {
+  i: number;
+  q: number;
+}
+
+/** Time span of a chart, in seconds. */
+export interface VisibleWindow {
+  start: number;
+  end: number;
+}
+
+/** Envelope of `sin(2π fc t + phase)`: I = sin(phase), Q = −cos(phase). */
+export function sinePhasor(phase: number, out: ComplexSample): void {
+  out.i = Math.sin(phase);
+  out.q = -Math.cos(phase);
+  if (__SIGNAL_COUNTERS__) hotCounters.transcendentals += 2;
+}
+
+/** Band-limited resampling of a real sequence onto the display grid inside `window`. */
+export function interpolateForDisplay(
+  values: ArrayLike<number>,
+  sampleRate: number,
+  displayRate: number,
+  window: VisibleWindow
+): DataPoint[] {
+  const points: DataPoint[] = [];
+  const first = Math.ceil(window.start * displayRate - 1e-9);
+  const last = Math.floor(window.end * displayRate + 1e-9);
+  for (let k = first; k <= last; k++) {
+    const t = k / displayRate;
+    points.push({ x: t, y: bandlimitedValue(values, t * sampleRate) });
+  }
+  return points;
+}
+
+/**
+ * Upconverts a stored I/Q envelope to the passband waveform, but only on the display
+ * grid inside `window`. The envelope is interpolated band-limited (windowed sinc)
+ * before mixing, as a digital upconverter's interpolation filter would.
+ */
+export function upconvert(
+  i: ArrayLike<number>,
+  q: ArrayLike<number>,
+  envelopeRate: number,
+  carrierFrequency: number,
+  displayRate: number,
+  window: VisibleWindow
+): DataPoint[] {
+  const points: DataPoint[] = [];
+  const first = Math.ceil(window.start * displayRate - 1e-9);
+  const last = Math.floor(window.end * displayRate + 1e-9);
+  for (let k = first; k <= last; k++) {
+    const t = k / displayRate;
+    const position = t * envelopeRate;
+    const phase = 2 * Math.PI * carrierFrequency * t;
+    const y = bandlimitedValue(i, position) * Math.cos(phase) - bandlimitedValue(q, position) * Math.sin(phase);
+    points.push({ x: t, y });
+  }
+  if (__SIGNAL_COUNTERS__) {
+    const count = Math.max(0, last - first + 1);
+    hotCounters.samplesEmitted += count;
+    hotCounters.transcendentals += 2 * count;
+  }
+  return points;
+}
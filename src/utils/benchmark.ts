@@ -0,0 +1,411 @@
+import { SamplePrecision } from '../types';
+import { Pipeline, PipelineOptions } from './pipeline';
+import {
+  AntiAliasFilterStage,
+  AwgnChannel,
+  BitSource,
+  CollectSink,
+  FirStage,
+  ReconstructionStage,
+  Resampler,
+  SymbolMapper,
+  ToneSource,
+} from './stages';
+import { BpskDemodulator, Modulator } from './digitalToAnalog';
+import { AnalogModulator } from './analogToAnalog';
+import { PcmQuantizer } from './analogToDigital';
+import { designLowpass } from './filters';
+import {
+  FixedPointBpskDemodulator,
+  FixedPointFir,
+  FixedPointOscillator,
+  FixedPointQuantizer,
+  FixedPointStats,
+  QFormat,
+  createStats,
+} from './fixedPoint';
+import { buildPcmLinkGraph } from './presets';
+import { LdpcLinkResult, evaluateLdpcLink, ldpcCode } from './ldpc';
+import { Random } from './random';
+
+/** A graph that can be rebuilt for every run; `output` collects the stream being measured. */
+export interface BenchmarkCase {
+  name: string;
+  build(options: PipelineOptions): { pipeline: Pipeline; output: CollectSink };
+}
+
+export interface PrecisionResult {
+  precision: SamplePrecision;
+  /** Mean wall time of one run, in milliseconds */
+  meanMs: number;
+  /** Output samples per second of wall time */
+  samplesPerSecond: number;
+  /** Bytes occupied by the collected output */
+  outputBytes: number;
+  /** Largest deviation from the float64 run */
+  maxAbsError: number;
+  /** Signal-to-error ratio against the float64 run, in dB (Infinity when identical) */
+  snrDb: number;
+}
+
+export interface BenchmarkResult {
+  name: string;
+  samples: number;
+  results: PrecisionResult[];
+}
+
+export interface BenchmarkOptions {
+  /** Timed runs per case and precision, after one warm-up run */
+  repetitions?: number;
+  precisions?: SamplePrecision[];
+}
+
+const benchmarkBits = 4096;
+const samplesPerBit = 100;
+
+function randomBits(count: number, seed: number): Uint8Array {
+  const random = new Random(seed);
+  const bits = new Uint8Array(count);
+  for (let i = 0; i < count; i++) bits[i] = random.bit();
+  return bits;
+}
+
+function modulatorCase(algorithm: 'BFSK' | 'QAM'): BenchmarkCase {
+  const bits = randomBits(benchmarkBits, 1);
+  return {
+    name: `${algorithm} modulator`,
+    build: options => {
+      const modulator = new Modulator(algorithm, 1, samplesPerBit);
+      const output = new CollectSink('real');
+      const pipeline = new Pipeline(options)
+        .add('source', new BitSource(bits))
+        .add('modulator', modulator)
+        .add('output', output)
+        .connect('modulator', 'output');
+      if (modulator.bitsPerSymbol > 1) {
+        pipeline.add('mapper', new SymbolMapper(modulator.bitsPerSymbol)).connect('source', 'mapper').connect('mapper', 'modulator');
+      } else {
+        pipeline.connect('source', 'modulator');
+      }
+      return { pipeline, output };
+    },
+  };
+}
+
+/** Generator, channel and receiver workloads covering every kind of stage kernel. */
+export function defaultBenchmarkCases(): BenchmarkCase[] {
+  const toneRate = 100;
+  const toneSamples = 200_000;
+
+  return [
+    modulatorCase('BFSK'),
+    modulatorCase('QAM'),
+    {
+      name: 'FM carrier',
+      build: options => {
+        const output = new CollectSink('real');
+        const pipeline = Pipeline.fromSpec({
+          nodes: {
+            message: new ToneSource(2, 1, 200, toneSamples),
+            modulator: new AnalogModulator('FM', 2, 1, 200),
+            output,
+          },
+          edges: [['message', 'modulator'], ['modulator', 'output']],
+        }, options);
+        return { pipeline, output };
+      },
+    },
+    {
+      name: 'AWGN channel',
+      build: options => {
+        const output = new CollectSink('real');
+        const pipeline = Pipeline.fromSpec({
+          nodes: {
+            message: new ToneSource(2, 1, toneRate, toneSamples),
+            channel: new AwgnChannel(0.1, 7),
+            output,
+          },
+          edges: [['message', 'channel'], ['channel', 'output']],
+        }, options);
+        return { pipeline, output };
+      },
+    },
+    {
+      name: 'Anti-alias + sinc reconstruction',
+      build: options => {
+        const samplingRate = 8;
+        const output = new CollectSink('real');
+        const pipeline = Pipeline.fromSpec({
+          nodes: {
+            message: new ToneSource(3, 1, toneRate, toneSamples / 4),
+            antiAlias: new AntiAliasFilterStage(samplingRate / 2 / toneRate),
+            sampler: new Resampler(toneRate, samplingRate),
+            reconstruction: new ReconstructionStage('sinc', samplingRate, toneRate, (toneSamples / 4 - 1) / toneRate),
+            output,
+          },
+          edges: [
+            ['message', 'antiAlias'],
+            ['antiAlias', 'sampler'],
+            ['sampler', 'reconstruction'],
+            ['reconstruction', 'output'],
+          ],
+        }, options);
+        return { pipeline, output };
+      },
+    },
+    {
+      name: 'PCM link (HDB3, σ = 0.2)',
+      build: options => {
+        const { pipeline, output } = buildPcmLinkGraph({
+          frequency: 2,
+          amplitude: 1,
+          samplingRate: 16,
+          quantizationLevels: 16,
+          lineCode: 'HDB3',
+          noiseSigma: 0.2,
+          duration: 200,
+          seed: 11,
+        }, options);
+        return { pipeline, output };
+      },
+    },
+  ];
+}
+
+function compare(reference: ArrayLike<number>, values: ArrayLike<number>): { maxAbsError: number; snrDb: number } {
+  const count = Math.min(reference.length, values.length);
+  let maxAbsError = 0;
+  let signal = 0;
+  let noise = 0;
+  for (let i = 0; i < count; i++) {
+    const error = values[i] - reference[i];
+    maxAbsError = Math.max(maxAbsError, Math.abs(error));
+    signal += reference[i] * reference[i];
+    noise += error * error;
+  }
+  if (reference.length !== values.length) maxAbsError = Infinity;
+  const snrDb = noise === 0 ? Infinity : 10 * Math.log10(signal / noise);
+  return { maxAbsError, snrDb };
+}
+
+/**
+ * Times every case at each precision and reports the accuracy of reduced-precision
+ * runs against float64. Runs synchronously; callers yield to the UI before invoking it.
+ */
+export function runBenchmark(
+  cases: BenchmarkCase[] = defaultBenchmarkCases(),
+  options: BenchmarkOptions = {}
+): BenchmarkResult[] {
+  const repetitions = options.repetitions ?? 5;
+  const precisions = options.precisions ?? ['float64', 'float32'];
+
+  return cases.map(benchmarkCase => {
+    // The float64 output is the accuracy reference even when it is not being timed
+    const runOnce = (precision: SamplePrecision) => {
+      const { pipeline, output } = benchmarkCase.build({ precision });
+      pipeline.run();
+      return output.values;
+    };
+    const reference = runOnce('float64');
+
+    const results = precisions.map(precision => {
+      let values = runOnce(precision);
+      const start = performance.now();
+      for (let r = 0; r < repetitions; r++) {
+        values = runOnce(precision);
+      }
+      const meanMs = (performance.now() - start) / repetitions;
+      return {
+        precision,
+        meanMs,
+        samplesPerSecond: meanMs > 0 ? (values.length / meanMs) * 1000 : Infinity,
+        outputBytes: values.byteLength,
+        ...compare(reference, values),
+      };
+    });
+
+    return { name: benchmarkCase.name, samples: reference.length, results };
+  });
+}
+
+// ---------------------------------------------------------------------------
+// Fixed-point word length
+// ---------------------------------------------------------------------------
+
+export type ArithmeticFormat = 'float64' | QFormat;
+
+/**
+ * A kernel built either in float64 (the reference) or in a fixed-point format.
+ * `metric` selects how outputs are compared: SNR for waveforms, mismatch count
+ * for quantiser levels and decided bits.
+ */
+export interface FixedPointCase {
+  name: string;
+  metric: 'snr' | 'mismatches';
+  build(format: ArithmeticFormat): { pipeline: Pipeline; output: CollectSink; stats: FixedPointStats };
+}
+
+export interface FormatResult {
+  format: ArithmeticFormat;
+  meanMs: number;
+  snrDb: number;
+  mismatches: number;
+  saturations: number;
+  overflows: number;
+}
+
+export interface FixedPointResult {
+  name: string;
+  metric: FixedPointCase['metric'];
+  samples: number;
+  results: FormatResult[];
+}
+
+/** Oscillator, FIR, quantiser and demodulator kernels in float64, Q15 and Q31. */
+export function defaultFixedPointCases(): FixedPointCase[] {
+  const rate = 100;
+  const samples = 100_000;
+  const taps = designLowpass(0.05, 63);
+  const bits = randomBits(1024, 3);
+
+  return [
+    {
+      name: 'Oscillator (NCO)',
+      metric: 'snr',
+      build: format => {
+        const output = new CollectSink('real');
+        const oscillator = format === 'float64'
+          ? new ToneSource(2, 1, rate, samples)
+          : new FixedPointOscillator(format, 2, 1, rate, samples);
+        const pipeline = Pipeline.fromSpec({
+          nodes: { oscillator, output },
+          edges: [['oscillator', 'output']],
+        });
+        return { pipeline, output, stats: oscillator instanceof FixedPointOscillator ? oscillator.stats : createStats() };
+      },
+    },
+    {
+      name: 'Low-pass FIR (63 taps)',
+      metric: 'snr',
+      build: format => {
+        const output = new CollectSink('real');
+        const filter = format === 'float64' ? new FirStage(taps) : new FixedPointFir(format, taps);
+        const pipeline = Pipeline.fromSpec({
+          nodes: {
+            message: new ToneSource(2, 1, rate, samples),
+            channel: new AwgnChannel(0.2, 5),
+            filter,
+            output,
+          },
+          edges: [['message', 'channel'], ['channel', 'filter'], ['filter', 'output']],
+        });
+        return { pipeline, output, stats: filter instanceof FixedPointFir ? filter.stats : createStats() };
+      },
+    },
+    {
+      name: 'PCM quantizer (256 levels)',
+      metric: 'mismatches',
+      build: format => {
+        const output = new CollectSink('symbols');
+        const quantizer = format === 'float64' ? new PcmQuantizer(1, 256) : new FixedPointQuantizer(format, 1, 256);
+        const pipeline = Pipeline.fromSpec({
+          nodes: { message: new ToneSource(2.3, 1, rate, samples), quantizer, output },
+          edges: [['message', 'quantizer'], ['quantizer', 'output']],
+        });
+        return { pipeline, output, stats: quantizer instanceof FixedPointQuantizer ? quantizer.stats : createStats() };
+      },
+    },
+    {
+      name: 'BPSK demodulator (σ = 1)',
+      metric: 'mismatches',
+      build: format => {
+        const output = new CollectSink('bits');
+        const demodulator = format === 'float64'
+          ? new BpskDemodulator(5, samplesPerBit, samplesPerBit)
+          : new FixedPointBpskDemodulator(format, 5, samplesPerBit, samplesPerBit);
+        const pipeline = Pipeline.fromSpec({
+          nodes: {
+            source: new BitSource(bits),
+            modulator: new Modulator('BPSK', 1, samplesPerBit),
+            channel: new AwgnChannel(1, 9),
+            demodulator,
+            output,
+          },
+          edges: [['source', 'modulator'], ['modulator', 'channel'], ['channel', 'demodulator'], ['demodulator', 'output']],
+        });
+        return {
+          pipeline,
+          output,
+          stats: demodulator instanceof FixedPointBpskDemodulator ? demodulator.stats : createStats(),
+        };
+      },
+    },
+  ];
+}
+
+function countMismatches(reference: ArrayLike<number>, values: ArrayLike<number>): number {
+  let mismatches = Math.abs(reference.length - values.length);
+  const count = Math.min(reference.length, values.length);
+  for (let i = 0; i < count; i++) {
+    if (reference[i] !== values[i]) mismatches++;
+  }
+  return mismatches;
+}
+
+/**
+ * Times each kernel in every format and compares it with the float64 version,
+ * reporting how often the fixed-point datapath saturated or outgrew 32 bits.
+ */
+export function runFixedPointBenchmark(
+  cases: FixedPointCase[] = defaultFixedPointCases(),
+  options: { repetitions?: number; formats?: ArithmeticFormat[] } = {}
+): FixedPointResult[] {
+  const repetitions = options.repetitions ?? 5;
+  const formats = options.formats ?? ['float64', 'q15', 'q31'];
+
+  return cases.map(benchmarkCase => {
+    const runOnce = (format: ArithmeticFormat) => {
+      const { pipeline, output, stats } = benchmarkCase.build(format);
+      pipeline.run();
+      return { values: output.values, stats };
+    };
+    const reference = runOnce('float64').values;
+
+    const results = formats.map(format => {
+      // The warm-up run also supplies the saturation counts, which are the same every run
+      const { values, stats } = runOnce(format);
+      const start = performance.now();
+      for (let r = 0; r < repetitions; r++) runOnce(format);
+      const meanMs = (performance.now() - start) / repetitions;
+      return {
+        format,
+        meanMs,
+        snrDb: compare(reference, values).snrDb,
+        mismatches: countMismatches(reference, values),
+        saturations: stats.saturations,
+        overflows: stats.overflows,
+      };
+    });
+
+    return { name: benchmarkCase.name, metric: benchmarkCase.metric, samples: reference.length, results };
+  });
+}
+
+// ---------------------------------------------------------------------------
+// LDPC decoding
+// ---------------------------------------------------------------------------
+
+/**
+ * Decoder throughput and iterations to converge of the rate-1/2 LDPC code over a sweep
+ * of Eb/N0: near the threshold the decoder runs to its iteration limit, well above it a
+ * few layered passes suffice and decoding speeds up accordingly.
+ */
+export function runLdpcBenchmark(
+  options: { n?: number; codewords?: number; ebN0Db?: number[] } = {}
+): LdpcLinkResult[] {
+  const code = ldpcCode(options.n ?? 2048);
+  const codewords = options.codewords ?? 100;
+  // Warm-up so the first point is not charged for compilation
+  evaluateLdpcLink(code, 3, 4);
+  return (options.ebN0Db ?? [1.5, 2, 2.5, 3, 4]).map(ebN0Db => evaluateLdpcLink(code, ebN0Db, codewords, { seed: 13 }));
+}
@@ -0,0 +1,112 @@
+import { DigitalToAnalogAlgorithm } from '../types';
+
+/**
+ * Closed-form bit error rates over AWGN for the coherent baseband keyings, as functions
+ * of the symbol SNR Es/N0 (linear). Each model matches the constellation and the
+ * maximum-likelihood receiver in `digitalToAnalog.ts`, including its bit mapping: QPSK
+ * is Gray-coded, while 8-PSK and the 16-QAM axes count in natural binary, so a
+ * neighbouring-symbol error there costs more than one bit on average.
+ */
+export interface ModulationModel {
+  algorithm: DigitalToAnalogAlgorithm;
+  bitsPerSymbol: number;
+  /** Mean |s|² of the envelope constellation, to scale channel noise for a given Es/N0 */
+  averageEnergy: number;
+  bitErrorRate(esN0: number): number;
+}
+
+/** Complementary error function (Numerical Recipes erfcc, fractional error < 1.2e-7). */
+export function erfc(x: number): number {
+  const z = Math.abs(x);
+  const t = 1 / (1 + 0.5 * z);
+  const r =
+    t *
+    Math.exp(
+      -z * z -
+        1.26551223 +
+        t * (1.00002368 + t * (0.37409196 + t * (0.09678418 + t * (-0.18628806 + t * (0.27886807 +
+        t * (-1.13520398 + t * (1.48851587 + t * (-0.82215223 + t * 0.17087277))))))))
+    );
+  return x >= 0 ? r : 2 - r;
+}
+
+/** Gaussian tail probability Q(x) = P(N(0, 1) > x). */
+export function gaussianQ(x: number): number {
+  return 0.5 * erfc(x / Math.SQRT2);
+}
+
+/** Models in order of increasing spectral efficiency. */
+export const modulationModels: readonly ModulationModel[] = [
+  {
+    // On-off keying between amplitudes 0.2 and 1, midpoint threshold
+    algorithm: 'ASK',
+    bitsPerSymbol: 1,
+    averageEnergy: 0.52,
+    bitErrorRate: esN0 => gaussianQ(Math.sqrt((8 * esN0) / 13)),
+  },
+  {
+    algorithm: 'BPSK',
+    bitsPerSymbol: 1,
+    averageEnergy: 1,
+    bitErrorRate: esN0 => gaussianQ(Math.sqrt(2 * esN0)),
+  },
+  {
+    algorithm: 'QPSK',
+    bitsPerSymbol: 2,
+    averageEnergy: 1,
+    bitErrorRate: esN0 => gaussianQ(Math.sqrt(esN0)),
+  },
+  {
+    // Two nearest neighbours; adjacent natural-binary labels differ in 1.75 bits on average
+    algorithm: 'MPSK',
+    bitsPerSymbol: 3,
+    averageEnergy: 1,
+    bitErrorRate: esN0 => (7 / 6) * gaussianQ(Math.sqrt(2 * esN0) * Math.sin(Math.PI / 8)),
+  },
+  {
+    // Per axis, 4-PAM in natural binary loses two bits per four neighbour crossings
+    algorithm: 'QAM',
+    bitsPerSymbol: 4,
+    averageEnergy: 10 / 9,
+    bitErrorRate: esN0 => gaussianQ(Math.sqrt(esN0 / 5)),
+  },
+];
+
+export function modulationModel(algorithm: DigitalToAnalogAlgorithm): ModulationModel {
+  const model = modulationModels.find(candidate => candidate.algorithm === algorithm);
+  if (!model) throw new Error(`No BER model for ${algorithm}`);
+  return model;
+}
+
+export function toDecibels(ratio: number): number {
+  return 10 * Math.log10(ratio);
+}
+
+export function fromDecibels(decibels: number): number {
+  return 10 ** (decibels / 10);
+}
+
+const thresholdTables = new Map<number, Float64Array>();
+
+/**
+ * Smallest Es/N0 in dB at which each model in `modulationModels` reaches `targetBer`,
+ * found by bisection once per target and cached. Entries line up with the model list.
+ */
+export function snrThresholds(targetBer: number): Float64Array {
+  let table = thresholdTables.get(targetBer);
+  if (table) return table;
+
+  table = new Float64Array(modulationModels.length);
+  modulationModels.forEach((model, index) => {
+    let low = -20;
+    let high = 60;
+    for (let iteration = 0; iteration < 60; iteration++) {
+      const middle = (low + high) / 2;
+      if (model.bitErrorRate(fromDecibels(middle)) > targetBer) low = middle;
+      else high = middle;
+    }
+    table![index] = high;
+  });
+  thresholdTables.set(targetBer, table);
+  return table;
+}
@@ -0,0 +1,501 @@
+import { BlockCode, DigitalToAnalogAlgorithm } from '../types';
+import { InputPort, OutputPort, Pipeline, PipelineOptions, Stage } from './pipeline';
+import { AwgnChannel, BitErrorCounter, BitSource, SymbolMapper } from './stages';
+import { BasebandDemodulator, BasebandModulator, basebandSamplesPerBit } from './digitalToAnalog';
+import { fromDecibels, modulationModel } from './berModels';
+import { BlockDeinterleaver, BlockInterleaver } from './interleaver';
+import { Random } from './random';
+
+/**
+ * Binary cyclic block codes in systematic form: a codeword sends the k message bits
+ * first and then the n − k parity bits, the remainder of m(x)·x^(n−k) modulo the
+ * generator g(x). Hamming codes are the single-error-correcting BCH codes; SECDED adds an
+ * overall parity bit to a Hamming code so double errors are detected rather than
+ * miscorrected.
+ *
+ * Everything that depends only on the code is built once per code and cached: parity
+ * contributions per message byte, so encoding is one table lookup and XOR per 8 message
+ * bits; the syndrome → error position table for the Hamming codes; and GF(2^m) log/exp
+ * tables for the BCH Berlekamp–Massey decoder.
+ */
+export const blockCodes: readonly BlockCode[] = [
+  'Hamming(7,4)',
+  'Hamming(15,11)',
+  'SECDED(8,4)',
+  'SECDED(16,11)',
+  'BCH(15,7)',
+  'BCH(31,21)',
+  'BCH(63,45)',
+];
+
+// Primitive polynomials of GF(2^m), bit i the coefficient of x^i
+const PRIMITIVE_POLYNOMIALS: Record<number, number> = { 3: 0xb, 4: 0x13, 5: 0x25, 6: 0x43 };
+
+// Field degree m and designed error-correcting capability t of each code
+const CODE_PARAMETERS: Record<BlockCode, { m: number; t: number; extended: boolean }> = {
+  'Hamming(7,4)': { m: 3, t: 1, extended: false },
+  'Hamming(15,11)': { m: 4, t: 1, extended: false },
+  'SECDED(8,4)': { m: 3, t: 1, extended: true },
+  'SECDED(16,11)': { m: 4, t: 1, extended: true },
+  'BCH(15,7)': { m: 4, t: 2, extended: false },
+  'BCH(31,21)': { m: 5, t: 2, extended: false },
+  'BCH(63,45)': { m: 6, t: 3, extended: false },
+};
+
+/** GF(2^m) arithmetic through exponent and logarithm tables of the primitive element α. */
+class GaloisField {
+  readonly order: number;
+  readonly exp: Uint8Array;
+  readonly log: Uint8Array;
+
+  constructor(m: number) {
+    this.order = (1 << m) - 1;
+    this.exp = new Uint8Array(2 * this.order);
+    this.log = new Uint8Array(this.order + 1);
+    let value = 1;
+    for (let i = 0; i < this.order; i++) {
+      this.exp[i] = value;
+      this.exp[i + this.order] = value;
+      this.log[value] = i;
+      value <<= 1;
+      if (value > this.order) value ^= PRIMITIVE_POLYNOMIALS[m];
+    }
+  }
+
+  multiply(a: number, b: number): number {
+    return a === 0 || b === 0 ? 0 : this.exp[this.log[a] + this.log[b]];
+  }
+
+  divide(a: number, b: number): number {
+    return a === 0 ? 0 : this.exp[this.log[a] + this.order - this.log[b]];
+  }
+
+  /** α^power for any integer power. */
+  power(power: number): number {
+    const reduced = power % this.order;
+    return this.exp[reduced < 0 ? reduced + this.order : reduced];
+  }
+}
+
+/** g(x) = lcm of the minimal polynomials of α, α^3, …, α^(2t−1), as a bit mask. */
+function generatorPolynomial(field: GaloisField, t: number): number {
+  const covered = new Uint8Array(field.order);
+  let generator = 1;
+  for (let i = 1; i < 2 * t; i += 2) {
+    if (covered[i]) continue;
+    // Minimal polynomial: product of (x + α^e) over the conjugates e = i·2^j
+    let minimal = [1];
+    for (let e = i; !covered[e]; e = (2 * e) % field.order) {
+      covered[e] = 1;
+      const root = field.power(e);
+      const product = new Array<number>(minimal.length + 1).fill(0);
+      minimal.forEach((coefficient, degree) => {
+        product[degree + 1] ^= coefficient;
+        product[degree] ^= field.multiply(coefficient, root);
+      });
+      minimal = product;
+    }
+    // The coefficients are 0 or 1, so the polynomial multiplies into g over GF(2)
+    let mask = 0;
+    minimal.forEach((coefficient, degree) => (mask |= coefficient << degree));
+    let product = 0;
+    for (let degree = 0; degree < minimal.length; degree++) {
+      if ((mask >> degree) & 1) product ^= generator << degree;
+    }
+    generator = product;
+  }
+  return generator;
+}
+
+/** Code tables shared by every encoder and decoder stage of one code. */
+export class BlockCodec {
+  readonly code: BlockCode;
+  /** Codeword length, including the overall parity bit of SECDED codes */
+  readonly n: number;
+  readonly k: number;
+  /** Errors per codeword the decoder corrects */
+  readonly t: number;
+  readonly extended: boolean;
+  /** Parity bits from the generator, excluding the SECDED overall parity */
+  readonly parityBits: number;
+  private readonly field: GaloisField;
+  // Per message byte j, the parity contributed by each of its 256 values
+  private readonly parityTable: Uint32Array;
+  // Hamming codes: remainder of a single error at degree d → d + 1 (0 for none)
+  private readonly syndromeTable: Int16Array | null;
+
+  constructor(code: BlockCode) {
+    const { m, t, extended } = CODE_PARAMETERS[code];
+    this.code = code;
+    this.t = t;
+    this.extended = extended;
+    this.field = new GaloisField(m);
+    const length = this.field.order;
+    const generator = generatorPolynomial(this.field, t);
+    this.parityBits = 31 - Math.clz32(generator);
+    this.k = length - this.parityBits;
+    this.n = length + (extended ? 1 : 0);
+
+    // x^d mod g(x) for every codeword degree
+    const remainders = new Uint32Array(length);
+    let remainder = 1;
+    for (let degree = 0; degree < length; degree++) {
+      remainders[degree] = remainder;
+      remainder <<= 1;
+      if ((remainder >> this.parityBits) & 1) remainder ^= generator;
+    }
+
+    // Message bit i sits at degree length − 1 − i
+    const bytes = Math.ceil(this.k / 8);
+    this.parityTable = new Uint32Array(bytes * 256);
+    for (let j = 0; j < bytes; j++) {
+      const table = this.parityTable.subarray(j * 256, (j + 1) * 256);
+      for (let value = 1; value < 256; value++) {
+        const lowest = 31 - Math.clz32(value & -value);
+        const bit = 8 * j + 7 - lowest;
+        const contribution = bit < this.k ? remainders[length - 1 - bit] : 0;
+        table[value] = table[value & (value - 1)] ^ contribution;
+      }
+    }
+
+    if (t === 1) {
+      this.syndromeTable = new Int16Array(1 << this.parityBits);
+      for (let degree = 0; degree < length; degree++) this.syndromeTable[remainders[degree]] = degree + 1;
+    } else {
+      this.syndromeTable = null;
+    }
+  }
+
+  /** Parity of a message packed MSB first into `message`, one lookup per byte. */
+  parity(message: Uint8Array): number {
+    let parity = 0;
+    for (let j = 0; j < message.length; j++) parity ^= this.parityTable[j * 256 + message[j]];
+    return parity;
+  }
+
+  /**
+   * Corrects `codeword` (n bits, one per byte) in place given the remainder of its
+   * cyclic part. Returns the number of bits flipped, or −1 if the errors were detected
+   * but not correctable.
+   */
+  correct(codeword: Uint8Array, remainder: number): number {
+    const length = this.field.order;
+    if (this.extended) {
+      let overall = 0;
+      for (let i = 0; i < this.n; i++) overall ^= codeword[i];
+      if (remainder === 0) {
+        if (overall === 0) return 0;
+        // Only the overall parity bit itself is wrong
+        codeword[length] ^= 1;
+        return 1;
+      }
+      // A non-zero syndrome with even overall parity means two errors
+      if (overall === 0) return -1;
+    } else if (remainder === 0) {
+      return 0;
+    }
+
+    if (this.syndromeTable) {
+      const position = this.syndromeTable[remainder];
+      if (position === 0) return -1;
+      codeword[length - position] ^= 1;
+      return 1;
+    }
+    return this.correctBch(codeword, remainder);
+  }
+
+  /** Berlekamp–Massey on the syndromes S_i = r(α^i), then a Chien search for the roots. */
+  private correctBch(codeword: Uint8Array, remainder: number): number {
+    const field = this.field;
+    const length = field.order;
+    const count = 2 * this.t;
+
+    // r(α^i) = (r mod g)(α^i) because g(α^i) = 0 for i ≤ 2t
+    const syndromes = new Uint8Array(count);
+    for (let i = 1; i <= count; i++) {
+      let sum = 0;
+      for (let degree = 0; degree < this.parityBits; degree++) {
+        if ((remainder >> degree) & 1) sum ^= field.power(i * degree);
+      }
+      syndromes[i - 1] = sum;
+    }
+
+    let locator = new Uint8Array(count + 1);
+    let previous = new Uint8Array(count + 1);
+    locator[0] = 1;
+    previous[0] = 1;
+    let errors = 0;
+    let shift = 1;
+    let lastDiscrepancy = 1;
+    for (let step = 0; step < count; step++) {
+      let discrepancy = syndromes[step];
+      for (let i = 1; i <= errors; i++) discrepancy ^= field.multiply(locator[i], syndromes[step - i]);
+      if (discrepancy === 0) {
+        shift++;
+        continue;
+      }
+      const scale = field.divide(discrepancy, lastDiscrepancy);
+      const updated = locator.slice();
+      for (let i = 0; i + shift <= count; i++) updated[i + shift] ^= field.multiply(scale, previous[i]);
+      if (2 * errors <= step) {
+        previous = locator;
+        errors = step + 1 - errors;
+        lastDiscrepancy = discrepancy;
+        shift = 1;
+      } else {
+        shift++;
+      }
+      locator = updated;
+    }
+    if (errors > this.t) return -1;
+
+    // Chien search: an error at degree d makes Λ(α^−d) = 0
+    const flips: number[] = [];
+    for (let degree = 0; degree < length; degree++) {
+      let sum = 0;
+      for (let i = 0; i <= errors; i++) sum ^= field.multiply(locator[i], field.power(-degree * i));
+      if (sum === 0) flips.push(degree);
+    }
+    if (flips.length !== errors) return -1;
+    for (const degree of flips) codeword[length - 1 - degree] ^= 1;
+    return errors;
+  }
+}
+
+const codecs = new Map<BlockCode, BlockCodec>();
+
+/** Cached tables for `code`. */
+export function blockCodec(code: BlockCode): BlockCodec {
+  let codec = codecs.get(code);
+  if (!codec) {
+    codec = new BlockCodec(code);
+    codecs.set(code, codec);
+  }
+  return codec;
+}
+
+// ---------------------------------------------------------------------------
+// Stages
+// ---------------------------------------------------------------------------
+
+/** k message bits → n codeword bits; a short final message is zero-padded. */
+export class BlockEncoder implements Stage {
+  readonly name: string;
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['bits'] as const;
+  readonly codec: BlockCodec;
+  private readonly message: Uint8Array;
+  private readonly codeword: Uint8Array;
+  private collected = 0;
+  private readPosition: number;
+
+  constructor(code: BlockCode) {
+    this.name = `${code} encoder`;
+    this.codec = blockCodec(code);
+    this.message = new Uint8Array(Math.ceil(this.codec.k / 8));
+    this.codeword = new Uint8Array(this.codec.n);
+    this.readPosition = this.codec.n;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const { k, n, parityBits, extended } = this.codec;
+    const codeword = this.codeword;
+
+    for (;;) {
+      while (this.readPosition < n && output.length < output.capacity) {
+        output.data[output.length++] = codeword[this.readPosition++];
+      }
+      if (this.readPosition < n) return false;
+
+      while (this.collected < k && input.offset < input.length) {
+        const bit = input.data[input.offset++];
+        codeword[this.collected] = bit;
+        this.message[this.collected >> 3] |= bit << (7 - (this.collected & 7));
+        this.collected++;
+      }
+      if (this.collected < k) {
+        if (!input.ended || this.collected === 0) return input.ended;
+        codeword.fill(0, this.collected, k);
+      }
+
+      const parity = this.codec.parity(this.message);
+      let overall = 0;
+      for (let i = 0; i < parityBits; i++) {
+        const bit = (parity >> (parityBits - 1 - i)) & 1;
+        codeword[k + i] = bit;
+        overall ^= bit;
+      }
+      if (extended) {
+        for (let i = 0; i < k; i++) overall ^= codeword[i];
+        codeword[n - 1] = overall;
+      }
+      this.message.fill(0);
+      this.collected = 0;
+      this.readPosition = 0;
+    }
+  }
+}
+
+/**
+ * n received bits → k decoded bits by syndrome lookup (Hamming, SECDED) or
+ * Berlekamp–Massey (BCH). An incomplete final codeword is dropped.
+ */
+export class BlockDecoder implements Stage {
+  readonly name: string;
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['bits'] as const;
+  readonly codec: BlockCodec;
+  codewords = 0;
+  /** Bits flipped by the decoder */
+  corrected = 0;
+  /** Codewords whose errors were detected but could not be corrected */
+  failures = 0;
+  private readonly message: Uint8Array;
+  private readonly codeword: Uint8Array;
+  private collected = 0;
+  private readPosition: number;
+
+  constructor(code: BlockCode) {
+    this.name = `${code} decoder`;
+    this.codec = blockCodec(code);
+    this.message = new Uint8Array(Math.ceil(this.codec.k / 8));
+    this.codeword = new Uint8Array(this.codec.n);
+    this.readPosition = this.codec.k;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const { k, n, parityBits } = this.codec;
+    const codeword = this.codeword;
+
+    for (;;) {
+      while (this.readPosition < k && output.length < output.capacity) {
+        output.data[output.length++] = codeword[this.readPosition++];
+      }
+      if (this.readPosition < k) return false;
+
+      while (this.collected < n && input.offset < input.length) codeword[this.collected++] = input.data[input.offset++];
+      if (this.collected < n) return input.ended;
+
+      this.message.fill(0);
+      for (let i = 0; i < k; i++) this.message[i >> 3] |= codeword[i] << (7 - (i & 7));
+      let received = 0;
+      for (let i = 0; i < parityBits; i++) received = (received << 1) | codeword[k + i];
+      const flipped = this.codec.correct(codeword, this.codec.parity(this.message) ^ received);
+      if (flipped < 0) this.failures++;
+      else this.corrected += flipped;
+      this.codewords++;
+      this.collected = 0;
+      this.readPosition = 0;
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Coded link evaluation
+// ---------------------------------------------------------------------------
+
+export interface CodedLinkResult {
+  /** Null for the uncoded reference */
+  code: BlockCode | null;
+  rate: number;
+  /** Information bits per channel symbol */
+  throughput: number;
+  /** Bit error rate of the coded bits out of the demodulator */
+  channelBitErrorRate: number;
+  /** Bit error rate of the information bits after decoding */
+  bitErrorRate: number;
+  corrected: number;
+  failures: number;
+  bits: number;
+}
+
+/**
+ * Sends `infoBits` random bits through encoder → baseband modulator → complex AWGN →
+ * receiver → decoder. `ebN0Db` is per information bit, so the channel SNR drops by the
+ * code rate and the comparison with the uncoded link is at equal energy per bit.
+ * Only the keyings with a BER model (coherent, fixed energy per symbol) are supported.
+ *
+ * With `interleaveDepth`, codewords go through a block interleaver of that many rows of
+ * one codeword each before the modulator, and the receiver's bits through the matching
+ * deinterleaver before the decoder, so adjacent channel bits belong to different codewords.
+ */
+export function evaluateCodedLink(
+  algorithm: DigitalToAnalogAlgorithm,
+  code: BlockCode | null,
+  ebN0Db: number,
+  infoBits: number,
+  options: PipelineOptions & { seed?: number; interleaveDepth?: number } = {}
+): CodedLinkResult {
+  const model = modulationModel(algorithm);
+  const codec = code ? blockCodec(code) : null;
+  const rate = codec ? codec.k / codec.n : 1;
+  const random = new Random(options.seed ?? 1);
+  const bits = new Uint8Array(infoBits);
+  for (let i = 0; i < infoBits; i++) bits[i] = random.bit();
+
+  // Es/N0 = Eb/N0 · information bits per symbol; N0 = 2σ² per envelope sample
+  const esN0 = fromDecibels(ebN0Db) * model.bitsPerSymbol * rate;
+  const symbolEnergy = model.averageEnergy * basebandSamplesPerBit * model.bitsPerSymbol;
+  const noiseSigma = Math.sqrt(symbolEnergy / (2 * esN0));
+
+  const modulator = new BasebandModulator(algorithm, 1, basebandSamplesPerBit);
+  const channelErrors = new BitErrorCounter();
+  const errors = new BitErrorCounter();
+  const encoder = code ? new BlockEncoder(code) : null;
+  const decoder = code ? new BlockDecoder(code) : null;
+  const pipeline = new Pipeline(options)
+    .add('source', new BitSource(bits))
+    .add('modulator', modulator)
+    .add('channel', new AwgnChannel(noiseSigma, random.nextUint32(), 'complex'))
+    .add('receiver', new BasebandDemodulator(algorithm, 1, basebandSamplesPerBit))
+    .add('channelErrors', channelErrors)
+    .add('errors', errors)
+    .connect('modulator', 'channel')
+    .connect('channel', 'receiver')
+    .connect('source', 'errors:0');
+
+  let coded = 'source';
+  if (encoder && decoder) {
+    pipeline
+      .add('encoder', encoder)
+      .add('decoder', decoder)
+      .connect('source', 'encoder')
+      .connect('decoder', 'errors:1');
+    coded = 'encoder';
+    if (codec && options.interleaveDepth && options.interleaveDepth > 1) {
+      pipeline
+        .add('interleaver', new BlockInterleaver('bits', options.interleaveDepth, codec.n))
+        .add('deinterleaver', new BlockDeinterleaver('bits', options.interleaveDepth, codec.n))
+        .connect('encoder', 'interleaver')
+        .connect('receiver', 'deinterleaver')
+        .connect('deinterleaver', 'decoder');
+      coded = 'interleaver';
+    } else {
+      pipeline.connect('receiver', 'decoder');
+    }
+  } else {
+    pipeline.connect('receiver', 'errors:1');
+  }
+  pipeline.connect(coded, 'channelErrors:0').connect('receiver', 'channelErrors:1');
+  if (modulator.bitsPerSymbol > 1) {
+    pipeline.add('mapper', new SymbolMapper(modulator.bitsPerSymbol)).connect(coded, 'mapper').connect('mapper', 'modulator');
+  } else {
+    pipeline.connect(coded, 'modulator');
+  }
+  pipeline.run();
+
+  return {
+    code,
+    rate,
+    throughput: rate * model.bitsPerSymbol,
+    channelBitErrorRate: channelErrors.errorRate,
+    bitErrorRate: errors.errorRate,
+    corrected: decoder ? decoder.corrected : 0,
+    failures: decoder ? decoder.failures : 0,
+    bits: errors.bits,
+  };
+}
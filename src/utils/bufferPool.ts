@@ -0,0 +1,150 @@
+import { SamplePrecision } from '../types';
+
+/** Typed array kinds handed out by the pool. */
+export interface BufferKinds {
+  float32: Float32Array;
+  float64: Float64Array;
+  uint8: Uint8Array;
+  int16: Int16Array;
+  int32: Int32Array;
+}
+
+export type BufferKind = keyof BufferKinds;
+export type PooledBuffer = BufferKinds[BufferKind];
+export type FloatArray = Float32Array | Float64Array;
+
+// Smallest size class is 2^6 elements; requests round up to the next power of two
+const MIN_CLASS_SHIFT = 6;
+// Free buffers kept per kind and size class; anything beyond is left to the GC
+const MAX_FREE_PER_CLASS = 32;
+
+/** Power-of-two length of the buffers that serve a request for `length` items. */
+export function sizeClass(length: number): number {
+  const shift = Math.max(MIN_CLASS_SHIFT, 32 - Math.clz32(Math.max(1, length) - 1));
+  return 2 ** shift;
+}
+
+/** Unpooled float array of the given precision, for buffers that outlive a run. */
+export function allocateFloat(precision: SamplePrecision, length: number): FloatArray {
+  return precision === 'float32' ? new Float32Array(length) : new Float64Array(length);
+}
+
+function kindOf(buffer: PooledBuffer): BufferKind {
+  if (buffer instanceof Float64Array) return 'float64';
+  if (buffer instanceof Float32Array) return 'float32';
+  if (buffer instanceof Int32Array) return 'int32';
+  if (buffer instanceof Int16Array) return 'int16';
+  return 'uint8';
+}
+
+function allocate(kind: BufferKind, length: number): PooledBuffer {
+  switch (kind) {
+    case 'float32':
+      return new Float32Array(length);
+    case 'float64':
+      return new Float64Array(length);
+    case 'uint8':
+      return new Uint8Array(length);
+    case 'int16':
+      return new Int16Array(length);
+    case 'int32':
+      return new Int32Array(length);
+  }
+}
+
+export interface BufferPoolStats {
+  /** Buffers created because no free buffer of the class existed */
+  allocations: number;
+  /** Requests served from a free list */
+  reuses: number;
+  bytesAllocated: number;
+}
+
+/**
+ * Size-class pool of typed arrays. Buffers are power-of-two lengths, so a request
+ * may return a longer array than asked for; callers that need an exact length use
+ * an `Arena`, which hands out views.
+ */
+export class BufferPool {
+  private readonly free = new Map<string, PooledBuffer[]>();
+  readonly stats: BufferPoolStats = { allocations: 0, reuses: 0, bytesAllocated: 0 };
+
+  acquire<K extends BufferKind>(kind: K, length: number): BufferKinds[K] {
+    const size = sizeClass(length);
+    const buffer = this.free.get(`${kind}:${size}`)?.pop();
+    if (buffer) {
+      this.stats.reuses++;
+      return buffer as BufferKinds[K];
+    }
+    const created = allocate(kind, size);
+    this.stats.allocations++;
+    this.stats.bytesAllocated += created.byteLength;
+    return created as BufferKinds[K];
+  }
+
+  /** Returns a buffer obtained from `acquire` (not a view of one). */
+  release(buffer: PooledBuffer): void {
+    const key = `${kindOf(buffer)}:${buffer.length}`;
+    let list = this.free.get(key);
+    if (!list) {
+      list = [];
+      this.free.set(key, list);
+    }
+    if (list.length < MAX_FREE_PER_CLASS) list.push(buffer);
+  }
+}
+
+export const sharedBufferPool = new BufferPool();
+
+/**
+ * Per-run scratch allocator. Stages draw zeroed, exact-length views from it while a
+ * run is set up, and the whole arena goes back to the pool in one `release` call
+ * when the run ends.
+ */
+export class Arena {
+  private readonly pool: BufferPool;
+  private readonly held: PooledBuffer[] = [];
+
+  constructor(pool: BufferPool = sharedBufferPool) {
+    this.pool = pool;
+  }
+
+  float32(length: number): Float32Array {
+    return this.take('float32', length);
+  }
+
+  float64(length: number): Float64Array {
+    return this.take('float64', length);
+  }
+
+  uint8(length: number): Uint8Array {
+    return this.take('uint8', length);
+  }
+
+  int16(length: number): Int16Array {
+    return this.take('int16', length);
+  }
+
+  int32(length: number): Int32Array {
+    return this.take('int32', length);
+  }
+
+  /** Sample buffer in the run's precision. */
+  float(precision: SamplePrecision, length: number): FloatArray {
+    return precision === 'float32' ? this.float32(length) : this.float64(length);
+  }
+
+  /** Returns every buffer drawn since the last release; views handed out become invalid. */
+  release(): void {
+    for (const buffer of this.held) this.pool.release(buffer);
+    this.held.length = 0;
+  }
+
+  private take<K extends BufferKind>(kind: K, length: number): BufferKinds[K] {
+    const buffer = this.pool.acquire(kind, length);
+    this.held.push(buffer);
+    const view = buffer.subarray(0, length) as BufferKinds[K];
+    view.fill(0);
+    return view;
+  }
+}
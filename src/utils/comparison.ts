@@ -0,0 +1,191 @@
+import { ComparisonFamily, DataPoint, DigitalToAnalogAlgorithm, DigitalToDigitalAlgorithm } from '../types';
+import { Pipeline } from './pipeline';
+import { BitSource, CollectSink, SymbolMapper } from './stages';
+import { LineCoder } from './digitalToDigital';
+import { Modulator } from './digitalToAnalog';
+import { amplitudeSpectrum, occupiedBandwidth } from './fft';
+import { WorkerPool, canShareMemory, sharedCopy } from './workerPool';
+
+/**
+ * Side-by-side comparison: one bit stream fanned out to several line codes or keyings,
+ * each generated on its own worker. The parsed bits are placed in a SharedArrayBuffer
+ * when the page is cross-origin isolated (vite.config.ts sends COOP/COEP), so every
+ * worker reads the same memory; otherwise each task gets a copy. Waveforms come back
+ * as transferred buffers.
+ */
+
+export type ComparisonAlgorithm = DigitalToDigitalAlgorithm | DigitalToAnalogAlgorithm;
+
+export interface ComparisonResult {
+  family: ComparisonFamily;
+  algorithm: ComparisonAlgorithm;
+  /** Line levels (`levelsPerBit` per bit) or passband samples */
+  samples: Float64Array;
+  /** Rate of `samples`, in samples per second */
+  sampleRate: number;
+  bits: number;
+  /** Occupied bandwidth in Hz, holding `bandwidthFraction` of the power */
+  bandwidth: number;
+  bandwidthFraction: number;
+  /** Level changes per bit for line codes, symbol changes per bit for keyings */
+  transitionsPerBit: number;
+  /** Mean of the transmitted signal */
+  dcLevel: number;
+  /** Time to run the generator pipeline, on the thread that ran it */
+  generationMs: number;
+}
+
+export const comparisonAlgorithms: Record<ComparisonFamily, ComparisonAlgorithm[]> = {
+  'line coding': ['NRZ-L', 'NRZ-I', 'Manchester', 'Differential Manchester', 'AMI', 'Pseudoternary', 'B8ZS', 'HDB3'],
+  // CSS spreads each symbol over a chirp of its own length, so it has no common time axis with the rest
+  modulation: ['ASK', 'BFSK', 'MFSK', 'BPSK', 'DPSK', 'QPSK', 'OQPSK', 'MPSK', 'QAM', 'CPFSK', 'MSK', 'GMSK'],
+};
+
+const bitDuration = 1;
+const samplesPerBit = 100;
+// Line levels are held for this many samples per bit before their spectrum is taken
+const spectrumSamplesPerBit = 32;
+// Rectangular line pulses have slowly decaying sinc sidelobes, so their 99% band mostly
+// measures the sample rate; 90% separates the codes
+const lineCodeFraction = 0.9;
+const modulationFraction = 0.99;
+
+function mean(values: ArrayLike<number>): number {
+  let sum = 0;
+  for (let i = 0; i < values.length; i++) sum += values[i];
+  return values.length > 0 ? sum / values.length : 0;
+}
+
+function lineCodeMetrics(levels: Float64Array, levelsPerBit: number, bits: number) {
+  let transitions = 0;
+  for (let i = 1; i < levels.length; i++) if (levels[i] !== levels[i - 1]) transitions++;
+
+  const hold = spectrumSamplesPerBit / levelsPerBit;
+  const held = new Float64Array(levels.length * hold);
+  for (let i = 0; i < levels.length; i++) held.fill(levels[i], i * hold, (i + 1) * hold);
+  const band = occupiedBandwidth(amplitudeSpectrum(held, spectrumSamplesPerBit / bitDuration), lineCodeFraction);
+  return { transitions: transitions / bits, bandwidth: band.bandwidth };
+}
+
+function symbolChanges(bits: ArrayLike<number>, bitsPerSymbol: number): number {
+  let changes = 0;
+  let previous = -1;
+  for (let i = 0; i < bits.length; i += bitsPerSymbol) {
+    let symbol = 0;
+    for (let b = 0; b < bitsPerSymbol; b++) symbol = symbol * 2 + (i + b < bits.length ? bits[i + b] : 0);
+    if (previous >= 0 && symbol !== previous) changes++;
+    previous = symbol;
+  }
+  return changes;
+}
+
+/** Generates one algorithm's waveform for `bits` and measures it. */
+export function computeComparison(
+  bits: ArrayLike<number>,
+  family: ComparisonFamily,
+  algorithm: ComparisonAlgorithm
+): ComparisonResult {
+  const sink = new CollectSink('real');
+  const pipeline = new Pipeline().add('source', new BitSource(bits)).add('sink', sink);
+  let levelsPerBit = 1;
+  let bitsPerSymbol = 1;
+
+  if (family === 'line coding') {
+    const coder = new LineCoder(algorithm as DigitalToDigitalAlgorithm);
+    levelsPerBit = coder.levelsPerBit;
+    pipeline.add('coder', coder).connect('source', 'coder').connect('coder', 'sink');
+  } else {
+    const modulator = new Modulator(algorithm as DigitalToAnalogAlgorithm, bitDuration, samplesPerBit);
+    bitsPerSymbol = modulator.bitsPerSymbol;
+    pipeline.add('modulator', modulator).connect('modulator', 'sink');
+    if (bitsPerSymbol > 1) {
+      pipeline.add('mapper', new SymbolMapper(bitsPerSymbol)).connect('source', 'mapper').connect('mapper', 'modulator');
+    } else {
+      pipeline.connect('source', 'modulator');
+    }
+  }
+
+  const start = performance.now();
+  pipeline.run();
+  const generationMs = performance.now() - start;
+  const samples = Float64Array.from(sink.values);
+  const count = Math.max(bits.length, 1);
+
+  if (family === 'line coding') {
+    const { transitions, bandwidth } = lineCodeMetrics(samples, levelsPerBit, count);
+    return {
+      family,
+      algorithm,
+      samples,
+      sampleRate: levelsPerBit / bitDuration,
+      bits: bits.length,
+      bandwidth,
+      bandwidthFraction: lineCodeFraction,
+      transitionsPerBit: transitions,
+      dcLevel: mean(samples),
+      generationMs,
+    };
+  }
+  const sampleRate = samplesPerBit / bitDuration;
+  return {
+    family,
+    algorithm,
+    samples,
+    sampleRate,
+    bits: bits.length,
+    bandwidth: samples.length > 0 ? occupiedBandwidth(amplitudeSpectrum(samples, sampleRate), modulationFraction).bandwidth : 0,
+    bandwidthFraction: modulationFraction,
+    transitionsPerBit: symbolChanges(bits, bitsPerSymbol) / count,
+    dcLevel: mean(samples),
+    generationMs,
+  };
+}
+
+/** Chart points of a result: held steps for line levels, one point per sample otherwise. */
+export function comparisonPoints(result: ComparisonResult): DataPoint[] {
+  const { samples, sampleRate } = result;
+  const points: DataPoint[] = [];
+  if (result.family === 'line coding') {
+    for (let i = 0; i < samples.length; i++) {
+      points.push({ x: i / sampleRate, y: samples[i] });
+      points.push({ x: (i + 1) / sampleRate, y: samples[i] });
+    }
+  } else {
+    for (let i = 0; i < samples.length; i++) points.push({ x: i / sampleRate, y: samples[i] });
+  }
+  return points;
+}
+
+// ---------------------------------------------------------------------------
+// Workers
+// ---------------------------------------------------------------------------
+
+/** Posted to a comparison worker. */
+export interface ComparisonTask {
+  family: ComparisonFamily;
+  algorithm: ComparisonAlgorithm;
+  /** The input bits, shared by every task of a run where the page allows it */
+  bits: Uint8Array;
+}
+
+/** Runs each algorithm of a comparison on its own worker of a `WorkerPool`. */
+export class ComparisonPool {
+  private readonly pool = new WorkerPool<ComparisonTask, ComparisonResult>(
+    () => new Worker(new URL('./comparisonWorker.ts', import.meta.url), { type: 'module' }),
+    'comparison worker',
+    task => computeComparison(task.bits, task.family, task.algorithm)
+  );
+
+  /** Whether the input of the last `run` was shared rather than copied to each worker. */
+  sharedInput = false;
+
+  run(bits: ArrayLike<number>, family: ComparisonFamily, algorithms: ComparisonAlgorithm[]): Promise<ComparisonResult[]> {
+    const input = sharedCopy(Uint8Array, bits);
+    this.sharedInput = canShareMemory();
+    return this.pool.run(algorithms.map(algorithm => ({ family, algorithm, bits: input })));
+  }
+
+  terminate(): void {
+    this.pool.terminate();
+  }
+}
@@ -0,0 +1,9 @@
+import { ComparisonResult, ComparisonTask, computeComparison } from './comparison';
+import { serveTasks } from './workerPool';
+
+// The waveform's buffer (a plain ArrayBuffer: the result's own copy) is transferred back, not copied
+serveTasks<ComparisonTask, ComparisonResult>(
+  task => task.algorithm,
+  task => computeComparison(task.bits, task.family, task.algorithm),
+  result => [result.samples.buffer as ArrayBuffer]
+);
@@ -0,0 +1,54 @@
+/**
+ * Exact operation counts from the inner loops of the generators and receivers. Every
+ * increment sits behind `if (__SIGNAL_COUNTERS__)`, a Vite `define` that is true only in
+ * the `instrumented` mode (`npm run dev:instrumented`). Ordinary builds fold the test to
+ * `false` and drop the counting code, so the counters cost nothing in production.
+ *
+ * Loops add their counts once per `process` call rather than once per sample where
+ * the count is known up front.
+ */
+export interface HotPathCounters {
+  /** Samples written by sources, modulators and mixers */
+  samplesEmitted: number;
+  /** Math.sin / cos / atan2 calls made to produce or detect those samples */
+  transcendentals: number;
+  /** Growable output buffers reallocated to a larger size */
+  bufferGrowths: number;
+  /** Continuous-phase state committed at a bit boundary */
+  checkpoints: number;
+}
+
+export const hotCounters: HotPathCounters = {
+  samplesEmitted: 0,
+  transcendentals: 0,
+  bufferGrowths: 0,
+  checkpoints: 0,
+};
+
+/** Counts made by the latest run of each instrumented call, by name. */
+const runCounts = new Map<string, HotPathCounters>();
+
+export function hotCounterSnapshot(): HotPathCounters {
+  return { ...hotCounters };
+}
+
+/** Stores and returns what the counters advanced by since `before`, as the latest counts for `name`. */
+export function recordRunCounts(name: string, before: HotPathCounters): HotPathCounters {
+  const counts = {
+    samplesEmitted: hotCounters.samplesEmitted - before.samplesEmitted,
+    transcendentals: hotCounters.transcendentals - before.transcendentals,
+    bufferGrowths: hotCounters.bufferGrowths - before.bufferGrowths,
+    checkpoints: hotCounters.checkpoints - before.checkpoints,
+  };
+  runCounts.set(name, counts);
+  return counts;
+}
+
+/** Latest counts per instrumented call, ordered by name. */
+export function runCountSnapshot(): [string, HotPathCounters][] {
+  return [...runCounts].sort(([a], [b]) => a.localeCompare(b));
+}
+
+export function clearRunCounts(): void {
+  runCounts.clear();
+}
@@ -0,0 +1,145 @@
+import { hotCounters } from './counters';
+
+/**
+ * Continuous-phase modulation (CPFSK, MSK, GMSK) as a table walk.
+ *
+ * Each bit a ∈ {−1, +1} contributes a frequency pulse g(t) lasting `memory` bit periods,
+ * so the carrier phase is
+ *   θ(t) = 2π h Σ a_k q(t − kT),   q(t) = ∫₀ᵗ g,   q(memory·T) = 1/2.
+ * During one bit the phase path depends only on the last `memory` bits, so it is
+ * tabulated once per bit pattern; a modulator then adds the pattern's trajectory to a
+ * phase accumulator that advances by the pattern's whole-bit increment at each boundary.
+ * Patterns are base-3 numbers (0 = no bit, 1 = bit 0, 2 = bit 1) so the start and end of
+ * a transmission, where the pulse window is only partly filled, are table entries too.
+ */
+export interface PhaseTable {
+  /** Bit periods spanned by the frequency pulse */
+  memory: number;
+  samplesPerBit: number;
+  /** Phase relative to the bit start, `samplesPerBit` entries per pattern */
+  trajectories: Float64Array;
+  /** Phase added over a whole bit, per pattern */
+  increments: Float64Array;
+}
+
+// Gaussian pulses longer than this are truncated; BT = 0.2 needs five periods
+const MAX_MEMORY = 6;
+
+const tables = new Map<string, PhaseTable>();
+
+/** Standard deviation of the GMSK Gaussian filter, in bit periods. */
+function gaussianSigma(bandwidthTime: number): number {
+  return Math.sqrt(Math.LN2) / (2 * Math.PI * bandwidthTime);
+}
+
+/** Abramowitz–Stegun 7.1.26; |error| < 1.5e-7, ample for a pulse shape. */
+function erf(x: number): number {
+  const sign = x < 0 ? -1 : 1;
+  const ax = Math.abs(x);
+  const t = 1 / (1 + 0.3275911 * ax);
+  const poly = ((((1.061405429 * t - 1.453152027) * t + 1.421413741) * t - 0.284496736) * t + 0.254829592) * t;
+  return sign * (1 - poly * Math.exp(-ax * ax));
+}
+
+/**
+ * Phase table for a rectangular pulse (`bandwidthTime` omitted: CPFSK, MSK when h = 1/2)
+ * or a Gaussian-filtered one (GMSK). Tables are cached per parameter set.
+ */
+export function phaseTable(modulationIndex: number, samplesPerBit: number, bandwidthTime?: number): PhaseTable {
+  const key = `${modulationIndex}:${samplesPerBit}:${bandwidthTime ?? 'rect'}`;
+  let table = tables.get(key);
+  if (table) return table;
+
+  let memory = 1;
+  let pulse = (_t: number) => 1;
+  if (bandwidthTime !== undefined) {
+    // Rectangular bit convolved with the Gaussian, centred in the truncated window
+    const sigma = gaussianSigma(bandwidthTime);
+    memory = Math.min(MAX_MEMORY, Math.ceil(1 + 6 * sigma));
+    const centre = memory / 2;
+    const scale = 1 / (sigma * Math.SQRT2);
+    pulse = t => erf((t - centre + 0.5) * scale) - erf((t - centre - 0.5) * scale);
+  }
+
+  // q on a grid of samplesPerBit steps per bit (midpoint rule), normalised to q(end) = 1/2
+  const n = samplesPerBit;
+  const q = new Float64Array(memory * n + 1);
+  for (let m = 0; m < memory * n; m++) {
+    q[m + 1] = q[m] + pulse((m + 0.5) / n) / n;
+  }
+  const norm = 0.5 / q[memory * n];
+  for (let m = 0; m <= memory * n; m++) q[m] *= norm;
+
+  const patterns = 3 ** memory;
+  const trajectories = new Float64Array(patterns * n);
+  const increments = new Float64Array(patterns);
+  for (let pattern = 0; pattern < patterns; pattern++) {
+    let digits = pattern;
+    // Digit k (weight 3^k) is the bit sent k periods ago
+    for (let k = 0; k < memory; k++) {
+      const digit = digits % 3;
+      digits = (digits - digit) / 3;
+      if (digit === 0) continue;
+      const a = digit === 2 ? 1 : -1;
+      const weight = 2 * Math.PI * modulationIndex * a;
+      for (let j = 0; j < n; j++) {
+        trajectories[pattern * n + j] += weight * (q[k * n + j] - q[k * n]);
+      }
+      increments[pattern] += weight * (q[(k + 1) * n] - q[k * n]);
+    }
+  }
+
+  table = { memory, samplesPerBit, trajectories, increments };
+  tables.set(key, table);
+  return table;
+}
+
+/** Walks a `PhaseTable`: one pattern shift per bit, one table read per sample. */
+export class PhaseAccumulator {
+  readonly table: PhaseTable;
+  private readonly patterns: number;
+  private pattern = 0;
+  private accumulated = 0;
+  private segmentStart = 0;
+
+  constructor(table: PhaseTable) {
+    this.table = table;
+    this.patterns = 3 ** table.memory;
+  }
+
+  /** Starts the next bit period with `bit`, or with no bit while the pulse window drains. */
+  begin(bit: number | null): void {
+    this.shift(bit === null ? 0 : bit === 1 ? 2 : 1);
+    this.segmentStart = 0;
+  }
+
+  /**
+   * Prepares the tail that lets the last bits' pulses finish and returns its length in
+   * samples (whole periods plus the closing sample at the final phase).
+   */
+  drain(): number {
+    this.begin(null);
+    return (this.table.memory - 1) * this.table.samplesPerBit + 1;
+  }
+
+  /** Carrier phase offset at sample `j` of the current period (tail periods advance on their own). */
+  phase(j: number): number {
+    const n = this.table.samplesPerBit;
+    while (j - this.segmentStart >= n) {
+      this.shift(0);
+      this.segmentStart += n;
+    }
+    return this.accumulated + this.table.trajectories[this.pattern * n + j - this.segmentStart];
+  }
+
+  private shift(digit: number): void {
+    if (__SIGNAL_COUNTERS__) hotCounters.checkpoints++;
+    this.accumulated = (this.accumulated + this.table.increments[this.pattern]) % (2 * Math.PI);
+    this.pattern = (this.pattern * 3 + digit) % this.patterns;
+  }
+}
+
+/** Bit periods a receiver waits before the centre of a bit's frequency pulse has passed. */
+export function decisionDelay(table: PhaseTable): number {
+  return (table.memory - 1) / 2;
+}
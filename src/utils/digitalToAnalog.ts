@@ -1,192 +1,260 @@
-import { DataPoint, DigitalToAnalogAlgorithm } from '../types';
+import { BasebandSignalData, DataPoint, DigitalToAnalogAlgorithm, KeyingConfig, SamplePrecision } from '../types';
+import { InputPort, OutputPort, Pipeline, PipelineOptions, Stage } from './pipeline';
+import { Arena, FloatArray } from './bufferPool';
+import { hotCounters } from './counters';
+import { ComplexSample, VisibleWindow, sinePhasor, upconvert } from './baseband';
+import { AwgnChannel, BitSource, CollectSink, PointSink, StepSink, SymbolMapper, parseBits } from './stages';
+import { PhaseAccumulator, PhaseTable, decisionDelay, phaseTable } from './cpm';
+import { amplitudeSpectrum, occupiedBandwidth } from './fft';
+import { generateChirpSignal } from './chirp';
+import { Random } from './random';
+
+const bitDuration = 1;
+const samplesPerBit = 100;
+// Every keying's spectrum is centred on 5 Hz (the FSK tones sit symmetrically around it)
+const carrierFrequency = 5;
+// Envelope rate of the baseband path: the widest envelope (MFSK, ±3 Hz) stays below Nyquist
+export const basebandSamplesPerBit = 16;
+
+export const defaultKeyingConfig: KeyingConfig = {
+  modulationIndex: 1,
+  bandwidthTime: 0.3,
+  spreadingFactor: 7,
+};
 
 /**
  * Generates digital-to-analog modulation signal data.
  * 
  * @param binaryInput - Binary string (0s and 1s)
- * @param algorithm - Modulation technique (ASK, BFSK, MFSK, BPSK, DPSK, QPSK, OQPSK, MPSK, or QAM)
+ * @param algorithm - Modulation technique (ASK, BFSK, MFSK, BPSK, DPSK, QPSK, OQPSK, MPSK, QAM, CPFSK, MSK, GMSK, or CSS)
+ * @param config - Modulation index, Gaussian BT and spreading factor for the keyings that use them
  * @returns Object containing input, transmitted, and output signal data
  * @throws Error if binary input is invalid
  */
 export function generateDigitalToAnalogSignal(
   binaryInput: string,
-  algorithm: DigitalToAnalogAlgorithm
+  algorithm: DigitalToAnalogAlgorithm,
+  config: KeyingConfig = defaultKeyingConfig
 ): { input: DataPoint[]; transmitted: DataPoint[]; output: DataPoint[] } {
-  const bits = binaryInput.split('').map(b => parseInt(b));
-  const bitDuration = 1;
-  const samplesPerBit = 100;
-
-  const inputSignal: DataPoint[] = [];
-  for (let i = 0; i < bits.length; i++) {
-    inputSignal.push({ x: i * bitDuration, y: bits[i] });
-    inputSignal.push({ x: (i + 1) * bitDuration, y: bits[i] });
+  if (algorithm === 'CSS') return generateChirpSignal(binaryInput, config.spreadingFactor);
+  const arena = new Arena();
+  try {
+    const bits = parseBits(binaryInput, arena);
+    const { pipeline, input, transmitted } = buildDigitalToAnalogGraph(bits, algorithm, {
+      arena,
+      keying: config,
+      closeSymbols: true,
+    });
+    pipeline.run();
+
+    return {
+      input: input.points,
+      transmitted: transmitted.points,
+      output: input.points,
+    };
+  } finally {
+    arena.release();
+  }
+}
+
+/**
+ * Preset graph for modulation: bits → (symbol mapper) → modulator → transmitted waveform,
+ * with the source bits drawn alongside as the reference input. `closeSymbols` draws the
+ * waveform as the charts do, each symbol with its own closing sample (see `Modulator`).
+ */
+export function buildDigitalToAnalogGraph(
+  bits: ArrayLike<number>,
+  algorithm: DigitalToAnalogAlgorithm,
+  options: PipelineOptions & { keying?: KeyingConfig; closeSymbols?: boolean } = {}
+): { pipeline: Pipeline; input: StepSink; transmitted: PointSink } {
+  const modulator = new Modulator(algorithm, bitDuration, samplesPerBit, options.keying, options.closeSymbols);
+  const input = new StepSink('bits', 1 / bitDuration);
+  const transmitted = new PointSink(
+    'real',
+    samplesPerBit / bitDuration,
+    false,
+    modulator.closesSymbols ? modulator.samplesPerSymbol : 0
+  );
+
+  const pipeline = new Pipeline(options)
+    .add('source', new BitSource(bits))
+    .add('input', input)
+    .add('modulator', modulator)
+    .add('transmitted', transmitted)
+    .connect('source', 'input')
+    .connect('modulator', 'transmitted');
+
+  if (modulator.bitsPerSymbol > 1) {
+    pipeline.add('mapper', new SymbolMapper(modulator.bitsPerSymbol)).connect('source', 'mapper').connect('mapper', 'modulator');
+  } else {
+    pipeline.connect('source', 'modulator');
   }
 
-  let transmittedSignal: DataPoint[] = [];
+  return { pipeline, input, transmitted };
+}
+
+/**
+ * Waveform of one keying scheme. `begin` is called with each symbol (a bit for binary
+ * schemes, an M-ary index otherwise) and `sample` for every sample in that symbol;
+ * `j` counts samples from the start of the symbol.
+ */
+interface Keying {
+  bitsPerSymbol: number;
+  begin(symbol: number): void;
+  sample(t: number, j: number): number;
+  /** Math.sin / cos calls per `sample`, for the hot-path counters */
+  transcendentals: number;
+  /** Whether a drawn symbol ends on its own closing sample, at the instant the next one starts */
+  closesSymbols: boolean;
+  /** Prepares the trailing samples after the last symbol and returns how many there are */
+  finish(): number;
+}
 
+function createKeying(
+  algorithm: DigitalToAnalogAlgorithm,
+  samplesPerBit: number,
+  config: KeyingConfig
+): Keying {
   switch (algorithm) {
     case 'ASK':
-      transmittedSignal = generateASK(bits, bitDuration, samplesPerBit);
-      break;
+      return askKeying();
     case 'BFSK':
-      transmittedSignal = generateBFSK(bits, bitDuration, samplesPerBit);
-      break;
+      return bfskKeying();
     case 'MFSK':
-      transmittedSignal = generateMFSK(bits, bitDuration, samplesPerBit);
-      break;
+      return mfskKeying();
     case 'BPSK':
-      transmittedSignal = generateBPSK(bits, bitDuration, samplesPerBit);
-      break;
+      return bpskKeying();
     case 'DPSK':
-      transmittedSignal = generateDPSK(bits, bitDuration, samplesPerBit);
-      break;
+      return dpskKeying();
     case 'QPSK':
-      transmittedSignal = generateQPSK(bits, bitDuration, samplesPerBit);
-      break;
+      return qpskKeying();
     case 'OQPSK':
-      transmittedSignal = generateOQPSK(bits, bitDuration, samplesPerBit);
-      break;
+      return oqpskKeying(samplesPerBit);
     case 'MPSK':
-      transmittedSignal = generateMPSK(bits, bitDuration, samplesPerBit);
-      break;
+      return mpskKeying();
     case 'QAM':
-      transmittedSignal = generateQAM(bits, bitDuration, samplesPerBit);
-      break;
+      return qamKeying();
+    case 'CPFSK':
+    case 'MSK':
+    case 'GMSK':
+      return continuousPhaseKeying(continuousPhaseTable(algorithm, samplesPerBit, config));
+    case 'CSS':
+      throw new Error('CSS runs at its chip rate; use generateChirpSignal');
     default:
       throw new Error(`Unknown algorithm: ${algorithm}`);
   }
-
-  return {
-    input: inputSignal,
-    transmitted: transmittedSignal,
-    output: inputSignal,
-  };
 }
 
+// Waveforms close with one extra sample at the end of the last symbol
+const closingSample = () => 1;
+
 /**
- * Generates ASK (Amplitude Shift Keying) signal.
+ * ASK (Amplitude Shift Keying).
  * Bit 1 = high amplitude, Bit 0 = low amplitude.
  */
-function generateASK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function askKeying(): Keying {
   const carrierFreq = 5;
-
-  for (let i = 0; i < bits.length; i++) {
-    const amplitude = bits[i] === 1 ? 1 : 0.2;
-    for (let j = 0; j <= samplesPerBit; j++) {
-      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
-      const y = amplitude * Math.sin(2 * Math.PI * carrierFreq * t);
-      signal.push({ x: t, y });
-    }
-  }
-  return signal;
+  let amplitude = 0;
+  return {
+    bitsPerSymbol: 1,
+    begin: bit => {
+      amplitude = bit === 1 ? 1 : 0.2;
+    },
+    sample: t => amplitude * Math.sin(2 * Math.PI * carrierFreq * t),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
 }
 
 /**
- * Generates BFSK (Binary Frequency Shift Keying) signal.
+ * BFSK (Binary Frequency Shift Keying).
  * Bit 1 = high frequency, Bit 0 = low frequency.
  */
-function generateBFSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function bfskKeying(): Keying {
   const freq0 = 3;  // Frequency for bit 0
   const freq1 = 7;  // Frequency for bit 1
-
-  for (let i = 0; i < bits.length; i++) {
-    const frequency = bits[i] === 1 ? freq1 : freq0;
-    for (let j = 0; j <= samplesPerBit; j++) {
-      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
-      const y = Math.sin(2 * Math.PI * frequency * t);
-      signal.push({ x: t, y });
-    }
-  }
-  return signal;
+  let frequency = freq0;
+  return {
+    bitsPerSymbol: 1,
+    begin: bit => {
+      frequency = bit === 1 ? freq1 : freq0;
+    },
+    sample: t => Math.sin(2 * Math.PI * frequency * t),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
 }
 
 /**
- * Generates MFSK (M-ary Frequency Shift Keying) signal.
+ * MFSK (M-ary Frequency Shift Keying).
  * Uses 4 frequencies (M=4) for 2-bit symbols: 00, 01, 10, 11
  */
-function generateMFSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function mfskKeying(): Keying {
   // 4-FSK: 4 different frequencies for 2 bits per symbol
   const frequencies = [2, 4, 6, 8]; // f00, f01, f10, f11
-  const symbolDuration = bitDuration * 2; // Each symbol = 2 bits
-  const samplesPerSymbol = samplesPerBit * 2;
-
-  // Pad bits to even number
-  const paddedBits = bits.length % 2 === 0 ? bits : [...bits, 0];
-  const numSymbols = paddedBits.length / 2;
-
-  for (let i = 0; i < numSymbols; i++) {
-    const bit1 = paddedBits[i * 2];
-    const bit2 = paddedBits[i * 2 + 1];
-    const symbolValue = bit1 * 2 + bit2; // 00=0, 01=1, 10=2, 11=3
-    const freq = frequencies[symbolValue];
-
-    for (let j = 0; j <= samplesPerSymbol; j++) {
-      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
-      const y = Math.sin(2 * Math.PI * freq * t);
-      signal.push({ x: t, y });
-    }
-  }
-
-  return signal;
+  let freq = frequencies[0];
+  return {
+    bitsPerSymbol: 2,
+    begin: symbolValue => {
+      freq = frequencies[symbolValue];
+    },
+    sample: t => Math.sin(2 * Math.PI * freq * t),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
 }
 
 /**
- * Generates BPSK (Binary Phase Shift Keying) signal.
+ * BPSK (Binary Phase Shift Keying).
  * Bit 1 = 0° phase, Bit 0 = 180° phase.
  */
-function generateBPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function bpskKeying(): Keying {
   const carrierFreq = 5;
-
-  for (let i = 0; i < bits.length; i++) {
-    const phaseShift = bits[i] === 1 ? 0 : Math.PI;
-    for (let j = 0; j <= samplesPerBit; j++) {
-      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
-      const y = Math.sin(2 * Math.PI * carrierFreq * t + phaseShift);
-      signal.push({ x: t, y });
-    }
-  }
-  return signal;
+  let phaseShift = 0;
+  return {
+    bitsPerSymbol: 1,
+    begin: bit => {
+      phaseShift = bit === 1 ? 0 : Math.PI;
+    },
+    sample: t => Math.sin(2 * Math.PI * carrierFreq * t + phaseShift),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
 }
 
 /**
- * Generates DPSK (Differential Phase Shift Keying) signal.
+ * DPSK (Differential Phase Shift Keying).
  * Phase changes (0° or 180°) are relative to the previous bit.
  * Bit 1 = no phase change, Bit 0 = 180° phase change.
  */
-function generateDPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function dpskKeying(): Keying {
   const carrierFreq = 5;
   let currentPhase = 0; // Start with reference phase
-
-  for (let i = 0; i < bits.length; i++) {
-    // In DPSK, bit 0 causes phase change, bit 1 keeps same phase
-    if (bits[i] === 0) {
-      currentPhase += Math.PI;
-    }
-
-    for (let j = 0; j <= samplesPerBit; j++) {
-      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
-      const y = Math.sin(2 * Math.PI * carrierFreq * t + currentPhase);
-      signal.push({ x: t, y });
-    }
-  }
-  return signal;
+  return {
+    bitsPerSymbol: 1,
+    begin: bit => {
+      // In DPSK, bit 0 causes phase change, bit 1 keeps same phase
+      if (bit === 0) {
+        currentPhase += Math.PI;
+      }
+    },
+    sample: t => Math.sin(2 * Math.PI * carrierFreq * t + currentPhase),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
 }
 
 /**
- * Generates QPSK (Quadrature Phase Shift Keying) signal.
+ * QPSK (Quadrature Phase Shift Keying).
  * Uses 4 phase states (45°, 135°, 225°, 315°) for 2-bit symbols.
  */
-function generateQPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function qpskKeying(): Keying {
   const carrierFreq = 5;
-  const symbolDuration = bitDuration * 2; // Each symbol = 2 bits
-  const samplesPerSymbol = samplesPerBit * 2;
-
   // Phase mapping for QPSK: 00=45°, 01=135°, 10=315°, 11=225°
   const phaseMap = [
     Math.PI / 4,       // 00 → 45°
@@ -194,149 +262,749 @@ function generateQPSK(bits: number[], bitDuration: number, samplesPerBit: number
     7 * Math.PI / 4,   // 10 → 315°
     5 * Math.PI / 4    // 11 → 225°
   ];
+  let phase = phaseMap[0];
+  return {
+    bitsPerSymbol: 2,
+    begin: symbolValue => {
+      phase = phaseMap[symbolValue];
+    },
+    sample: t => Math.sin(2 * Math.PI * carrierFreq * t + phase),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
+}
+
+/**
+ * OQPSK (Offset Quadrature Phase Shift Keying).
+ * Similar to QPSK but with Q-channel delayed by half a symbol period.
+ * This limits phase transitions to 90° maximum.
+ */
+function oqpskKeying(samplesPerBit: number): Keying {
+  const carrierFreq = 5;
+  const halfSymbolSamples = samplesPerBit; // Q offset by half symbol
+  const qDelay = halfSymbolSamples / 2;
+  let iValue = 0;
+  let qValue = 0;
+  let previousQ = 0; // Q level still on air until the offset has elapsed
+  return {
+    bitsPerSymbol: 2,
+    begin: symbolValue => {
+      // Even bits → I channel, odd bits → Q channel
+      previousQ = qValue;
+      iValue = (symbolValue >> 1) === 1 ? 1 : -1;
+      qValue = (symbolValue & 1) === 1 ? 1 : -1;
+    },
+    // Generate OQPSK: I(t)*cos(wt) + Q(t-T/2)*sin(wt)
+    sample: (t, j) => {
+      const q = j < qDelay ? previousQ : qValue;
+      return iValue * Math.cos(2 * Math.PI * carrierFreq * t) + q * Math.sin(2 * Math.PI * carrierFreq * t);
+    },
+    transcendentals: 2,
+    closesSymbols: false,
+    // The delayed Q channel runs on for half a symbol after I has stopped
+    finish: () => {
+      previousQ = qValue;
+      iValue = 0;
+      qValue = 0;
+      return halfSymbolSamples;
+    },
+  };
+}
+
+/**
+ * MPSK (M-ary Phase Shift Keying).
+ * Uses 8 phase states (M=8) for 3-bit symbols.
+ */
+function mpskKeying(): Keying {
+  const carrierFreq = 5;
+  const M = 8; // 8-PSK
+  let phase = 0;
+  return {
+    bitsPerSymbol: 3,
+    begin: symbolValue => {
+      phase = (symbolValue / M) * 2 * Math.PI; // Uniform phase distribution
+    },
+    sample: t => Math.sin(2 * Math.PI * carrierFreq * t + phase),
+    transcendentals: 1,
+    closesSymbols: true,
+    finish: closingSample,
+  };
+}
 
-  // Pad bits to even number
-  const paddedBits = bits.length % 2 === 0 ? bits : [...bits, 0];
-  const numSymbols = paddedBits.length / 2;
+/**
+ * QAM (Quadrature Amplitude Modulation).
+ * Uses 16-QAM: 4 amplitude levels × 4 phase states for 4-bit symbols.
+ */
+function qamKeying(): Keying {
+  const carrierFreq = 5;
+  // 16-QAM constellation: 4x4 grid
+  // I levels: -3, -1, +1, +3 (normalized)
+  // Q levels: -3, -1, +1, +3 (normalized)
+  const levels = [-3, -1, 1, 3];
+  let iAmplitude = 0;
+  let qAmplitude = 0;
+  return {
+    bitsPerSymbol: 4,
+    begin: symbolValue => {
+      // Gray coding for I (bits 1,2) and Q (bits 3,4) channels
+      const iIndex = symbolValue >> 2;
+      const qIndex = symbolValue & 3;
+      iAmplitude = levels[iIndex] / 3; // Normalize to ±1 range
+      qAmplitude = levels[qIndex] / 3;
+    },
+    sample: t => iAmplitude * Math.cos(2 * Math.PI * carrierFreq * t) + qAmplitude * Math.sin(2 * Math.PI * carrierFreq * t),
+    transcendentals: 2,
+    closesSymbols: true,
+    finish: closingSample,
+  };
+}
 
-  for (let i = 0; i < numSymbols; i++) {
-    const bit1 = paddedBits[i * 2];
-    const bit2 = paddedBits[i * 2 + 1];
-    const symbolValue = bit1 * 2 + bit2;
-    const phase = phaseMap[symbolValue];
+function isContinuousPhase(algorithm: DigitalToAnalogAlgorithm): boolean {
+  return algorithm === 'CPFSK' || algorithm === 'MSK' || algorithm === 'GMSK';
+}
 
-    for (let j = 0; j <= samplesPerSymbol; j++) {
-      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
-      const y = Math.sin(2 * Math.PI * carrierFreq * t + phase);
-      signal.push({ x: t, y });
-    }
+/** CPFSK uses the configured index; MSK is CPFSK with h = 1/2 and GMSK Gaussian-filters MSK's pulse. */
+function continuousPhaseTable(
+  algorithm: DigitalToAnalogAlgorithm,
+  samplesPerBit: number,
+  config: KeyingConfig
+): PhaseTable {
+  switch (algorithm) {
+    case 'CPFSK':
+      return phaseTable(config.modulationIndex, samplesPerBit);
+    case 'MSK':
+      return phaseTable(0.5, samplesPerBit);
+    case 'GMSK':
+      return phaseTable(0.5, samplesPerBit, config.bandwidthTime);
+    default:
+      throw new Error(`${algorithm} is not a continuous-phase scheme`);
   }
-
-  return signal;
 }
 
 /**
- * Generates OQPSK (Offset Quadrature Phase Shift Keying) signal.
- * Similar to QPSK but with Q-channel delayed by half a symbol period.
- * This limits phase transitions to 90° maximum.
+ * CPFSK / MSK / GMSK: sin(2π fc t + θ(t)), with θ walked from the phase table, so the
+ * phase never jumps at a bit boundary. Bit 1 raises the frequency, bit 0 lowers it. The
+ * tail lets the last bits' frequency pulses run out (one period each for GMSK's memory).
  */
-function generateOQPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
-  const carrierFreq = 5;
+function continuousPhaseKeying(table: PhaseTable): Keying {
+  const accumulator = new PhaseAccumulator(table);
+  return {
+    bitsPerSymbol: 1,
+    begin: bit => accumulator.begin(bit),
+    sample: (t, j) => Math.sin(2 * Math.PI * carrierFrequency * t + accumulator.phase(j)),
+    transcendentals: 1,
+    closesSymbols: false,
+    finish: () => accumulator.drain(),
+  };
+}
 
-  // Pad bits to even number
-  const paddedBits = bits.length % 2 === 0 ? bits : [...bits, 0];
-  const numSymbols = paddedBits.length / 2;
+/**
+ * Streams bits (binary schemes) or symbols (M-ary schemes) into a passband waveform
+ * sampled at `samplesPerBit / bitDuration`. With `closeSymbols`, the keyings that draw
+ * symbol by symbol also emit each symbol's closing sample, so every symbol spans
+ * `samplesPerSymbol + 1` samples and shares its end instant with the next symbol's
+ * start: the layout the charts draw, with a vertical step at each boundary. The
+ * continuous stream (the default) is the one channels and receivers take.
+ */
+export class Modulator implements Stage {
+  readonly name: string;
+  readonly inputs: readonly ['bits'] | readonly ['symbols'];
+  readonly outputs = ['real'] as const;
+  readonly bitsPerSymbol: number;
+  readonly samplesPerSymbol: number;
+  readonly closesSymbols: boolean;
+  private readonly keying: Keying;
+  private readonly sampleRate: number;
+  private symbolStart = 0;
+  private symbolSample = 0;
+  private remaining = 0;
+  private symbols = 0;
+  private finished = false;
+
+  constructor(
+    algorithm: DigitalToAnalogAlgorithm,
+    bitDuration: number,
+    samplesPerBit: number,
+    config: KeyingConfig = defaultKeyingConfig,
+    closeSymbols = false
+  ) {
+    this.name = `${algorithm} modulator`;
+    this.keying = createKeying(algorithm, samplesPerBit, config);
+    this.bitsPerSymbol = this.keying.bitsPerSymbol;
+    this.inputs = this.bitsPerSymbol === 1 ? ['bits'] : ['symbols'];
+    this.sampleRate = samplesPerBit / bitDuration;
+    this.samplesPerSymbol = samplesPerBit * this.bitsPerSymbol;
+    this.closesSymbols = closeSymbols && this.keying.closesSymbols;
+  }
 
-  // Extract I and Q bits
-  const iBits: number[] = [];
-  const qBits: number[] = [];
-  for (let i = 0; i < numSymbols; i++) {
-    iBits.push(paddedBits[i * 2]);     // Even bits → I channel
-    qBits.push(paddedBits[i * 2 + 1]); // Odd bits → Q channel
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const signal = output.data;
+
+    for (;;) {
+      const first = output.length;
+      while (this.remaining > 0 && output.length < output.capacity) {
+        signal[output.length++] = this.keying.sample((this.symbolStart + this.symbolSample) / this.sampleRate, this.symbolSample);
+        this.symbolSample++;
+        this.remaining--;
+      }
+      if (__SIGNAL_COUNTERS__) {
+        hotCounters.samplesEmitted += output.length - first;
+        hotCounters.transcendentals += (output.length - first) * this.keying.transcendentals;
+      }
+      if (this.remaining > 0) return false;
+
+      if (this.finished) return true;
+      if (input.offset < input.length) {
+        this.keying.begin(input.data[input.offset++]);
+        this.symbolStart = this.symbols * this.samplesPerSymbol;
+        this.symbolSample = 0;
+        this.remaining = this.closesSymbols ? this.samplesPerSymbol + 1 : this.samplesPerSymbol;
+        this.symbols++;
+      } else if (input.ended) {
+        this.symbolStart = this.symbols * this.samplesPerSymbol;
+        this.symbolSample = 0;
+        // A closed last symbol has already emitted its closing sample
+        this.remaining = this.symbols > 0 && !this.closesSymbols ? this.keying.finish() : 0;
+        this.finished = true;
+      } else {
+        return false;
+      }
+    }
   }
+}
 
-  const symbolDuration = bitDuration * 2;
-  const samplesPerSymbol = samplesPerBit * 2;
-  const halfSymbolSamples = samplesPerBit; // Q offset by half symbol
-  const totalSamples = numSymbols * samplesPerSymbol + halfSymbolSamples;
+/**
+ * Coherent BPSK receiver: correlates each symbol with the carrier `sin(2π f t)` used by
+ * the BPSK keying and decides the bit from the sign. Samples after the last full
+ * symbol (the modulator's closing sample) are ignored.
+ */
+export class BpskDemodulator implements Stage {
+  readonly name = 'BPSK demodulator';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly carrierFrequency: number;
+  private readonly sampleRate: number;
+  private readonly samplesPerSymbol: number;
+  private sampleIndex = 0;
+  private symbolSample = 0;
+  private correlation = 0;
+
+  constructor(carrierFrequency: number, sampleRate: number, samplesPerSymbol: number) {
+    this.carrierFrequency = carrierFrequency;
+    this.sampleRate = sampleRate;
+    this.samplesPerSymbol = samplesPerSymbol;
+  }
 
-  // Generate OQPSK: I(t)*cos(wt) + Q(t-T/2)*sin(wt)
-  for (let sample = 0; sample < totalSamples; sample++) {
-    const t = (sample / samplesPerSymbol) * symbolDuration;
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    while (input.offset < input.length) {
+      if (this.symbolSample === this.samplesPerSymbol - 1 && output.length >= output.capacity) return false;
+      const t = this.sampleIndex++ / this.sampleRate;
+      this.correlation += input.data[input.offset++] * Math.sin(2 * Math.PI * this.carrierFrequency * t);
+      if (__SIGNAL_COUNTERS__) hotCounters.transcendentals++;
+      if (++this.symbolSample === this.samplesPerSymbol) {
+        output.data[output.length++] = this.correlation >= 0 ? 1 : 0;
+        this.correlation = 0;
+        this.symbolSample = 0;
+      }
+    }
+    return input.ended;
+  }
+}
 
-    // Determine which symbol we're in for I channel
-    const iSymbolIdx = Math.floor(sample / samplesPerSymbol);
-    // Q channel is offset by half symbol
-    const qSymbolIdx = Math.floor((sample - halfSymbolSamples / 2) / samplesPerSymbol);
+// ---------------------------------------------------------------------------
+// Complex baseband
+// ---------------------------------------------------------------------------
 
-    const iValue = iSymbolIdx >= 0 && iSymbolIdx < iBits.length
-      ? (iBits[iSymbolIdx] === 1 ? 1 : -1)
-      : 0;
-    const qValue = qSymbolIdx >= 0 && qSymbolIdx < qBits.length
-      ? (qBits[qSymbolIdx] === 1 ? 1 : -1)
+/**
+ * Simulates the modulation on its complex envelope at `basebandSamplesPerBit`, demodulates
+ * it, and upconverts to the passband only for `window` (the whole signal by default).
+ */
+export function generateDigitalToAnalogBaseband(
+  binaryInput: string,
+  algorithm: DigitalToAnalogAlgorithm,
+  window?: VisibleWindow,
+  config: KeyingConfig = defaultKeyingConfig
+): BasebandSignalData {
+  const arena = new Arena();
+  try {
+    const bits = parseBits(binaryInput, arena);
+    const { pipeline, input, envelope, output } = buildDigitalToAnalogBasebandGraph(bits, algorithm, {
+      arena,
+      keying: config,
+    });
+    pipeline.run();
+
+    const i = envelope.values;
+    // Both paths emit whole symbols plus the same tail (a closing sample, OQPSK's half
+    // symbol, or the continuous-phase pulse run-out), which a fresh keying reports
+    const basebandTail = createBasebandKeying(algorithm, basebandSamplesPerBit, config).finish();
+    const passbandTail = createKeying(algorithm, samplesPerBit, config).finish();
+    const symbolSamples = i.length - basebandTail;
+    const passbandSamples = i.length > 0
+      ? (symbolSamples / basebandSamplesPerBit) * samplesPerBit + passbandTail
       : 0;
+    const transmitted = upconvert(
+      i,
+      envelope.imagValues,
+      basebandSamplesPerBit / bitDuration,
+      carrierFrequency,
+      samplesPerBit / bitDuration,
+      window ?? { start: 0, end: ((passbandSamples - 1) / samplesPerBit) * bitDuration }
+    );
+
+    return {
+      input: input.points,
+      transmitted,
+      // The mapper zero-pads the last symbol; only the transmitted bits are shown
+      output: output.points.slice(0, 2 * bits.length),
+      basebandSamples: i.length,
+      passbandSamples,
+    };
+  } finally {
+    arena.release();
+  }
+}
+
+/**
+ * Baseband preset: bits → (symbol mapper) → I/Q modulator → (complex AWGN) → receiver → bits.
+ * `noiseSigma` is per I/Q component.
+ */
+export function buildDigitalToAnalogBasebandGraph(
+  bits: ArrayLike<number>,
+  algorithm: DigitalToAnalogAlgorithm,
+  options: PipelineOptions & { noiseSigma?: number; seed?: number; keying?: KeyingConfig } = {}
+): { pipeline: Pipeline; input: StepSink; envelope: CollectSink; output: StepSink } {
+  const modulator = new BasebandModulator(algorithm, bitDuration, basebandSamplesPerBit, options.keying);
+  const input = new StepSink('bits', 1 / bitDuration);
+  const envelope = new CollectSink('complex');
+  const output = new StepSink('bits', 1 / bitDuration);
+
+  const pipeline = new Pipeline(options)
+    .add('source', new BitSource(bits))
+    .add('input', input)
+    .add('modulator', modulator)
+    .add('envelope', envelope)
+    .add('receiver', new BasebandDemodulator(algorithm, bitDuration, basebandSamplesPerBit, options.keying))
+    .add('output', output)
+    .connect('source', 'input')
+    .connect('modulator', 'envelope')
+    .connect('receiver', 'output');
+
+  if (modulator.bitsPerSymbol > 1) {
+    pipeline.add('mapper', new SymbolMapper(modulator.bitsPerSymbol)).connect('source', 'mapper').connect('mapper', 'modulator');
+  } else {
+    pipeline.connect('source', 'modulator');
+  }
 
-    const y = iValue * Math.cos(2 * Math.PI * carrierFreq * t) + qValue * Math.sin(2 * Math.PI * carrierFreq * t);
-    signal.push({ x: t, y });
+  if (options.noiseSigma) {
+    pipeline
+      .add('channel', new AwgnChannel(options.noiseSigma, options.seed, 'complex'))
+      .connect('modulator', 'channel')
+      .connect('channel', 'receiver');
+  } else {
+    pipeline.connect('modulator', 'receiver');
   }
 
-  return signal;
+  return { pipeline, input, envelope, output };
 }
 
 /**
- * Generates MPSK (M-ary Phase Shift Keying) signal.
- * Uses 8 phase states (M=8) for 3-bit symbols.
+ * Complex envelope of one keying scheme relative to the 5 Hz carrier; the same
+ * begin/sample/finish protocol as `Keying`, writing I/Q into `out`.
  */
-function generateMPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
-  const carrierFreq = 5;
-  const M = 8; // 8-PSK
-  const bitsPerSymbol = 3;
-  const symbolDuration = bitDuration * bitsPerSymbol;
-  const samplesPerSymbol = samplesPerBit * bitsPerSymbol;
-
-  // Pad bits to multiple of 3
-  const remainder = bits.length % bitsPerSymbol;
-  const paddedBits = remainder === 0 ? bits : [...bits, ...new Array(bitsPerSymbol - remainder).fill(0)];
-  const numSymbols = paddedBits.length / bitsPerSymbol;
-
-  for (let i = 0; i < numSymbols; i++) {
-    const bit1 = paddedBits[i * bitsPerSymbol];
-    const bit2 = paddedBits[i * bitsPerSymbol + 1];
-    const bit3 = paddedBits[i * bitsPerSymbol + 2];
-    const symbolValue = bit1 * 4 + bit2 * 2 + bit3; // 0 to 7
-    const phase = (symbolValue / M) * 2 * Math.PI; // Uniform phase distribution
-
-    for (let j = 0; j <= samplesPerSymbol; j++) {
-      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
-      const y = Math.sin(2 * Math.PI * carrierFreq * t + phase);
-      signal.push({ x: t, y });
+interface BasebandKeying {
+  bitsPerSymbol: number;
+  begin(symbol: number): void;
+  sample(t: number, j: number, out: ComplexSample): void;
+  finish(): number;
+}
+
+function createBasebandKeying(
+  algorithm: DigitalToAnalogAlgorithm,
+  samplesPerBit: number,
+  config: KeyingConfig
+): BasebandKeying {
+  switch (algorithm) {
+    case 'ASK': {
+      let amplitude = 0;
+      return {
+        bitsPerSymbol: 1,
+        begin: bit => {
+          amplitude = bit === 1 ? 1 : 0.2;
+        },
+        sample: (_t, _j, out) => {
+          out.i = 0;
+          out.q = -amplitude;
+        },
+        finish: closingSample,
+      };
+    }
+    case 'BFSK':
+      return fskEnvelope(1, [3, 7]);
+    case 'MFSK':
+      return fskEnvelope(2, [2, 4, 6, 8]);
+    case 'BPSK':
+      return pskEnvelope(1, symbol => (symbol === 1 ? 0 : Math.PI));
+    case 'DPSK': {
+      let currentPhase = 0;
+      return {
+        bitsPerSymbol: 1,
+        begin: bit => {
+          if (bit === 0) currentPhase += Math.PI;
+        },
+        sample: (_t, _j, out) => sinePhasor(currentPhase, out),
+        finish: closingSample,
+      };
+    }
+    case 'QPSK': {
+      const phaseMap = [Math.PI / 4, (3 * Math.PI) / 4, (7 * Math.PI) / 4, (5 * Math.PI) / 4];
+      return pskEnvelope(2, symbol => phaseMap[symbol]);
+    }
+    case 'OQPSK': {
+      // Same quarter-symbol Q offset as the passband keying
+      const qDelay = samplesPerBit / 2;
+      let iValue = 0;
+      let qValue = 0;
+      let previousQ = 0;
+      return {
+        bitsPerSymbol: 2,
+        begin: symbol => {
+          previousQ = qValue;
+          iValue = (symbol >> 1) === 1 ? 1 : -1;
+          qValue = (symbol & 1) === 1 ? 1 : -1;
+        },
+        // I cos(ωt) + q sin(ωt) has envelope I = i, Q = −q
+        sample: (_t, j, out) => {
+          out.i = iValue;
+          out.q = -(j < qDelay ? previousQ : qValue);
+        },
+        finish: () => {
+          previousQ = qValue;
+          iValue = 0;
+          qValue = 0;
+          return samplesPerBit;
+        },
+      };
     }
+    case 'MPSK':
+      return pskEnvelope(3, symbol => (symbol / 8) * 2 * Math.PI);
+    case 'QAM': {
+      const levels = [-3, -1, 1, 3];
+      let iAmplitude = 0;
+      let qAmplitude = 0;
+      return {
+        bitsPerSymbol: 4,
+        begin: symbol => {
+          iAmplitude = levels[symbol >> 2] / 3;
+          qAmplitude = levels[symbol & 3] / 3;
+        },
+        sample: (_t, _j, out) => {
+          out.i = iAmplitude;
+          out.q = -qAmplitude;
+        },
+        finish: closingSample,
+      };
+    }
+    case 'CPFSK':
+    case 'MSK':
+    case 'GMSK': {
+      const accumulator = new PhaseAccumulator(continuousPhaseTable(algorithm, samplesPerBit, config));
+      return {
+        bitsPerSymbol: 1,
+        begin: bit => accumulator.begin(bit),
+        sample: (_t, j, out) => sinePhasor(accumulator.phase(j), out),
+        finish: () => accumulator.drain(),
+      };
+    }
+    case 'CSS':
+      throw new Error('CSS runs at its chip rate; use generateChirpSignal');
+    default:
+      throw new Error(`Unknown algorithm: ${algorithm}`);
+  }
+}
+
+/** sin(2π fc t + φ(symbol)) */
+function pskEnvelope(bitsPerSymbol: number, phaseOf: (symbol: number) => number): BasebandKeying {
+  let phase = 0;
+  return {
+    bitsPerSymbol,
+    begin: symbol => {
+      phase = phaseOf(symbol);
+    },
+    sample: (_t, _j, out) => sinePhasor(phase, out),
+    finish: closingSample,
+  };
+}
+
+/** sin(2π f t) = sin(2π fc t + 2π (f − fc) t): the envelope rotates at the tone's offset. */
+function fskEnvelope(bitsPerSymbol: number, frequencies: number[]): BasebandKeying {
+  let offset = frequencies[0] - carrierFrequency;
+  return {
+    bitsPerSymbol,
+    begin: symbol => {
+      offset = frequencies[symbol] - carrierFrequency;
+    },
+    sample: (t, _j, out) => sinePhasor(2 * Math.PI * offset * t, out),
+    finish: closingSample,
+  };
+}
+
+/** Complex-envelope counterpart of `Modulator`, sampled at `samplesPerBit / bitDuration`. */
+export class BasebandModulator implements Stage {
+  readonly name: string;
+  readonly inputs: readonly ('bits' | 'symbols')[];
+  readonly outputs = ['complex'] as const;
+  readonly bitsPerSymbol: number;
+  private readonly keying: BasebandKeying;
+  private readonly sampleRate: number;
+  private readonly samplesPerSymbol: number;
+  private readonly envelope: ComplexSample = { i: 0, q: 0 };
+  private sampleIndex = 0;
+  private symbolSample = 0;
+  private remaining = 0;
+  private symbols = 0;
+  private finished = false;
+
+  constructor(
+    algorithm: DigitalToAnalogAlgorithm,
+    bitDuration: number,
+    samplesPerBit: number,
+    config: KeyingConfig = defaultKeyingConfig
+  ) {
+    this.name = `${algorithm} baseband modulator`;
+    this.keying = createBasebandKeying(algorithm, samplesPerBit, config);
+    this.bitsPerSymbol = this.keying.bitsPerSymbol;
+    this.inputs = this.bitsPerSymbol === 1 ? ['bits'] : ['symbols'];
+    this.sampleRate = samplesPerBit / bitDuration;
+    this.samplesPerSymbol = samplesPerBit * this.bitsPerSymbol;
   }
 
-  return signal;
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const envelope = this.envelope;
+
+    for (;;) {
+      const first = output.length;
+      while (this.remaining > 0 && output.length < output.capacity) {
+        this.keying.sample(this.sampleIndex / this.sampleRate, this.symbolSample, envelope);
+        output.data[output.length] = envelope.i;
+        output.imag![output.length] = envelope.q;
+        output.length++;
+        this.sampleIndex++;
+        this.symbolSample++;
+        this.remaining--;
+      }
+      if (__SIGNAL_COUNTERS__) hotCounters.samplesEmitted += output.length - first;
+      if (this.remaining > 0) return false;
+
+      if (this.finished) return true;
+      if (input.offset < input.length) {
+        this.keying.begin(input.data[input.offset++]);
+        this.symbolSample = 0;
+        this.remaining = this.samplesPerSymbol;
+        this.symbols++;
+      } else if (input.ended) {
+        this.symbolSample = 0;
+        this.remaining = this.symbols > 0 ? this.keying.finish() : 0;
+        this.finished = true;
+      } else {
+        return false;
+      }
+    }
+  }
 }
 
 /**
- * Generates QAM (Quadrature Amplitude Modulation) signal.
- * Uses 16-QAM: 4 amplitude levels × 4 phase states for 4-bit symbols.
+ * Baseband receiver for every keying. Each symbol is decided by correlating the received
+ * envelope with the envelope of every candidate symbol (minimum distance), except DPSK,
+ * which compares each symbol with the previous one, OQPSK, whose Q decision window
+ * is offset like its transmitter, and the continuous-phase schemes, which decide on the
+ * direction the phase turns across each bit's pulse centre. Bits leave MSB first.
  */
-function generateQAM(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
-  const signal: DataPoint[] = [];
-  const carrierFreq = 5;
-  const bitsPerSymbol = 4; // 16-QAM
-  const symbolDuration = bitDuration * bitsPerSymbol;
-  const samplesPerSymbol = samplesPerBit * bitsPerSymbol;
+export class BasebandDemodulator implements Stage {
+  readonly name: string;
+  readonly inputs = ['complex'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly algorithm: DigitalToAnalogAlgorithm;
+  private readonly keying: BasebandKeying;
+  private readonly sampleRate: number;
+  private readonly samplesPerSymbol: number;
+  private readonly qDelay: number;
+  private readonly table: PhaseTable | null;
+  private readonly pulseDelay: number;
+  private readonly window: number;
+  private readonly reference: ComplexSample = { i: 0, q: 0 };
+  private received!: FloatArray;
+  private receivedImag!: FloatArray;
+  private filled = 0;
+  private symbolStart = 0;
+  // DPSK reference: the sum of the previous symbol, starting from the zero-phase carrier
+  private previousI = 0;
+  private previousQ: number;
+  private pendingSymbol = 0;
+  private pendingBits = 0;
+
+  constructor(
+    algorithm: DigitalToAnalogAlgorithm,
+    bitDuration: number,
+    samplesPerBit: number,
+    config: KeyingConfig = defaultKeyingConfig
+  ) {
+    this.name = `${algorithm} baseband demodulator`;
+    this.algorithm = algorithm;
+    this.keying = createBasebandKeying(algorithm, samplesPerBit, config);
+    this.sampleRate = samplesPerBit / bitDuration;
+    this.samplesPerSymbol = samplesPerBit * this.keying.bitsPerSymbol;
+    this.qDelay = algorithm === 'OQPSK' ? samplesPerBit / 2 : 0;
+    this.table = isContinuousPhase(algorithm) ? continuousPhaseTable(algorithm, samplesPerBit, config) : null;
+    this.pulseDelay = this.table ? Math.round(decisionDelay(this.table) * samplesPerBit) : 0;
+    this.window = this.samplesPerSymbol + this.qDelay + this.pulseDelay;
+    this.previousQ = -this.samplesPerSymbol;
+  }
 
-  // Pad bits to multiple of 4
-  const remainder = bits.length % bitsPerSymbol;
-  const paddedBits = remainder === 0 ? bits : [...bits, ...new Array(bitsPerSymbol - remainder).fill(0)];
-  const numSymbols = paddedBits.length / bitsPerSymbol;
+  setup(arena: Arena, precision: SamplePrecision): void {
+    this.received = arena.float(precision, this.window);
+    this.receivedImag = arena.float(precision, this.window);
+  }
 
-  // 16-QAM constellation: 4x4 grid
-  // I levels: -3, -1, +1, +3 (normalized)
-  // Q levels: -3, -1, +1, +3 (normalized)
-  const levels = [-3, -1, 1, 3];
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    for (;;) {
+      while (this.pendingBits > 0) {
+        if (output.length >= output.capacity) return false;
+        this.pendingBits--;
+        output.data[output.length++] = (this.pendingSymbol >> this.pendingBits) & 1;
+      }
+
+      if (this.filled === this.window) {
+        this.pendingSymbol = this.decide();
+        this.pendingBits = this.keying.bitsPerSymbol;
+        // Keep the overlap the next window shares with this one (OQPSK's delayed Q)
+        this.received.copyWithin(0, this.samplesPerSymbol, this.window);
+        this.receivedImag.copyWithin(0, this.samplesPerSymbol, this.window);
+        this.filled -= this.samplesPerSymbol;
+        this.symbolStart += this.samplesPerSymbol;
+      } else if (input.offset < input.length) {
+        this.received[this.filled] = input.data[input.offset];
+        this.receivedImag[this.filled] = input.imag![input.offset];
+        input.offset++;
+        this.filled++;
+      } else {
+        // A trailing partial window (closing samples) carries no decision
+        return input.ended;
+      }
+    }
+  }
+
+  private decide(): number {
+    const r = this.received;
+    const rq = this.receivedImag;
+    const n = this.samplesPerSymbol;
+
+    if (this.table) {
+      // Integrate each half of the bit, then Im(second · conj(first)) is positive when
+      // the phase advanced (bit 1); valid while the half-bit phase step stays below π
+      const half = n >> 1;
+      let firstI = 0;
+      let firstQ = 0;
+      let secondI = 0;
+      let secondQ = 0;
+      for (let j = 0; j < half; j++) {
+        firstI += r[this.pulseDelay + j];
+        firstQ += rq[this.pulseDelay + j];
+        secondI += r[this.pulseDelay + half + j];
+        secondQ += rq[this.pulseDelay + half + j];
+      }
+      return secondQ * firstI - secondI * firstQ > 0 ? 1 : 0;
+    }
 
-  for (let i = 0; i < numSymbols; i++) {
-    const bit1 = paddedBits[i * bitsPerSymbol];
-    const bit2 = paddedBits[i * bitsPerSymbol + 1];
-    const bit3 = paddedBits[i * bitsPerSymbol + 2];
-    const bit4 = paddedBits[i * bitsPerSymbol + 3];
-
-    // Gray coding for I (bits 1,2) and Q (bits 3,4) channels
-    const iIndex = bit1 * 2 + bit2;
-    const qIndex = bit3 * 2 + bit4;
-    const iAmplitude = levels[iIndex] / 3; // Normalize to ±1 range
-    const qAmplitude = levels[qIndex] / 3;
-
-    for (let j = 0; j <= samplesPerSymbol; j++) {
-      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
-      const y = iAmplitude * Math.cos(2 * Math.PI * carrierFreq * t) + qAmplitude * Math.sin(2 * Math.PI * carrierFreq * t);
-      signal.push({ x: t, y });
+    if (this.algorithm === 'OQPSK') {
+      let iSum = 0;
+      let qSum = 0;
+      for (let j = 0; j < n; j++) {
+        iSum += r[j];
+        qSum -= rq[j + this.qDelay];
+      }
+      return ((iSum > 0 ? 1 : 0) << 1) | (qSum > 0 ? 1 : 0);
     }
+
+    if (this.algorithm === 'DPSK') {
+      let iSum = 0;
+      let qSum = 0;
+      for (let j = 0; j < n; j++) {
+        iSum += r[j];
+        qSum += rq[j];
+      }
+      const bit = iSum * this.previousI + qSum * this.previousQ >= 0 ? 1 : 0;
+      this.previousI = iSum;
+      this.previousQ = qSum;
+      return bit;
+    }
+
+    const reference = this.reference;
+    let best = 0;
+    let bestMetric = -Infinity;
+    for (let symbol = 0; symbol < 1 << this.keying.bitsPerSymbol; symbol++) {
+      this.keying.begin(symbol);
+      let metric = 0;
+      for (let j = 0; j < n; j++) {
+        this.keying.sample((this.symbolStart + j) / this.sampleRate, j, reference);
+        metric += r[j] * reference.i + rq[j] * reference.q - 0.5 * (reference.i * reference.i + reference.q * reference.q);
+      }
+      if (metric > bestMetric) {
+        bestMetric = metric;
+        best = symbol;
+      }
+    }
+    return best;
   }
+}
 
-  return signal;
+// ---------------------------------------------------------------------------
+// Spectral efficiency
+// ---------------------------------------------------------------------------
+
+export interface SpectralEfficiency {
+  algorithm: DigitalToAnalogAlgorithm;
+  /** Bandwidth holding 99% of the transmitted power, in Hz */
+  occupiedBandwidth: number;
+  /** Bit rate over occupied bandwidth, in bit/s/Hz */
+  efficiency: number;
+}
+
+/**
+ * Runs BFSK and the continuous-phase schemes over the same pseudo-random bit stream and
+ * measures each passband signal's 99% occupied bandwidth, so the sidelobes BFSK's
+ * abrupt tone switching leaves can be compared with CPFSK, MSK and GMSK.
+ */
+export function compareSpectralEfficiency(
+  config: KeyingConfig = defaultKeyingConfig,
+  bitCount = 256,
+  seed?: number
+): SpectralEfficiency[] {
+  const random = new Random(seed);
+  const bits = new Uint8Array(bitCount);
+  for (let k = 0; k < bitCount; k++) bits[k] = random.bit();
+
+  const algorithms: DigitalToAnalogAlgorithm[] = ['BFSK', 'CPFSK', 'MSK', 'GMSK'];
+  return algorithms.map(algorithm => {
+    const { pipeline, transmitted } = buildDigitalToAnalogGraph(bits, algorithm, { keying: config });
+    pipeline.run();
+    const values = transmitted.points.map(point => point.y);
+    const band = occupiedBandwidth(amplitudeSpectrum(values, samplesPerBit / bitDuration), 0.99);
+    return {
+      algorithm,
+      occupiedBandwidth: band.bandwidth,
+      efficiency: band.bandwidth > 0 ? 1 / bitDuration / band.bandwidth : 0,
+    };
+  });
 }
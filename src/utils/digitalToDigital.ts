@@ -1,240 +1,558 @@
-import { DataPoint, DigitalToDigitalAlgorithm } from '../types';
+import { DataPoint, DigitalToDigitalAlgorithm, SourceCoding } from '../types';
+import { InputPort, OutputPort, Pipeline, PipelineOptions, Stage } from './pipeline';
+import { Arena } from './bufferPool';
+import { BitSource, CollectSink, StepSink, SymbolMapper, SymbolSerializer, parseBits } from './stages';
+import { SourceDecoder, SourceEncoder } from './sourceCoding';
+
+const bitDuration = 1;
 
 export function generateDigitalToDigitalSignal(
   binaryInput: string,
   algorithm: DigitalToDigitalAlgorithm
 ): { input: DataPoint[]; transmitted: DataPoint[]; output: DataPoint[] } {
-  const bits = binaryInput.split('').map(b => parseInt(b));
-  const bitDuration = 1;
+  const arena = new Arena();
+  try {
+    const bits = parseBits(binaryInput, arena);
+    const { pipeline, input, transmitted } = buildDigitalToDigitalGraph(bits, algorithm, { arena });
+    pipeline.run();
 
-  const inputSignal: DataPoint[] = [];
-  for (let i = 0; i < bits.length; i++) {
-    inputSignal.push({ x: i * bitDuration, y: bits[i] });
-    inputSignal.push({ x: (i + 1) * bitDuration, y: bits[i] });
+    return {
+      input: input.points,
+      transmitted: transmitted.points,
+      output: input.points,
+    };
+  } finally {
+    arena.release();
   }
+}
+
+/**
+ * Preset graph for line coding: bits → line coder → transmitted levels,
+ * with the source bits drawn alongside as the reference input.
+ */
+export function buildDigitalToDigitalGraph(
+  bits: ArrayLike<number>,
+  algorithm: DigitalToDigitalAlgorithm,
+  options?: PipelineOptions
+): { pipeline: Pipeline; input: StepSink; transmitted: StepSink } {
+  const coder = new LineCoder(algorithm);
+  const input = new StepSink('bits', 1 / bitDuration);
+  const transmitted = new StepSink('real', coder.levelsPerBit / bitDuration);
 
-  let transmittedSignal: DataPoint[] = [];
+  const pipeline = Pipeline.fromSpec({
+    nodes: { source: new BitSource(bits), coder, input, transmitted },
+    edges: [
+      ['source', 'input'],
+      ['source', 'coder'],
+      ['coder', 'transmitted'],
+    ],
+  }, options);
+
+  return { pipeline, input, transmitted };
+}
+
+/** UTF-8 bytes of `text`, 8 bits per byte MSB first. */
+export function textToBits(text: string): Uint8Array {
+  const bytes = new TextEncoder().encode(text);
+  const bits = new Uint8Array(bytes.length * 8);
+  for (let i = 0; i < bits.length; i++) bits[i] = (bytes[i >> 3] >> (7 - (i & 7))) & 1;
+  return bits;
+}
+
+/**
+ * Text link with a source coder ahead of the line code: text bits → bytes → source
+ * encoder → line coder, then line decoder → source decoder → bits. The input chart shows
+ * the coded bits that go on the line; the output is the recovered text's 8 bits per byte.
+ */
+export function generateSourceCodedSignal(
+  text: string,
+  coding: SourceCoding,
+  algorithm: DigitalToDigitalAlgorithm
+): { input: DataPoint[]; transmitted: DataPoint[]; output: DataPoint[]; codedBits: number; decodedText: string } {
+  const coder = new LineCoder(algorithm);
+  const input = new StepSink('bits', 1 / bitDuration);
+  const transmitted = new StepSink('real', coder.levelsPerBit / bitDuration);
+  const output = new StepSink('bits', 1 / bitDuration);
+  const decoded = new CollectSink('symbols');
+
+  Pipeline.fromSpec({
+    nodes: {
+      source: new BitSource(textToBits(text)),
+      bytes: new SymbolMapper(8),
+      encoder: new SourceEncoder(coding),
+      coder,
+      transmitted,
+      input,
+      lineDecoder: new LineDecoderStage(algorithm),
+      decoder: new SourceDecoder(coding),
+      serializer: new SymbolSerializer(8),
+      output,
+      decoded,
+    },
+    edges: [
+      ['source', 'bytes'],
+      ['bytes', 'encoder'],
+      ['encoder', 'input'],
+      ['encoder', 'coder'],
+      ['coder', 'transmitted'],
+      ['coder', 'lineDecoder'],
+      ['lineDecoder', 'decoder'],
+      ['decoder', 'decoded'],
+      ['decoder', 'serializer'],
+      ['serializer', 'output'],
+    ],
+  }).run();
+
+  return {
+    input: input.points,
+    transmitted: transmitted.points,
+    output: output.points,
+    codedBits: input.points.length / 2,
+    decodedText: new TextDecoder().decode(Uint8Array.from(decoded.values)),
+  };
+}
+
+type Emit = (value: number) => void;
+
+/**
+ * Line code as a bit-serial state machine. Each bit emits `levelsPerBit` levels,
+ * except where a substitution code holds zeros back to look ahead.
+ */
+interface LineEncoder {
+  levelsPerBit: number;
+  encode(bit: number, emit: Emit): void;
+  /** Emits anything held back for look-ahead once the input has ended */
+  finish(emit: Emit): void;
+}
 
+function createLineEncoder(algorithm: DigitalToDigitalAlgorithm): LineEncoder {
   switch (algorithm) {
     case 'NRZ-L':
-      transmittedSignal = generateNRZL(bits, bitDuration);
-      break;
+      return nrzlEncoder();
     case 'NRZ-I':
-      transmittedSignal = generateNRZI(bits, bitDuration);
-      break;
+      return nrziEncoder();
     case 'Manchester':
-      transmittedSignal = generateManchester(bits, bitDuration);
-      break;
+      return manchesterEncoder();
     case 'Differential Manchester':
-      transmittedSignal = generateDifferentialManchester(bits, bitDuration);
-      break;
+      return differentialManchesterEncoder();
     case 'AMI':
-      transmittedSignal = generateAMI(bits, bitDuration);
-      break;
+      return amiEncoder();
     case 'Pseudoternary':
-      transmittedSignal = generatePseudoternary(bits, bitDuration);
-      break;
+      return pseudoternaryEncoder();
     case 'B8ZS':
-      transmittedSignal = generateB8ZS(bits, bitDuration);
-      break;
+      return b8zsEncoder();
     case 'HDB3':
-      transmittedSignal = generateHDB3(bits, bitDuration);
-      break;
+      return hdb3Encoder();
   }
-
-  return {
-    input: inputSignal,
-    transmitted: transmittedSignal,
-    output: inputSignal,
-  };
 }
 
 // NRZ-L: 0 = high level (+1), 1 = low level (-1)
-function generateNRZL(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
-  for (let i = 0; i < bits.length; i++) {
-    const voltage = bits[i] === 0 ? 1 : -1;
-    signal.push({ x: i * bitDuration, y: voltage });
-    signal.push({ x: (i + 1) * bitDuration, y: voltage });
-  }
-  return signal;
+function nrzlEncoder(): LineEncoder {
+  return {
+    levelsPerBit: 1,
+    encode: (bit, emit) => emit(bit === 0 ? 1 : -1),
+    finish: () => {},
+  };
 }
 
 // NRZ-I: 0 = no transition, 1 = transition at beginning
-function generateNRZI(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function nrziEncoder(): LineEncoder {
   let currentLevel = 1;
-
-  for (let i = 0; i < bits.length; i++) {
-    if (bits[i] === 1) {
-      currentLevel = currentLevel === 1 ? -1 : 1;
-    }
-    signal.push({ x: i * bitDuration, y: currentLevel });
-    signal.push({ x: (i + 1) * bitDuration, y: currentLevel });
-  }
-  return signal;
+  return {
+    levelsPerBit: 1,
+    encode: (bit, emit) => {
+      if (bit === 1) {
+        currentLevel = currentLevel === 1 ? -1 : 1;
+      }
+      emit(currentLevel);
+    },
+    finish: () => {},
+  };
 }
 
 // Manchester: 0 = high to low transition, 1 = low to high transition
-function generateManchester(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
-  for (let i = 0; i < bits.length; i++) {
-    if (bits[i] === 0) {
-      // High to low
-      signal.push({ x: i * bitDuration, y: 1 });
-      signal.push({ x: (i + 0.5) * bitDuration, y: 1 });
-      signal.push({ x: (i + 0.5) * bitDuration, y: -1 });
-      signal.push({ x: (i + 1) * bitDuration, y: -1 });
-    } else {
-      // Low to high
-      signal.push({ x: i * bitDuration, y: -1 });
-      signal.push({ x: (i + 0.5) * bitDuration, y: -1 });
-      signal.push({ x: (i + 0.5) * bitDuration, y: 1 });
-      signal.push({ x: (i + 1) * bitDuration, y: 1 });
-    }
-  }
-  return signal;
+function manchesterEncoder(): LineEncoder {
+  return {
+    levelsPerBit: 2,
+    encode: (bit, emit) => {
+      if (bit === 0) {
+        // High to low
+        emit(1);
+        emit(-1);
+      } else {
+        // Low to high
+        emit(-1);
+        emit(1);
+      }
+    },
+    finish: () => {},
+  };
 }
 
 // Differential Manchester: always transition in middle, 0 = transition at beginning, 1 = no transition at beginning
-function generateDifferentialManchester(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function differentialManchesterEncoder(): LineEncoder {
   let currentLevel = 1;
-
-  for (let i = 0; i < bits.length; i++) {
-    // For 0: transition at beginning
-    if (bits[i] === 0) {
+  return {
+    levelsPerBit: 2,
+    encode: (bit, emit) => {
+      // For 0: transition at beginning
+      if (bit === 0) {
+        currentLevel = currentLevel === 1 ? -1 : 1;
+      }
+      // First half of bit period
+      emit(currentLevel);
+      // Always transition in middle
       currentLevel = currentLevel === 1 ? -1 : 1;
-    }
-    // For 1: no transition at beginning
-    
-    // First half of bit period
-    signal.push({ x: i * bitDuration, y: currentLevel });
-    signal.push({ x: (i + 0.5) * bitDuration, y: currentLevel });
-    
-    // Always transition in middle
-    currentLevel = currentLevel === 1 ? -1 : 1;
-    
-    // Second half of bit period
-    signal.push({ x: (i + 0.5) * bitDuration, y: currentLevel });
-    signal.push({ x: (i + 1) * bitDuration, y: currentLevel });
-  }
-  return signal;
+      // Second half of bit period
+      emit(currentLevel);
+    },
+    finish: () => {},
+  };
 }
 
 // Bipolar AMI: 0 = no signal (0), 1 = alternating +1/-1
-function generateAMI(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function amiEncoder(): LineEncoder {
   let lastOnePolarity = -1;
-
-  for (let i = 0; i < bits.length; i++) {
-    let voltage = 0;
-    if (bits[i] === 1) {
-      lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
-      voltage = lastOnePolarity;
-    }
-    signal.push({ x: i * bitDuration, y: voltage });
-    signal.push({ x: (i + 1) * bitDuration, y: voltage });
-  }
-  return signal;
+  return {
+    levelsPerBit: 1,
+    encode: (bit, emit) => {
+      let voltage = 0;
+      if (bit === 1) {
+        lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
+        voltage = lastOnePolarity;
+      }
+      emit(voltage);
+    },
+    finish: () => {},
+  };
 }
 
 // Pseudoternary: 0 = alternating +1/-1, 1 = no signal (0)
-function generatePseudoternary(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function pseudoternaryEncoder(): LineEncoder {
   let lastZeroPolarity = -1;
-
-  for (let i = 0; i < bits.length; i++) {
-    let voltage = 0;
-    if (bits[i] === 0) {
-      lastZeroPolarity = lastZeroPolarity === 1 ? -1 : 1;
-      voltage = lastZeroPolarity;
-    }
-    signal.push({ x: i * bitDuration, y: voltage });
-    signal.push({ x: (i + 1) * bitDuration, y: voltage });
-  }
-  return signal;
+  return {
+    levelsPerBit: 1,
+    encode: (bit, emit) => {
+      let voltage = 0;
+      if (bit === 0) {
+        lastZeroPolarity = lastZeroPolarity === 1 ? -1 : 1;
+        voltage = lastZeroPolarity;
+      }
+      emit(voltage);
+    },
+    finish: () => {},
+  };
 }
 
 // B8ZS: Same as AMI, but string of 8 zeros replaced with pattern containing violations
-function generateB8ZS(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function b8zsEncoder(): LineEncoder {
   let lastOnePolarity = -1;
+  let pendingZeros = 0; // Zeros held back until we know whether 8 arrive in a row
+
+  const releaseZeros = (emit: Emit) => {
+    for (; pendingZeros > 0; pendingZeros--) emit(0);
+  };
 
-  for (let i = 0; i < bits.length; i++) {
-    // Check for 8 consecutive zeros
-    if (i + 7 < bits.length && bits.slice(i, i + 8).every(b => b === 0)) {
-      // Replace with B8ZS substitution pattern: 000VB0VB
-      // V = violation (same polarity as last), B = bipolar (opposite polarity)
-      const V = lastOnePolarity;
-      const B = lastOnePolarity === 1 ? -1 : 1;
-      
-      // 000VB0VB pattern
-      const pattern = [0, 0, 0, V, B, 0, V, B];
-      for (let j = 0; j < 8; j++) {
-        signal.push({ x: (i + j) * bitDuration, y: pattern[j] });
-        signal.push({ x: (i + j + 1) * bitDuration, y: pattern[j] });
+  return {
+    levelsPerBit: 1,
+    encode: (bit, emit) => {
+      if (bit === 0) {
+        pendingZeros++;
+        if (pendingZeros === 8) {
+          // Replace with B8ZS substitution pattern: 000VB0VB
+          // V = violation (same polarity as last), B = bipolar (opposite polarity)
+          const V = lastOnePolarity;
+          const B = lastOnePolarity === 1 ? -1 : 1;
+          emit(0);
+          emit(0);
+          emit(0);
+          emit(V);
+          emit(B);
+          emit(0);
+          emit(V);
+          emit(B);
+          lastOnePolarity = B;
+          pendingZeros = 0;
+        }
+        return;
       }
-      
-      lastOnePolarity = B;
-      i += 7; // Skip the next 7 bits (loop increment will add 1)
-    } else {
       // Normal AMI encoding
-      let voltage = 0;
-      if (bits[i] === 1) {
-        lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
-        voltage = lastOnePolarity;
-      }
-      signal.push({ x: i * bitDuration, y: voltage });
-      signal.push({ x: (i + 1) * bitDuration, y: voltage });
-    }
-  }
-  return signal;
+      releaseZeros(emit);
+      lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
+      emit(lastOnePolarity);
+    },
+    finish: releaseZeros,
+  };
 }
 
 // HDB3: Same as AMI, but string of 4 zeros replaced with pattern containing violation
-function generateHDB3(bits: number[], bitDuration: number): DataPoint[] {
-  const signal: DataPoint[] = [];
+function hdb3Encoder(): LineEncoder {
   let lastOnePolarity = -1;
   let onesCount = 0; // Count of ones since last substitution
+  let pendingZeros = 0;
 
-  for (let i = 0; i < bits.length; i++) {
-    // Check for 4 consecutive zeros
-    if (i + 3 < bits.length && bits.slice(i, i + 4).every(b => b === 0)) {
-      // Determine substitution pattern based on ones count
-      let pattern: number[];
-      
-      if (onesCount % 2 === 0) {
-        // Even number of ones: use 000V (violation)
-        const V = lastOnePolarity;
-        pattern = [0, 0, 0, V];
-        lastOnePolarity = V;
+  const releaseZeros = (emit: Emit) => {
+    for (; pendingZeros > 0; pendingZeros--) emit(0);
+  };
+
+  return {
+    levelsPerBit: 1,
+    encode: (bit, emit) => {
+      if (bit === 0) {
+        pendingZeros++;
+        if (pendingZeros === 4) {
+          // Determine substitution pattern based on ones count
+          if (onesCount % 2 === 0) {
+            // Even number of ones: use 000V (violation)
+            const V = lastOnePolarity;
+            emit(0);
+            emit(0);
+            emit(0);
+            emit(V);
+            lastOnePolarity = V;
+          } else {
+            // Odd number of ones: use B00V (balance + violation)
+            const B = lastOnePolarity === 1 ? -1 : 1;
+            const V = B;
+            emit(B);
+            emit(0);
+            emit(0);
+            emit(V);
+            lastOnePolarity = V;
+          }
+          onesCount = 0;
+          pendingZeros = 0;
+        }
+        return;
+      }
+      // Normal AMI encoding
+      releaseZeros(emit);
+      lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
+      onesCount++;
+      emit(lastOnePolarity);
+    },
+    finish: releaseZeros,
+  };
+}
+
+// Most values one bit can release: B8ZS's eight-level substitution, or seven held-back
+// zeros and the pulse after them; the substitution decoder's eight zeros on the way back.
+// A power of two, so the queues below wrap with a mask
+const maxBurst = 8;
+const burstMask = maxBurst - 1;
+
+/** Streams bits through a line code, producing `levelsPerBit` levels per bit. */
+export class LineCoder implements Stage {
+  readonly name: string;
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['real'] as const;
+  readonly levelsPerBit: number;
+  private readonly encoder: LineEncoder;
+  // Ring of levels produced by the last bit that did not fit in the output block yet,
+  // drawn from the run's arena in setup()
+  private queue!: Float64Array;
+  private queueHead = 0;
+  private queued = 0;
+  private finished = false;
+  private readonly enqueue: Emit = level => {
+    this.queue[(this.queueHead + this.queued++) & burstMask] = level;
+  };
+
+  constructor(algorithm: DigitalToDigitalAlgorithm) {
+    this.name = `${algorithm} encoder`;
+    this.encoder = createLineEncoder(algorithm);
+    this.levelsPerBit = this.encoder.levelsPerBit;
+  }
+
+  setup(arena: Arena): void {
+    this.queue = arena.float64(maxBurst);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const levels = output.data;
+
+    for (;;) {
+      while (this.queued > 0 && output.length < output.capacity) {
+        levels[output.length++] = this.queue[this.queueHead];
+        this.queueHead = (this.queueHead + 1) & burstMask;
+        this.queued--;
+      }
+      if (this.queued > 0) return false;
+
+      if (this.finished) return true;
+      if (input.offset < input.length) {
+        this.encoder.encode(input.data[input.offset++], this.enqueue);
+      } else if (input.ended) {
+        this.encoder.finish(this.enqueue);
+        this.finished = true;
       } else {
-        // Odd number of ones: use B00V (balance + violation)
-        const B = lastOnePolarity === 1 ? -1 : 1;
-        const V = B;
-        pattern = [B, 0, 0, V];
-        lastOnePolarity = V;
+        return false;
       }
-      
-      for (let j = 0; j < 4; j++) {
-        signal.push({ x: (i + j) * bitDuration, y: pattern[j] });
-        signal.push({ x: (i + j + 1) * bitDuration, y: pattern[j] });
+    }
+  }
+}
+
+// Slicer for ternary line levels
+function ternary(level: number): number {
+  return level > 0.5 ? 1 : level < -0.5 ? -1 : 0;
+}
+
+/**
+ * Inverse of a line code. `decode` receives the `levelsPerBit` levels of one bit period
+ * and emits zero or more bits; substitution codes hold a window of pulses back to
+ * recognise their violation patterns, drawn from the run's arena in `setup`.
+ */
+interface LineDecoder {
+  levelsPerBit: number;
+  setup?(arena: Arena): void;
+  decode(levels: Float64Array, emit: Emit): void;
+  finish(emit: Emit): void;
+}
+
+function createLineDecoder(algorithm: DigitalToDigitalAlgorithm): LineDecoder {
+  switch (algorithm) {
+    case 'NRZ-L':
+      return { levelsPerBit: 1, decode: (levels, emit) => emit(levels[0] < 0 ? 1 : 0), finish: () => {} };
+    case 'NRZ-I': {
+      let previous = 1;
+      return {
+        levelsPerBit: 1,
+        decode: (levels, emit) => {
+          const current = levels[0] < 0 ? -1 : 1;
+          emit(current !== previous ? 1 : 0);
+          previous = current;
+        },
+        finish: () => {},
+      };
+    }
+    case 'Manchester':
+      return { levelsPerBit: 2, decode: (levels, emit) => emit(levels[1] > levels[0] ? 1 : 0), finish: () => {} };
+    case 'Differential Manchester': {
+      let previous = 1;
+      return {
+        levelsPerBit: 2,
+        decode: (levels, emit) => {
+          const current = levels[0] < 0 ? -1 : 1;
+          emit(current === previous ? 1 : 0);
+          previous = levels[1] < 0 ? -1 : 1;
+        },
+        finish: () => {},
+      };
+    }
+    case 'AMI':
+      return { levelsPerBit: 1, decode: (levels, emit) => emit(ternary(levels[0]) !== 0 ? 1 : 0), finish: () => {} };
+    case 'Pseudoternary':
+      return { levelsPerBit: 1, decode: (levels, emit) => emit(ternary(levels[0]) !== 0 ? 0 : 1), finish: () => {} };
+    case 'B8ZS':
+      // 000VB0VB where V repeats the previous pulse polarity
+      return substitutionDecoder(8, (window, last) =>
+        window[0] === 0 && window[1] === 0 && window[2] === 0 && window[5] === 0 &&
+        window[3] === last && window[4] === -last && window[6] === last && window[7] === -last
+      );
+    case 'HDB3':
+      // 000V (V repeats the previous pulse) or B00V (V repeats the balancing pulse)
+      return substitutionDecoder(4, (window, last) =>
+        window[1] === 0 && window[2] === 0 && window[3] !== 0 &&
+        ((window[0] === 0 && window[3] === last) || (window[0] === -last && window[3] === window[0]))
+      );
+  }
+}
+
+function substitutionDecoder(
+  length: number,
+  matches: (window: Int32Array, lastPulse: number) => boolean
+): LineDecoder {
+  // Oldest pulse first; `filled` of `length` slots in use
+  let window = new Int32Array(0);
+  let filled = 0;
+  let lastPulse = -1;
+
+  const releaseOne = (emit: Emit) => {
+    const pulse = window[0];
+    window.copyWithin(0, 1, filled--);
+    if (pulse !== 0) lastPulse = pulse;
+    emit(pulse !== 0 ? 1 : 0);
+  };
+
+  return {
+    levelsPerBit: 1,
+    setup: arena => {
+      window = arena.int32(length);
+      filled = 0;
+    },
+    decode: (levels, emit) => {
+      window[filled++] = ternary(levels[0]);
+      if (filled < length) return;
+      if (matches(window, lastPulse)) {
+        lastPulse = window[length - 1];
+        filled = 0;
+        for (let i = 0; i < length; i++) emit(0);
+      } else {
+        releaseOne(emit);
       }
-      
-      onesCount = 0;
-      i += 3; // Skip the next 3 bits (loop increment will add 1)
-    } else {
-      // Normal AMI encoding
-      let voltage = 0;
-      if (bits[i] === 1) {
-        lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
-        voltage = lastOnePolarity;
-        onesCount++;
+    },
+    finish: emit => {
+      while (filled > 0) releaseOne(emit);
+    },
+  };
+}
+
+/** Recovers bits from received line levels (hard decisions). */
+export class LineDecoderStage implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly decoder: LineDecoder;
+  // Scratch below is drawn from the run's arena in setup(): the levels of the bit period
+  // being read, and a ring of decoded bits that did not fit in the output block yet
+  private period!: Float64Array;
+  private periodLength = 0;
+  private queue!: Uint8Array;
+  private queueHead = 0;
+  private queued = 0;
+  private finished = false;
+  private readonly enqueue: Emit = bit => {
+    this.queue[(this.queueHead + this.queued++) & burstMask] = bit;
+  };
+
+  constructor(algorithm: DigitalToDigitalAlgorithm) {
+    this.name = `${algorithm} decoder`;
+    this.decoder = createLineDecoder(algorithm);
+  }
+
+  setup(arena: Arena): void {
+    this.period = arena.float64(this.decoder.levelsPerBit);
+    this.queue = arena.uint8(maxBurst);
+    this.decoder.setup?.(arena);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    for (;;) {
+      while (this.queued > 0 && output.length < output.capacity) {
+        output.data[output.length++] = this.queue[this.queueHead];
+        this.queueHead = (this.queueHead + 1) & burstMask;
+        this.queued--;
+      }
+      if (this.queued > 0) return false;
+
+      if (this.finished) return true;
+      if (input.offset < input.length) {
+        this.period[this.periodLength++] = input.data[input.offset++];
+        if (this.periodLength === this.decoder.levelsPerBit) {
+          this.decoder.decode(this.period, this.enqueue);
+          this.periodLength = 0;
+        }
+      } else if (input.ended) {
+        this.decoder.finish(this.enqueue);
+        this.finished = true;
+      } else {
+        return false;
       }
-      signal.push({ x: i * bitDuration, y: voltage });
-      signal.push({ x: (i + 1) * bitDuration, y: voltage });
     }
   }
-  return signal;
 }
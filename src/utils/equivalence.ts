@@ -0,0 +1,396 @@
+import { BlockCode, DataPoint, DigitalToDigitalAlgorithm, PortType, SamplePrecision } from '../types';
+import { ArraySource, BitSource, CollectSink, PointSink, StepSink, SymbolMapper } from './stages';
+import { Pipeline, Stage } from './pipeline';
+import { LineCoder } from './digitalToDigital';
+import { Modulator, defaultKeyingConfig } from './digitalToAnalog';
+import {
+  BlockDeinterleaver,
+  BlockInterleaver,
+  ConvolutionalDeinterleaver,
+  ConvolutionalInterleaver,
+  transposeTiled,
+} from './interleaver';
+import { BlockEncoder, blockCodes } from './blockCodes';
+import { fft } from './fft';
+import { Random } from './random';
+import {
+  referenceBlockEncode,
+  referenceBlockInterleave,
+  referenceConvolutionalInterleave,
+  referenceDft,
+  referenceKeyings,
+  referenceLineCode,
+  referenceModulation,
+  referenceTranspose,
+} from './reference';
+
+/**
+ * Randomised differential harness: every kernel is run on random inputs, sizes and
+ * pipeline block sizes (so stream state is split at random chunk boundaries) and
+ * compared element by element with its frozen oracle in `reference.ts`. An optimised
+ * kernel registers a `KernelCase` here against the same oracle as the code it replaces.
+ */
+
+/** Element i passes when |actual − expected| ≤ absolute + relative · |expected|. */
+export interface Tolerance {
+  absolute: number;
+  relative: number;
+}
+
+export const exact: Tolerance = { absolute: 0, relative: 0 };
+
+// float32 buffers round each sample to 24 significant bits
+const float32Tolerance: Tolerance = { absolute: 1e-6, relative: 1e-6 };
+const float64Tolerance: Tolerance = { absolute: 1e-9, relative: 1e-9 };
+
+export interface Trial {
+  /** Inputs of this trial, reported with a mismatch */
+  description: string;
+  expected: ArrayLike<number>;
+  actual: ArrayLike<number>;
+  tolerance: Tolerance;
+}
+
+export interface KernelCase {
+  name: string;
+  trial(random: Random): Trial;
+}
+
+export interface Mismatch {
+  description: string;
+  /** First failing index (the shorter length when the lengths differ) */
+  index: number;
+  expected: number;
+  actual: number;
+}
+
+export interface EquivalenceResult {
+  kernel: string;
+  trials: number;
+  failures: number;
+  /** Largest |actual − expected| over every trial with matching lengths */
+  maxError: number;
+  firstMismatch: Mismatch | null;
+}
+
+export interface EquivalenceOptions {
+  trials?: number;
+  seed?: number;
+}
+
+/** First element outside `tolerance` (or the length mismatch), and the largest error seen. */
+export function compareOutputs(
+  expected: ArrayLike<number>,
+  actual: ArrayLike<number>,
+  tolerance: Tolerance
+): { index: number; maxError: number } {
+  let maxError = 0;
+  let index = -1;
+  const length = Math.min(expected.length, actual.length);
+  for (let i = 0; i < length; i++) {
+    const error = Math.abs(actual[i] - expected[i]);
+    // NaN on either side fails
+    if (!(error <= tolerance.absolute + tolerance.relative * Math.abs(expected[i]))) {
+      if (index < 0) index = i;
+      if (!(error <= maxError)) maxError = error;
+    } else if (error > maxError) {
+      maxError = error;
+    }
+  }
+  if (index < 0 && expected.length !== actual.length) index = length;
+  return { index, maxError };
+}
+
+// ---------------------------------------------------------------------------
+// Random inputs
+// ---------------------------------------------------------------------------
+
+function randomInt(random: Random, min: number, max: number): number {
+  return min + Math.floor(random.next() * (max - min + 1));
+}
+
+/** Bits with a random density of ones, so zero runs (and substitutions) are sometimes long. */
+function randomBits(random: Random, length: number): Uint8Array {
+  const density = random.next();
+  const bits = new Uint8Array(length);
+  for (let i = 0; i < length; i++) bits[i] = random.next() < density ? 1 : 0;
+  return bits;
+}
+
+function randomValues(random: Random, length: number): Float64Array {
+  const values = new Float64Array(length);
+  for (let i = 0; i < length; i++) values[i] = random.gaussian();
+  return values;
+}
+
+// Tiny blocks split every bit's output; odd sizes move the split points around
+function randomBlockSize(random: Random): number {
+  const sizes = [1, 2, 3, 7, 64, 1024];
+  return random.next() < 0.5 ? sizes[randomInt(random, 0, sizes.length - 1)] : randomInt(random, 1, 257);
+}
+
+/** Runs `source → stages… → sink` with the given block size. */
+function runInto(source: Stage, stages: Stage[], sink: Stage, blockSize: number, precision: SamplePrecision): void {
+  const pipeline = new Pipeline({ blockSize, precision }).add('source', source).add('sink', sink);
+  let previous = 'source';
+  stages.forEach((stage, index) => {
+    const id = `stage${index}`;
+    pipeline.add(id, stage).connect(previous, id);
+    previous = id;
+  });
+  pipeline.connect(previous, 'sink');
+  pipeline.run();
+}
+
+/** Runs `source → stages… → collector` with the given block size and returns what was collected. */
+function runChain(
+  source: Stage,
+  stages: Stage[],
+  type: PortType,
+  blockSize: number,
+  precision: SamplePrecision = 'float64'
+): Float64Array {
+  const sink = new CollectSink(type);
+  runInto(source, stages, sink, blockSize, precision);
+  return Float64Array.from(sink.values);
+}
+
+/** Chart points as x0, y0, x1, y1, …, so times and values are compared together. */
+function flattenPoints(points: DataPoint[]): Float64Array {
+  const values = new Float64Array(2 * points.length);
+  points.forEach((point, i) => {
+    values[2 * i] = point.x;
+    values[2 * i + 1] = point.y;
+  });
+  return values;
+}
+
+// ---------------------------------------------------------------------------
+// Kernel cases
+// ---------------------------------------------------------------------------
+
+const lineCodings: DigitalToDigitalAlgorithm[] = [
+  'NRZ-L',
+  'NRZ-I',
+  'Manchester',
+  'Differential Manchester',
+  'AMI',
+  'Pseudoternary',
+  'B8ZS',
+  'HDB3',
+];
+
+function lineCodingCase(algorithm: DigitalToDigitalAlgorithm): KernelCase {
+  return {
+    name: `line coder: ${algorithm}`,
+    trial: random => {
+      const bits = randomBits(random, randomInt(random, 0, 600));
+      const blockSize = randomBlockSize(random);
+      // Drawn as the preset draws it: each level held for its share of the bit
+      const coder = new LineCoder(algorithm);
+      const sink = new StepSink('real', coder.levelsPerBit);
+      runInto(new BitSource(bits), [coder], sink, blockSize, 'float64');
+      return {
+        description: `${bits.length} bits, block ${blockSize}`,
+        expected: flattenPoints(referenceLineCode(bits, algorithm)),
+        actual: flattenPoints(sink.points),
+        tolerance: exact,
+      };
+    },
+  };
+}
+
+function modulationCase(algorithm: (typeof referenceKeyings)[number]): KernelCase {
+  return {
+    name: `modulator: ${algorithm}`,
+    trial: random => {
+      // The mode only modulates non-empty input; the original OQPSK generator drew its tail even for none
+      const bits = randomBits(random, randomInt(random, 1, 48));
+      const samplesPerBit = [8, 16, 100][randomInt(random, 0, 2)];
+      const blockSize = randomBlockSize(random);
+      const precision: SamplePrecision = random.next() < 0.5 ? 'float64' : 'float32';
+      // Drawn as the preset draws it, each symbol closing on the next one's first instant
+      const modulator = new Modulator(algorithm, 1, samplesPerBit, defaultKeyingConfig, true);
+      const stages = modulator.bitsPerSymbol > 1 ? [new SymbolMapper(modulator.bitsPerSymbol), modulator] : [modulator];
+      const sink = new PointSink('real', samplesPerBit, false, modulator.closesSymbols ? modulator.samplesPerSymbol : 0);
+      runInto(new BitSource(bits), stages, sink, blockSize, precision);
+      return {
+        description: `${bits.length} bits, ${samplesPerBit} samples/bit, block ${blockSize}, ${precision}`,
+        expected: flattenPoints(referenceModulation(bits, algorithm, 1, samplesPerBit)),
+        actual: flattenPoints(sink.points),
+        tolerance: precision === 'float32' ? float32Tolerance : float64Tolerance,
+      };
+    },
+  };
+}
+
+const transposeCase: KernelCase = {
+  name: 'tiled transpose',
+  trial: random => {
+    const rows = randomInt(random, 1, 100);
+    const cols = randomInt(random, 1, 100);
+    const source = randomValues(random, rows * cols);
+    const target = new Float64Array(rows * cols);
+    transposeTiled(source, target, rows, cols);
+    return { description: `${rows} × ${cols}`, expected: referenceTranspose(source, rows, cols), actual: target, tolerance: exact };
+  },
+};
+
+const blockInterleaverCase: KernelCase = {
+  name: 'block interleaver',
+  trial: random => {
+    const rows = randomInt(random, 1, 24);
+    const cols = randomInt(random, 1, 24);
+    const values = randomValues(random, randomInt(random, 0, 2000));
+    const blockSize = randomBlockSize(random);
+    return {
+      description: `${values.length} samples, ${rows} × ${cols}, block ${blockSize}`,
+      expected: referenceBlockInterleave(values, rows, cols),
+      actual: runChain(new ArraySource(values), [new BlockInterleaver('real', rows, cols)], 'real', blockSize),
+      tolerance: exact,
+    };
+  },
+};
+
+const convolutionalInterleaverCase: KernelCase = {
+  name: 'convolutional interleaver',
+  trial: random => {
+    const branches = randomInt(random, 1, 12);
+    const unitDelay = randomInt(random, 1, 6);
+    const values = randomValues(random, randomInt(random, 0, 2000));
+    const blockSize = randomBlockSize(random);
+    return {
+      description: `${values.length} samples, B = ${branches}, D = ${unitDelay}, block ${blockSize}`,
+      expected: referenceConvolutionalInterleave(values, branches, unitDelay),
+      actual: runChain(new ArraySource(values), [new ConvolutionalInterleaver('real', branches, unitDelay)], 'real', blockSize),
+      tolerance: exact,
+    };
+  },
+};
+
+// Bits or real samples, with the source that streams them
+function randomStream(random: Random, length: number): { type: PortType; values: Float64Array; source: Stage } {
+  if (random.next() < 0.5) {
+    const bits = randomBits(random, length);
+    return { type: 'bits', values: Float64Array.from(bits), source: new BitSource(bits) };
+  }
+  const values = randomValues(random, length);
+  return { type: 'real', values, source: new ArraySource(values) };
+}
+
+// Deinterleaving what was interleaved must give back the input, short final block and
+// Forney start-up delay included
+const blockRoundTripCase: KernelCase = {
+  name: 'block interleaver round trip',
+  trial: random => {
+    const rows = randomInt(random, 1, 24);
+    const cols = randomInt(random, 1, 24);
+    const { type, values, source } = randomStream(random, randomInt(random, 0, 2000));
+    const blockSize = randomBlockSize(random);
+    const stages = [new BlockInterleaver(type, rows, cols), new BlockDeinterleaver(type, rows, cols)];
+    return {
+      description: `${values.length} ${type}, ${rows} × ${cols}, block ${blockSize}`,
+      expected: values,
+      actual: runChain(source, stages, type, blockSize),
+      tolerance: exact,
+    };
+  },
+};
+
+const convolutionalRoundTripCase: KernelCase = {
+  name: 'convolutional interleaver round trip',
+  trial: random => {
+    const branches = randomInt(random, 1, 12);
+    const unitDelay = randomInt(random, 1, 6);
+    const { type, values, source } = randomStream(random, randomInt(random, 0, 2000));
+    const blockSize = randomBlockSize(random);
+    const stages = [new ConvolutionalInterleaver(type, branches, unitDelay), new ConvolutionalDeinterleaver(type, branches, unitDelay)];
+    return {
+      description: `${values.length} ${type}, B = ${branches}, D = ${unitDelay}, block ${blockSize}`,
+      expected: values,
+      actual: runChain(source, stages, type, blockSize),
+      tolerance: exact,
+    };
+  },
+};
+
+const fftCase: KernelCase = {
+  name: 'FFT (radix-2 and Bluestein)',
+  trial: random => {
+    // Mix powers of two with arbitrary lengths
+    const size = random.next() < 0.5 ? 1 << randomInt(random, 0, 10) : randomInt(random, 1, 600);
+    const re = randomValues(random, size);
+    const im = randomValues(random, size);
+    const expected = referenceDft(re, im);
+    fft(re, im);
+    // Rounding grows with the transform length and the signal energy (unit-variance input)
+    const absolute = 1e-12 * size * Math.sqrt(size) * 10;
+    return {
+      description: `${size} points`,
+      expected,
+      actual: [...re, ...im],
+      tolerance: { absolute, relative: 1e-9 },
+    };
+  },
+};
+
+function blockEncoderCase(code: BlockCode): KernelCase {
+  return {
+    name: `block encoder: ${code}`,
+    trial: random => {
+      const bits = randomBits(random, randomInt(random, 0, 500));
+      const blockSize = randomBlockSize(random);
+      return {
+        description: `${bits.length} bits, block ${blockSize}`,
+        expected: referenceBlockEncode(bits, code),
+        actual: runChain(new BitSource(bits), [new BlockEncoder(code)], 'bits', blockSize),
+        tolerance: exact,
+      };
+    },
+  };
+}
+
+export function defaultKernelCases(): KernelCase[] {
+  return [
+    ...lineCodings.map(lineCodingCase),
+    ...referenceKeyings.map(modulationCase),
+    transposeCase,
+    blockInterleaverCase,
+    convolutionalInterleaverCase,
+    blockRoundTripCase,
+    convolutionalRoundTripCase,
+    fftCase,
+    ...blockCodes.map(blockEncoderCase),
+  ];
+}
+
+/** Runs `trials` random trials of one kernel. Trials are seeded per kernel, so results do not depend on which other kernels run. */
+export function runKernelCase(kernel: KernelCase, options: EquivalenceOptions = {}): EquivalenceResult {
+  const trials = options.trials ?? 50;
+  let seed = options.seed ?? 1;
+  for (let i = 0; i < kernel.name.length; i++) seed = Math.imul(seed ^ kernel.name.charCodeAt(i), 0x01000193);
+  const random = new Random(seed);
+  const result: EquivalenceResult = { kernel: kernel.name, trials, failures: 0, maxError: 0, firstMismatch: null };
+
+  for (let t = 0; t < trials; t++) {
+    const trial = kernel.trial(random);
+    const { index, maxError } = compareOutputs(trial.expected, trial.actual, trial.tolerance);
+    if (trial.expected.length === trial.actual.length) result.maxError = Math.max(result.maxError, maxError);
+    if (index < 0) continue;
+    result.failures++;
+    result.firstMismatch ??= {
+      description: `${trial.description}; lengths ${trial.expected.length} / ${trial.actual.length}`,
+      index,
+      expected: index < trial.expected.length ? trial.expected[index] : NaN,
+      actual: index < trial.actual.length ? trial.actual[index] : NaN,
+    };
+  }
+  return result;
+}
+
+export function runEquivalenceHarness(
+  kernels: KernelCase[] = defaultKernelCases(),
+  options: EquivalenceOptions = {}
+): EquivalenceResult[] {
+  return kernels.map(kernel => runKernelCase(kernel, options));
+}
@@ -0,0 +1,245 @@
+import { DataPoint } from '../types';
+
+function isPowerOfTwo(n: number): boolean {
+  return n > 0 && (n & (n - 1)) === 0;
+}
+
+function nextPowerOfTwo(n: number): number {
+  return 2 ** (32 - Math.clz32(Math.max(1, n) - 1));
+}
+
+/**
+ * Precomputed bit-reversal permutation and twiddle factors for one power-of-two size,
+ * so repeated transforms of that size (one per received symbol, say) do no trigonometry.
+ */
+export class FftPlan {
+  readonly size: number;
+  private readonly reversed: Uint32Array;
+  // exp(−2πjk/size) for k < size/2
+  private readonly cos: Float64Array;
+  private readonly sin: Float64Array;
+
+  constructor(size: number) {
+    if (!isPowerOfTwo(size)) throw new Error(`FFT plan size must be a power of two, got ${size}`);
+    this.size = size;
+    this.reversed = new Uint32Array(size);
+    const bits = 31 - Math.clz32(size);
+    for (let i = 0; i < size; i++) {
+      let r = 0;
+      for (let b = 0; b < bits; b++) r |= ((i >> b) & 1) << (bits - 1 - b);
+      this.reversed[i] = r;
+    }
+    this.cos = new Float64Array(size >> 1);
+    this.sin = new Float64Array(size >> 1);
+    for (let k = 0; k < size >> 1; k++) {
+      this.cos[k] = Math.cos((2 * Math.PI * k) / size);
+      this.sin[k] = -Math.sin((2 * Math.PI * k) / size);
+    }
+  }
+
+  /** In-place forward transform of the first `size` elements. */
+  forward(re: Float64Array, im: Float64Array): void {
+    const n = this.size;
+    const reversed = this.reversed;
+    for (let i = 0; i < n; i++) {
+      const j = reversed[i];
+      if (i < j) {
+        let t = re[i];
+        re[i] = re[j];
+        re[j] = t;
+        t = im[i];
+        im[i] = im[j];
+        im[j] = t;
+      }
+    }
+
+    for (let size = 2; size <= n; size <<= 1) {
+      const half = size >> 1;
+      const stride = n / size;
+      for (let start = 0; start < n; start += size) {
+        for (let k = 0; k < half; k++) {
+          const wr = this.cos[k * stride];
+          const wi = this.sin[k * stride];
+          const a = start + k;
+          const b = a + half;
+          const tr = re[b] * wr - im[b] * wi;
+          const ti = re[b] * wi + im[b] * wr;
+          re[b] = re[a] - tr;
+          im[b] = im[a] - ti;
+          re[a] += tr;
+          im[a] += ti;
+        }
+      }
+    }
+  }
+}
+
+const plans = new Map<number, FftPlan>();
+
+/** Shared plan for a power-of-two size. */
+export function fftPlan(size: number): FftPlan {
+  let plan = plans.get(size);
+  if (!plan) {
+    plan = new FftPlan(size);
+    plans.set(size, plan);
+  }
+  return plan;
+}
+
+function radix2(re: Float64Array, im: Float64Array, n: number): void {
+  fftPlan(n).forward(re, im);
+}
+
+interface BluesteinPlan {
+  size: number;
+  // Chirp w_k = exp(−jπk²/n)
+  chirpRe: Float64Array;
+  chirpIm: Float64Array;
+  // Transform of the conjugate chirp, zero-padded and wrapped to `size`
+  kernelRe: Float64Array;
+  kernelIm: Float64Array;
+  workRe: Float64Array;
+  workIm: Float64Array;
+}
+
+// Plans depend only on the length, so repeated frames of one size share them
+const bluesteinPlans = new Map<number, BluesteinPlan>();
+
+function bluesteinPlan(n: number): BluesteinPlan {
+  let plan = bluesteinPlans.get(n);
+  if (plan) return plan;
+
+  const size = nextPowerOfTwo(2 * n - 1);
+  const chirpRe = new Float64Array(n);
+  const chirpIm = new Float64Array(n);
+  const kernelRe = new Float64Array(size);
+  const kernelIm = new Float64Array(size);
+  for (let k = 0; k < n; k++) {
+    // k² mod 2n keeps the angle small for long transforms
+    const angle = (Math.PI * ((k * k) % (2 * n))) / n;
+    chirpRe[k] = Math.cos(angle);
+    chirpIm[k] = -Math.sin(angle);
+    kernelRe[k] = chirpRe[k];
+    kernelIm[k] = -chirpIm[k];
+    if (k > 0) {
+      kernelRe[size - k] = kernelRe[k];
+      kernelIm[size - k] = kernelIm[k];
+    }
+  }
+  radix2(kernelRe, kernelIm, size);
+
+  plan = {
+    size,
+    chirpRe,
+    chirpIm,
+    kernelRe,
+    kernelIm,
+    workRe: new Float64Array(size),
+    workIm: new Float64Array(size),
+  };
+  bluesteinPlans.set(n, plan);
+  return plan;
+}
+
+/** Forward transform of any length as a chirp convolution (Bluestein). */
+function bluestein(re: Float64Array, im: Float64Array, n: number): void {
+  const { size, chirpRe, chirpIm, kernelRe, kernelIm, workRe, workIm } = bluesteinPlan(n);
+
+  workRe.fill(0);
+  workIm.fill(0);
+  for (let k = 0; k < n; k++) {
+    workRe[k] = re[k] * chirpRe[k] - im[k] * chirpIm[k];
+    workIm[k] = re[k] * chirpIm[k] + im[k] * chirpRe[k];
+  }
+  radix2(workRe, workIm, size);
+  for (let k = 0; k < size; k++) {
+    const r = workRe[k] * kernelRe[k] - workIm[k] * kernelIm[k];
+    const i = workRe[k] * kernelIm[k] + workIm[k] * kernelRe[k];
+    // Conjugate so the forward kernel also computes the inverse transform
+    workRe[k] = r;
+    workIm[k] = -i;
+  }
+  radix2(workRe, workIm, size);
+  for (let k = 0; k < n; k++) {
+    const r = workRe[k] / size;
+    const i = -workIm[k] / size;
+    re[k] = r * chirpRe[k] - i * chirpIm[k];
+    im[k] = r * chirpIm[k] + i * chirpRe[k];
+  }
+}
+
+/**
+ * In-place discrete Fourier transform of the first `length` elements of (re, im).
+ * Power-of-two lengths use radix-2; other lengths go through Bluestein's algorithm,
+ * so records such as 400 samples transform without padding. The inverse is unscaled:
+ * divide by `length` to undo a forward transform.
+ */
+export function fft(re: Float64Array, im: Float64Array, length = re.length, inverse = false): void {
+  if (length <= 1) return;
+  if (inverse) {
+    for (let k = 0; k < length; k++) im[k] = -im[k];
+  }
+  if (isPowerOfTwo(length)) radix2(re, im, length);
+  else bluestein(re, im, length);
+  if (inverse) {
+    for (let k = 0; k < length; k++) im[k] = -im[k];
+  }
+}
+
+/**
+ * One-sided amplitude spectrum of a real record (a tone of amplitude A reads A).
+ * Bins are spaced `sampleRate / values.length` apart; the record is treated as periodic.
+ */
+export function amplitudeSpectrum(values: ArrayLike<number>, sampleRate: number, maxFrequency = sampleRate / 2): DataPoint[] {
+  const n = values.length;
+  const re = Float64Array.from(values);
+  const im = new Float64Array(n);
+  fft(re, im);
+
+  const points: DataPoint[] = [];
+  for (let k = 0; k <= n / 2; k++) {
+    const frequency = (k * sampleRate) / n;
+    if (frequency > maxFrequency + 1e-9) break;
+    const scale = k === 0 || 2 * k === n ? 1 / n : 2 / n;
+    points.push({ x: frequency, y: Math.hypot(re[k], im[k]) * scale });
+  }
+  return points;
+}
+
+export interface OccupiedBand {
+  low: number;
+  high: number;
+  bandwidth: number;
+}
+
+/**
+ * Band holding `fraction` of the power of a one-sided spectrum, trimming equal power
+ * from either end. When `reference` (a carrier frequency) is given the band is widened
+ * to include it, so a single sideband measures as the message bandwidth rather than
+ * as one spectral line.
+ */
+export function occupiedBandwidth(spectrum: DataPoint[], fraction = 0.99, reference?: number): OccupiedBand {
+  let total = 0;
+  for (const point of spectrum) total += point.y * point.y;
+  if (spectrum.length === 0 || total === 0) return { low: 0, high: 0, bandwidth: 0 };
+
+  const tail = (total * (1 - fraction)) / 2;
+  let lowIndex = 0;
+  for (let acc = 0; lowIndex < spectrum.length - 1; lowIndex++) {
+    acc += spectrum[lowIndex].y * spectrum[lowIndex].y;
+    if (acc > tail) break;
+  }
+  let highIndex = spectrum.length - 1;
+  for (let acc = 0; highIndex > lowIndex; highIndex--) {
+    acc += spectrum[highIndex].y * spectrum[highIndex].y;
+    if (acc > tail) break;
+  }
+
+  let low = spectrum[lowIndex].x;
+  let high = spectrum[highIndex].x;
+  if (reference !== undefined) {
+    low = Math.min(low, reference);
+    high = Math.max(high, reference);
+  }
+  return { low, high, bandwidth: high - low };
+}
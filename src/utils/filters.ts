@@ -0,0 +1,357 @@
+import { ReconstructionMethod, SamplePrecision } from '../types';
+import { FloatArray } from './bufferPool';
+import { fft } from './fft';
+
+export type WindowType = 'hamming' | 'blackman';
+
+// Filter designs are pure functions of their parameters, so every stage asking for
+// the same response shares one kernel instead of redesigning it per run.
+const designCache = new Map<string, Float64Array>();
+
+function cached(key: string, design: () => Float64Array): Float64Array {
+  let taps = designCache.get(key);
+  if (!taps) {
+    taps = design();
+    designCache.set(key, taps);
+  }
+  return taps;
+}
+
+function windowValue(window: WindowType, n: number, length: number): number {
+  if (length === 1) return 1;
+  const phase = (2 * Math.PI * n) / (length - 1);
+  switch (window) {
+    case 'hamming':
+      return 0.54 - 0.46 * Math.cos(phase);
+    case 'blackman':
+      return 0.42 - 0.5 * Math.cos(phase) + 0.08 * Math.cos(2 * phase);
+  }
+}
+
+function sinc(x: number): number {
+  if (x === 0) return 1;
+  const px = Math.PI * x;
+  return Math.sin(px) / px;
+}
+
+/**
+ * Designs a windowed-sinc lowpass FIR filter with unity DC gain.
+ *
+ * @param cutoff - Cutoff frequency normalised to the sample rate (0 to 0.5)
+ * @param numTaps - Filter length; odd lengths give an integer group delay
+ * @param window - Window applied to the ideal impulse response
+ */
+export function designLowpass(cutoff: number, numTaps: number, window: WindowType = 'hamming'): Float64Array {
+  const fc = Math.min(0.5, Math.max(0, cutoff));
+  const key = `lowpass:${fc.toFixed(9)}:${numTaps}:${window}`;
+
+  return cached(key, () => {
+    const taps = new Float64Array(numTaps);
+    const center = (numTaps - 1) / 2;
+    let sum = 0;
+    for (let n = 0; n < numTaps; n++) {
+      taps[n] = 2 * fc * sinc(2 * fc * (n - center)) * windowValue(window, n, numTaps);
+      sum += taps[n];
+    }
+    if (sum !== 0) {
+      for (let n = 0; n < numTaps; n++) taps[n] /= sum;
+    }
+    return taps;
+  });
+}
+
+/**
+ * Designs a linear-phase FIR filter whose gain follows `response` by frequency sampling:
+ * the response is sampled on a grid eight times the filter length, transformed to its
+ * zero-phase impulse response and windowed to `numTaps` around the centre. With
+ * `quadrature` the design is the Hilbert transformer, −j·sgn(f) weighted by `response`.
+ *
+ * @param response - Gain at a frequency normalised to the sample rate (0 to 0.5)
+ * @param numTaps - Odd filter length; the group delay is (numTaps − 1) / 2 samples
+ * @param quadrature - Design the weighted Hilbert transformer instead of a plain filter
+ * @param window - Window applied to the sampled impulse response
+ */
+export function designFromResponse(
+  response: (frequency: number) => number,
+  numTaps: number,
+  quadrature = false,
+  window: WindowType = 'blackman'
+): Float64Array {
+  if (numTaps < 1 || numTaps % 2 === 0) throw new Error('A response-sampled filter needs an odd tap count');
+  const grid = 2 ** Math.ceil(Math.log2(8 * numTaps));
+  const re = new Float64Array(grid);
+  const im = new Float64Array(grid);
+  for (let k = 0; k < grid; k++) {
+    const gain = response(Math.min(k, grid - k) / grid);
+    if (quadrature) {
+      // DC and Nyquist have no quadrature part
+      const sign = k === 0 || 2 * k === grid ? 0 : k < grid / 2 ? 1 : -1;
+      im[k] = -sign * gain;
+    } else {
+      re[k] = gain;
+    }
+  }
+  fft(re, im, grid, true);
+
+  const taps = new Float64Array(numTaps);
+  const center = (numTaps - 1) / 2;
+  for (let n = 0; n < numTaps; n++) {
+    taps[n] = (re[(n - center + grid) % grid] / grid) * windowValue(window, n, numTaps);
+  }
+  return taps;
+}
+
+/**
+ * Picks an odd tap count whose Hamming transition band is roughly `transition`
+ * (normalised to the sample rate), clamped to keep short displays usable.
+ */
+export function lowpassLength(transition: number, minTaps = 31, maxTaps = 129): number {
+  const taps = Math.ceil(3.3 / Math.max(transition, 1e-6));
+  const clamped = Math.min(maxTaps, Math.max(minTaps, taps));
+  return clamped % 2 === 0 ? clamped + 1 : clamped;
+}
+
+const singlePrecisionTaps = new WeakMap<Float64Array, Float32Array>();
+
+/** Returns a design's taps in the requested precision; float32 copies are cached per design. */
+export function tapsInPrecision(taps: Float64Array, precision: SamplePrecision): FloatArray {
+  if (precision === 'float64') return taps;
+  let single = singlePrecisionTaps.get(taps);
+  if (!single) {
+    single = Float32Array.from(taps);
+    singlePrecisionTaps.set(taps, single);
+  }
+  return single;
+}
+
+/**
+ * Streaming direct-form FIR filter.
+ * State is kept between calls, so a signal can be filtered in arbitrary blocks.
+ */
+export class FirFilter {
+  readonly taps: FloatArray;
+  /** Group delay in samples for the (symmetric) designs produced above. */
+  readonly delay: number;
+  // History is stored twice so the convolution window is always contiguous
+  private readonly history: FloatArray;
+  private position = 0;
+
+  /**
+   * `history`, when given, must be zeroed and hold `2 * taps.length` samples.
+   * Float32 taps and history run the whole kernel in single precision storage.
+   */
+  constructor(taps: FloatArray, history: FloatArray = new Float64Array(taps.length * 2)) {
+    if (history.length !== taps.length * 2) {
+      throw new Error(`FIR history must hold ${taps.length * 2} samples`);
+    }
+    this.taps = taps;
+    this.delay = (taps.length - 1) / 2;
+    this.history = history;
+  }
+
+  /** Filters `count` samples from `input` into `output` (which may alias `input`). */
+  process(input: ArrayLike<number>, output: FloatArray, count = input.length): void {
+    for (let i = 0; i < count; i++) {
+      output[i] = this.step(input[i]);
+    }
+  }
+
+  /** Filters a single sample. */
+  step(x: number): number {
+    const taps = this.taps;
+    const length = taps.length;
+    const history = this.history;
+
+    this.position = this.position === 0 ? length - 1 : this.position - 1;
+    history[this.position] = x;
+    history[this.position + length] = x;
+
+    let acc = 0;
+    const base = this.position;
+    for (let k = 0; k < length; k++) {
+      acc += taps[k] * history[base + k];
+    }
+    return acc;
+  }
+
+  reset(): void {
+    this.history.fill(0);
+    this.position = 0;
+  }
+}
+
+// Oversampling factor of the tabulated reconstruction kernel
+const SINC_TABLE_PHASES = 256;
+
+/**
+ * Tabulated Blackman-windowed sinc for reconstruction, indexed by |x| * phases.
+ * `bandwidth` scales the kernel when the output rate is below the sample rate.
+ */
+function sincTable(halfWidth: number, bandwidth: number): Float64Array {
+  const key = `sinc:${halfWidth}:${bandwidth.toFixed(9)}`;
+  return cached(key, () => {
+    const span = Math.ceil(halfWidth / bandwidth);
+    const table = new Float64Array(span * SINC_TABLE_PHASES + 2);
+    for (let i = 0; i < table.length; i++) {
+      const x = i / SINC_TABLE_PHASES;
+      if (x >= span) break;
+      const w = 0.42 + 0.5 * Math.cos((Math.PI * x) / span) + 0.08 * Math.cos((2 * Math.PI * x) / span);
+      table[i] = bandwidth * sinc(bandwidth * x) * w;
+    }
+    return table;
+  });
+}
+
+function reconstructionSpan(
+  method: ReconstructionMethod,
+  sampleRate: number,
+  displayRate: number,
+  halfWidth: number
+): number {
+  if (method !== 'sinc') return 1;
+  return Math.ceil(halfWidth / Math.min(1, displayRate / sampleRate));
+}
+
+/**
+ * Band-limited (windowed-sinc) value of a stored sample sequence at fractional
+ * index `position`. The sequence is extended by point reflection about its end
+ * samples, as the anti-alias filter does, so the edges keep their slope instead
+ * of drooping towards zero.
+ */
+export function bandlimitedValue(samples: ArrayLike<number>, position: number, halfWidth = 8): number {
+  const last = samples.length - 1;
+  if (last < 0) return 0;
+  const table = sincTable(halfWidth, 1);
+  const base = Math.floor(position);
+  let acc = 0;
+  for (let n = base - halfWidth + 1; n <= base + halfWidth; n++) {
+    const offset = Math.abs(position - n) * SINC_TABLE_PHASES;
+    const i = Math.floor(offset);
+    if (i >= table.length - 1) continue;
+    let sample: number;
+    if (n < 0) sample = 2 * samples[0] - samples[Math.min(last, -n)];
+    else if (n > last) sample = 2 * samples[last] - samples[Math.max(0, 2 * last - n)];
+    else sample = samples[n];
+    acc += (table[i] + (offset - i) * (table[i + 1] - table[i])) * sample;
+  }
+  return acc;
+}
+
+/**
+ * Streaming DAC model: turns samples taken at `sampleRate` into a waveform on the
+ * display grid (`k / displayRate`). Each display value becomes available as soon as
+ * every sample it depends on has been pushed; callers drain `next()` before pushing
+ * more so the ring only ever holds the kernel's support.
+ */
+export class Reconstructor {
+  private readonly method: ReconstructionMethod;
+  private readonly sampleRate: number;
+  private readonly displayRate: number;
+  private readonly table: Float64Array | null;
+  /** Kernel support on each side, in input samples */
+  private readonly span: number;
+  // Ring buffer of the most recent samples, addressed by absolute sample index
+  private readonly ring: FloatArray;
+  private received = 0;
+  private nextOutput = 0;
+  private ended = false;
+
+  /** `ring`, when given, must hold `Reconstructor.ringLength(...)` samples for the same arguments. */
+  constructor(
+    method: ReconstructionMethod,
+    sampleRate: number,
+    displayRate: number,
+    halfWidth = 8,
+    ring?: FloatArray
+  ) {
+    this.method = method;
+    this.sampleRate = sampleRate;
+    this.displayRate = displayRate;
+
+    if (method === 'sinc') {
+      const bandwidth = Math.min(1, displayRate / sampleRate);
+      this.table = sincTable(halfWidth, bandwidth);
+    } else {
+      this.table = null;
+    }
+    this.span = reconstructionSpan(method, sampleRate, displayRate, halfWidth);
+    const ringLength = Reconstructor.ringLength(method, sampleRate, displayRate, halfWidth);
+    if (ring && ring.length !== ringLength) {
+      throw new Error(`Reconstruction ring must hold ${ringLength} samples`);
+    }
+    this.ring = ring ?? new Float64Array(ringLength);
+  }
+
+  /** Samples of history the reconstructor keeps for the given settings. */
+  static ringLength(method: ReconstructionMethod, sampleRate: number, displayRate: number, halfWidth = 8): number {
+    return 2 * reconstructionSpan(method, sampleRate, displayRate, halfWidth) + 2;
+  }
+
+  /** Appends the next input sample. */
+  push(sample: number): void {
+    this.ring[this.received % this.ring.length] = sample;
+    this.received++;
+  }
+
+  /** Marks the input as complete; samples beyond the end are treated as zero. */
+  end(): void {
+    this.ended = true;
+  }
+
+  /**
+   * Returns the next display-rate value, or null while it still depends on samples that
+   * have not been pushed, or once the output would pass `endTime`.
+   */
+  next(endTime = Infinity): number | null {
+    if (!this.available(endTime)) return null;
+    const position = (this.nextOutput++ / this.displayRate) * this.sampleRate;
+    return this.valueAt(position, Math.floor(position + 1e-9));
+  }
+
+  /** Moves past the next display-rate value without computing it; false where `next` would return null. */
+  skip(endTime = Infinity): boolean {
+    if (!this.available(endTime)) return false;
+    this.nextOutput++;
+    return true;
+  }
+
+  private available(endTime: number): boolean {
+    const time = this.nextOutput / this.displayRate;
+    if (time > endTime + 1e-9) return false;
+    const index = Math.floor(time * this.sampleRate + 1e-9);
+    const lookahead = this.method === 'zero-order' ? 0 : this.span;
+    return this.ended || index + lookahead < this.received;
+  }
+
+  private sample(index: number): number {
+    if (index < 0 || index >= this.received || index < this.received - this.ring.length) return 0;
+    return this.ring[index % this.ring.length];
+  }
+
+  private valueAt(position: number, index: number): number {
+    const last = this.received - 1;
+
+    switch (this.method) {
+      case 'zero-order':
+        return this.sample(Math.min(index, last));
+      case 'first-order': {
+        if (index >= last) return this.sample(last);
+        const fraction = position - index;
+        const y0 = this.sample(index);
+        return y0 + Math.max(0, fraction) * (this.sample(index + 1) - y0);
+      }
+      case 'sinc': {
+        const table = this.table!;
+        let acc = 0;
+        for (let n = index - this.span + 1; n <= index + this.span; n++) {
+          const offset = Math.abs(position - n) * SINC_TABLE_PHASES;
+          const i = Math.floor(offset);
+          if (i >= table.length - 1) continue;
+          const weight = table[i] + (offset - i) * (table[i + 1] - table[i]);
+          acc += weight * this.sample(n);
+        }
+        return acc;
+      }
+    }
+  }
+}
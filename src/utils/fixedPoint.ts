@@ -0,0 +1,355 @@
+import { Arena } from './bufferPool';
+import { InputPort, OutputPort, Stage } from './pipeline';
+
+/**
+ * Fixed-point emulation of the DSP kernels found on modem hardware.
+ * Q15 values live in Int16Array storage and Q31 values in Int32Array storage;
+ * stages convert at their float ports (the ADC/DAC boundary) and count every
+ * value that had to be clamped.
+ */
+export type QFormat = 'q15' | 'q31';
+
+export interface FixedPointStats {
+  /** Results clamped to the format's range */
+  saturations: number;
+  /** Accumulations that exceeded a 32-bit accumulator (absorbed by guard bits) */
+  overflows: number;
+}
+
+export type FixedArray = Int16Array | Int32Array;
+
+export function createStats(): FixedPointStats {
+  return { saturations: 0, overflows: 0 };
+}
+
+export function fractionBits(format: QFormat): number {
+  return format === 'q15' ? 15 : 31;
+}
+
+/** Value of 1.0 in the format (one past the largest representable value). */
+export function qOne(format: QFormat): number {
+  return format === 'q15' ? 0x8000 : 0x80000000;
+}
+
+/** Clamps an integer result to the format's range, counting the clamp. */
+export function saturate(value: number, format: QFormat, stats: FixedPointStats): number {
+  const one = qOne(format);
+  if (value >= one) {
+    stats.saturations++;
+    return one - 1;
+  }
+  if (value < -one) {
+    stats.saturations++;
+    return -one;
+  }
+  return value;
+}
+
+/** Converts a real value in [-1, 1) to the format with round-to-nearest and saturation. */
+export function toFixed(value: number, format: QFormat, stats: FixedPointStats): number {
+  return saturate(Math.round(value * qOne(format)), format, stats);
+}
+
+export function fromFixed(value: number, format: QFormat): number {
+  return value / qOne(format);
+}
+
+/** Rounded Q15 product; only -1 × -1 leaves the Q15 range, so callers saturate. */
+export function mulQ15(a: number, b: number): number {
+  return (Math.imul(a, b) + 0x4000) >> 15;
+}
+
+/**
+ * Rounded Q31 product. The 62-bit product is formed from 16-bit halves so every
+ * partial sum stays exact in a double, as a 32×32→64 multiplier would produce it.
+ */
+export function mulQ31(a: number, b: number): number {
+  const ah = a >> 16;
+  const al = a & 0xffff;
+  const bh = b >> 16;
+  const bl = b & 0xffff;
+  const high = Math.imul(ah, bh);
+  const middle = ah * bl + al * bh;
+  const low = al * bl;
+  return high * 2 + Math.floor((middle * 0x10000 + low + 0x40000000) / 0x80000000);
+}
+
+export function mulFixed(a: number, b: number, format: QFormat, stats: FixedPointStats): number {
+  return saturate(format === 'q15' ? mulQ15(a, b) : mulQ31(a, b), format, stats);
+}
+
+/** 32-bit saturating add (QADD). */
+export function addSaturate32(a: number, b: number, stats: FixedPointStats): number {
+  const sum = a + b;
+  if (sum > 0x7fffffff) {
+    stats.saturations++;
+    return 0x7fffffff;
+  }
+  if (sum < -0x80000000) {
+    stats.saturations++;
+    return -0x80000000;
+  }
+  return sum;
+}
+
+function allocateFixed(arena: Arena, format: QFormat, length: number): FixedArray {
+  return format === 'q15' ? arena.int16(length) : arena.int32(length);
+}
+
+// ---------------------------------------------------------------------------
+// Oscillator
+// ---------------------------------------------------------------------------
+
+// Sine table resolution of the numerically controlled oscillator
+const SINE_TABLE_BITS = 12;
+const SINE_TABLE_SIZE = 1 << SINE_TABLE_BITS;
+const sineTables = new Map<QFormat, FixedArray>();
+
+/** One sine period in the format, with a guard entry so interpolation never wraps. */
+function sineTable(format: QFormat): FixedArray {
+  let table = sineTables.get(format);
+  if (!table) {
+    table = format === 'q15' ? new Int16Array(SINE_TABLE_SIZE + 1) : new Int32Array(SINE_TABLE_SIZE + 1);
+    const scratch = createStats();
+    for (let i = 0; i <= SINE_TABLE_SIZE; i++) {
+      table[i] = toFixed(Math.sin((2 * Math.PI * i) / SINE_TABLE_SIZE), format, scratch);
+    }
+    sineTables.set(format, table);
+  }
+  return table;
+}
+
+/**
+ * Numerically controlled oscillator: a wrapping 32-bit phase accumulator addressing
+ * the sine table, with linear interpolation on the remaining phase bits.
+ */
+class Nco {
+  private readonly format: QFormat;
+  private readonly table: FixedArray;
+  private readonly step: number;
+  private phase = 0;
+
+  constructor(format: QFormat, frequency: number, sampleRate: number) {
+    this.format = format;
+    this.table = sineTable(format);
+    this.step = Math.round((frequency / sampleRate) * 0x100000000) >>> 0;
+  }
+
+  next(): number {
+    const phase = this.phase;
+    this.phase = (phase + this.step) >>> 0;
+    const index = phase >>> (32 - SINE_TABLE_BITS);
+    const s0 = this.table[index];
+    const s1 = this.table[index + 1];
+    // The phase bits below the table index, as a fraction in the format
+    if (this.format === 'q15') {
+      const fraction = (phase >>> (32 - SINE_TABLE_BITS - 15)) & 0x7fff;
+      return s0 + mulQ15(s1 - s0, fraction);
+    }
+    const fraction = (phase << SINE_TABLE_BITS) >>> 1;
+    return s0 + mulQ31(s1 - s0, fraction);
+  }
+}
+
+/** Fixed-point counterpart of `ToneSource`; `fullScale` maps to 1.0 in the format. */
+export class FixedPointOscillator implements Stage {
+  readonly name: string;
+  readonly inputs = [] as const;
+  readonly outputs = ['real'] as const;
+  readonly stats = createStats();
+  private readonly format: QFormat;
+  private readonly nco: Nco;
+  private readonly gain: number;
+  private readonly fullScale: number;
+  private readonly count: number;
+  private position = 0;
+
+  constructor(format: QFormat, frequency: number, amplitude: number, sampleRate: number, count: number, fullScale = 2) {
+    this.name = `${format} oscillator`;
+    this.format = format;
+    this.nco = new Nco(format, frequency, sampleRate);
+    this.gain = toFixed(amplitude / fullScale, format, this.stats);
+    this.fullScale = fullScale;
+    this.count = count;
+  }
+
+  process(_inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const output = outputs[0];
+    while (output.length < output.capacity && this.position < this.count) {
+      const value = mulFixed(this.nco.next(), this.gain, this.format, this.stats);
+      output.data[output.length++] = fromFixed(value, this.format) * this.fullScale;
+      this.position++;
+    }
+    return this.position >= this.count;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Filters
+// ---------------------------------------------------------------------------
+
+/**
+ * Causal fixed-point FIR. Q15 runs 16×16 multiplies into a wide accumulator (a DSP
+ * MAC with guard bits) and counts sums that would not fit 32 bits; Q31 rounds each
+ * product to Q31 and accumulates with 32-bit saturation.
+ */
+export class FixedPointFir implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  readonly stats = createStats();
+  private readonly format: QFormat;
+  private readonly design: Float64Array;
+  private readonly fullScale: number;
+  private taps!: FixedArray;
+  // Doubled history so the convolution window is contiguous, as in FirFilter
+  private history!: FixedArray;
+  private position = 0;
+
+  constructor(format: QFormat, taps: Float64Array, fullScale = 2) {
+    this.name = `${format} FIR`;
+    this.format = format;
+    this.design = taps;
+    this.fullScale = fullScale;
+  }
+
+  setup(arena: Arena): void {
+    const length = this.design.length;
+    this.taps = allocateFixed(arena, this.format, length);
+    for (let k = 0; k < length; k++) {
+      this.taps[k] = toFixed(this.design[k], this.format, this.stats);
+    }
+    this.history = allocateFixed(arena, this.format, length * 2);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const taps = this.taps;
+    const history = this.history;
+    const length = taps.length;
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+
+    for (let i = 0; i < count; i++) {
+      const x = toFixed(input.data[input.offset + i] / this.fullScale, this.format, this.stats);
+      this.position = this.position === 0 ? length - 1 : this.position - 1;
+      history[this.position] = x;
+      history[this.position + length] = x;
+
+      const base = this.position;
+      let y: number;
+      if (this.format === 'q15') {
+        let acc = 0;
+        for (let k = 0; k < length; k++) {
+          acc += Math.imul(taps[k], history[base + k]);
+        }
+        if (acc > 0x7fffffff || acc < -0x80000000) this.stats.overflows++;
+        y = saturate(Math.floor((acc + 0x4000) / 0x8000), 'q15', this.stats);
+      } else {
+        let acc = 0;
+        for (let k = 0; k < length; k++) {
+          acc = addSaturate32(acc, mulQ31(taps[k], history[base + k]), this.stats);
+        }
+        y = acc;
+      }
+      output.data[output.length + i] = fromFixed(y, this.format) * this.fullScale;
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Quantizer
+// ---------------------------------------------------------------------------
+
+/** Fixed-point counterpart of `PcmQuantizer`: the level index is formed with integer ops. */
+export class FixedPointQuantizer implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['symbols'] as const;
+  readonly stats = createStats();
+  private readonly format: QFormat;
+  private readonly amplitude: number;
+  private readonly levels: number;
+
+  constructor(format: QFormat, amplitude: number, levels: number) {
+    if (format === 'q15' && levels > 0x8000) {
+      throw new Error('Q15 quantizer supports at most 32768 levels');
+    }
+    this.name = `${format} PCM quantizer`;
+    this.format = format;
+    this.amplitude = amplitude;
+    this.levels = levels;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    const steps = this.levels - 1;
+
+    for (let i = 0; i < count; i++) {
+      const x = toFixed(input.data[input.offset + i] / this.amplitude, this.format, this.stats);
+      // round((x + 1) / 2 * (levels - 1)) with x in the format
+      output.data[output.length + i] = this.format === 'q15'
+        ? (Math.imul(x + 0x8000, steps) + 0x8000) >>> 16
+        : Math.floor(((x + 0x80000000) * steps + 0x80000000) / 0x100000000);
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Demodulators
+// ---------------------------------------------------------------------------
+
+/**
+ * Fixed-point coherent BPSK receiver: mixes with an NCO replica of the carrier and
+ * integrates over each symbol. Products are pre-shifted by log2(samplesPerSymbol)
+ * (block scaling) so the integrator cannot overflow; the sign decides the bit.
+ */
+export class FixedPointBpskDemodulator implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['bits'] as const;
+  readonly stats = createStats();
+  private readonly format: QFormat;
+  private readonly nco: Nco;
+  private readonly samplesPerSymbol: number;
+  private readonly shift: number;
+  private readonly fullScale: number;
+  private accumulator = 0;
+  private symbolSample = 0;
+
+  constructor(format: QFormat, carrierFrequency: number, sampleRate: number, samplesPerSymbol: number, fullScale = 2) {
+    this.name = `${format} BPSK demodulator`;
+    this.format = format;
+    this.nco = new Nco(format, carrierFrequency, sampleRate);
+    this.samplesPerSymbol = samplesPerSymbol;
+    this.shift = Math.ceil(Math.log2(samplesPerSymbol));
+    this.fullScale = fullScale;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    while (input.offset < input.length) {
+      if (this.symbolSample === this.samplesPerSymbol - 1 && output.length >= output.capacity) return false;
+      const x = toFixed(input.data[input.offset++] / this.fullScale, this.format, this.stats);
+      const product = mulFixed(x, this.nco.next(), this.format, this.stats);
+      this.accumulator = addSaturate32(this.accumulator, product >> this.shift, this.stats);
+      if (++this.symbolSample === this.samplesPerSymbol) {
+        output.data[output.length++] = this.accumulator >= 0 ? 1 : 0;
+        this.accumulator = 0;
+        this.symbolSample = 0;
+      }
+    }
+    // A trailing partial symbol (the modulator's closing sample) carries no decision
+    return input.ended;
+  }
+}
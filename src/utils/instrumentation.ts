@@ -0,0 +1,164 @@
+/**
+ * Opt-in timing of pipeline stages, signal generators and chart renders. While
+ * recording is off every hook is a single boolean test, so the instrumentation can stay
+ * wired in permanently; the performance overlay switches it on while it is open.
+ *
+ * Each timing is also published as a User Timing measure (`performance.measure`), so
+ * the same spans appear in the browser's performance panel, and is copied into the
+ * Chrome trace while one is recording.
+ */
+import { clearRunCounts, hotCounterSnapshot, recordRunCounts } from './counters';
+import { traceCounter, traceRecording, traceSpan } from './trace';
+
+export type TimingCategory = 'stage' | 'generate' | 'render' | 'commit';
+
+export interface TimingSeries {
+  name: string;
+  category: TimingCategory;
+  /** Duration of the latest occurrence, in milliseconds */
+  latestMs: number;
+  /** Items the latest occurrence produced (0 when not counted) */
+  items: number;
+  itemsPerSecond: number;
+  /** Durations of the most recent occurrences, oldest first */
+  history: number[];
+}
+
+const HISTORY_LENGTH = 32;
+
+interface SeriesState {
+  name: string;
+  category: TimingCategory;
+  latestMs: number;
+  items: number;
+  history: Float64Array;
+  head: number;
+  count: number;
+}
+
+let enabled = false;
+const series = new Map<string, SeriesState>();
+const listeners = new Set<() => void>();
+let notifyPending = false;
+
+/** True while the overlay or a trace recording wants timings. */
+export function instrumentationEnabled(): boolean {
+  return enabled || traceRecording();
+}
+
+export function setInstrumentationEnabled(on: boolean): void {
+  enabled = on;
+}
+
+/** Forgets every series and drops its User Timing measures from the performance buffer. */
+export function clearTimings(): void {
+  for (const key of series.keys()) performance.clearMeasures(key);
+  series.clear();
+  if (__SIGNAL_COUNTERS__) clearRunCounts();
+  notify();
+}
+
+/** Calls `listener` (at most once per frame) after new timings arrive. */
+export function subscribeTimings(listener: () => void): () => void {
+  listeners.add(listener);
+  return () => {
+    listeners.delete(listener);
+  };
+}
+
+function notify(): void {
+  if (notifyPending || listeners.size === 0) return;
+  notifyPending = true;
+  const flush = () => {
+    notifyPending = false;
+    listeners.forEach(listener => listener());
+  };
+  if (typeof requestAnimationFrame === 'function') requestAnimationFrame(flush);
+  else setTimeout(flush, 16);
+}
+
+/** Adds one occurrence of `name`; `start` places its User Timing measure. */
+export function recordTiming(name: string, category: TimingCategory, start: number, durationMs: number, items = 0): void {
+  // The pipeline traces stages step by step itself; the per-run total would overlap them
+  if (category !== 'stage') traceSpan(name, category, start, durationMs, items ? { items } : undefined);
+  if (!enabled) return;
+  const key = `${category}:${name}`;
+  performance.measure(key, { start, duration: durationMs, detail: { items } });
+
+  let state = series.get(key);
+  if (!state) {
+    state = { name, category, latestMs: 0, items: 0, history: new Float64Array(HISTORY_LENGTH), head: 0, count: 0 };
+    series.set(key, state);
+  }
+  state.latestMs = durationMs;
+  state.items = items;
+  state.history[state.head] = durationMs;
+  state.head = (state.head + 1) % HISTORY_LENGTH;
+  state.count = Math.min(state.count + 1, HISTORY_LENGTH);
+  notify();
+}
+
+/**
+ * Runs `run` between `performance.mark` calls and records it under `name`. `count`
+ * turns the result into an item count for the throughput column. Instrumented builds
+ * also keep the hot-path operation counts the call made.
+ */
+export function timed<T>(name: string, run: () => T, count?: (result: T) => number): T {
+  if (!instrumentationEnabled()) return run();
+  const startMark = `${name}:start`;
+  const before = __SIGNAL_COUNTERS__ ? hotCounterSnapshot() : null;
+  performance.mark(startMark);
+  const start = performance.now();
+  const result = run();
+  const duration = performance.now() - start;
+  performance.clearMarks(startMark);
+  if (__SIGNAL_COUNTERS__ && before) {
+    const counts = recordRunCounts(name, before);
+    traceCounter(`${name} operations`, { ...counts }, start + duration);
+  }
+  recordTiming(name, 'generate', start, duration, count ? count(result) : 0);
+  return result;
+}
+
+/** `count` for `timed` around the signal generators: transmitted points produced. */
+export function countPoints(data: { transmitted: ArrayLike<unknown> }): number {
+  return data.transmitted.length;
+}
+
+/**
+ * `onRender` callback for React `<Profiler>`: records the render time of the profiled
+ * subtree and how far into the commit phase the callback ran.
+ */
+export function recordRender(
+  id: string,
+  _phase: string,
+  actualDuration: number,
+  _baseDuration: number,
+  startTime: number,
+  commitTime: number
+): void {
+  if (!instrumentationEnabled()) return;
+  recordTiming(id, 'render', startTime, actualDuration);
+  recordTiming(id, 'commit', commitTime, performance.now() - commitTime);
+}
+
+/** Current series ordered by category, then name. */
+export function timingSnapshot(): TimingSeries[] {
+  const order: TimingCategory[] = ['generate', 'stage', 'render', 'commit'];
+  return [...series.values()]
+    .map(state => {
+      const history: number[] = [];
+      for (let i = 0; i < state.count; i++) {
+        history.push(state.history[(state.head - state.count + i + HISTORY_LENGTH) % HISTORY_LENGTH]);
+      }
+      return {
+        name: state.name,
+        category: state.category,
+        latestMs: state.latestMs,
+        items: state.items,
+        itemsPerSecond: state.latestMs > 0 ? (state.items / state.latestMs) * 1000 : 0,
+        history,
+      };
+    })
+    .sort((a, b) => order.indexOf(a.category) - order.indexOf(b.category) || a.name.localeCompare(b.name));
+}
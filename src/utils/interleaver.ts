@@ -0,0 +1,281 @@
+import { PortType, SamplePrecision } from '../types';
+import { Arena, FloatArray } from './bufferPool';
+import { BlockData, InputPort, OutputPort, Stage } from './pipeline';
+
+/**
+ * Interleavers spread a burst of channel errors over many codewords. They take any port
+ * type, so they can sit between a coder and a modulator (bits or symbols) or around a
+ * channel (real or complex samples), and every one is paired with its deinterleaver.
+ */
+
+// Square tiles small enough that a source and a destination tile stay in L1 together
+const TILE = 32;
+
+/**
+ * Writes the row-major `rows` × `cols` matrix in `source` to `target` as its row-major
+ * `cols` × `rows` transpose. Walking tile by tile keeps both the strided reads and the
+ * strided writes inside a few cache lines instead of striding across the whole block.
+ */
+export function transposeTiled(source: BlockData, target: BlockData, rows: number, cols: number): void {
+  for (let r0 = 0; r0 < rows; r0 += TILE) {
+    const r1 = Math.min(r0 + TILE, rows);
+    for (let c0 = 0; c0 < cols; c0 += TILE) {
+      const c1 = Math.min(c0 + TILE, cols);
+      for (let r = r0; r < r1; r++) {
+        let from = r * cols + c0;
+        for (let c = c0; c < c1; c++) target[c * rows + r] = source[from++];
+      }
+    }
+  }
+}
+
+function allocate(arena: Arena, type: PortType, precision: SamplePrecision, length: number): BlockData {
+  if (type === 'bits') return arena.uint8(length);
+  if (type === 'symbols') return arena.int32(length);
+  return arena.float(precision, length);
+}
+
+// ---------------------------------------------------------------------------
+// Block interleaver
+// ---------------------------------------------------------------------------
+
+/**
+ * Row/column block permutation. The interleaver writes `rows` × `cols` items row by row
+ * and reads them column by column; the deinterleaver undoes it. A short final block is
+ * permuted the same way with its empty cells skipped, so stream lengths are preserved.
+ */
+class BlockPermutation implements Stage {
+  readonly name: string;
+  readonly inputs: readonly PortType[];
+  readonly outputs: readonly PortType[];
+  private readonly rows: number;
+  private readonly cols: number;
+  private readonly inverse: boolean;
+  private pending: BlockData = new Uint8Array(0);
+  private ready: BlockData = new Uint8Array(0);
+  private pendingImag: FloatArray | null = null;
+  private readyImag: FloatArray | null = null;
+  private filled = 0;
+  private readyLength = 0;
+  private readPosition = 0;
+
+  constructor(name: string, type: PortType, rows: number, cols: number, inverse: boolean) {
+    if (rows < 1 || cols < 1) throw new Error('Interleaver dimensions must be positive');
+    this.name = name;
+    this.inputs = [type];
+    this.outputs = [type];
+    this.rows = rows;
+    this.cols = cols;
+    this.inverse = inverse;
+  }
+
+  setup(arena: Arena, precision: SamplePrecision): void {
+    const size = this.rows * this.cols;
+    const type = this.inputs[0];
+    this.pending = allocate(arena, type, precision, size);
+    this.ready = allocate(arena, type, precision, size);
+    if (type === 'complex') {
+      this.pendingImag = arena.float(precision, size);
+      this.readyImag = arena.float(precision, size);
+    }
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const size = this.rows * this.cols;
+
+    for (;;) {
+      // Drain the permuted block first
+      if (this.readPosition < this.readyLength) {
+        const count = Math.min(this.readyLength - this.readPosition, output.capacity - output.length);
+        output.data.set(this.ready.subarray(this.readPosition, this.readPosition + count), output.length);
+        if (this.readyImag && output.imag) {
+          output.imag.set(this.readyImag.subarray(this.readPosition, this.readPosition + count), output.length);
+        }
+        output.length += count;
+        this.readPosition += count;
+        if (this.readPosition < this.readyLength) return false;
+      }
+
+      const count = Math.min(size - this.filled, input.length - input.offset);
+      this.pending.set(input.data.subarray(input.offset, input.offset + count), this.filled);
+      if (this.pendingImag && input.imag) {
+        this.pendingImag.set(input.imag.subarray(input.offset, input.offset + count), this.filled);
+      }
+      input.offset += count;
+      this.filled += count;
+
+      if (this.filled === size) {
+        this.permuteFull();
+      } else if (input.ended && input.offset === input.length) {
+        if (this.filled === 0) return true;
+        this.permutePartial();
+      } else {
+        return false;
+      }
+      this.readyLength = this.filled;
+      this.readPosition = 0;
+      this.filled = 0;
+    }
+  }
+
+  private permuteFull(): void {
+    // Interleaving reads columns of rows × cols; deinterleaving reads columns of cols × rows
+    const [rows, cols] = this.inverse ? [this.cols, this.rows] : [this.rows, this.cols];
+    transposeTiled(this.pending, this.ready, rows, cols);
+    if (this.pendingImag && this.readyImag) transposeTiled(this.pendingImag, this.readyImag, rows, cols);
+  }
+
+  private permutePartial(): void {
+    const { rows, cols, filled, pending, ready, pendingImag, readyImag } = this;
+    let k = 0;
+    for (let c = 0; c < cols; c++) {
+      for (let r = 0; r < rows; r++) {
+        const p = r * cols + c;
+        if (p >= filled) continue;
+        const [from, to] = this.inverse ? [k, p] : [p, k];
+        ready[to] = pending[from];
+        if (pendingImag && readyImag) readyImag[to] = pendingImag[from];
+        k++;
+      }
+    }
+  }
+}
+
+/** Writes `rows` × `cols` blocks row by row and sends them column by column. */
+export class BlockInterleaver extends BlockPermutation {
+  constructor(type: PortType, rows: number, cols: number) {
+    super('block interleaver', type, rows, cols, false);
+  }
+}
+
+/** Inverse of `BlockInterleaver` with the same `rows` and `cols`. */
+export class BlockDeinterleaver extends BlockPermutation {
+  constructor(type: PortType, rows: number, cols: number) {
+    super('block deinterleaver', type, rows, cols, true);
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Convolutional interleaver
+// ---------------------------------------------------------------------------
+
+/**
+ * Forney convolutional interleaving: a commutator steps through `branches` delay lines,
+ * one item per line, where line i delays by i · `unitDelay` items in the interleaver and
+ * by (branches − 1 − i) · `unitDelay` in the deinterleaver, so every item is delayed by
+ * the same `latency` end to end. All lines share one ring-buffer store with a head per
+ * line, so each item costs one read and one write.
+ *
+ * The interleaver flushes `latency` zeros after its input ends and the deinterleaver
+ * drops the first `latency` items it produces, so the pair preserves stream lengths.
+ */
+class ConvolutionalPermutation implements Stage {
+  readonly name: string;
+  readonly inputs: readonly PortType[];
+  readonly outputs: readonly PortType[];
+  /** Items between an item entering the interleaver and leaving the deinterleaver */
+  readonly latency: number;
+  private readonly branches: number;
+  private readonly inverse: boolean;
+  private readonly starts: Int32Array;
+  private readonly delays: Int32Array;
+  private readonly heads: Int32Array;
+  private store: BlockData = new Uint8Array(0);
+  private storeImag: FloatArray | null = null;
+  private branch = 0;
+  // Interleaver: flush items still to send; deinterleaver: start-up items still to drop
+  private remaining: number;
+
+  constructor(name: string, type: PortType, branches: number, unitDelay: number, inverse: boolean) {
+    if (branches < 1 || unitDelay < 1) throw new Error('Interleaver dimensions must be positive');
+    this.name = name;
+    this.inputs = [type];
+    this.outputs = [type];
+    this.branches = branches;
+    this.inverse = inverse;
+    this.latency = unitDelay * branches * (branches - 1);
+    this.remaining = this.latency;
+    this.starts = new Int32Array(branches);
+    this.delays = new Int32Array(branches);
+    this.heads = new Int32Array(branches);
+    let start = 0;
+    for (let i = 0; i < branches; i++) {
+      this.starts[i] = start;
+      this.delays[i] = (inverse ? branches - 1 - i : i) * unitDelay;
+      start += this.delays[i];
+    }
+  }
+
+  setup(arena: Arena, precision: SamplePrecision): void {
+    const size = this.latency / 2;
+    const type = this.inputs[0];
+    // Delay lines start out holding zeros
+    this.store = allocate(arena, type, precision, size).fill(0);
+    if (type === 'complex') this.storeImag = arena.float(precision, size).fill(0);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const { starts, delays, heads, store, storeImag, branches } = this;
+    const inImag = input.imag;
+    const outImag = output.imag;
+
+    for (;;) {
+      let value: number;
+      let imag = 0;
+      if (input.offset < input.length) {
+        if (output.length === output.capacity) return false;
+        if (inImag) imag = inImag[input.offset];
+        value = input.data[input.offset++];
+      } else if (!input.ended) {
+        return false;
+      } else if (!this.inverse && this.remaining > 0) {
+        if (output.length === output.capacity) return false;
+        this.remaining--;
+        value = 0;
+      } else {
+        return true;
+      }
+
+      const branch = this.branch;
+      this.branch = branch + 1 === branches ? 0 : branch + 1;
+      const delay = delays[branch];
+      if (delay > 0) {
+        const slot = starts[branch] + heads[branch];
+        const delayed = store[slot];
+        store[slot] = value;
+        value = delayed;
+        if (storeImag) {
+          const delayedImag = storeImag[slot];
+          storeImag[slot] = imag;
+          imag = delayedImag;
+        }
+        heads[branch] = heads[branch] + 1 === delay ? 0 : heads[branch] + 1;
+      }
+
+      if (this.inverse && this.remaining > 0) {
+        this.remaining--;
+        continue;
+      }
+      if (outImag) outImag[output.length] = imag;
+      output.data[output.length++] = value;
+    }
+  }
+}
+
+/** Forney interleaver: line i of `branches` delays by i · `unitDelay` items. */
+export class ConvolutionalInterleaver extends ConvolutionalPermutation {
+  constructor(type: PortType, branches: number, unitDelay: number) {
+    super('convolutional interleaver', type, branches, unitDelay, false);
+  }
+}
+
+/** Inverse of `ConvolutionalInterleaver` with the same `branches` and `unitDelay`. */
+export class ConvolutionalDeinterleaver extends ConvolutionalPermutation {
+  constructor(type: PortType, branches: number, unitDelay: number) {
+    super('convolutional deinterleaver', type, branches, unitDelay, true);
+  }
+}
@@ -0,0 +1,405 @@
+import { Arena } from './bufferPool';
+import { InputPort, OutputPort, Pipeline, PipelineOptions, Stage } from './pipeline';
+import { AwgnChannel, BitErrorCounter, BitSource } from './stages';
+import { LineCoder } from './digitalToDigital';
+import { fromDecibels } from './berModels';
+import { Random } from './random';
+
+/**
+ * Systematic LDPC code given by its parity-check matrix H (m × n) in CSR form: row r
+ * holds the columns `columns[rowStart[r]]` … `columns[rowStart[r + 1] − 1]`, ascending.
+ * The first k = n − m columns carry the message; the last m are parity bits whose part
+ * of H is dual-diagonal (row r checks parity bits r and r − 1), as in the IEEE 802.11n
+ * and 802.16e codes, so encoding is one pass over H accumulating parity row by row.
+ */
+export class LdpcCode {
+  readonly n: number;
+  readonly k: number;
+  readonly m: number;
+  readonly rowStart: Int32Array;
+  readonly columns: Int32Array;
+  /** Largest number of bits in one check */
+  readonly maxRowWeight: number;
+
+  constructor(n: number, rowStart: Int32Array, columns: Int32Array) {
+    this.n = n;
+    this.m = rowStart.length - 1;
+    this.k = n - this.m;
+    this.rowStart = rowStart;
+    this.columns = columns;
+    let maxRowWeight = 0;
+    for (let r = 0; r < this.m; r++) {
+      const start = rowStart[r];
+      const end = rowStart[r + 1];
+      maxRowWeight = Math.max(maxRowWeight, end - start);
+      // A column twice in one check would cancel in the encoder's XOR but count as two
+      // edges in the decoder
+      for (let e = start; e < end; e++) {
+        if (columns[e] < 0 || columns[e] >= n || (e > start && columns[e] <= columns[e - 1])) {
+          throw new Error('LDPC check columns must be distinct, ascending and within the code');
+        }
+      }
+      // Columns are sorted, so the parity bits are the row's last one or two entries
+      const parityCount = r === 0 ? 1 : 2;
+      const ok = end - start > parityCount
+        && columns[end - 1] === this.k + r
+        && (r === 0 || columns[end - 2] === this.k + r - 1)
+        && columns[end - 1 - parityCount] < this.k;
+      if (!ok) throw new Error('LDPC parity part must be dual-diagonal with a message bit in every check');
+    }
+    this.maxRowWeight = maxRowWeight;
+  }
+
+  /** Writes the m parity bits of the k message bits in `codeword[0 … k)` after them. */
+  encode(codeword: Uint8Array): void {
+    const { k, m, rowStart, columns } = this;
+    let previous = 0;
+    for (let r = 0; r < m; r++) {
+      let parity = previous;
+      const end = rowStart[r + 1] - (r === 0 ? 1 : 2);
+      for (let e = rowStart[r]; e < end; e++) parity ^= codeword[columns[e]];
+      codeword[k + r] = parity;
+      previous = parity;
+    }
+  }
+}
+
+/**
+ * Rate-1/2 (or `rate`) code with `columnWeight` ones in every message column, spread
+ * over the checks as evenly as the sizes allow. Positions come from a shuffled list of
+ * row sockets with repeated rows in one column swapped away; short cycles are not
+ * removed, which costs a little at low error rates but keeps construction instant.
+ */
+export function createLdpcCode(n: number, rate = 0.5, columnWeight = 3, seed = 1): LdpcCode {
+  const m = Math.round(n * (1 - rate));
+  const k = n - m;
+  if (m < 2 || k < 1 || columnWeight > m) throw new Error('Invalid LDPC code dimensions');
+  const random = new Random(seed);
+
+  const sockets = new Int32Array(k * columnWeight);
+  for (let i = 0; i < sockets.length; i++) sockets[i] = i % m;
+  for (let i = sockets.length - 1; i > 0; i--) {
+    const j = random.nextUint32() % (i + 1);
+    [sockets[i], sockets[j]] = [sockets[j], sockets[i]];
+  }
+  // A column must not check the same row twice: swap repeats with random sockets of other
+  // columns, keeping a swap only if it leaves no repeat behind in a column already fixed
+  const holds = (column: number, row: number, skip: number) => {
+    for (let i = column * columnWeight; i < (column + 1) * columnWeight; i++) {
+      if (i !== skip && sockets[i] === row) return true;
+    }
+    return false;
+  };
+  for (let c = 0; c < k; c++) {
+    for (let w = 0; w < columnWeight; w++) {
+      const index = c * columnWeight + w;
+      for (let attempt = 0; holds(c, sockets[index], index); attempt++) {
+        if (attempt === 1000) throw new Error('Could not place the LDPC parity checks; try another seed');
+        const other = random.nextUint32() % sockets.length;
+        const otherColumn = Math.floor(other / columnWeight);
+        if (otherColumn === c || holds(c, sockets[other], index)) continue;
+        if (otherColumn < c && holds(otherColumn, sockets[index], other)) continue;
+        [sockets[index], sockets[other]] = [sockets[other], sockets[index]];
+      }
+    }
+  }
+
+  const rows: number[][] = Array.from({ length: m }, () => []);
+  for (let i = 0; i < sockets.length; i++) rows[sockets[i]].push(Math.floor(i / columnWeight));
+  for (let r = 0; r < m; r++) {
+    if (r > 0) rows[r].push(k + r - 1);
+    rows[r].push(k + r);
+  }
+  // Rows without a message bit cannot occur when k · columnWeight ≥ m; guard anyway
+  for (let r = 0; r < m; r++) if (rows[r].length === (r === 0 ? 1 : 2)) rows[r].unshift(random.nextUint32() % k);
+
+  const rowStart = new Int32Array(m + 1);
+  for (let r = 0; r < m; r++) rowStart[r + 1] = rowStart[r] + rows[r].length;
+  const columns = new Int32Array(rowStart[m]);
+  rows.forEach((row, r) => columns.set(Int32Array.from(row).sort(), rowStart[r]));
+  return new LdpcCode(n, rowStart, columns);
+}
+
+const codes = new Map<number, LdpcCode>();
+
+/** Cached rate-1/2 code of length `n`. */
+export function ldpcCode(n: number): LdpcCode {
+  let code = codes.get(n);
+  if (!code) {
+    code = createLdpcCode(n);
+    codes.set(n, code);
+  }
+  return code;
+}
+
+// ---------------------------------------------------------------------------
+// Stages
+// ---------------------------------------------------------------------------
+
+/** k message bits → n codeword bits; a short final message is zero-padded. */
+export class LdpcEncoder implements Stage {
+  readonly name = 'LDPC encoder';
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly code: LdpcCode;
+  private readonly codeword: Uint8Array;
+  private collected = 0;
+  private readPosition: number;
+
+  constructor(code: LdpcCode) {
+    this.code = code;
+    this.codeword = new Uint8Array(code.n);
+    this.readPosition = code.n;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const { k, n } = this.code;
+    const codeword = this.codeword;
+
+    for (;;) {
+      while (this.readPosition < n && output.length < output.capacity) {
+        output.data[output.length++] = codeword[this.readPosition++];
+      }
+      if (this.readPosition < n) return false;
+
+      while (this.collected < k && input.offset < input.length) codeword[this.collected++] = input.data[input.offset++];
+      if (this.collected < k) {
+        if (!input.ended || this.collected === 0) return input.ended;
+        codeword.fill(0, this.collected, k);
+      }
+      this.code.encode(codeword);
+      this.collected = 0;
+      this.readPosition = 0;
+    }
+  }
+}
+
+/**
+ * Received ±1 levels (bit 0 sent as +1, as NRZ-L and BPSK do) → log-likelihood ratios
+ * log P(0)/P(1) = 2y/σ² for Gaussian noise of standard deviation `noiseSigma`.
+ */
+export class SoftDemapper implements Stage {
+  readonly name = 'soft demapper';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly scale: number;
+
+  constructor(noiseSigma: number) {
+    this.scale = 2 / (noiseSigma * noiseSigma);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    while (input.offset < input.length && output.length < output.capacity) {
+      output.data[output.length++] = this.scale * input.data[input.offset++];
+    }
+    return input.ended && input.offset === input.length;
+  }
+}
+
+export interface LdpcDecoderOptions {
+  maxIterations?: number;
+  /** Scale applied to min-sum check messages to offset their overestimate */
+  normalisation?: number;
+}
+
+/**
+ * n channel LLRs → k decoded bits by layered normalised min-sum. Each check in turn
+ * removes its old messages from the bit posteriors, recomputes them from the two
+ * smallest magnitudes and the sign product, and adds them back, so later checks in the
+ * same iteration already see the update. Check-to-bit messages are stored per edge in
+ * CSR order, so a check reads and writes one contiguous run. Decoding stops as soon as
+ * the hard decisions satisfy every check. An incomplete final codeword is dropped.
+ */
+export class LdpcDecoder implements Stage {
+  readonly name = 'LDPC decoder';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['bits'] as const;
+  codewords = 0;
+  /** Iterations summed over all codewords */
+  iterations = 0;
+  /** Codewords that still failed a check after `maxIterations` */
+  failures = 0;
+  /** Wall time spent decoding, in milliseconds */
+  decodeMs = 0;
+  private readonly code: LdpcCode;
+  private readonly maxIterations: number;
+  private readonly normalisation: number;
+  private posterior = new Float32Array(0);
+  private messages = new Float32Array(0);
+  private scratch = new Float32Array(0);
+  private readonly decided: Uint8Array;
+  private collected = 0;
+  private readPosition: number;
+
+  constructor(code: LdpcCode, options: LdpcDecoderOptions = {}) {
+    this.code = code;
+    this.maxIterations = options.maxIterations ?? 50;
+    this.normalisation = options.normalisation ?? 0.75;
+    this.decided = new Uint8Array(code.k);
+    this.readPosition = code.k;
+  }
+
+  setup(arena: Arena): void {
+    this.posterior = arena.float32(this.code.n);
+    this.messages = arena.float32(this.code.columns.length);
+    this.scratch = arena.float32(this.code.maxRowWeight);
+  }
+
+  get meanIterations(): number {
+    return this.codewords > 0 ? this.iterations / this.codewords : 0;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const { k, n } = this.code;
+
+    for (;;) {
+      while (this.readPosition < k && output.length < output.capacity) {
+        output.data[output.length++] = this.decided[this.readPosition++];
+      }
+      if (this.readPosition < k) return false;
+
+      while (this.collected < n && input.offset < input.length) this.posterior[this.collected++] = input.data[input.offset++];
+      if (this.collected < n) return input.ended;
+
+      const start = performance.now();
+      this.decode();
+      this.decodeMs += performance.now() - start;
+      for (let i = 0; i < k; i++) this.decided[i] = this.posterior[i] < 0 ? 1 : 0;
+      this.collected = 0;
+      this.readPosition = 0;
+    }
+  }
+
+  private decode(): void {
+    const { m, rowStart, columns } = this.code;
+    const { posterior, messages, scratch, normalisation } = this;
+    messages.fill(0, 0, columns.length);
+
+    let iteration = 0;
+    let satisfied = this.checksSatisfied();
+    while (!satisfied && iteration < this.maxIterations) {
+      iteration++;
+      for (let r = 0; r < m; r++) {
+        const start = rowStart[r];
+        const end = rowStart[r + 1];
+        let min1 = Infinity;
+        let min2 = Infinity;
+        let minEdge = -1;
+        let negative = 0;
+        for (let e = start; e < end; e++) {
+          const q = posterior[columns[e]] - messages[e];
+          scratch[e - start] = q;
+          const magnitude = Math.abs(q);
+          if (q < 0) negative ^= 1;
+          if (magnitude < min1) {
+            min2 = min1;
+            min1 = magnitude;
+            minEdge = e;
+          } else if (magnitude < min2) {
+            min2 = magnitude;
+          }
+        }
+        const small = normalisation * min1;
+        const large = normalisation * min2;
+        for (let e = start; e < end; e++) {
+          const q = scratch[e - start];
+          // Sign of the other bits: the row's parity with this bit's sign taken out
+          const sign = (negative ^ (q < 0 ? 1 : 0)) === 1 ? -1 : 1;
+          const message = sign * (e === minEdge ? large : small);
+          messages[e] = message;
+          posterior[columns[e]] = q + message;
+        }
+      }
+      satisfied = this.checksSatisfied();
+    }
+
+    this.codewords++;
+    this.iterations += iteration;
+    if (!satisfied) this.failures++;
+  }
+
+  private checksSatisfied(): boolean {
+    const { m, rowStart, columns } = this.code;
+    const posterior = this.posterior;
+    for (let r = 0; r < m; r++) {
+      let parity = 0;
+      for (let e = rowStart[r]; e < rowStart[r + 1]; e++) if (posterior[columns[e]] < 0) parity ^= 1;
+      if (parity !== 0) return false;
+    }
+    return true;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Link evaluation
+// ---------------------------------------------------------------------------
+
+export interface LdpcLinkResult {
+  n: number;
+  k: number;
+  ebN0Db: number;
+  codewords: number;
+  bitErrorRate: number;
+  /** Share of codewords left failing a check after the last iteration */
+  frameErrorRate: number;
+  meanIterations: number;
+  /** Information bits decoded per second of decoder wall time, in Mbit/s */
+  decodedMbps: number;
+}
+
+/**
+ * `codewords` random messages through LDPC encoder → NRZ-L → AWGN → soft demapper →
+ * decoder. `ebN0Db` is per information bit, so the code rate lowers the symbol SNR.
+ */
+export function evaluateLdpcLink(
+  code: LdpcCode,
+  ebN0Db: number,
+  codewords: number,
+  options: PipelineOptions & LdpcDecoderOptions & { seed?: number } = {}
+): LdpcLinkResult {
+  const random = new Random(options.seed ?? 1);
+  const bits = new Uint8Array(codewords * code.k);
+  for (let i = 0; i < bits.length; i++) bits[i] = random.bit();
+  // ±1 levels carry Es = 1 per coded bit, so Eb = n / k and N0 = 2σ²
+  const noiseSigma = Math.sqrt(code.n / (2 * code.k * fromDecibels(ebN0Db)));
+  const decoder = new LdpcDecoder(code, options);
+  const errors = new BitErrorCounter();
+
+  Pipeline.fromSpec({
+    nodes: {
+      source: new BitSource(bits),
+      encoder: new LdpcEncoder(code),
+      mapper: new LineCoder('NRZ-L'),
+      channel: new AwgnChannel(noiseSigma, random.nextUint32()),
+      demapper: new SoftDemapper(noiseSigma),
+      decoder,
+      errors,
+    },
+    edges: [
+      ['source', 'encoder'],
+      ['encoder', 'mapper'],
+      ['mapper', 'channel'],
+      ['channel', 'demapper'],
+      ['demapper', 'decoder'],
+      ['source', 'errors:0'],
+      ['decoder', 'errors:1'],
+    ],
+  }, options).run();
+
+  return {
+    n: code.n,
+    k: code.k,
+    ebN0Db,
+    codewords: decoder.codewords,
+    bitErrorRate: errors.errorRate,
+    frameErrorRate: decoder.codewords > 0 ? decoder.failures / decoder.codewords : 0,
+    meanIterations: decoder.meanIterations,
+    decodedMbps: decoder.decodeMs > 0 ? (decoder.codewords * code.k) / decoder.decodeMs / 1000 : 0,
+  };
+}
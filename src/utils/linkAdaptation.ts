@@ -0,0 +1,204 @@
+import { DigitalToAnalogAlgorithm } from '../types';
+import { basebandSamplesPerBit, buildDigitalToAnalogBasebandGraph } from './digitalToAnalog';
+import { ModulationModel, fromDecibels, modulationModels, snrThresholds, toDecibels } from './berModels';
+import { BitErrorCounter } from './stages';
+import { Random } from './random';
+
+/**
+ * Link adaptation over a block-fading channel. Every frame the controller picks the
+ * densest keying whose precomputed Es/N0 threshold for the target BER lies below the
+ * SNR it last heard about (the previous frame's, as a feedback channel would report
+ * it), minus a safety margin. The frame then runs through the baseband modulator,
+ * complex AWGN at that frame's true SNR, and the maximum-likelihood receiver.
+ * Throughput is counted in bits per symbol, so it compares directly with the Shannon
+ * capacity log2(1 + SNR) of each frame.
+ */
+export interface LinkAdaptationConfig {
+  /** Mean Es/N0 of the channel, in dB */
+  meanSnrDb: number;
+  /** BER each frame's keying is chosen to stay under */
+  targetBer: number;
+  /** Subtracted from the reported SNR before the threshold lookup, in dB */
+  marginDb: number;
+  /** Frames over which the fading gain decorrelates to 1/e; 0 keeps a static AWGN channel */
+  coherenceFrames: number;
+  symbolsPerFrame: number;
+  seed?: number;
+}
+
+export const defaultLinkAdaptationConfig: LinkAdaptationConfig = {
+  meanSnrDb: 15,
+  targetBer: 1e-3,
+  marginDb: 1,
+  coherenceFrames: 20,
+  symbolsPerFrame: 128,
+};
+
+export interface FrameReport {
+  frame: number;
+  snrDb: number;
+  /** Null when even the most robust keying misses the target and the frame is skipped */
+  algorithm: DigitalToAnalogAlgorithm | null;
+  bits: number;
+  bitErrors: number;
+  /** Correctly received bits per symbol */
+  goodput: number;
+  /** Shannon capacity at this frame's SNR, in bits per symbol */
+  capacity: number;
+}
+
+export interface LinkAdaptationSummary {
+  frames: number;
+  bits: number;
+  bitErrors: number;
+  bitErrorRate: number;
+  /** Mean correctly received bits per symbol over all frames */
+  goodput: number;
+  /** Mean capacity over the same frames (the ergodic capacity estimate) */
+  capacity: number;
+  /** Frames sent with each keying, skipped frames under 'none' */
+  usage: Record<string, number>;
+}
+
+/**
+ * Rayleigh block fading as a first-order Gauss–Markov process: the complex gain keeps
+ * a fraction ρ = exp(−1/coherenceFrames) of itself each frame, with E|h|² = 1.
+ */
+class FadingProcess {
+  private readonly rho: number;
+  private readonly random: Random;
+  private re: number;
+  private im: number;
+
+  constructor(coherenceFrames: number, seed: number) {
+    this.rho = coherenceFrames > 0 ? Math.exp(-1 / coherenceFrames) : 0;
+    this.random = new Random(seed);
+    this.re = this.random.gaussian() * Math.SQRT1_2;
+    this.im = this.random.gaussian() * Math.SQRT1_2;
+  }
+
+  /** Power gain |h|² of the next frame. */
+  next(): number {
+    const innovation = Math.sqrt((1 - this.rho * this.rho) / 2);
+    this.re = this.rho * this.re + innovation * this.random.gaussian();
+    this.im = this.rho * this.im + innovation * this.random.gaussian();
+    return this.re * this.re + this.im * this.im;
+  }
+}
+
+/** Chooses a keying per frame from the threshold table for one target BER. */
+export class AdaptiveModulationController {
+  private readonly thresholds: Float64Array;
+  private readonly marginDb: number;
+
+  constructor(targetBer: number, marginDb: number) {
+    this.thresholds = snrThresholds(targetBer);
+    this.marginDb = marginDb;
+  }
+
+  /** Highest-rate model whose threshold is met, or null if none is. */
+  select(reportedSnrDb: number): ModulationModel | null {
+    const snr = reportedSnrDb - this.marginDb;
+    let best: ModulationModel | null = null;
+    for (let index = 0; index < modulationModels.length; index++) {
+      const model = modulationModels[index];
+      if (snr >= this.thresholds[index] && (!best || model.bitsPerSymbol > best.bitsPerSymbol)) best = model;
+    }
+    return best;
+  }
+}
+
+/**
+ * Frame-by-frame simulation driven by `step`, so a caller can render results while it
+ * streams. Each frame builds its own small pipeline; frames share nothing but the
+ * fading process and the bit generator.
+ */
+export class LinkAdaptationSimulation {
+  readonly config: LinkAdaptationConfig;
+  private readonly controller: AdaptiveModulationController;
+  private readonly fading: FadingProcess;
+  private readonly random: Random;
+  private reportedSnrDb: number;
+  private frame = 0;
+  private bits = 0;
+  private bitErrors = 0;
+  private goodputSum = 0;
+  private capacitySum = 0;
+  private readonly usage: Record<string, number> = {};
+
+  constructor(config: LinkAdaptationConfig = defaultLinkAdaptationConfig) {
+    this.config = config;
+    const seed = config.seed ?? 1;
+    this.controller = new AdaptiveModulationController(config.targetBer, config.marginDb);
+    this.fading = new FadingProcess(config.coherenceFrames, seed);
+    this.random = new Random(seed + 1);
+    // Before any feedback the controller assumes the mean SNR
+    this.reportedSnrDb = config.meanSnrDb;
+  }
+
+  step(): FrameReport {
+    const { meanSnrDb, symbolsPerFrame, coherenceFrames } = this.config;
+    const gain = coherenceFrames > 0 ? this.fading.next() : 1;
+    const snr = fromDecibels(meanSnrDb) * gain;
+    const snrDb = toDecibels(snr);
+    const model = this.controller.select(this.reportedSnrDb);
+    const capacity = Math.log2(1 + snr);
+
+    let bits = 0;
+    let bitErrors = 0;
+    if (model) {
+      bits = symbolsPerFrame * model.bitsPerSymbol;
+      bitErrors = this.sendFrame(model, snr, bits);
+    }
+
+    const report: FrameReport = {
+      frame: this.frame,
+      snrDb,
+      algorithm: model ? model.algorithm : null,
+      bits,
+      bitErrors,
+      goodput: (bits - bitErrors) / symbolsPerFrame,
+      capacity,
+    };
+
+    this.frame++;
+    this.bits += bits;
+    this.bitErrors += bitErrors;
+    this.goodputSum += report.goodput;
+    this.capacitySum += capacity;
+    const key = model ? model.algorithm : 'none';
+    this.usage[key] = (this.usage[key] ?? 0) + 1;
+    this.reportedSnrDb = snrDb;
+    return report;
+  }
+
+  get summary(): LinkAdaptationSummary {
+    const frames = this.frame;
+    return {
+      frames,
+      bits: this.bits,
+      bitErrors: this.bitErrors,
+      bitErrorRate: this.bits > 0 ? this.bitErrors / this.bits : 0,
+      goodput: frames > 0 ? this.goodputSum / frames : 0,
+      capacity: frames > 0 ? this.capacitySum / frames : 0,
+      usage: { ...this.usage },
+    };
+  }
+
+  private sendFrame(model: ModulationModel, snr: number, count: number): number {
+    const bits = new Uint8Array(count);
+    for (let k = 0; k < count; k++) bits[k] = this.random.bit();
+
+    // Es is the envelope energy summed over a symbol's samples; N0 = 2σ² per sample
+    const symbolEnergy = model.averageEnergy * basebandSamplesPerBit * model.bitsPerSymbol;
+    const noiseSigma = Math.sqrt(symbolEnergy / (2 * snr));
+    const errors = new BitErrorCounter();
+    const { pipeline } = buildDigitalToAnalogBasebandGraph(bits, model.algorithm, {
+      noiseSigma,
+      seed: this.random.nextUint32(),
+    });
+    pipeline.add('errors', errors).connect('source', 'errors:0').connect('receiver', 'errors:1');
+    pipeline.run();
+    return errors.errors;
+  }
+}
@@ -0,0 +1,131 @@
+import { PagedSignal } from './pagedSignal';
+
+/**
+ * Min/max level-of-detail pyramid over a `PagedSignal`. Level 0 holds the minimum and
+ * maximum of every `LOD_BASE_BLOCK` samples and each level above halves the resolution,
+ * so the envelope of any range at any width reads a few summary values per column
+ * instead of the samples. Views finer than level 0 read the samples themselves, through
+ * the signal's paged `read`; the pyramid is built by one `scan` over the signal.
+ *
+ * The summaries take 2 × 4 bytes per block per level, about 1/64 of the signal.
+ */
+
+/** Samples summarised by one level-0 entry. */
+export const LOD_BASE_BLOCK = 256;
+
+/** Minimum and maximum of each column of a view. */
+export interface Envelope {
+  /** First sample and one past the last sample covered */
+  start: number;
+  end: number;
+  min: Float32Array;
+  max: Float32Array;
+}
+
+interface Level {
+  /** Samples per entry */
+  block: number;
+  min: Float32Array;
+  max: Float32Array;
+}
+
+export class LodPyramid {
+  readonly signal: PagedSignal;
+  private readonly levels: Level[] = [];
+
+  constructor(signal: PagedSignal) {
+    this.signal = signal;
+    const blocks = Math.ceil(signal.length / LOD_BASE_BLOCK);
+    const min = new Float32Array(blocks);
+    const max = new Float32Array(blocks);
+    // Chunks hold whole blocks, so every view of the scan starts on a block boundary
+    signal.scan(0, signal.length, (values, first) => {
+      for (let offset = 0; offset < values.length; offset += LOD_BASE_BLOCK) {
+        const stop = Math.min(values.length, offset + LOD_BASE_BLOCK);
+        let low = Infinity;
+        let high = -Infinity;
+        for (let i = offset; i < stop; i++) {
+          if (values[i] < low) low = values[i];
+          if (values[i] > high) high = values[i];
+        }
+        min[(first + offset) / LOD_BASE_BLOCK] = low;
+        max[(first + offset) / LOD_BASE_BLOCK] = high;
+      }
+    });
+    this.levels.push({ block: LOD_BASE_BLOCK, min, max });
+
+    for (let below = this.levels[0]; below.min.length > 1; ) {
+      const length = Math.ceil(below.min.length / 2);
+      const level: Level = { block: below.block * 2, min: new Float32Array(length), max: new Float32Array(length) };
+      for (let i = 0; i < length; i++) {
+        const pair = Math.min(2 * i + 1, below.min.length - 1);
+        level.min[i] = Math.min(below.min[2 * i], below.min[pair]);
+        level.max[i] = Math.max(below.max[2 * i], below.max[pair]);
+      }
+      this.levels.push(level);
+      below = level;
+    }
+  }
+
+  /** Bytes held by the summaries. */
+  get bytes(): number {
+    return this.levels.reduce((sum, level) => sum + level.min.byteLength + level.max.byteLength, 0);
+  }
+
+  /**
+   * Envelope of samples `[start, end)` in `columns` columns, clipped to the signal; no
+   * columns when nothing is left. Columns are read from the coarsest level whose entries
+   * fit inside one column, so edge entries can reach a little into the neighbouring
+   * columns: the envelope never misses a peak.
+   */
+  envelope(start: number, end: number, columns: number): Envelope {
+    const first = Math.min(this.signal.length, Math.max(0, Math.floor(start)));
+    const last = Math.min(this.signal.length, Math.ceil(end));
+    if (last <= first || columns < 1) {
+      return { start: first, end: first, min: new Float32Array(0), max: new Float32Array(0) };
+    }
+    const count = Math.min(Math.floor(columns), last - first);
+    const min = new Float32Array(count);
+    const max = new Float32Array(count);
+    const span = last - first;
+    const perColumn = span / count;
+
+    if (perColumn < 2 * LOD_BASE_BLOCK) {
+      // Fine view: the samples themselves, under 2 × LOD_BASE_BLOCK per column
+      const samples = new Float32Array(span);
+      this.signal.read(first, samples);
+      for (let c = 0; c < count; c++) {
+        const from = Math.floor(c * perColumn);
+        const to = Math.max(from + 1, Math.floor((c + 1) * perColumn));
+        let low = Infinity;
+        let high = -Infinity;
+        for (let i = from; i < to && i < span; i++) {
+          if (samples[i] < low) low = samples[i];
+          if (samples[i] > high) high = samples[i];
+        }
+        min[c] = low;
+        max[c] = high;
+      }
+      return { start: first, end: last, min, max };
+    }
+
+    let level = this.levels[0];
+    for (const candidate of this.levels) {
+      if (candidate.block > perColumn) break;
+      level = candidate;
+    }
+    for (let c = 0; c < count; c++) {
+      const from = Math.floor((first + c * perColumn) / level.block);
+      const to = Math.ceil((first + (c + 1) * perColumn) / level.block);
+      let low = Infinity;
+      let high = -Infinity;
+      for (let i = from; i < to && i < level.min.length; i++) {
+        if (level.min[i] < low) low = level.min[i];
+        if (level.max[i] > high) high = level.max[i];
+      }
+      min[c] = low;
+      max[c] = high;
+    }
+    return { start: first, end: last, min, max };
+  }
+}
@@ -0,0 +1,386 @@
+import { AnalogToDigitalConfig } from '../types';
+import { Pipeline } from './pipeline';
+import { AntiAliasFilterStage, ReconstructionStage, Resampler, ToneSource } from './stages';
+import { DeltaDecoder, DeltaEncoder, PcmDecoder, PcmQuantizer } from './analogToDigital';
+import { OpfsChunkStore, PagedSignal, PagedSink } from './pagedSignal';
+import { Envelope, LodPyramid } from './lodPyramid';
+
+/**
+ * Long analog-to-digital captures: the message and the receiver's reconstruction over
+ * minutes to days, stored in `PagedSignal`s that spill to OPFS in a worker. One LOD
+ * pyramid per signal serves the charts' envelopes at any zoom, and the metrics stream
+ * through the same paged reads, so memory stays bounded by the resident chunks and the
+ * pyramids whatever the duration.
+ *
+ * Sessions run in `longCaptureWorker.ts`; `LongCapture` is the page's handle on one, and
+ * runs it on this thread, in memory, where workers are unavailable.
+ */
+
+/** Sample rate of captured signals, in Hz. */
+export const captureSampleRate = 1000;
+
+// Above this, a capture that cannot spill to OPFS is refused rather than risk the tab
+const memoryBudgetBytes = 256 * 1024 * 1024;
+// Per signal: 64 chunks of 256 KiB
+const maxResidentChunks = 64;
+
+export interface CaptureConfig {
+  frequency: number;
+  amplitude: number;
+  /** Captured length, in seconds */
+  duration: number;
+  conversion: AnalogToDigitalConfig;
+  /** Spill to OPFS when the thread allows it (default true) */
+  useOpfs?: boolean;
+}
+
+export interface SignalMetrics {
+  mean: number;
+  rms: number;
+  peak: number;
+}
+
+export interface CaptureSummary {
+  samples: number;
+  sampleRate: number;
+  storage: 'opfs' | 'memory';
+  /** Bytes of samples written, both signals */
+  storedBytes: number;
+  /** Largest number of sample bytes held in memory at once, both signals */
+  residentBytes: number;
+  pyramidBytes: number;
+  pageIns: number;
+  pageOuts: number;
+  input: SignalMetrics;
+  output: SignalMetrics;
+  /** Input against reconstruction over the whole capture, in dB */
+  sqnrDb: number;
+  generationMs: number;
+  analysisMs: number;
+}
+
+/** Envelopes of both signals over one time window. */
+export interface CaptureView {
+  /** Window covered, in seconds */
+  startTime: number;
+  endTime: number;
+  input: Envelope;
+  output: Envelope;
+}
+
+function signalMetrics(signal: PagedSignal): SignalMetrics {
+  let sum = 0;
+  let squares = 0;
+  let peak = 0;
+  signal.scan(0, signal.length, values => {
+    for (let i = 0; i < values.length; i++) {
+      sum += values[i];
+      squares += values[i] * values[i];
+      peak = Math.max(peak, Math.abs(values[i]));
+    }
+  });
+  const n = Math.max(1, signal.length);
+  return { mean: sum / n, rms: Math.sqrt(squares / n), peak };
+}
+
+// SQNR of `output` against `reference`, reading the reference chunk by chunk and the
+// matching stretch of the output alongside it
+function pagedSqnr(reference: PagedSignal, output: PagedSignal): number {
+  let signal = 0;
+  let noise = 0;
+  let scratch = new Float32Array(0);
+  reference.scan(0, Math.min(reference.length, output.length), (values, first) => {
+    if (scratch.length !== values.length) scratch = new Float32Array(values.length);
+    output.read(first, scratch);
+    for (let i = 0; i < values.length; i++) {
+      const error = values[i] - scratch[i];
+      signal += values[i] * values[i];
+      noise += error * error;
+    }
+  });
+  return noise === 0 ? Infinity : 10 * Math.log10(signal / noise);
+}
+
+/** A finished capture: its two signals, their pyramids and its summary. */
+export class CaptureSession {
+  readonly summary: CaptureSummary;
+  private readonly input: PagedSignal;
+  private readonly output: PagedSignal;
+  private readonly inputPyramid: LodPyramid;
+  private readonly outputPyramid: LodPyramid;
+
+  private constructor(input: PagedSignal, output: PagedSignal, summary: CaptureSummary) {
+    this.input = input;
+    this.output = output;
+    this.inputPyramid = new LodPyramid(input);
+    this.outputPyramid = new LodPyramid(output);
+    this.summary = summary;
+  }
+
+  /** Runs the capture, reporting the samples generated so far to `onProgress`. */
+  static async run(config: CaptureConfig, onProgress: (samples: number) => void = () => undefined): Promise<CaptureSession> {
+    const count = Math.round(config.duration * captureSampleRate);
+    const opfs = config.useOpfs ?? true;
+    if (opfs) await OpfsChunkStore.removeStale();
+    const [inputStore, outputStore] = opfs
+      ? await Promise.all([OpfsChunkStore.open('input.f32'), OpfsChunkStore.open('output.f32')])
+      : [null, null];
+    // Both signals on OPFS, or both in memory
+    const paged = inputStore !== null && outputStore !== null;
+    if (!paged) {
+      inputStore?.close();
+      outputStore?.close();
+      if (2 * count * Float32Array.BYTES_PER_ELEMENT > memoryBudgetBytes) {
+        throw new Error('Captures this long need OPFS (Origin Private File System) in a worker, which this browser does not offer');
+      }
+    }
+    const input = new PagedSignal(captureSampleRate, paged ? inputStore : null, maxResidentChunks);
+    const output = new PagedSignal(captureSampleRate, paged ? outputStore : null, maxResidentChunks);
+
+    try {
+      const generationStart = performance.now();
+      let residentBytes = 0;
+      const track = () => {
+        residentBytes = Math.max(residentBytes, input.residentBytes + output.residentBytes);
+      };
+      buildCaptureGraph(config, count, new PagedSink(input, track), new PagedSink(output, samples => {
+        track();
+        onProgress(samples);
+      })).run();
+      track();
+      const generationMs = performance.now() - generationStart;
+
+      const analysisStart = performance.now();
+      const inputMetrics = signalMetrics(input);
+      const outputMetrics = signalMetrics(output);
+      const sqnrDb = pagedSqnr(input, output);
+      track();
+      const session = new CaptureSession(input, output, {
+        samples: input.length,
+        sampleRate: captureSampleRate,
+        storage: input.storage,
+        storedBytes: (input.length + output.length) * Float32Array.BYTES_PER_ELEMENT,
+        residentBytes,
+        pyramidBytes: 0,
+        pageIns: 0,
+        pageOuts: 0,
+        input: inputMetrics,
+        output: outputMetrics,
+        sqnrDb,
+        generationMs,
+        analysisMs: 0,
+      });
+      session.summary.pyramidBytes = session.inputPyramid.bytes + session.outputPyramid.bytes;
+      session.summary.pageIns = input.stats.pageIns + output.stats.pageIns;
+      session.summary.pageOuts = input.stats.pageOuts + output.stats.pageOuts;
+      session.summary.analysisMs = performance.now() - analysisStart;
+      return session;
+    } catch (error) {
+      input.close();
+      output.close();
+      throw error;
+    }
+  }
+
+  /** Both signals' envelopes over `[startTime, endTime)` seconds in `columns` columns. */
+  view(startTime: number, endTime: number, columns: number): CaptureView {
+    const length = this.input.length;
+    const start = Math.min(length, Math.max(0, Math.floor(startTime * captureSampleRate)));
+    const end = Math.min(length, Math.max(start, Math.ceil(endTime * captureSampleRate)));
+    return {
+      startTime: start / captureSampleRate,
+      endTime: end / captureSampleRate,
+      input: this.inputPyramid.envelope(start, end, columns),
+      output: this.outputPyramid.envelope(start, end, columns),
+    };
+  }
+
+  /** Deletes the capture's files and drops its memory. */
+  close(): void {
+    this.input.close();
+    this.output.close();
+  }
+}
+
+// message → (anti-alias →) sampler → PCM quantiser and decoder, or delta modulator, →
+// reconstruction at the capture rate; the message and the reconstruction are captured
+function buildCaptureGraph(config: CaptureConfig, count: number, input: PagedSink, output: PagedSink): Pipeline {
+  const { frequency, amplitude, conversion } = config;
+  const endTime = (count - 1) / captureSampleRate;
+  const pipeline = new Pipeline()
+    .add('source', new ToneSource(frequency, amplitude, captureSampleRate, count))
+    .add('input', input)
+    .add('output', output)
+    .connect('source', 'input');
+
+  if (conversion.algorithm === 'PCM') {
+    const pcm = conversion.pcm;
+    if (!pcm) throw new Error('PCM configuration required');
+    pipeline
+      .add('sampler', new Resampler(captureSampleRate, pcm.samplingRate))
+      .add('quantizer', new PcmQuantizer(amplitude, pcm.quantizationLevels))
+      .add('decoder', new PcmDecoder(amplitude, pcm.quantizationLevels))
+      .add('reconstruction', new ReconstructionStage(pcm.reconstruction ?? 'zero-order', pcm.samplingRate, captureSampleRate, endTime))
+      .connect('sampler', 'quantizer')
+      .connect('quantizer', 'decoder')
+      .connect('decoder', 'reconstruction')
+      .connect('reconstruction', 'output');
+    if (pcm.antiAlias) {
+      pipeline
+        .add('antiAlias', new AntiAliasFilterStage(pcm.samplingRate / 2 / captureSampleRate))
+        .connect('source', 'antiAlias')
+        .connect('antiAlias', 'sampler');
+    } else {
+      pipeline.connect('source', 'sampler');
+    }
+    return pipeline;
+  }
+
+  const delta = conversion.deltaModulation;
+  if (!delta) throw new Error('Delta Modulation configuration required');
+  // The decoder's staircase, held at the capture rate
+  return pipeline
+    .add('sampler', new Resampler(captureSampleRate, delta.samplingRate))
+    .add('encoder', new DeltaEncoder(amplitude, delta.deltaStepSize))
+    .add('decoder', new DeltaDecoder(amplitude, delta.deltaStepSize))
+    .add('reconstruction', new ReconstructionStage('zero-order', delta.samplingRate, captureSampleRate, endTime))
+    .connect('source', 'sampler')
+    .connect('sampler', 'encoder')
+    .connect('encoder', 'decoder')
+    .connect('decoder', 'reconstruction')
+    .connect('reconstruction', 'output');
+}
+
+// ---------------------------------------------------------------------------
+// Worker protocol
+// ---------------------------------------------------------------------------
+
+export type CaptureRequest =
+  | { id: number; type: 'capture'; config: CaptureConfig }
+  | { id: number; type: 'view'; startTime: number; endTime: number; columns: number }
+  | { id: number; type: 'close' };
+
+export type CaptureReply =
+  | { id: number; type: 'progress'; samples: number }
+  | { id: number; type: 'summary'; summary: CaptureSummary }
+  | { id: number; type: 'view'; view: CaptureView }
+  | { id: number; type: 'closed' }
+  | { id: number; type: 'error'; error: string };
+
+/**
+ * Answers one request against the session a worker (or the in-thread fallback) holds;
+ * `post` receives the progress replies and the final one.
+ */
+export class CaptureHost {
+  private session: CaptureSession | null = null;
+
+  async handle(request: CaptureRequest, post: (reply: CaptureReply, transfer?: Transferable[]) => void): Promise<void> {
+    const { id } = request;
+    try {
+      switch (request.type) {
+        case 'capture': {
+          this.session?.close();
+          this.session = null;
+          this.session = await CaptureSession.run(request.config, samples => post({ id, type: 'progress', samples }));
+          post({ id, type: 'summary', summary: this.session.summary });
+          return;
+        }
+        case 'view': {
+          if (!this.session) throw new Error('No capture to view');
+          const view = this.session.view(request.startTime, request.endTime, request.columns);
+          const buffers = [view.input.min, view.input.max, view.output.min, view.output.max].map(array => array.buffer as ArrayBuffer);
+          post({ id, type: 'view', view }, buffers);
+          return;
+        }
+        case 'close':
+          this.session?.close();
+          this.session = null;
+          post({ id, type: 'closed' });
+          return;
+      }
+    } catch (error) {
+      post({ id, type: 'error', error: error instanceof Error ? error.message : String(error) });
+    }
+  }
+}
+
+interface PendingRequest {
+  resolve: (reply: CaptureReply) => void;
+  reject: (error: Error) => void;
+  onProgress?: (samples: number) => void;
+}
+
+/**
+ * The page's handle on one capture session in a worker. Without Worker support the
+ * session runs on this thread with its signals in memory.
+ */
+export class LongCapture {
+  private worker: Worker | null = null;
+  private local: CaptureHost | null = null;
+  private readonly pending = new Map<number, PendingRequest>();
+  private nextId = 0;
+
+  /** Runs a capture, replacing any earlier one. */
+  async capture(config: CaptureConfig, onProgress?: (samples: number) => void): Promise<CaptureSummary> {
+    const reply = await this.send({ id: this.nextId++, type: 'capture', config }, onProgress);
+    if (reply.type !== 'summary') throw new Error('Unexpected reply to a capture');
+    return reply.summary;
+  }
+
+  async view(startTime: number, endTime: number, columns: number): Promise<CaptureView> {
+    const reply = await this.send({ id: this.nextId++, type: 'view', startTime, endTime, columns });
+    if (reply.type !== 'view') throw new Error('Unexpected reply to a view');
+    return reply.view;
+  }
+
+  /**
+   * Stops the worker, abandoning any capture in progress; its files are deleted when
+   * the next capture starts. A later call starts a new worker.
+   */
+  terminate(): void {
+    this.worker?.terminate();
+    this.worker = null;
+    void this.local?.handle({ id: this.nextId++, type: 'close' }, () => undefined);
+    for (const request of this.pending.values()) request.reject(new Error('Capture stopped'));
+    this.pending.clear();
+  }
+
+  private send(request: CaptureRequest, onProgress?: (samples: number) => void): Promise<CaptureReply> {
+    return new Promise((resolve, reject) => {
+      this.pending.set(request.id, { resolve, reject, onProgress });
+      if (typeof Worker === 'undefined') {
+        this.local ??= new CaptureHost();
+        // Not in a worker, so never OPFS: sync access handles are worker-only
+        const local = request.type === 'capture' ? { ...request, config: { ...request.config, useOpfs: false } } : request;
+        void this.local.handle(local, reply => this.receive(reply));
+        return;
+      }
+      this.connect().postMessage(request);
+    });
+  }
+
+  private connect(): Worker {
+    if (!this.worker) {
+      this.worker = new Worker(new URL('./longCaptureWorker.ts', import.meta.url), { type: 'module' });
+      this.worker.onmessage = (event: MessageEvent<CaptureReply>) => this.receive(event.data);
+      this.worker.onerror = event => {
+        const requests = [...this.pending.values()];
+        this.pending.clear();
+        for (const request of requests) request.reject(new Error(event.message || 'capture worker failed'));
+      };
+    }
+    return this.worker;
+  }
+
+  private receive(reply: CaptureReply): void {
+    const request = this.pending.get(reply.id);
+    if (!request) return;
+    if (reply.type === 'progress') {
+      request.onProgress?.(reply.samples);
+      return;
+    }
+    this.pending.delete(reply.id);
+    if (reply.type === 'error') request.reject(new Error(reply.error));
+    else request.resolve(reply);
+  }
+}
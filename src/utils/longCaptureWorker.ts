@@ -0,0 +1,13 @@
+import { CaptureHost, CaptureReply, CaptureRequest } from './longCapture';
+
+// One session per worker, so not a `serveTasks` pool: requests are answered in order,
+// each after the previous one (a capture awaits its OPFS files) has finished
+const host = new CaptureHost();
+let queue = Promise.resolve();
+
+self.onmessage = (event: MessageEvent<CaptureRequest>) => {
+  const request = event.data;
+  queue = queue.then(() =>
+    host.handle(request, (reply: CaptureReply, transfer: Transferable[] = []) => self.postMessage(reply, { transfer }))
+  );
+};
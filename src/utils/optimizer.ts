@@ -0,0 +1,218 @@
+import { AnalogToDigitalAlgorithm } from '../types';
+import { SweepAxis, SweepEvaluator, defaultSweepAxes, sweepBitRate } from './sweep';
+
+/**
+ * Picks A/D parameters for a goal instead of a rule of thumb: the lowest bit rate that
+ * reaches a target SQNR, or the highest SQNR within a bit-rate budget. Every candidate is
+ * scored by a `SweepEvaluator`, which keeps each sampling rate's samples, so the searches
+ * below need a few dozen PCM or a few hundred DM evaluations rather than a full sweep.
+ *
+ * PCM is a coordinate search over bits per sample and sampling rate. For a target, it
+ * finds the fewest bits that can reach it at the highest rate, then for each bit depth
+ * from there the lowest rate that reaches it, stopping once more bits cannot pay for
+ * themselves. For a budget, it picks the bit depth that does best at the highest rate it
+ * can afford, then refines that depth's rate by golden-section search. Only full power-of-two level counts
+ * are tried, since the bits per sample are paid for either way. Delta modulation's SQNR
+ * is unimodal in the step size (granular noise below the peak, slope overload above), so
+ * the step is found by golden-section search at each rate the outer search visits.
+ */
+
+export type OptimizationGoal =
+  | { kind: 'min bit rate'; targetSqnrDb: number }
+  | { kind: 'max sqnr'; maxBitRate: number };
+
+export interface OptimizedConfig {
+  /** Sampling rate, in Hz, rounded to 0.01 Hz */
+  rate: number;
+  /** Quantisation levels (PCM) or delta step size (DM) */
+  value: number;
+  sqnrDb: number;
+  bitRate: number;
+  /** Whether the goal's constraint is met; if not, this is the configuration closest to meeting it */
+  feasible: boolean;
+  evaluations: number;
+  elapsedMs: number;
+}
+
+export interface OptimizationBounds {
+  rate: SweepAxis;
+  value: SweepAxis;
+}
+
+const goldenRatio = (Math.sqrt(5) - 1) / 2;
+// Rates the feasibility scan tries before bisecting between the last miss and the first hit
+const scanSteps = 8;
+const bisectionSteps = 6;
+// Search tolerances: sampling rate in Hz, delta step as a fraction of the amplitude
+const rateTolerance = 0.25;
+const stepTolerance = 0.005;
+
+// Rates are kept to the 0.01 Hz the controls show; rounding up keeps a feasible rate feasible
+function roundRate(rate: number): number {
+  return Math.ceil(rate * 100 - 1e-6) / 100;
+}
+
+/** Maximum of `f` on [low, high], assuming it is unimodal there, to within `tolerance`. */
+export function goldenSectionMax(
+  f: (x: number) => number,
+  low: number,
+  high: number,
+  tolerance: number
+): { x: number; y: number } {
+  let a = low;
+  let b = high;
+  let c = b - goldenRatio * (b - a);
+  let d = a + goldenRatio * (b - a);
+  let fc = f(c);
+  let fd = f(d);
+  while (b - a > tolerance) {
+    if (fc >= fd) {
+      b = d;
+      d = c;
+      fd = fc;
+      c = b - goldenRatio * (b - a);
+      fc = f(c);
+    } else {
+      a = c;
+      c = d;
+      fc = fd;
+      d = a + goldenRatio * (b - a);
+      fd = f(d);
+    }
+  }
+  return fc >= fd ? { x: c, y: fc } : { x: d, y: fd };
+}
+
+/**
+ * Lowest rate in [low, high] where `feasible` holds, assuming it keeps holding above
+ * that rate: a coarse scan, then bisection inside the step where it starts. Null if it
+ * fails even at `high`.
+ */
+function lowestFeasibleRate(feasible: (rate: number) => boolean, low: number, high: number): number | null {
+  if (!feasible(high)) return null;
+  let miss = low;
+  let hit = high;
+  for (let i = 0; i < scanSteps; i++) {
+    const rate = low + (i / scanSteps) * (high - low);
+    if (feasible(rate)) {
+      hit = rate;
+      break;
+    }
+    miss = rate;
+  }
+  if (hit === low) return low;
+  for (let i = 0; i < bisectionSteps && hit - miss > rateTolerance / 4; i++) {
+    const middle = (miss + hit) / 2;
+    if (feasible(middle)) hit = middle;
+    else miss = middle;
+  }
+  return hit;
+}
+
+/** Searches the parameters of `algorithm` that best meet `goal` for the evaluator's input. */
+export function optimizeConfig(
+  evaluator: SweepEvaluator,
+  algorithm: AnalogToDigitalAlgorithm,
+  goal: OptimizationGoal,
+  bounds: OptimizationBounds = defaultSweepAxes[algorithm]
+): OptimizedConfig {
+  const start = performance.now();
+  let evaluations = 0;
+  const scores = new Map<string, number>();
+  const score = (rate: number, value: number): number => {
+    const key = `${rate}:${value}`;
+    let sqnrDb = scores.get(key);
+    if (sqnrDb === undefined) {
+      evaluations++;
+      sqnrDb = evaluator.sqnr(algorithm, rate, value);
+      scores.set(key, sqnrDb);
+    }
+    return sqnrDb;
+  };
+  const result = (rate: number, value: number): OptimizedConfig => {
+    const rounded = roundRate(rate);
+    const sqnrDb = score(rounded, value);
+    const bitRate = sweepBitRate(algorithm, rounded, value);
+    return {
+      rate: rounded,
+      value,
+      sqnrDb,
+      bitRate,
+      feasible: goal.kind === 'min bit rate' ? sqnrDb >= goal.targetSqnrDb : bitRate <= goal.maxBitRate + 1e-9,
+      evaluations,
+      elapsedMs: performance.now() - start,
+    };
+  };
+
+  const minRate = bounds.rate.min;
+  const maxRate = bounds.rate.max;
+
+  if (algorithm === 'PCM') {
+    const minBits = Math.max(1, Math.ceil(Math.log2(bounds.value.min)));
+    const maxBits = Math.max(minBits, Math.floor(Math.log2(bounds.value.max)));
+    const levels = (bits: number) => 2 ** bits;
+
+    if (goal.kind === 'min bit rate') {
+      const reaches = (rate: number, bits: number) => score(rate, levels(bits)) >= goal.targetSqnrDb;
+      if (!reaches(maxRate, maxBits)) return result(maxRate, levels(maxBits));
+
+      // Fewest bits that reach the target at the highest rate (more bits never lower SQNR there)
+      let low = minBits;
+      let high = maxBits;
+      while (low < high) {
+        const middle = Math.floor((low + high) / 2);
+        if (reaches(maxRate, middle)) high = middle;
+        else low = middle + 1;
+      }
+
+      // Then the lowest rate for each bit depth, only as high as still beats the best so far
+      let best = { rate: maxRate, bits: low, bitRate: maxRate * low };
+      for (let bits = low; bits <= maxBits && bits * minRate < best.bitRate; bits++) {
+        const rate = lowestFeasibleRate(r => reaches(roundRate(r), bits), minRate, Math.min(maxRate, best.bitRate / bits));
+        if (rate !== null && roundRate(rate) * bits < best.bitRate) {
+          best = { rate, bits, bitRate: roundRate(rate) * bits };
+        }
+      }
+      return result(best.rate, levels(best.bits));
+    }
+
+    // Highest SQNR within the budget: the best bit depth at the highest rate each can afford,
+    // then the best rate for that depth (near a multiple of the tone can beat the highest)
+    const affordable = (bits: number) => Math.min(maxRate, Math.floor((goal.maxBitRate / bits) * 100) / 100);
+    let bestBits = 0;
+    for (let bits = minBits; bits <= maxBits && affordable(bits) >= minRate; bits++) {
+      if (bestBits === 0 || score(affordable(bits), levels(bits)) > score(affordable(bestBits), levels(bestBits))) {
+        bestBits = bits;
+      }
+    }
+    if (bestBits === 0) return result(minRate, levels(minBits));
+    const high = affordable(bestBits);
+    const peak = goldenSectionMax(
+      r => score(Math.min(high, roundRate(r)), levels(bestBits)),
+      Math.max(minRate, high / 2),
+      high,
+      rateTolerance
+    );
+    const rate = peak.y > score(high, levels(bestBits)) ? Math.min(high, roundRate(peak.x)) : high;
+    return result(rate, levels(bestBits));
+  }
+
+  // Delta modulation: one bit per sample, so the bit rate is the sampling rate
+  const bestStep = (rate: number) => {
+    const peak = goldenSectionMax(step => score(rate, step), bounds.value.min, bounds.value.max, stepTolerance);
+    // Scored at the step the control will show, so feasibility holds for the step returned
+    const step = Math.round(peak.x * 1000) / 1000;
+    return { step, sqnrDb: score(rate, step) };
+  };
+
+  if (goal.kind === 'min bit rate') {
+    const rate = lowestFeasibleRate(r => bestStep(roundRate(r)).sqnrDb >= goal.targetSqnrDb, minRate, maxRate);
+    if (rate === null) return result(maxRate, bestStep(maxRate).step);
+    return result(rate, bestStep(roundRate(rate)).step);
+  }
+
+  // A faster staircase follows the input more closely at its best step, so spend the whole budget
+  const rate = Math.min(maxRate, Math.floor(goal.maxBitRate * 100) / 100);
+  if (rate < minRate) return result(minRate, bestStep(minRate).step);
+  return result(rate, bestStep(rate).step);
+}
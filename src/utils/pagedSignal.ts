@@ -0,0 +1,255 @@
+import { InputPort, Stage } from './pipeline';
+
+/**
+ * Sample storage for captures too long to hold in memory. A `PagedSignal` is a float32
+ * sequence split into fixed-size chunks. With a `ChunkStore` only the most recently used
+ * chunks stay resident and the rest are written out, to a file in the Origin Private File
+ * System through a `FileSystemSyncAccessHandle` (dedicated workers only); without one,
+ * every chunk stays in memory.
+ *
+ * Readers (the chart envelopes, the LOD pyramid and the capture metrics) go through
+ * `read` and `scan`, which page chunks in as needed, so none of them holds the whole
+ * signal. Samples are float32: ample for display and SQNR, at half the bytes.
+ */
+
+/** Samples per chunk: 256 KiB of float32. */
+export const CHUNK_LENGTH = 65536;
+const chunkBytes = CHUNK_LENGTH * Float32Array.BYTES_PER_ELEMENT;
+
+/** Backing storage for chunks that are not resident. */
+export interface ChunkStore {
+  /** Fills `chunk` with chunk `index` as last saved */
+  load(index: number, chunk: Float32Array): void;
+  save(index: number, chunk: Float32Array): void;
+  /** Releases the storage and deletes what was saved */
+  close(): void;
+}
+
+// The parts of FileSystemSyncAccessHandle used here; TypeScript's DOM library only
+// declares it for workers
+interface SyncAccessHandle {
+  read(buffer: ArrayBufferView, options?: { at?: number }): number;
+  write(buffer: ArrayBufferView, options?: { at?: number }): number;
+  close(): void;
+}
+
+interface SyncAccessFileHandle extends FileSystemFileHandle {
+  createSyncAccessHandle(): Promise<SyncAccessHandle>;
+}
+
+const captureDirectory = 'captures';
+
+/** Whether this thread can open OPFS files for synchronous access (a dedicated worker in a supporting browser). */
+export function opfsAvailable(): boolean {
+  return (
+    typeof navigator !== 'undefined' &&
+    typeof navigator.storage?.getDirectory === 'function' &&
+    typeof FileSystemFileHandle !== 'undefined' &&
+    'createSyncAccessHandle' in FileSystemFileHandle.prototype
+  );
+}
+
+/** Chunks in one OPFS file, chunk i at byte i × chunk size. */
+export class OpfsChunkStore implements ChunkStore {
+  private readonly handle: SyncAccessHandle;
+  private readonly directory: FileSystemDirectoryHandle;
+  private readonly fileName: string;
+
+  private constructor(handle: SyncAccessHandle, directory: FileSystemDirectoryHandle, fileName: string) {
+    this.handle = handle;
+    this.directory = directory;
+    this.fileName = fileName;
+  }
+
+  /** Creates (or truncates) `fileName` in the capture directory; null where OPFS is unavailable. */
+  static async open(fileName: string): Promise<OpfsChunkStore | null> {
+    if (!opfsAvailable()) return null;
+    try {
+      const root = await navigator.storage.getDirectory();
+      const directory = await root.getDirectoryHandle(captureDirectory, { create: true });
+      const file = (await directory.getFileHandle(fileName, { create: true })) as SyncAccessFileHandle;
+      return new OpfsChunkStore(await file.createSyncAccessHandle(), directory, fileName);
+    } catch {
+      return null;
+    }
+  }
+
+  /** Deletes capture files left behind by sessions that ended without closing (a closed tab). */
+  static async removeStale(): Promise<void> {
+    if (!opfsAvailable()) return;
+    try {
+      const root = await navigator.storage.getDirectory();
+      await root.removeEntry(captureDirectory, { recursive: true });
+    } catch {
+      // Nothing left over, or a file still open in another tab
+    }
+  }
+
+  load(index: number, chunk: Float32Array): void {
+    const read = this.handle.read(chunk, { at: index * chunkBytes });
+    // Never written in full: the tail of the last chunk
+    if (read < chunkBytes) chunk.fill(0, Math.floor(read / Float32Array.BYTES_PER_ELEMENT));
+  }
+
+  save(index: number, chunk: Float32Array): void {
+    this.handle.write(chunk, { at: index * chunkBytes });
+  }
+
+  close(): void {
+    this.handle.close();
+    this.directory.removeEntry(this.fileName).catch(() => undefined);
+  }
+}
+
+export interface PagingStats {
+  /** Chunks read back from the store */
+  pageIns: number;
+  /** Chunks written out to make room */
+  pageOuts: number;
+}
+
+export class PagedSignal {
+  readonly sampleRate: number;
+  readonly stats: PagingStats = { pageIns: 0, pageOuts: 0 };
+  private readonly store: ChunkStore | null;
+  private readonly maxResident: number;
+  // Resident chunks from least to most recently used (a Map keeps insertion order)
+  private readonly resident = new Map<number, Float32Array>();
+  private readonly dirty = new Set<number>();
+  // An evicted chunk's array, reused for the next page-in
+  private spare: Float32Array | null = null;
+  private count = 0;
+
+  /** `maxResidentChunks` only applies with a `store`; without one nothing is evicted. */
+  constructor(sampleRate: number, store: ChunkStore | null = null, maxResidentChunks = 64) {
+    this.sampleRate = sampleRate;
+    this.store = store;
+    this.maxResident = store ? Math.max(2, maxResidentChunks) : Infinity;
+  }
+
+  get length(): number {
+    return this.count;
+  }
+
+  get storage(): 'opfs' | 'memory' {
+    return this.store ? 'opfs' : 'memory';
+  }
+
+  /** Bytes of samples currently held in memory. */
+  get residentBytes(): number {
+    return this.resident.size * chunkBytes;
+  }
+
+  /** Appends `values[start..end)`. */
+  append(values: ArrayLike<number>, start = 0, end = values.length): void {
+    let i = start;
+    while (i < end) {
+      const index = Math.floor(this.count / CHUNK_LENGTH);
+      const offset = this.count - index * CHUNK_LENGTH;
+      const chunk = this.chunk(index);
+      const n = Math.min(end - i, CHUNK_LENGTH - offset);
+      for (let j = 0; j < n; j++) chunk[offset + j] = values[i + j];
+      this.dirty.add(index);
+      i += n;
+      this.count += n;
+    }
+  }
+
+  /** Copies samples from `start` into `out` (up to `out.length`, clipped to the signal); returns how many. */
+  read(start: number, out: Float32Array | Float64Array): number {
+    const end = Math.min(this.count, start + out.length);
+    let copied = 0;
+    this.scan(start, end, values => {
+      out.set(values, copied);
+      copied += values.length;
+    });
+    return copied;
+  }
+
+  /**
+   * Visits samples `[start, end)` in order, one chunk-sized view at a time. A view is only
+   * valid during its call: the chunk behind it may be evicted afterwards.
+   */
+  scan(start: number, end: number, visit: (values: Float32Array, first: number) => void): void {
+    let position = Math.max(0, start);
+    const stop = Math.min(this.count, end);
+    while (position < stop) {
+      const index = Math.floor(position / CHUNK_LENGTH);
+      const offset = position - index * CHUNK_LENGTH;
+      const n = Math.min(stop - position, CHUNK_LENGTH - offset);
+      visit(this.chunk(index).subarray(offset, offset + n), position);
+      position += n;
+    }
+  }
+
+  /** Releases the store (deleting its file) and every resident chunk. */
+  close(): void {
+    this.store?.close();
+    this.resident.clear();
+    this.dirty.clear();
+    this.spare = null;
+  }
+
+  // Chunk `index`, paged in (or started, past the end) and marked most recently used
+  private chunk(index: number): Float32Array {
+    let chunk = this.resident.get(index);
+    if (chunk) {
+      this.resident.delete(index);
+      this.resident.set(index, chunk);
+      return chunk;
+    }
+    if (this.resident.size >= this.maxResident) this.evictOldest();
+    chunk = this.spare ?? new Float32Array(CHUNK_LENGTH);
+    this.spare = null;
+    if (this.store && index * CHUNK_LENGTH < this.count) {
+      this.store.load(index, chunk);
+      this.stats.pageIns++;
+    } else {
+      chunk.fill(0);
+    }
+    this.resident.set(index, chunk);
+    return chunk;
+  }
+
+  private evictOldest(): void {
+    const [index, chunk] = this.resident.entries().next().value as [number, Float32Array];
+    this.resident.delete(index);
+    if (this.dirty.delete(index)) {
+      this.store?.save(index, chunk);
+      this.stats.pageOuts++;
+    }
+    this.spare = chunk;
+  }
+}
+
+/**
+ * Appends a real stream to a `PagedSignal`. `onProgress` is called with the length so
+ * far about every `progressInterval` items, for runs long enough to want a progress bar.
+ */
+export class PagedSink implements Stage {
+  readonly name = 'paged sink';
+  readonly inputs = ['real'] as const;
+  readonly outputs = [] as const;
+  readonly signal: PagedSignal;
+  private readonly onProgress: ((length: number) => void) | null;
+  private readonly progressInterval: number;
+  private nextReport: number;
+
+  constructor(signal: PagedSignal, onProgress?: (length: number) => void, progressInterval = 1 << 20) {
+    this.signal = signal;
+    this.onProgress = onProgress ?? null;
+    this.progressInterval = progressInterval;
+    this.nextReport = progressInterval;
+  }
+
+  process(inputs: InputPort[]): boolean {
+    const input = inputs[0];
+    this.signal.append(input.data, input.offset, input.length);
+    input.offset = input.length;
+    if (this.onProgress && this.signal.length >= this.nextReport) {
+      this.onProgress(this.signal.length);
+      this.nextReport = this.signal.length + this.progressInterval;
+    }
+    return input.ended;
+  }
+}
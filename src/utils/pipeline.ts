@@ -0,0 +1,493 @@
+import { PortType, SamplePrecision } from '../types';
+import { Arena, BufferPool, FloatArray, sharedBufferPool, sizeClass } from './bufferPool';
+import { hotCounters } from './counters';
+import { instrumentationEnabled, recordTiming } from './instrumentation';
+import { traceAllocations, traceRecording, traceSpan } from './trace';
+
+/**
+ * Storage used for each port type:
+ * bits → Uint8Array (0/1), symbols → Int32Array (symbol index),
+ * real → float array, complex → float array in-phase plus `imag` quadrature.
+ * Float arrays are Float64Array or Float32Array depending on the run's precision.
+ */
+export type BlockData = Uint8Array | Int32Array | FloatArray;
+
+export interface Block {
+  readonly type: PortType;
+  data: BlockData;
+  imag: FloatArray | null;
+  /** Number of valid items in `data` */
+  length: number;
+}
+
+/**
+ * View of the block at the front of an input edge.
+ * Items from `offset` to `length` are unread; a stage advances `offset` by what it consumes.
+ */
+export interface InputPort {
+  readonly type: PortType;
+  data: BlockData;
+  imag: FloatArray | null;
+  offset: number;
+  length: number;
+  /** The producer has finished and every block it emitted has been consumed */
+  ended: boolean;
+}
+
+/**
+ * View of the block a stage is filling. A stage writes from `length` up to `capacity`
+ * and advances `length` by what it produces.
+ */
+export interface OutputPort {
+  readonly type: PortType;
+  data: BlockData;
+  imag: FloatArray | null;
+  length: number;
+  capacity: number;
+}
+
+/**
+ * A processing node. Stages are stateful and used for a single run.
+ * Input blocks are shared between consumers and recycled after use, so a stage must
+ * neither modify them nor keep references to them after `process` returns.
+ */
+export interface Stage {
+  readonly name: string;
+  readonly inputs: readonly PortType[];
+  readonly outputs: readonly PortType[];
+  /**
+   * Called once before the run so the stage can draw its scratch buffers from the run's
+   * arena, in the precision used for sample blocks.
+   */
+  setup?(arena: Arena, precision: SamplePrecision): void;
+  /**
+   * Moves as much data as possible from inputs to outputs.
+   * Returns true once the stage has finished and will produce nothing more.
+   */
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean;
+}
+
+export const DEFAULT_BLOCK_SIZE = 1024;
+
+// Blocks each edge may hold before its producer is paused
+const DEFAULT_EDGE_CAPACITY = 4;
+
+/**
+ * Free lists of blocks per port type and size class, shared by every run so that
+ * repeated simulations reuse the same buffers. New blocks draw their arrays from
+ * the typed-array pool, so a block may be longer than the requested size.
+ */
+export class BlockPool {
+  private readonly free = new Map<string, Block[]>();
+  private readonly buffers: BufferPool;
+
+  constructor(buffers: BufferPool = sharedBufferPool) {
+    this.buffers = buffers;
+  }
+
+  acquire(type: PortType, size: number, precision: SamplePrecision = 'float64'): Block {
+    const list = this.free.get(blockKey(type, precision, sizeClass(size)));
+    const block = list?.pop();
+    if (block) {
+      block.length = 0;
+      return block;
+    }
+    return {
+      type,
+      data: type === 'bits'
+        ? this.buffers.acquire('uint8', size)
+        : type === 'symbols' ? this.buffers.acquire('int32', size) : this.buffers.acquire(precision, size),
+      imag: type === 'complex' ? this.buffers.acquire(precision, size) : null,
+      length: 0,
+    };
+  }
+
+  release(block: Block): void {
+    const precision = block.data instanceof Float32Array ? 'float32' : 'float64';
+    const key = blockKey(block.type, precision, block.data.length);
+    let list = this.free.get(key);
+    if (!list) {
+      list = [];
+      this.free.set(key, list);
+    }
+    list.push(block);
+  }
+}
+
+export const sharedBlockPool = new BlockPool();
+
+function blockKey(type: PortType, precision: SamplePrecision, size: number): string {
+  // Bit and symbol blocks do not depend on the sample precision
+  return type === 'bits' || type === 'symbols' ? `${type}:${size}` : `${type}:${precision}:${size}`;
+}
+
+interface SharedBlock {
+  block: Block;
+  refs: number;
+}
+
+interface Edge {
+  from: GraphNode;
+  to: GraphNode;
+  queue: SharedBlock[];
+  capacity: number;
+  readOffset: number;
+}
+
+interface GraphNode {
+  id: string;
+  stage: Stage;
+  inEdges: (Edge | null)[];
+  outEdges: Edge[][];
+  inputs: InputPort[];
+  outputs: OutputPort[];
+  pending: (SharedBlock | null)[];
+  done: boolean;
+  /** Items on the first output (first input, for sinks) and time spent in `step`, for instrumentation */
+  items: number;
+  busyMs: number;
+}
+
+export interface PipelineOptions {
+  /** Items per block on every edge */
+  blockSize?: number;
+  /** Blocks an edge may queue before backpressure pauses the producer */
+  edgeCapacity?: number;
+  pool?: BlockPool;
+  /** Storage for real and complex samples (float64 by default) */
+  precision?: SamplePrecision;
+  /** Scratch arena handed to `Stage.setup`; a private one is released after the run when omitted */
+  arena?: Arena;
+}
+
+/**
+ * Declarative description of a graph: named stages plus edges written as
+ * `'node'` or `'node:port'` (port 0 when omitted).
+ */
+export interface GraphSpec {
+  nodes: Record<string, Stage>;
+  edges: [from: string, to: string][];
+}
+
+function parseEndpoint(endpoint: string): [string, number] {
+  const separator = endpoint.lastIndexOf(':');
+  if (separator < 0) return [endpoint, 0];
+  return [endpoint.slice(0, separator), parseInt(endpoint.slice(separator + 1))];
+}
+
+/**
+ * Directed acyclic graph of stages executed block by block.
+ * Every edge is a bounded queue of pooled blocks: a producer only runs while all of
+ * its downstream queues have room, and blocks return to the pool once every consumer
+ * has read them.
+ */
+export class Pipeline {
+  private readonly nodes = new Map<string, GraphNode>();
+  private readonly blockSize: number;
+  private readonly edgeCapacity: number;
+  private readonly pool: BlockPool;
+  private readonly precision: SamplePrecision;
+  private readonly arena: Arena | null;
+
+  constructor(options: PipelineOptions = {}) {
+    this.blockSize = options.blockSize ?? DEFAULT_BLOCK_SIZE;
+    this.edgeCapacity = options.edgeCapacity ?? DEFAULT_EDGE_CAPACITY;
+    this.pool = options.pool ?? sharedBlockPool;
+    this.precision = options.precision ?? 'float64';
+    this.arena = options.arena ?? null;
+  }
+
+  static fromSpec(spec: GraphSpec, options?: PipelineOptions): Pipeline {
+    const pipeline = new Pipeline(options);
+    for (const [id, stage] of Object.entries(spec.nodes)) {
+      pipeline.add(id, stage);
+    }
+    for (const [from, to] of spec.edges) {
+      pipeline.connect(from, to);
+    }
+    return pipeline;
+  }
+
+  add(id: string, stage: Stage): this {
+    if (this.nodes.has(id)) {
+      throw new Error(`Duplicate pipeline node: ${id}`);
+    }
+    this.nodes.set(id, {
+      id,
+      stage,
+      inEdges: stage.inputs.map(() => null),
+      outEdges: stage.outputs.map(() => []),
+      inputs: stage.inputs.map(type => ({ type, data: new Float64Array(0), imag: null, offset: 0, length: 0, ended: false })),
+      outputs: stage.outputs.map(type => ({ type, data: new Float64Array(0), imag: null, length: 0, capacity: 0 })),
+      pending: stage.outputs.map(() => null),
+      done: false,
+      items: 0,
+      busyMs: 0,
+    });
+    return this;
+  }
+
+  /** Connects `'node:port'` to `'node:port'`; the port types must match. */
+  connect(from: string, to: string): this {
+    const [fromId, fromPort] = parseEndpoint(from);
+    const [toId, toPort] = parseEndpoint(to);
+    const source = this.nodes.get(fromId);
+    const target = this.nodes.get(toId);
+    if (!source || !target) {
+      throw new Error(`Unknown pipeline node in edge ${from} → ${to}`);
+    }
+
+    const outputType = source.stage.outputs[fromPort];
+    const inputType = target.stage.inputs[toPort];
+    if (outputType === undefined || inputType === undefined) {
+      throw new Error(`Unknown port in edge ${from} → ${to}`);
+    }
+    if (outputType !== inputType) {
+      throw new Error(`Port type mismatch in edge ${from} → ${to}: ${outputType} → ${inputType}`);
+    }
+    if (target.inEdges[toPort]) {
+      throw new Error(`Input ${to} is already connected`);
+    }
+
+    const edge: Edge = { from: source, to: target, queue: [], capacity: this.edgeCapacity, readOffset: 0 };
+    source.outEdges[fromPort].push(edge);
+    target.inEdges[toPort] = edge;
+    return this;
+  }
+
+  /**
+   * Runs every stage to completion. While instrumentation is recording, each stage's
+   * time in `step` is summed and reported once per run; while a trace is recording,
+   * every step that moves data also becomes a trace span of its own.
+   */
+  run(): void {
+    const order = this.topologicalOrder();
+    const arena = this.arena ?? new Arena();
+    const timing = instrumentationEnabled();
+    const tracing = traceRecording();
+    const runStart = timing ? performance.now() : 0;
+
+    try {
+      for (const node of order) {
+        node.stage.setup?.(arena, this.precision);
+      }
+      for (;;) {
+        let progress = false;
+        let finished = true;
+        for (const node of order) {
+          if (timing) {
+            const start = performance.now();
+            const moved = this.step(node);
+            const elapsed = performance.now() - start;
+            node.busyMs += elapsed;
+            if (moved) {
+              progress = true;
+              if (tracing) traceSpan(node.id, node.stage.name, start, elapsed);
+            }
+          } else if (this.step(node)) {
+            progress = true;
+          }
+          if (!node.done) finished = false;
+        }
+        if (finished) break;
+        if (!progress && !this.relieveBackpressure(order)) {
+          throw new Error('Pipeline stalled: no stage can make progress');
+        }
+      }
+      if (timing) {
+        for (const node of order) recordTiming(`${node.id} (${node.stage.name})`, 'stage', runStart, node.busyMs, node.items);
+      }
+      if (tracing) {
+        traceSpan('pipeline run', 'pipeline', runStart, performance.now() - runStart, { stages: order.length });
+        traceAllocations();
+      }
+    } finally {
+      this.releaseAll(order);
+      if (!this.arena) arena.release();
+    }
+  }
+
+  private topologicalOrder(): GraphNode[] {
+    const indegree = new Map<GraphNode, number>();
+    for (const node of this.nodes.values()) {
+      node.inEdges.forEach((edge, port) => {
+        if (!edge) {
+          throw new Error(`Input ${node.id}:${port} (${node.stage.inputs[port]}) is not connected`);
+        }
+      });
+      indegree.set(node, node.inEdges.length);
+    }
+
+    const ready = [...this.nodes.values()].filter(node => node.inEdges.length === 0);
+    const order: GraphNode[] = [];
+    while (ready.length > 0) {
+      const node = ready.shift()!;
+      order.push(node);
+      for (const edges of node.outEdges) {
+        for (const edge of edges) {
+          const remaining = indegree.get(edge.to)! - 1;
+          indegree.set(edge.to, remaining);
+          if (remaining === 0) ready.push(edge.to);
+        }
+      }
+    }
+
+    if (order.length !== this.nodes.size) {
+      throw new Error('Pipeline graph contains a cycle');
+    }
+    return order;
+  }
+
+  /** Gives one stage a chance to run; returns whether anything moved. */
+  private step(node: GraphNode): boolean {
+    if (node.done) return false;
+
+    for (let p = 0; p < node.inputs.length; p++) {
+      const edge = node.inEdges[p]!;
+      const port = node.inputs[p];
+      const front = edge.queue[0];
+      if (front) {
+        port.data = front.block.data;
+        port.imag = front.block.imag;
+        port.offset = edge.readOffset;
+        port.length = front.block.length;
+        port.ended = false;
+      } else {
+        port.offset = 0;
+        port.length = 0;
+        port.ended = edge.from.done;
+      }
+    }
+
+    for (let p = 0; p < node.outputs.length; p++) {
+      if (!node.pending[p]) {
+        if (this.blocked(node.outEdges[p])) return false;
+        node.pending[p] = { block: this.pool.acquire(node.stage.outputs[p], this.blockSize, this.precision), refs: 0 };
+      }
+      const block = node.pending[p]!.block;
+      const port = node.outputs[p];
+      port.data = block.data;
+      port.imag = block.imag;
+      port.length = block.length;
+      port.capacity = this.blockSize;
+    }
+
+    const finished = node.stage.process(node.inputs, node.outputs);
+    let progress = finished;
+
+    for (let p = 0; p < node.inputs.length; p++) {
+      const edge = node.inEdges[p]!;
+      const port = node.inputs[p];
+      const front = edge.queue[0];
+      if (!front) continue;
+      if (port.offset !== edge.readOffset) {
+        progress = true;
+        if (node.outputs.length === 0 && p === 0) node.items += port.offset - edge.readOffset;
+        edge.readOffset = port.offset;
+      }
+      if (edge.readOffset >= front.block.length) {
+        edge.queue.shift();
+        edge.readOffset = 0;
+        this.unref(front);
+      }
+    }
+
+    let stalled = !progress;
+    for (let p = 0; p < node.outputs.length; p++) {
+      const shared = node.pending[p]!;
+      const port = node.outputs[p];
+      if (port.length !== shared.block.length) {
+        progress = true;
+        stalled = false;
+        if (p === 0) node.items += port.length - shared.block.length;
+        shared.block.length = port.length;
+      }
+    }
+
+    for (let p = 0; p < node.outputs.length; p++) {
+      const shared = node.pending[p]!;
+      const length = shared.block.length;
+      // Partial blocks are passed on when the stage is starved so downstream never waits on them
+      if (length === this.blockSize || (length > 0 && (finished || stalled))) {
+        this.emit(node, p, shared);
+        progress = true;
+      }
+    }
+
+    if (finished) {
+      node.done = true;
+      for (let p = 0; p < node.pending.length; p++) {
+        const shared = node.pending[p];
+        if (shared) this.pool.release(shared.block);
+        node.pending[p] = null;
+      }
+    }
+
+    return progress;
+  }
+
+  private blocked(edges: Edge[]): boolean {
+    for (const edge of edges) {
+      if (!edge.to.done && edge.queue.length >= edge.capacity) return true;
+    }
+    return false;
+  }
+
+  private emit(node: GraphNode, port: number, shared: SharedBlock): void {
+    node.pending[port] = null;
+    // Consumers that already finished no longer receive blocks
+    let refs = 0;
+    for (const edge of node.outEdges[port]) {
+      if (edge.to.done) continue;
+      edge.queue.push(shared);
+      refs++;
+    }
+    if (refs === 0) {
+      this.pool.release(shared.block);
+      return;
+    }
+    shared.refs = refs;
+  }
+
+  private unref(shared: SharedBlock): void {
+    shared.refs--;
+    if (shared.refs === 0) this.pool.release(shared.block);
+  }
+
+  /**
+   * Fan-in of paths with different latencies can fill one queue while the consumer
+   * still waits on the other. Grows the full queues of blocked producers by one block.
+   */
+  private relieveBackpressure(order: GraphNode[]): boolean {
+    let relieved = false;
+    for (const node of order) {
+      if (node.done) continue;
+      for (const edges of node.outEdges) {
+        for (const edge of edges) {
+          if (edge.queue.length >= edge.capacity) {
+            if (__SIGNAL_COUNTERS__) hotCounters.bufferGrowths++;
+            edge.capacity++;
+            relieved = true;
+          }
+        }
+      }
+    }
+    return relieved;
+  }
+
+  private releaseAll(order: GraphNode[]): void {
+    for (const node of order) {
+      for (let p = 0; p < node.pending.length; p++) {
+        const shared = node.pending[p];
+        if (shared) this.pool.release(shared.block);
+        node.pending[p] = null;
+      }
+      for (const edges of node.outEdges) {
+        for (const edge of edges) {
+          for (const shared of edge.queue) this.unref(shared);
+          edge.queue.length = 0;
+        }
+      }
+    }
+  }
+}
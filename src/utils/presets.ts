@@ -0,0 +1,111 @@
+import { DigitalToDigitalAlgorithm } from '../types';
+import { Pipeline, PipelineOptions } from './pipeline';
+import {
+  AwgnChannel,
+  BitErrorCounter,
+  BitSource,
+  CollectSink,
+  Resampler,
+  SymbolMapper,
+  SymbolSerializer,
+  ToneSource,
+} from './stages';
+import { LineCoder, LineDecoderStage } from './digitalToDigital';
+import { PcmDecoder, PcmQuantizer } from './analogToDigital';
+import { Random } from './random';
+
+export interface PcmLinkConfig {
+  frequency: number;
+  amplitude: number;
+  samplingRate: number;
+  quantizationLevels: number;
+  lineCode: DigitalToDigitalAlgorithm;
+  /** Standard deviation of the channel noise relative to the ±1 line levels */
+  noiseSigma: number;
+  duration?: number;
+  seed?: number;
+}
+
+/**
+ * End-to-end PCM link built only from existing stages:
+ * tone → sampler → quantiser → serialiser → line coder → AWGN → line decoder →
+ * deserialiser → PCM decoder, with a bit error counter tapping both ends of the channel.
+ */
+export function buildPcmLinkGraph(
+  config: PcmLinkConfig,
+  options?: PipelineOptions
+): { pipeline: Pipeline; output: CollectSink; errors: BitErrorCounter } {
+  const displayRate = 100;
+  const duration = config.duration ?? 2;
+  const bitsPerSample = Math.max(1, Math.ceil(Math.log2(config.quantizationLevels)));
+  const output = new CollectSink('real');
+  const errors = new BitErrorCounter();
+
+  const pipeline = Pipeline.fromSpec({
+    nodes: {
+      message: new ToneSource(config.frequency, config.amplitude, displayRate, duration * displayRate),
+      sampler: new Resampler(displayRate, config.samplingRate),
+      quantizer: new PcmQuantizer(config.amplitude, config.quantizationLevels),
+      serializer: new SymbolSerializer(bitsPerSample),
+      coder: new LineCoder(config.lineCode),
+      channel: new AwgnChannel(config.noiseSigma, config.seed),
+      lineDecoder: new LineDecoderStage(config.lineCode),
+      deserializer: new SymbolMapper(bitsPerSample),
+      pcmDecoder: new PcmDecoder(config.amplitude, config.quantizationLevels),
+      output,
+      errors,
+    },
+    edges: [
+      ['message', 'sampler'],
+      ['sampler', 'quantizer'],
+      ['quantizer', 'serializer'],
+      ['serializer', 'coder'],
+      ['coder', 'channel'],
+      ['channel', 'lineDecoder'],
+      ['lineDecoder', 'deserializer'],
+      ['deserializer', 'pcmDecoder'],
+      ['pcmDecoder', 'output'],
+      ['serializer', 'errors:0'],
+      ['lineDecoder', 'errors:1'],
+    ],
+  }, options);
+
+  return { pipeline, output, errors };
+}
+
+/**
+ * Bit error rate of a line code over AWGN, measured by pushing `bitCount` pseudo-random
+ * bits through coder → channel → hard-decision decoder. `noiseSigma` is relative to the
+ * ±1 line levels, as in `PcmLinkConfig`.
+ */
+export function measureLineCodeBer(
+  lineCode: DigitalToDigitalAlgorithm,
+  noiseSigma: number,
+  bitCount = 100000,
+  seed?: number,
+  options?: PipelineOptions
+): number {
+  const random = new Random(seed);
+  const bits = new Uint8Array(bitCount);
+  for (let k = 0; k < bitCount; k++) bits[k] = random.bit();
+  const errors = new BitErrorCounter();
+
+  Pipeline.fromSpec({
+    nodes: {
+      source: new BitSource(bits),
+      coder: new LineCoder(lineCode),
+      channel: new AwgnChannel(noiseSigma, seed === undefined ? undefined : seed + 1),
+      decoder: new LineDecoderStage(lineCode),
+      errors,
+    },
+    edges: [
+      ['source', 'coder'],
+      ['coder', 'channel'],
+      ['channel', 'decoder'],
+      ['source', 'errors:0'],
+      ['decoder', 'errors:1'],
+    ],
+  }, options).run();
+
+  return errors.errorRate;
+}
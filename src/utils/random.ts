@@ -0,0 +1,76 @@
+/**
+ * Seedable pseudo-random source (xoshiro128**) so that simulated
+ * noise and test patterns are reproducible between runs.
+ */
+export class Random {
+  private s0: number;
+  private s1: number;
+  private s2: number;
+  private s3: number;
+  private spareGaussian: number | null = null;
+
+  constructor(seed = 0x2545f491) {
+    // SplitMix32 expands the seed into a non-zero state
+    let z = seed >>> 0;
+    const next = () => {
+      z = (z + 0x9e3779b9) >>> 0;
+      let t = z ^ (z >>> 16);
+      t = Math.imul(t, 0x21f0aaad);
+      t ^= t >>> 15;
+      t = Math.imul(t, 0x735a2d97);
+      return (t ^ (t >>> 15)) >>> 0;
+    };
+    this.s0 = next() | 1;
+    this.s1 = next();
+    this.s2 = next();
+    this.s3 = next();
+  }
+
+  /** Uniform 32-bit unsigned integer */
+  nextUint32(): number {
+    // xoshiro128** step
+    const result = Math.imul(rotl(Math.imul(this.s1, 5), 7), 9) >>> 0;
+    const t = this.s1 << 9;
+    this.s2 ^= this.s0;
+    this.s3 ^= this.s1;
+    this.s1 ^= this.s2;
+    this.s0 ^= this.s3;
+    this.s2 ^= t;
+    this.s3 = rotl(this.s3, 11);
+    return result;
+  }
+
+  /** Uniform value in [0, 1) */
+  next(): number {
+    return this.nextUint32() / 4294967296;
+  }
+
+  /** Uniform random bit */
+  bit(): number {
+    return this.nextUint32() >>> 31;
+  }
+
+  /** Standard normal deviate (polar Box–Muller) */
+  gaussian(): number {
+    if (this.spareGaussian !== null) {
+      const spare = this.spareGaussian;
+      this.spareGaussian = null;
+      return spare;
+    }
+    let u = 0;
+    let v = 0;
+    let s = 0;
+    do {
+      u = 2 * this.next() - 1;
+      v = 2 * this.next() - 1;
+      s = u * u + v * v;
+    } while (s >= 1 || s === 0);
+    const scale = Math.sqrt((-2 * Math.log(s)) / s);
+    this.spareGaussian = v * scale;
+    return u * scale;
+  }
+}
+
+function rotl(x: number, k: number): number {
+  return (x << k) | (x >>> (32 - k));
+}
@@ -0,0 +1,673 @@
+import { BlockCode, DataPoint, DigitalToDigitalAlgorithm, DigitalToAnalogAlgorithm } from '../types';
+
+/**
+ * Reference oracles: whole-array, one-sample-at-a-time restatements of the kernels,
+ * written for obviousness rather than speed. The line coding and keying oracles are the
+ * original chart generators, copied unchanged from before the streaming pipeline. They
+ * are frozen on purpose. A faster kernel is only correct if `equivalence.ts` finds it
+ * matching these on random inputs, so do not change an oracle to fit a new implementation.
+ */
+
+// ---------------------------------------------------------------------------
+// Line coding
+// ---------------------------------------------------------------------------
+
+/**
+ * Chart points of `bits` under `algorithm` at one bit per unit time: the original
+ * generators below, copied unchanged, each level a pair of points spanning its interval.
+ */
+export function referenceLineCode(bits: ArrayLike<number>, algorithm: DigitalToDigitalAlgorithm): DataPoint[] {
+  const values = Array.from(bits);
+  const bitDuration = 1;
+  switch (algorithm) {
+    case 'NRZ-L':
+      return generateNRZL(values, bitDuration);
+    case 'NRZ-I':
+      return generateNRZI(values, bitDuration);
+    case 'Manchester':
+      return generateManchester(values, bitDuration);
+    case 'Differential Manchester':
+      return generateDifferentialManchester(values, bitDuration);
+    case 'AMI':
+      return generateAMI(values, bitDuration);
+    case 'Pseudoternary':
+      return generatePseudoternary(values, bitDuration);
+    case 'B8ZS':
+      return generateB8ZS(values, bitDuration);
+    case 'HDB3':
+      return generateHDB3(values, bitDuration);
+  }
+}
+
+// NRZ-L: 0 = high level (+1), 1 = low level (-1)
+function generateNRZL(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  for (let i = 0; i < bits.length; i++) {
+    const voltage = bits[i] === 0 ? 1 : -1;
+    signal.push({ x: i * bitDuration, y: voltage });
+    signal.push({ x: (i + 1) * bitDuration, y: voltage });
+  }
+  return signal;
+}
+
+// NRZ-I: 0 = no transition, 1 = transition at beginning
+function generateNRZI(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  let currentLevel = 1;
+
+  for (let i = 0; i < bits.length; i++) {
+    if (bits[i] === 1) {
+      currentLevel = currentLevel === 1 ? -1 : 1;
+    }
+    signal.push({ x: i * bitDuration, y: currentLevel });
+    signal.push({ x: (i + 1) * bitDuration, y: currentLevel });
+  }
+  return signal;
+}
+
+// Manchester: 0 = high to low transition, 1 = low to high transition
+function generateManchester(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  for (let i = 0; i < bits.length; i++) {
+    if (bits[i] === 0) {
+      // High to low
+      signal.push({ x: i * bitDuration, y: 1 });
+      signal.push({ x: (i + 0.5) * bitDuration, y: 1 });
+      signal.push({ x: (i + 0.5) * bitDuration, y: -1 });
+      signal.push({ x: (i + 1) * bitDuration, y: -1 });
+    } else {
+      // Low to high
+      signal.push({ x: i * bitDuration, y: -1 });
+      signal.push({ x: (i + 0.5) * bitDuration, y: -1 });
+      signal.push({ x: (i + 0.5) * bitDuration, y: 1 });
+      signal.push({ x: (i + 1) * bitDuration, y: 1 });
+    }
+  }
+  return signal;
+}
+
+// Differential Manchester: always transition in middle, 0 = transition at beginning, 1 = no transition at beginning
+function generateDifferentialManchester(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  let currentLevel = 1;
+
+  for (let i = 0; i < bits.length; i++) {
+    // For 0: transition at beginning
+    if (bits[i] === 0) {
+      currentLevel = currentLevel === 1 ? -1 : 1;
+    }
+    // For 1: no transition at beginning
+    
+    // First half of bit period
+    signal.push({ x: i * bitDuration, y: currentLevel });
+    signal.push({ x: (i + 0.5) * bitDuration, y: currentLevel });
+    
+    // Always transition in middle
+    currentLevel = currentLevel === 1 ? -1 : 1;
+    
+    // Second half of bit period
+    signal.push({ x: (i + 0.5) * bitDuration, y: currentLevel });
+    signal.push({ x: (i + 1) * bitDuration, y: currentLevel });
+  }
+  return signal;
+}
+
+// Bipolar AMI: 0 = no signal (0), 1 = alternating +1/-1
+function generateAMI(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  let lastOnePolarity = -1;
+
+  for (let i = 0; i < bits.length; i++) {
+    let voltage = 0;
+    if (bits[i] === 1) {
+      lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
+      voltage = lastOnePolarity;
+    }
+    signal.push({ x: i * bitDuration, y: voltage });
+    signal.push({ x: (i + 1) * bitDuration, y: voltage });
+  }
+  return signal;
+}
+
+// Pseudoternary: 0 = alternating +1/-1, 1 = no signal (0)
+function generatePseudoternary(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  let lastZeroPolarity = -1;
+
+  for (let i = 0; i < bits.length; i++) {
+    let voltage = 0;
+    if (bits[i] === 0) {
+      lastZeroPolarity = lastZeroPolarity === 1 ? -1 : 1;
+      voltage = lastZeroPolarity;
+    }
+    signal.push({ x: i * bitDuration, y: voltage });
+    signal.push({ x: (i + 1) * bitDuration, y: voltage });
+  }
+  return signal;
+}
+
+// B8ZS: Same as AMI, but string of 8 zeros replaced with pattern containing violations
+function generateB8ZS(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  let lastOnePolarity = -1;
+
+  for (let i = 0; i < bits.length; i++) {
+    // Check for 8 consecutive zeros
+    if (i + 7 < bits.length && bits.slice(i, i + 8).every(b => b === 0)) {
+      // Replace with B8ZS substitution pattern: 000VB0VB
+      // V = violation (same polarity as last), B = bipolar (opposite polarity)
+      const V = lastOnePolarity;
+      const B = lastOnePolarity === 1 ? -1 : 1;
+      
+      // 000VB0VB pattern
+      const pattern = [0, 0, 0, V, B, 0, V, B];
+      for (let j = 0; j < 8; j++) {
+        signal.push({ x: (i + j) * bitDuration, y: pattern[j] });
+        signal.push({ x: (i + j + 1) * bitDuration, y: pattern[j] });
+      }
+      
+      lastOnePolarity = B;
+      i += 7; // Skip the next 7 bits (loop increment will add 1)
+    } else {
+      // Normal AMI encoding
+      let voltage = 0;
+      if (bits[i] === 1) {
+        lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
+        voltage = lastOnePolarity;
+      }
+      signal.push({ x: i * bitDuration, y: voltage });
+      signal.push({ x: (i + 1) * bitDuration, y: voltage });
+    }
+  }
+  return signal;
+}
+
+// HDB3: Same as AMI, but string of 4 zeros replaced with pattern containing violation
+function generateHDB3(bits: number[], bitDuration: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  let lastOnePolarity = -1;
+  let onesCount = 0; // Count of ones since last substitution
+
+  for (let i = 0; i < bits.length; i++) {
+    // Check for 4 consecutive zeros
+    if (i + 3 < bits.length && bits.slice(i, i + 4).every(b => b === 0)) {
+      // Determine substitution pattern based on ones count
+      let pattern: number[];
+      
+      if (onesCount % 2 === 0) {
+        // Even number of ones: use 000V (violation)
+        const V = lastOnePolarity;
+        pattern = [0, 0, 0, V];
+        lastOnePolarity = V;
+      } else {
+        // Odd number of ones: use B00V (balance + violation)
+        const B = lastOnePolarity === 1 ? -1 : 1;
+        const V = B;
+        pattern = [B, 0, 0, V];
+        lastOnePolarity = V;
+      }
+      
+      for (let j = 0; j < 4; j++) {
+        signal.push({ x: (i + j) * bitDuration, y: pattern[j] });
+        signal.push({ x: (i + j + 1) * bitDuration, y: pattern[j] });
+      }
+      
+      onesCount = 0;
+      i += 3; // Skip the next 3 bits (loop increment will add 1)
+    } else {
+      // Normal AMI encoding
+      let voltage = 0;
+      if (bits[i] === 1) {
+        lastOnePolarity = lastOnePolarity === 1 ? -1 : 1;
+        voltage = lastOnePolarity;
+        onesCount++;
+      }
+      signal.push({ x: i * bitDuration, y: voltage });
+      signal.push({ x: (i + 1) * bitDuration, y: voltage });
+    }
+  }
+  return signal;
+}
+
+// ---------------------------------------------------------------------------
+// Passband keying
+// ---------------------------------------------------------------------------
+
+/** Keyings with an original per-sample generator (everything but the CPM family and CSS). */
+export const referenceKeyings: readonly DigitalToAnalogAlgorithm[] = [
+  'ASK',
+  'BFSK',
+  'MFSK',
+  'BPSK',
+  'DPSK',
+  'QPSK',
+  'OQPSK',
+  'MPSK',
+  'QAM',
+];
+
+/**
+ * Chart points of the passband waveform of `bits`: the original generators below, copied
+ * unchanged. Each symbol runs from j = 0 to samplesPerSymbol inclusive, so it ends on a
+ * sample at the instant the next one starts; OQPSK is one stream with a half-symbol tail.
+ */
+export function referenceModulation(
+  bits: ArrayLike<number>,
+  algorithm: DigitalToAnalogAlgorithm,
+  bitDuration: number,
+  samplesPerBit: number
+): DataPoint[] {
+  const values = Array.from(bits);
+  switch (algorithm) {
+    case 'ASK':
+      return generateASK(values, bitDuration, samplesPerBit);
+    case 'BFSK':
+      return generateBFSK(values, bitDuration, samplesPerBit);
+    case 'MFSK':
+      return generateMFSK(values, bitDuration, samplesPerBit);
+    case 'BPSK':
+      return generateBPSK(values, bitDuration, samplesPerBit);
+    case 'DPSK':
+      return generateDPSK(values, bitDuration, samplesPerBit);
+    case 'QPSK':
+      return generateQPSK(values, bitDuration, samplesPerBit);
+    case 'OQPSK':
+      return generateOQPSK(values, bitDuration, samplesPerBit);
+    case 'MPSK':
+      return generateMPSK(values, bitDuration, samplesPerBit);
+    case 'QAM':
+      return generateQAM(values, bitDuration, samplesPerBit);
+    default:
+      throw new Error(`No reference keying for ${algorithm}`);
+  }
+}
+
+
+/**
+ * Generates ASK (Amplitude Shift Keying) signal.
+ * Bit 1 = high amplitude, Bit 0 = low amplitude.
+ */
+function generateASK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+
+  for (let i = 0; i < bits.length; i++) {
+    const amplitude = bits[i] === 1 ? 1 : 0.2;
+    for (let j = 0; j <= samplesPerBit; j++) {
+      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
+      const y = amplitude * Math.sin(2 * Math.PI * carrierFreq * t);
+      signal.push({ x: t, y });
+    }
+  }
+  return signal;
+}
+
+/**
+ * Generates BFSK (Binary Frequency Shift Keying) signal.
+ * Bit 1 = high frequency, Bit 0 = low frequency.
+ */
+function generateBFSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const freq0 = 3;  // Frequency for bit 0
+  const freq1 = 7;  // Frequency for bit 1
+
+  for (let i = 0; i < bits.length; i++) {
+    const frequency = bits[i] === 1 ? freq1 : freq0;
+    for (let j = 0; j <= samplesPerBit; j++) {
+      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
+      const y = Math.sin(2 * Math.PI * frequency * t);
+      signal.push({ x: t, y });
+    }
+  }
+  return signal;
+}
+
+/**
+ * Generates MFSK (M-ary Frequency Shift Keying) signal.
+ * Uses 4 frequencies (M=4) for 2-bit symbols: 00, 01, 10, 11
+ */
+function generateMFSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  // 4-FSK: 4 different frequencies for 2 bits per symbol
+  const frequencies = [2, 4, 6, 8]; // f00, f01, f10, f11
+  const symbolDuration = bitDuration * 2; // Each symbol = 2 bits
+  const samplesPerSymbol = samplesPerBit * 2;
+
+  // Pad bits to even number
+  const paddedBits = bits.length % 2 === 0 ? bits : [...bits, 0];
+  const numSymbols = paddedBits.length / 2;
+
+  for (let i = 0; i < numSymbols; i++) {
+    const bit1 = paddedBits[i * 2];
+    const bit2 = paddedBits[i * 2 + 1];
+    const symbolValue = bit1 * 2 + bit2; // 00=0, 01=1, 10=2, 11=3
+    const freq = frequencies[symbolValue];
+
+    for (let j = 0; j <= samplesPerSymbol; j++) {
+      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
+      const y = Math.sin(2 * Math.PI * freq * t);
+      signal.push({ x: t, y });
+    }
+  }
+
+  return signal;
+}
+
+/**
+ * Generates BPSK (Binary Phase Shift Keying) signal.
+ * Bit 1 = 0° phase, Bit 0 = 180° phase.
+ */
+function generateBPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+
+  for (let i = 0; i < bits.length; i++) {
+    const phaseShift = bits[i] === 1 ? 0 : Math.PI;
+    for (let j = 0; j <= samplesPerBit; j++) {
+      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
+      const y = Math.sin(2 * Math.PI * carrierFreq * t + phaseShift);
+      signal.push({ x: t, y });
+    }
+  }
+  return signal;
+}
+
+/**
+ * Generates DPSK (Differential Phase Shift Keying) signal.
+ * Phase changes (0° or 180°) are relative to the previous bit.
+ * Bit 1 = no phase change, Bit 0 = 180° phase change.
+ */
+function generateDPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+  let currentPhase = 0; // Start with reference phase
+
+  for (let i = 0; i < bits.length; i++) {
+    // In DPSK, bit 0 causes phase change, bit 1 keeps same phase
+    if (bits[i] === 0) {
+      currentPhase += Math.PI;
+    }
+
+    for (let j = 0; j <= samplesPerBit; j++) {
+      const t = i * bitDuration + (j / samplesPerBit) * bitDuration;
+      const y = Math.sin(2 * Math.PI * carrierFreq * t + currentPhase);
+      signal.push({ x: t, y });
+    }
+  }
+  return signal;
+}
+
+/**
+ * Generates QPSK (Quadrature Phase Shift Keying) signal.
+ * Uses 4 phase states (45°, 135°, 225°, 315°) for 2-bit symbols.
+ */
+function generateQPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+  const symbolDuration = bitDuration * 2; // Each symbol = 2 bits
+  const samplesPerSymbol = samplesPerBit * 2;
+
+  // Phase mapping for QPSK: 00=45°, 01=135°, 10=315°, 11=225°
+  const phaseMap = [
+    Math.PI / 4,       // 00 → 45°
+    3 * Math.PI / 4,   // 01 → 135°
+    7 * Math.PI / 4,   // 10 → 315°
+    5 * Math.PI / 4    // 11 → 225°
+  ];
+
+  // Pad bits to even number
+  const paddedBits = bits.length % 2 === 0 ? bits : [...bits, 0];
+  const numSymbols = paddedBits.length / 2;
+
+  for (let i = 0; i < numSymbols; i++) {
+    const bit1 = paddedBits[i * 2];
+    const bit2 = paddedBits[i * 2 + 1];
+    const symbolValue = bit1 * 2 + bit2;
+    const phase = phaseMap[symbolValue];
+
+    for (let j = 0; j <= samplesPerSymbol; j++) {
+      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
+      const y = Math.sin(2 * Math.PI * carrierFreq * t + phase);
+      signal.push({ x: t, y });
+    }
+  }
+
+  return signal;
+}
+
+/**
+ * Generates OQPSK (Offset Quadrature Phase Shift Keying) signal.
+ * Similar to QPSK but with Q-channel delayed by half a symbol period.
+ * This limits phase transitions to 90° maximum.
+ */
+function generateOQPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+
+  // Pad bits to even number
+  const paddedBits = bits.length % 2 === 0 ? bits : [...bits, 0];
+  const numSymbols = paddedBits.length / 2;
+
+  // Extract I and Q bits
+  const iBits: number[] = [];
+  const qBits: number[] = [];
+  for (let i = 0; i < numSymbols; i++) {
+    iBits.push(paddedBits[i * 2]);     // Even bits → I channel
+    qBits.push(paddedBits[i * 2 + 1]); // Odd bits → Q channel
+  }
+
+  const symbolDuration = bitDuration * 2;
+  const samplesPerSymbol = samplesPerBit * 2;
+  const halfSymbolSamples = samplesPerBit; // Q offset by half symbol
+  const totalSamples = numSymbols * samplesPerSymbol + halfSymbolSamples;
+
+  // Generate OQPSK: I(t)*cos(wt) + Q(t-T/2)*sin(wt)
+  for (let sample = 0; sample < totalSamples; sample++) {
+    const t = (sample / samplesPerSymbol) * symbolDuration;
+
+    // Determine which symbol we're in for I channel
+    const iSymbolIdx = Math.floor(sample / samplesPerSymbol);
+    // Q channel is offset by half symbol
+    const qSymbolIdx = Math.floor((sample - halfSymbolSamples / 2) / samplesPerSymbol);
+
+    const iValue = iSymbolIdx >= 0 && iSymbolIdx < iBits.length
+      ? (iBits[iSymbolIdx] === 1 ? 1 : -1)
+      : 0;
+    const qValue = qSymbolIdx >= 0 && qSymbolIdx < qBits.length
+      ? (qBits[qSymbolIdx] === 1 ? 1 : -1)
+      : 0;
+
+    const y = iValue * Math.cos(2 * Math.PI * carrierFreq * t) + qValue * Math.sin(2 * Math.PI * carrierFreq * t);
+    signal.push({ x: t, y });
+  }
+
+  return signal;
+}
+
+/**
+ * Generates MPSK (M-ary Phase Shift Keying) signal.
+ * Uses 8 phase states (M=8) for 3-bit symbols.
+ */
+function generateMPSK(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+  const M = 8; // 8-PSK
+  const bitsPerSymbol = 3;
+  const symbolDuration = bitDuration * bitsPerSymbol;
+  const samplesPerSymbol = samplesPerBit * bitsPerSymbol;
+
+  // Pad bits to multiple of 3
+  const remainder = bits.length % bitsPerSymbol;
+  const paddedBits = remainder === 0 ? bits : [...bits, ...new Array(bitsPerSymbol - remainder).fill(0)];
+  const numSymbols = paddedBits.length / bitsPerSymbol;
+
+  for (let i = 0; i < numSymbols; i++) {
+    const bit1 = paddedBits[i * bitsPerSymbol];
+    const bit2 = paddedBits[i * bitsPerSymbol + 1];
+    const bit3 = paddedBits[i * bitsPerSymbol + 2];
+    const symbolValue = bit1 * 4 + bit2 * 2 + bit3; // 0 to 7
+    const phase = (symbolValue / M) * 2 * Math.PI; // Uniform phase distribution
+
+    for (let j = 0; j <= samplesPerSymbol; j++) {
+      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
+      const y = Math.sin(2 * Math.PI * carrierFreq * t + phase);
+      signal.push({ x: t, y });
+    }
+  }
+
+  return signal;
+}
+
+/**
+ * Generates QAM (Quadrature Amplitude Modulation) signal.
+ * Uses 16-QAM: 4 amplitude levels × 4 phase states for 4-bit symbols.
+ */
+function generateQAM(bits: number[], bitDuration: number, samplesPerBit: number): DataPoint[] {
+  const signal: DataPoint[] = [];
+  const carrierFreq = 5;
+  const bitsPerSymbol = 4; // 16-QAM
+  const symbolDuration = bitDuration * bitsPerSymbol;
+  const samplesPerSymbol = samplesPerBit * bitsPerSymbol;
+
+  // Pad bits to multiple of 4
+  const remainder = bits.length % bitsPerSymbol;
+  const paddedBits = remainder === 0 ? bits : [...bits, ...new Array(bitsPerSymbol - remainder).fill(0)];
+  const numSymbols = paddedBits.length / bitsPerSymbol;
+
+  // 16-QAM constellation: 4x4 grid
+  // I levels: -3, -1, +1, +3 (normalized)
+  // Q levels: -3, -1, +1, +3 (normalized)
+  const levels = [-3, -1, 1, 3];
+
+  for (let i = 0; i < numSymbols; i++) {
+    const bit1 = paddedBits[i * bitsPerSymbol];
+    const bit2 = paddedBits[i * bitsPerSymbol + 1];
+    const bit3 = paddedBits[i * bitsPerSymbol + 2];
+    const bit4 = paddedBits[i * bitsPerSymbol + 3];
+
+    // Gray coding for I (bits 1,2) and Q (bits 3,4) channels
+    const iIndex = bit1 * 2 + bit2;
+    const qIndex = bit3 * 2 + bit4;
+    const iAmplitude = levels[iIndex] / 3; // Normalize to ±1 range
+    const qAmplitude = levels[qIndex] / 3;
+
+    for (let j = 0; j <= samplesPerSymbol; j++) {
+      const t = i * symbolDuration + (j / samplesPerSymbol) * symbolDuration;
+      const y = iAmplitude * Math.cos(2 * Math.PI * carrierFreq * t) + qAmplitude * Math.sin(2 * Math.PI * carrierFreq * t);
+      signal.push({ x: t, y });
+    }
+  }
+
+  return signal;
+}
+
+// ---------------------------------------------------------------------------
+// Interleaving
+// ---------------------------------------------------------------------------
+
+/** Row-major transpose of a `rows` × `cols` matrix, element by element. */
+export function referenceTranspose(source: ArrayLike<number>, rows: number, cols: number): number[] {
+  const target = new Array<number>(rows * cols);
+  for (let r = 0; r < rows; r++) {
+    for (let c = 0; c < cols; c++) target[c * rows + r] = source[r * cols + c];
+  }
+  return target;
+}
+
+/**
+ * Block interleaving of a whole stream: each `rows` × `cols` block is written row by
+ * row and read column by column, skipping the empty cells of a short final block.
+ */
+export function referenceBlockInterleave(values: ArrayLike<number>, rows: number, cols: number): number[] {
+  const size = rows * cols;
+  const out: number[] = [];
+  for (let start = 0; start < values.length; start += size) {
+    const filled = Math.min(size, values.length - start);
+    for (let c = 0; c < cols; c++) {
+      for (let r = 0; r < rows; r++) {
+        const p = r * cols + c;
+        if (p < filled) out.push(values[start + p]);
+      }
+    }
+  }
+  return out;
+}
+
+/**
+ * Forney interleaving of a whole stream: item n travels on line n mod `branches` and
+ * reappears (n mod branches) · `unitDelay` · `branches` positions later. The stream is
+ * extended by the latency, and positions with nothing delayed into them carry 0.
+ */
+export function referenceConvolutionalInterleave(values: ArrayLike<number>, branches: number, unitDelay: number): number[] {
+  const latency = unitDelay * branches * (branches - 1);
+  const out: number[] = [];
+  for (let n = 0; n < values.length + latency; n++) {
+    const source = n - (n % branches) * unitDelay * branches;
+    out.push(source >= 0 && source < values.length ? values[source] : 0);
+  }
+  return out;
+}
+
+// ---------------------------------------------------------------------------
+// Transforms
+// ---------------------------------------------------------------------------
+
+/** Forward DFT by the definition, O(N²); returns the real parts followed by the imaginary parts. */
+export function referenceDft(re: ArrayLike<number>, im: ArrayLike<number>): number[] {
+  const n = re.length;
+  const outRe: number[] = [];
+  const outIm: number[] = [];
+  for (let k = 0; k < n; k++) {
+    let sumRe = 0;
+    let sumIm = 0;
+    for (let j = 0; j < n; j++) {
+      const angle = (-2 * Math.PI * ((j * k) % n)) / n;
+      sumRe += re[j] * Math.cos(angle) - im[j] * Math.sin(angle);
+      sumIm += re[j] * Math.sin(angle) + im[j] * Math.cos(angle);
+    }
+    outRe.push(sumRe);
+    outIm.push(sumIm);
+  }
+  return outRe.concat(outIm);
+}
+
+// ---------------------------------------------------------------------------
+// Block codes
+// ---------------------------------------------------------------------------
+
+// Published generator polynomials (bit i the coefficient of x^i), independent of the codec's derivation
+const GENERATORS: Record<BlockCode, { n: number; generator: number; extended: boolean }> = {
+  'Hamming(7,4)': { n: 7, generator: 0xb, extended: false },
+  'Hamming(15,11)': { n: 15, generator: 0x13, extended: false },
+  'SECDED(8,4)': { n: 7, generator: 0xb, extended: true },
+  'SECDED(16,11)': { n: 15, generator: 0x13, extended: true },
+  'BCH(15,7)': { n: 15, generator: 0x1d1, extended: false },
+  'BCH(31,21)': { n: 31, generator: 0x769, extended: false },
+  'BCH(63,45)': { n: 63, generator: 0x782cf, extended: false },
+};
+
+/**
+ * Systematic encoding by long division: each k-bit message (the last one padded with
+ * zeros) is followed by the remainder of m(x)·x^(n−k) mod g(x), highest degree first,
+ * and by an overall parity bit for SECDED codes.
+ */
+export function referenceBlockEncode(bits: ArrayLike<number>, code: BlockCode): number[] {
+  const { n, generator, extended } = GENERATORS[code];
+  const parityBits = 31 - Math.clz32(generator);
+  const k = n - parityBits;
+  const out: number[] = [];
+  for (let start = 0; start < bits.length; start += k) {
+    const dividend: number[] = [];
+    for (let i = 0; i < k; i++) dividend.push(start + i < bits.length ? bits[start + i] : 0);
+    for (let i = 0; i < parityBits; i++) dividend.push(0);
+    const remainder = dividend.slice();
+    for (let i = 0; i < k; i++) {
+      if (remainder[i] === 0) continue;
+      for (let d = 0; d <= parityBits; d++) remainder[i + d] ^= (generator >> (parityBits - d)) & 1;
+    }
+    const codeword = dividend.slice(0, k).concat(remainder.slice(k));
+    if (extended) codeword.push(codeword.reduce((sum, bit) => sum ^ bit, 0));
+    out.push(...codeword);
+  }
+  return out;
+}
@@ -0,0 +1,246 @@
+/**
+ * Responsiveness monitor for the parameter controls. Controls call `markInteraction`
+ * from their change handlers. While the monitor runs, three sources are attributed to
+ * the latest such interaction:
+ *
+ * - Event Timing entries (`PerformanceObserver` type 'event') give each interaction's
+ *   time to next paint. Browsers without Event Timing fall back to a rAF-then-timeout
+ *   probe after the handler.
+ * - 'longtask' entries report main-thread tasks over 50 ms.
+ * - A rAF loop reports gaps between frames as dropped frames.
+ *
+ * A long task or frame gap is charged to an interaction that happened up to
+ * `ATTRIBUTION_WINDOW_MS` before it began. Work nobody interacted with is ignored.
+ */
+export interface ControlResponsiveness {
+  control: string;
+  interactions: number;
+  /** Interaction to next paint, in milliseconds (75th percentile and worst) */
+  p75Ms: number;
+  worstMs: number;
+  longTasks: number;
+  longTaskMs: number;
+  droppedFrames: number;
+}
+
+export interface JankIncident {
+  kind: 'long task' | 'dropped frames';
+  control: string;
+  /** Control value that triggered it */
+  value: string;
+  durationMs: number;
+  /** Frames lost (dropped-frame incidents only) */
+  frames: number;
+}
+
+export interface ResponsivenessSnapshot {
+  controls: ControlResponsiveness[];
+  /** Most recent incidents, newest first */
+  incidents: JankIncident[];
+}
+
+const ATTRIBUTION_WINDOW_MS = 500;
+const FRAME_MS = 1000 / 60;
+// A gap of more than one and a half frame budgets has skipped at least one frame
+const DROPPED_FRAME_GAP_MS = 1.5 * FRAME_MS;
+// Event Timing reports only events slower than this; faster ones count as instant
+const EVENT_DURATION_THRESHOLD_MS = 16;
+const MAX_LATENCIES = 256;
+const MAX_INCIDENTS = 20;
+const MAX_AWAITING = 32;
+
+interface Interaction {
+  control: string;
+  value: string;
+  timeStamp: number;
+}
+
+interface ControlState {
+  interactions: number;
+  latencies: number[];
+  longTasks: number;
+  longTaskMs: number;
+  droppedFrames: number;
+}
+
+let running = false;
+let latest: Interaction | null = null;
+// Interactions still waiting for their Event Timing entry
+let awaiting: Interaction[] = [];
+const controls = new Map<string, ControlState>();
+let incidents: JankIncident[] = [];
+let observers: PerformanceObserver[] = [];
+let eventTiming = false;
+let frameHandle = 0;
+let lastFrame = 0;
+const listeners = new Set<() => void>();
+let notifyPending = false;
+
+function supports(type: string): boolean {
+  return typeof PerformanceObserver !== 'undefined' && (PerformanceObserver.supportedEntryTypes ?? []).includes(type);
+}
+
+function notify(): void {
+  if (notifyPending || listeners.size === 0) return;
+  notifyPending = true;
+  requestAnimationFrame(() => {
+    notifyPending = false;
+    listeners.forEach(listener => listener());
+  });
+}
+
+function stateOf(control: string): ControlState {
+  let state = controls.get(control);
+  if (!state) {
+    state = { interactions: 0, latencies: [], longTasks: 0, longTaskMs: 0, droppedFrames: 0 };
+    controls.set(control, state);
+  }
+  return state;
+}
+
+function addLatency(control: string, latencyMs: number): void {
+  const latencies = stateOf(control).latencies;
+  if (latencies.length === MAX_LATENCIES) latencies.shift();
+  latencies.push(latencyMs);
+  notify();
+}
+
+/** The interaction to charge for work that ran from `start` to `end`, if any. */
+function attribute(start: number, end: number): Interaction | null {
+  if (!latest || latest.timeStamp > end || latest.timeStamp < start - ATTRIBUTION_WINDOW_MS) return null;
+  return latest;
+}
+
+function addIncident(incident: JankIncident): void {
+  incidents.unshift(incident);
+  if (incidents.length > MAX_INCIDENTS) incidents.length = MAX_INCIDENTS;
+  notify();
+}
+
+function onEvents(list: PerformanceObserverEntryList): void {
+  for (const entry of list.getEntries()) {
+    // A change handler sees the same timestamp the browser gives the event entry
+    const index = awaiting.findIndex(interaction => Math.abs(interaction.timeStamp - entry.startTime) < 1);
+    if (index < 0) continue;
+    addLatency(awaiting[index].control, entry.duration);
+    awaiting.splice(index, 1);
+  }
+}
+
+function onLongTasks(list: PerformanceObserverEntryList): void {
+  for (const entry of list.getEntries()) {
+    const interaction = attribute(entry.startTime, entry.startTime + entry.duration);
+    if (!interaction) continue;
+    const state = stateOf(interaction.control);
+    state.longTasks++;
+    state.longTaskMs += entry.duration;
+    addIncident({ kind: 'long task', control: interaction.control, value: interaction.value, durationMs: entry.duration, frames: 0 });
+  }
+}
+
+function onFrame(now: number): void {
+  if (!running) return;
+  const gap = now - lastFrame;
+  // Hidden tabs pause rAF; those gaps are not jank
+  if (gap > DROPPED_FRAME_GAP_MS && document.visibilityState === 'visible') {
+    const interaction = attribute(lastFrame, now);
+    if (interaction) {
+      const frames = Math.round(gap / FRAME_MS) - 1;
+      stateOf(interaction.control).droppedFrames += frames;
+      addIncident({ kind: 'dropped frames', control: interaction.control, value: interaction.value, durationMs: gap, frames });
+    }
+  }
+  lastFrame = now;
+  frameHandle = requestAnimationFrame(onFrame);
+}
+
+/**
+ * Records a change to `control`. Pass the DOM event's `timeStamp` so the interaction
+ * can be matched with its Event Timing entry.
+ */
+export function markInteraction(control: string, value: unknown, timeStamp = performance.now()): void {
+  if (!running) return;
+  const interaction = { control, value: String(value), timeStamp };
+  latest = interaction;
+  stateOf(control).interactions++;
+  notify();
+  if (eventTiming) {
+    if (awaiting.length === MAX_AWAITING) awaiting.shift();
+    awaiting.push(interaction);
+  } else {
+    // Next paint: the frame after this task, then the task after that frame
+    requestAnimationFrame(() => setTimeout(() => addLatency(control, performance.now() - timeStamp), 0));
+  }
+}
+
+export function startResponsivenessMonitor(): void {
+  if (running) return;
+  running = true;
+  eventTiming = supports('event');
+  if (eventTiming) {
+    const observer = new PerformanceObserver(onEvents);
+    // durationThreshold is not in every DOM typing yet
+    observer.observe({ type: 'event', durationThreshold: EVENT_DURATION_THRESHOLD_MS } as PerformanceObserverInit);
+    observers.push(observer);
+  }
+  if (supports('longtask')) {
+    const observer = new PerformanceObserver(onLongTasks);
+    observer.observe({ type: 'longtask' });
+    observers.push(observer);
+  }
+  lastFrame = performance.now();
+  frameHandle = requestAnimationFrame(onFrame);
+}
+
+export function stopResponsivenessMonitor(): void {
+  running = false;
+  for (const observer of observers) observer.disconnect();
+  observers = [];
+  cancelAnimationFrame(frameHandle);
+  latest = null;
+  awaiting = [];
+}
+
+export function clearResponsiveness(): void {
+  controls.clear();
+  incidents = [];
+  notify();
+}
+
+/** Calls `listener` (at most once per frame) after new interactions or incidents. */
+export function subscribeResponsiveness(listener: () => void): () => void {
+  listeners.add(listener);
+  return () => {
+    listeners.delete(listener);
+  };
+}
+
+function percentile(sorted: number[], p: number): number {
+  if (sorted.length === 0) return 0;
+  return sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))];
+}
+
+/** Per-control statistics ordered by worst latency, plus the recent incidents. */
+export function responsivenessSnapshot(): ResponsivenessSnapshot {
+  const rows: ControlResponsiveness[] = [];
+  for (const [control, state] of controls) {
+    const measured = [...state.latencies];
+    // With Event Timing, interactions that produced no entry finished under the threshold
+    if (eventTiming) {
+      const fast = Math.min(state.interactions, MAX_LATENCIES) - measured.length;
+      for (let i = 0; i < fast; i++) measured.push(0);
+    }
+    measured.sort((a, b) => a - b);
+    rows.push({
+      control,
+      interactions: state.interactions,
+      p75Ms: percentile(measured, 0.75),
+      worstMs: measured.length > 0 ? measured[measured.length - 1] : 0,
+      longTasks: state.longTasks,
+      longTaskMs: state.longTaskMs,
+      droppedFrames: state.droppedFrames,
+    });
+  }
+  rows.sort((a, b) => b.worstMs - a.worstMs || a.control.localeCompare(b.control));
+  return { controls: rows, incidents: [...incidents] };
+}
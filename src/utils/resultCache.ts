@@ -0,0 +1,254 @@
+import { ResultCacheKind } from '../types';
+
+/**
+ * Persistent cache of expensive results (parameter sweeps, BER measurements, benchmark
+ * runs) in IndexedDB, so an analysis reopened after a reload shows without rerunning.
+ *
+ * An entry's key is a SHA-256 of its kind, its configuration and `__CODE_VERSION__` (a
+ * hash of the simulation sources taken at build time), so a code change never serves a
+ * stale result. Values are stored as structured clones, not JSON: typed arrays keep their
+ * binary form and non-finite numbers survive. Payloads and their bookkeeping (size, last
+ * use) live in separate object stores, so eviction only reads the small records; the
+ * least recently used entries go once the total passes the size bound.
+ *
+ * Every operation turns into a miss or a no-op where IndexedDB is unavailable or fails
+ * (private browsing, quota, a blocked upgrade): the cache never stops a computation.
+ */
+
+export interface CachedResult<T> {
+  value: T;
+  /** When the value was computed, in ms since the epoch */
+  storedAt: number;
+}
+
+export interface CacheUsage {
+  entries: number;
+  bytes: number;
+  maxBytes: number;
+}
+
+interface CacheEntry {
+  key: string;
+  kind: ResultCacheKind;
+  /** Canonical configuration, checked on every hit so a hash collision is a miss */
+  config: string;
+  bytes: number;
+  storedAt: number;
+  usedAt: number;
+}
+
+const databaseName = 'signal-sculptor-results';
+const databaseVersion = 1;
+const payloadStore = 'payloads';
+const entryStore = 'entries';
+const defaultMaxBytes = 64 * 1024 * 1024;
+
+/** Canonical JSON of a configuration: keys sorted, typed arrays as arrays, non-finite numbers kept. */
+export function canonicalJson(value: unknown): string {
+  if (ArrayBuffer.isView(value) && !(value instanceof DataView)) {
+    return canonicalJson(Array.from(value as unknown as ArrayLike<number>));
+  }
+  if (Array.isArray(value)) return `[${value.map(canonicalJson).join(',')}]`;
+  if (value !== null && typeof value === 'object') {
+    const record = value as Record<string, unknown>;
+    const fields = Object.keys(record)
+      .filter(key => record[key] !== undefined)
+      .sort()
+      .map(key => `${JSON.stringify(key)}:${canonicalJson(record[key])}`);
+    return `{${fields.join(',')}}`;
+  }
+  if (typeof value === 'number' && !isFinite(value)) return String(value);
+  return JSON.stringify(value) ?? 'null';
+}
+
+// 64-bit FNV-1a as two 32-bit halves, for pages without SubtleCrypto (insecure origins)
+function fnv1a64(text: string): string {
+  let low = 0x84222325;
+  let high = 0xcbf29ce4;
+  for (let i = 0; i < text.length; i++) {
+    low = (low ^ text.charCodeAt(i)) >>> 0;
+    // Multiply by the 64-bit FNV prime 2^40 + 0x1b3
+    const productLow = low * 0x1b3;
+    const carry = Math.floor(productLow / 0x100000000);
+    high = (Math.imul(high, 0x1b3) + Math.imul(low, 0x100) + carry) >>> 0;
+    low = productLow >>> 0;
+  }
+  return high.toString(16).padStart(8, '0') + low.toString(16).padStart(8, '0');
+}
+
+/** Content hash identifying a result of `kind` for `config` with this build's code. */
+export async function cacheKey(kind: ResultCacheKind, config: unknown): Promise<string> {
+  const text = `${kind}\n${__CODE_VERSION__}\n${canonicalJson(config)}`;
+  if (typeof crypto === 'undefined' || !crypto.subtle) return fnv1a64(text);
+  const digest = await crypto.subtle.digest('SHA-256', new TextEncoder().encode(text));
+  return Array.from(new Uint8Array(digest), byte => byte.toString(16).padStart(2, '0')).join('');
+}
+
+/** Approximate stored size of a value: exact for typed arrays, a rough figure for the rest. */
+export function storedBytes(value: unknown): number {
+  if (ArrayBuffer.isView(value) || value instanceof ArrayBuffer) return value.byteLength;
+  if (typeof value === 'string') return 2 * value.length;
+  if (Array.isArray(value)) return value.reduce((sum: number, item) => sum + storedBytes(item), 16);
+  if (value !== null && typeof value === 'object') {
+    let sum = 16;
+    for (const [key, field] of Object.entries(value)) sum += 2 * key.length + storedBytes(field);
+    return sum;
+  }
+  return 8;
+}
+
+function transactionDone(transaction: IDBTransaction): Promise<void> {
+  return new Promise((resolve, reject) => {
+    transaction.oncomplete = () => resolve();
+    transaction.onerror = () => reject(transaction.error);
+    transaction.onabort = () => reject(transaction.error ?? new Error('result cache transaction aborted'));
+  });
+}
+
+export class ResultCache {
+  readonly maxBytes: number;
+  private database: Promise<IDBDatabase | null> | null = null;
+
+  constructor(maxBytes = defaultMaxBytes) {
+    this.maxBytes = maxBytes;
+  }
+
+  /** The stored result of `kind` for `config`, or null; a hit counts as a use for eviction. */
+  async get<T>(kind: ResultCacheKind, config: unknown): Promise<CachedResult<T> | null> {
+    try {
+      const database = await this.open();
+      if (!database) return null;
+      const key = await cacheKey(kind, config);
+      const transaction = database.transaction([entryStore, payloadStore], 'readwrite');
+      const entries = transaction.objectStore(entryStore);
+      const entryRequest = entries.get(key);
+      const valueRequest = transaction.objectStore(payloadStore).get(key);
+      entryRequest.onsuccess = () => {
+        const entry = entryRequest.result as CacheEntry | undefined;
+        if (entry) entries.put({ ...entry, usedAt: Date.now() });
+      };
+      await transactionDone(transaction);
+
+      const entry = entryRequest.result as CacheEntry | undefined;
+      if (!entry || valueRequest.result === undefined || entry.config !== canonicalJson(config)) return null;
+      return { value: valueRequest.result as T, storedAt: entry.storedAt };
+    } catch {
+      return null;
+    }
+  }
+
+  /** Stores `value` as the result of `kind` for `config`, then evicts down to the size bound. */
+  async put<T>(kind: ResultCacheKind, config: unknown, value: T): Promise<void> {
+    try {
+      const bytes = storedBytes(value);
+      const database = await this.open();
+      if (!database || bytes > this.maxBytes) return;
+      const key = await cacheKey(kind, config);
+      const now = Date.now();
+      const entry: CacheEntry = { key, kind, config: canonicalJson(config), bytes, storedAt: now, usedAt: now };
+      const transaction = database.transaction([entryStore, payloadStore], 'readwrite');
+      transaction.objectStore(payloadStore).put(value, key);
+      transaction.objectStore(entryStore).put(entry);
+      await transactionDone(transaction);
+      await this.evict(database);
+    } catch {
+      // Not cached; the caller already has the value
+    }
+  }
+
+  /** Entries stored and their approximate total size. */
+  async usage(): Promise<CacheUsage> {
+    const usage = { entries: 0, bytes: 0, maxBytes: this.maxBytes };
+    try {
+      const database = await this.open();
+      if (!database) return usage;
+      const transaction = database.transaction(entryStore, 'readonly');
+      const request = transaction.objectStore(entryStore).getAll();
+      await transactionDone(transaction);
+      for (const entry of request.result as CacheEntry[]) {
+        usage.entries++;
+        usage.bytes += entry.bytes;
+      }
+    } catch {
+      // Report an empty cache
+    }
+    return usage;
+  }
+
+  async clear(): Promise<void> {
+    try {
+      const database = await this.open();
+      if (!database) return;
+      const transaction = database.transaction([entryStore, payloadStore], 'readwrite');
+      transaction.objectStore(entryStore).clear();
+      transaction.objectStore(payloadStore).clear();
+      await transactionDone(transaction);
+    } catch {
+      // Nothing to clear
+    }
+  }
+
+  // Deletes the least recently used entries until the total fits the bound
+  private evict(database: IDBDatabase): Promise<void> {
+    const transaction = database.transaction([entryStore, payloadStore], 'readwrite');
+    const entries = transaction.objectStore(entryStore);
+    const payloads = transaction.objectStore(payloadStore);
+    const request = entries.index('usedAt').getAll();
+    request.onsuccess = () => {
+      const oldestFirst = request.result as CacheEntry[];
+      let total = oldestFirst.reduce((sum, entry) => sum + entry.bytes, 0);
+      for (const entry of oldestFirst) {
+        if (total <= this.maxBytes) break;
+        entries.delete(entry.key);
+        payloads.delete(entry.key);
+        total -= entry.bytes;
+      }
+    };
+    return transactionDone(transaction);
+  }
+
+  private open(): Promise<IDBDatabase | null> {
+    if (!this.database) {
+      this.database = new Promise(resolve => {
+        if (typeof indexedDB === 'undefined') {
+          resolve(null);
+          return;
+        }
+        const request = indexedDB.open(databaseName, databaseVersion);
+        request.onupgradeneeded = () => {
+          const database = request.result;
+          database.createObjectStore(payloadStore);
+          database.createObjectStore(entryStore, { keyPath: 'key' }).createIndex('usedAt', 'usedAt');
+        };
+        request.onsuccess = () => {
+          const database = request.result;
+          // Let a newer version of the page upgrade the schema
+          database.onversionchange = () => database.close();
+          resolve(database);
+        };
+        request.onerror = () => resolve(null);
+        request.onblocked = () => resolve(null);
+      });
+    }
+    return this.database;
+  }
+}
+
+/** The page's result cache. */
+export const resultCache = new ResultCache();
+
+/**
+ * `compute`'s result for `config`, from the cache when an earlier run stored one;
+ * otherwise computed and stored. `storedAt` tells the two apart.
+ */
+export async function cachedResult<T>(
+  kind: ResultCacheKind,
+  config: unknown,
+  compute: () => T | Promise<T>
+): Promise<CachedResult<T> & { cached: boolean }> {
+  const hit = await resultCache.get<T>(kind, config);
+  if (hit) return { ...hit, cached: true };
+  const value = await compute();
+  void resultCache.put(kind, config, value);
+  return { value, storedAt: Date.now(), cached: false };
+}
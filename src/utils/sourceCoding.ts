@@ -0,0 +1,474 @@
+import { SourceCoding } from '../types';
+import { hotCounters } from './counters';
+import { InputPort, OutputPort, Stage } from './pipeline';
+
+/**
+ * Lossless source coding of byte payloads ahead of the line coders and modulators.
+ * Every coded payload starts with its 32-bit byte count so the decoder knows where the
+ * last symbol ends. Huffman payloads then carry their code-length table; LZ77 payloads
+ * are self-describing token streams.
+ */
+export interface CodedPayload {
+  bytes: Uint8Array;
+  bitLength: number;
+}
+
+// ---------------------------------------------------------------------------
+// Bit I/O
+// ---------------------------------------------------------------------------
+
+/** MSB-first bit packer over a growable byte buffer. */
+export class BitWriter {
+  private buffer = new Uint8Array(256);
+  private length = 0;
+  private accumulator = 0;
+  private pending = 0;
+
+  /** Appends the low `count` bits of `value`, most significant first (count ≤ 24). */
+  write(value: number, count: number): void {
+    this.accumulator = (this.accumulator << count) | (value & ((1 << count) - 1));
+    this.pending += count;
+    while (this.pending >= 8) {
+      this.pending -= 8;
+      this.push((this.accumulator >>> this.pending) & 0xff);
+    }
+    this.accumulator &= (1 << this.pending) - 1;
+  }
+
+  write32(value: number): void {
+    this.write(value >>> 16, 16);
+    this.write(value & 0xffff, 16);
+  }
+
+  finish(): CodedPayload {
+    const bitLength = this.length * 8 + this.pending;
+    if (this.pending > 0) this.push((this.accumulator << (8 - this.pending)) & 0xff);
+    return { bytes: this.buffer.slice(0, this.length), bitLength };
+  }
+
+  private push(byte: number): void {
+    if (this.length === this.buffer.length) {
+      if (__SIGNAL_COUNTERS__) hotCounters.bufferGrowths++;
+      const grown = new Uint8Array(this.buffer.length * 2);
+      grown.set(this.buffer);
+      this.buffer = grown;
+    }
+    this.buffer[this.length++] = byte;
+  }
+}
+
+/** MSB-first reader; bits past the end read as zeros. */
+export class BitReader {
+  private readonly bytes: Uint8Array;
+  position = 0;
+
+  constructor(bytes: Uint8Array) {
+    this.bytes = bytes;
+  }
+
+  /** Next `count` bits without consuming them (count ≤ 16). */
+  peek(count: number): number {
+    const index = this.position >> 3;
+    const bytes = this.bytes;
+    const window =
+      ((bytes[index] ?? 0) << 16) | ((bytes[index + 1] ?? 0) << 8) | (bytes[index + 2] ?? 0);
+    return (window >>> (24 - (this.position & 7) - count)) & ((1 << count) - 1);
+  }
+
+  read(count: number): number {
+    const value = this.peek(count);
+    this.position += count;
+    return value;
+  }
+
+  read32(): number {
+    return ((this.read(16) << 16) | this.read(16)) >>> 0;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Canonical Huffman
+// ---------------------------------------------------------------------------
+
+const MAX_CODE_LENGTH = 15;
+// Codes up to this length decode with a single table lookup
+const LOOKUP_BITS = 9;
+
+/** Huffman code lengths per byte value, rebuilt with flattened counts until none exceeds 15 bits. */
+function codeLengths(counts: Uint32Array): Uint8Array {
+  const lengths = new Uint8Array(256);
+  const weights = Float64Array.from(counts);
+  for (;;) {
+    const symbols: number[] = [];
+    for (let s = 0; s < 256; s++) if (weights[s] > 0) symbols.push(s);
+    if (symbols.length === 0) return lengths;
+    if (symbols.length === 1) {
+      lengths[symbols[0]] = 1;
+      return lengths;
+    }
+
+    // Two-queue construction: leaves sorted by weight, merged nodes arrive in order
+    symbols.sort((a, b) => weights[a] - weights[b] || a - b);
+    const nodeCount = 2 * symbols.length - 1;
+    const nodeWeight = new Float64Array(nodeCount);
+    const parent = new Int32Array(nodeCount);
+    symbols.forEach((symbol, index) => (nodeWeight[index] = weights[symbol]));
+    let leaf = 0;
+    let merged = symbols.length;
+    const take = (next: number) => {
+      if (leaf < symbols.length && (merged >= next || nodeWeight[leaf] <= nodeWeight[merged])) return leaf++;
+      return merged++;
+    };
+    for (let next = symbols.length; next < nodeCount; next++) {
+      const a = take(next);
+      const b = take(next);
+      nodeWeight[next] = nodeWeight[a] + nodeWeight[b];
+      parent[a] = next;
+      parent[b] = next;
+    }
+
+    // Depths from the root (the last node) down
+    const depth = new Uint8Array(nodeCount);
+    let longest = 0;
+    for (let node = nodeCount - 2; node >= 0; node--) {
+      depth[node] = depth[parent[node]] + 1;
+      if (node < symbols.length) longest = Math.max(longest, depth[node]);
+    }
+    if (longest <= MAX_CODE_LENGTH) {
+      symbols.forEach((symbol, index) => (lengths[symbol] = depth[index]));
+      return lengths;
+    }
+    for (const symbol of symbols) weights[symbol] = Math.floor(weights[symbol] / 2) + 1;
+  }
+}
+
+interface CanonicalCode {
+  codes: Uint16Array;
+  lengths: Uint8Array;
+  /** Symbols ordered by (length, value) */
+  sorted: Uint8Array;
+  /** Per length: codes of that length, first code value, index of its first symbol in `sorted` */
+  countOf: Uint16Array;
+  firstCode: Int32Array;
+  firstIndex: Int32Array;
+}
+
+function canonicalCode(lengths: Uint8Array): CanonicalCode {
+  const countOf = new Uint16Array(MAX_CODE_LENGTH + 1);
+  for (let s = 0; s < 256; s++) if (lengths[s] > 0) countOf[lengths[s]]++;
+
+  const firstCode = new Int32Array(MAX_CODE_LENGTH + 2);
+  const firstIndex = new Int32Array(MAX_CODE_LENGTH + 2);
+  let code = 0;
+  let index = 0;
+  for (let length = 1; length <= MAX_CODE_LENGTH; length++) {
+    code = (code + countOf[length - 1]) << 1;
+    firstCode[length] = code;
+    firstIndex[length] = index;
+    index += countOf[length];
+  }
+
+  const sorted = new Uint8Array(index);
+  const codes = new Uint16Array(256);
+  const nextIndex = firstIndex.slice();
+  for (let s = 0; s < 256; s++) {
+    const length = lengths[s];
+    if (length === 0) continue;
+    const position = nextIndex[length]++;
+    sorted[position] = s;
+    codes[s] = firstCode[length] + position - firstIndex[length];
+  }
+  return { codes, lengths, sorted, countOf, firstCode, firstIndex };
+}
+
+/**
+ * Header: 32-bit byte count, 8-bit (symbols used − 1), then per used symbol in value
+ * order its byte and 4-bit code length. Codes are canonical, so lengths suffice.
+ */
+export function huffmanEncode(data: Uint8Array): CodedPayload {
+  const writer = new BitWriter();
+  writer.write32(data.length);
+  if (data.length === 0) return writer.finish();
+
+  const counts = new Uint32Array(256);
+  for (let i = 0; i < data.length; i++) counts[data[i]]++;
+  const { codes, lengths } = canonicalCode(codeLengths(counts));
+
+  let used = 0;
+  for (let s = 0; s < 256; s++) if (lengths[s] > 0) used++;
+  writer.write(used - 1, 8);
+  for (let s = 0; s < 256; s++) {
+    if (lengths[s] === 0) continue;
+    writer.write(s, 8);
+    writer.write(lengths[s], 4);
+  }
+  for (let i = 0; i < data.length; i++) writer.write(codes[data[i]], lengths[data[i]]);
+  return writer.finish();
+}
+
+export function huffmanDecode(payload: Uint8Array): Uint8Array {
+  const reader = new BitReader(payload);
+  const output = new Uint8Array(reader.read32());
+  if (output.length === 0) return output;
+
+  const lengths = new Uint8Array(256);
+  const used = reader.read(8) + 1;
+  for (let k = 0; k < used; k++) {
+    const symbol = reader.read(8);
+    lengths[symbol] = reader.read(4);
+  }
+  const { codes, sorted, countOf, firstCode, firstIndex } = canonicalCode(lengths);
+
+  // Every LOOKUP_BITS-bit prefix of a short code maps to (symbol << 4) | length
+  const table = new Uint16Array(1 << LOOKUP_BITS);
+  for (let s = 0; s < 256; s++) {
+    const length = lengths[s];
+    if (length === 0 || length > LOOKUP_BITS) continue;
+    const start = codes[s] << (LOOKUP_BITS - length);
+    table.fill((s << 4) | length, start, start + (1 << (LOOKUP_BITS - length)));
+  }
+
+  for (let i = 0; i < output.length; i++) {
+    const entry = table[reader.peek(LOOKUP_BITS)];
+    if (entry !== 0) {
+      output[i] = entry >> 4;
+      reader.position += entry & 15;
+      continue;
+    }
+    // Longer codes: extend one bit at a time from the table's width
+    let length = LOOKUP_BITS;
+    let code = reader.read(LOOKUP_BITS);
+    for (;;) {
+      length++;
+      code = (code << 1) | reader.read(1);
+      const offset = code - firstCode[length];
+      if (offset < countOf[length]) {
+        output[i] = sorted[firstIndex[length] + offset];
+        break;
+      }
+      if (length === MAX_CODE_LENGTH) throw new Error('Invalid Huffman code');
+    }
+  }
+  return output;
+}
+
+// ---------------------------------------------------------------------------
+// LZ77
+// ---------------------------------------------------------------------------
+
+const WINDOW_BITS = 12;
+const WINDOW_SIZE = 1 << WINDOW_BITS;
+const LENGTH_BITS = 4;
+const MIN_MATCH = 3;
+const MAX_MATCH = MIN_MATCH + (1 << LENGTH_BITS) - 1;
+const HASH_BITS = 13;
+// Candidates examined per position before settling for the best so far
+const MAX_CHAIN = 64;
+
+function hash3(data: Uint8Array, i: number): number {
+  return (Math.imul((data[i] << 16) | (data[i + 1] << 8) | data[i + 2], 0x9e3779b1) >>> (32 - HASH_BITS));
+}
+
+/**
+ * Greedy LZ77 over a 4 KiB window. Tokens are a 0 flag plus a literal byte, or a 1 flag,
+ * 12-bit distance − 1 and 4-bit length − 3. Matches are found through hash chains:
+ * `head` holds the latest position of each 3-byte hash and `previous` links every
+ * position in the window to the one before it with the same hash.
+ */
+export function lz77Encode(data: Uint8Array): CodedPayload {
+  const writer = new BitWriter();
+  writer.write32(data.length);
+  const head = new Int32Array(1 << HASH_BITS).fill(-1);
+  const previous = new Int32Array(WINDOW_SIZE).fill(-1);
+  const insert = (position: number) => {
+    if (position + MIN_MATCH > data.length) return;
+    const h = hash3(data, position);
+    previous[position & (WINDOW_SIZE - 1)] = head[h];
+    head[h] = position;
+  };
+
+  let i = 0;
+  while (i < data.length) {
+    let bestLength = 0;
+    let bestDistance = 0;
+    if (i + MIN_MATCH <= data.length) {
+      const limit = Math.min(MAX_MATCH, data.length - i);
+      let candidate = head[hash3(data, i)];
+      for (let chain = 0; chain < MAX_CHAIN && candidate >= 0 && i - candidate <= WINDOW_SIZE; chain++) {
+        let length = 0;
+        while (length < limit && data[candidate + length] === data[i + length]) length++;
+        if (length > bestLength) {
+          bestLength = length;
+          bestDistance = i - candidate;
+          if (length === limit) break;
+        }
+        candidate = previous[candidate & (WINDOW_SIZE - 1)];
+      }
+    }
+
+    if (bestLength >= MIN_MATCH) {
+      writer.write(1, 1);
+      writer.write(bestDistance - 1, WINDOW_BITS);
+      writer.write(bestLength - MIN_MATCH, LENGTH_BITS);
+      for (let k = 0; k < bestLength; k++) insert(i + k);
+      i += bestLength;
+    } else {
+      writer.write(data[i], 9);
+      insert(i);
+      i++;
+    }
+  }
+  return writer.finish();
+}
+
+export function lz77Decode(payload: Uint8Array): Uint8Array {
+  const reader = new BitReader(payload);
+  const output = new Uint8Array(reader.read32());
+  let i = 0;
+  while (i < output.length) {
+    if (reader.read(1) === 0) {
+      output[i++] = reader.read(8);
+      continue;
+    }
+    const distance = reader.read(WINDOW_BITS) + 1;
+    const length = Math.min(reader.read(LENGTH_BITS) + MIN_MATCH, output.length - i);
+    if (distance > i) throw new Error('Invalid LZ77 distance');
+    // Byte by byte, so overlapping matches repeat the bytes they just wrote
+    for (let k = 0; k < length; k++, i++) output[i] = output[i - distance];
+  }
+  return output;
+}
+
+// ---------------------------------------------------------------------------
+// Payload API and stages
+// ---------------------------------------------------------------------------
+
+export function encodeSource(data: Uint8Array, coding: SourceCoding): CodedPayload {
+  switch (coding) {
+    case 'None':
+      return { bytes: data.slice(), bitLength: data.length * 8 };
+    case 'Huffman':
+      return huffmanEncode(data);
+    case 'LZ77':
+      return lz77Encode(data);
+  }
+}
+
+export function decodeSource(payload: Uint8Array, coding: SourceCoding): Uint8Array {
+  switch (coding) {
+    case 'None':
+      return payload.slice();
+    case 'Huffman':
+      return huffmanDecode(payload);
+    case 'LZ77':
+      return lz77Decode(payload);
+  }
+}
+
+export interface SourceCodingReport {
+  coding: SourceCoding;
+  originalBits: number;
+  codedBits: number;
+  /** Original over coded size */
+  ratio: number;
+  /** Channel time the coded payload saves at `bitDuration` seconds per bit */
+  timeSaved: number;
+  /** Decoding reproduced the payload */
+  lossless: boolean;
+}
+
+/** Codes `data` with every scheme and checks each round trip. */
+export function compareSourceCodings(data: Uint8Array, bitDuration = 1): SourceCodingReport[] {
+  const codings: SourceCoding[] = ['None', 'Huffman', 'LZ77'];
+  return codings.map(coding => {
+    const coded = encodeSource(data, coding);
+    const decoded = decodeSource(coded.bytes, coding);
+    const originalBits = data.length * 8;
+    return {
+      coding,
+      originalBits,
+      codedBits: coded.bitLength,
+      ratio: coded.bitLength > 0 ? originalBits / coded.bitLength : 1,
+      timeSaved: (originalBits - coded.bitLength) * bitDuration,
+      lossless: decoded.length === data.length && decoded.every((byte, k) => byte === data[k]),
+    };
+  });
+}
+
+/**
+ * Bytes (8-bit symbols) → coded bits. Huffman needs the statistics of the whole
+ * payload, so the stage collects its input and starts emitting once the input ends.
+ */
+export class SourceEncoder implements Stage {
+  readonly name: string;
+  readonly inputs = ['symbols'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly coding: SourceCoding;
+  private collected = new Uint8Array(256);
+  private length = 0;
+  private coded: CodedPayload | null = null;
+  private position = 0;
+
+  constructor(coding: SourceCoding) {
+    this.name = `${coding} source encoder`;
+    this.coding = coding;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    if (!this.coded) {
+      while (input.offset < input.length) {
+        if (this.length === this.collected.length) {
+          if (__SIGNAL_COUNTERS__) hotCounters.bufferGrowths++;
+          const grown = new Uint8Array(this.collected.length * 2);
+          grown.set(this.collected);
+          this.collected = grown;
+        }
+        this.collected[this.length++] = input.data[input.offset++];
+      }
+      if (!input.ended) return false;
+      this.coded = encodeSource(this.collected.subarray(0, this.length), this.coding);
+    }
+
+    const output = outputs[0];
+    const { bytes, bitLength } = this.coded;
+    while (output.length < output.capacity && this.position < bitLength) {
+      output.data[output.length++] = (bytes[this.position >> 3] >> (7 - (this.position & 7))) & 1;
+      this.position++;
+    }
+    return this.position >= bitLength;
+  }
+}
+
+/** Coded bits → bytes, decoding once the whole payload has arrived. */
+export class SourceDecoder implements Stage {
+  readonly name: string;
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['symbols'] as const;
+  private readonly coding: SourceCoding;
+  private writer: BitWriter | null = new BitWriter();
+  private decoded: Uint8Array | null = null;
+  private position = 0;
+
+  constructor(coding: SourceCoding) {
+    this.name = `${coding} source decoder`;
+    this.coding = coding;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    if (this.writer) {
+      while (input.offset < input.length) this.writer.write(input.data[input.offset++], 1);
+      if (!input.ended) return false;
+      this.decoded = decodeSource(this.writer.finish().bytes, this.coding);
+      this.writer = null;
+    }
+
+    const output = outputs[0];
+    const decoded = this.decoded!;
+    while (output.length < output.capacity && this.position < decoded.length) {
+      output.data[output.length++] = decoded[this.position++];
+    }
+    return this.position >= decoded.length;
+  }
+}
@@ -0,0 +1,1012 @@
+import { DataPoint, PortType, ReconstructionMethod, SamplePrecision } from '../types';
+import { InputPort, OutputPort, Stage } from './pipeline';
+import { Arena, FloatArray, allocateFloat } from './bufferPool';
+import { FirFilter, Reconstructor, designFromResponse, designLowpass, lowpassLength, tapsInPrecision } from './filters';
+import { fft } from './fft';
+import { Random } from './random';
+import { hotCounters } from './counters';
+
+// ---------------------------------------------------------------------------
+// Sources
+// ---------------------------------------------------------------------------
+
+/**
+ * Parses a string of 0s and 1s into a bit array drawn from `arena`.
+ * Callers validate the input first; any character other than '1' reads as 0.
+ */
+export function parseBits(binaryInput: string, arena: Arena): Uint8Array {
+  const bits = arena.uint8(binaryInput.length);
+  for (let i = 0; i < binaryInput.length; i++) {
+    bits[i] = binaryInput.charCodeAt(i) === 49 ? 1 : 0;
+  }
+  return bits;
+}
+
+/** Emits a fixed bit sequence. */
+export class BitSource implements Stage {
+  readonly name = 'bit source';
+  readonly inputs = [] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly bits: ArrayLike<number>;
+  private position = 0;
+
+  constructor(bits: ArrayLike<number>) {
+    this.bits = bits;
+  }
+
+  process(_inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const output = outputs[0];
+    const data = output.data;
+    while (output.length < output.capacity && this.position < this.bits.length) {
+      data[output.length++] = this.bits[this.position++];
+    }
+    return this.position >= this.bits.length;
+  }
+}
+
+/** Emits a fixed sequence of real samples. */
+export class ArraySource implements Stage {
+  readonly name = 'array source';
+  readonly inputs = [] as const;
+  readonly outputs = ['real'] as const;
+  private readonly values: ArrayLike<number>;
+  private position = 0;
+
+  constructor(values: ArrayLike<number>) {
+    this.values = values;
+  }
+
+  process(_inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const output = outputs[0];
+    const data = output.data;
+    while (output.length < output.capacity && this.position < this.values.length) {
+      data[output.length++] = this.values[this.position++];
+    }
+    return this.position >= this.values.length;
+  }
+}
+
+/** Sine message `amplitude * sin(2π f t)` sampled at `sampleRate` for `count` samples. */
+export class ToneSource implements Stage {
+  readonly name = 'tone';
+  readonly inputs = [] as const;
+  readonly outputs = ['real'] as const;
+  private readonly frequency: number;
+  private readonly amplitude: number;
+  private readonly sampleRate: number;
+  private readonly count: number;
+  private position = 0;
+
+  constructor(frequency: number, amplitude: number, sampleRate: number, count: number) {
+    this.frequency = frequency;
+    this.amplitude = amplitude;
+    this.sampleRate = sampleRate;
+    this.count = count;
+  }
+
+  process(_inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const output = outputs[0];
+    const data = output.data;
+    const first = output.length;
+    while (output.length < output.capacity && this.position < this.count) {
+      const t = this.position / this.sampleRate;
+      data[output.length++] = this.amplitude * Math.sin(2 * Math.PI * this.frequency * t);
+      this.position++;
+    }
+    if (__SIGNAL_COUNTERS__) {
+      hotCounters.samplesEmitted += output.length - first;
+      hotCounters.transcendentals += output.length - first;
+    }
+    return this.position >= this.count;
+  }
+}
+
+/** `count` uniform random symbols of `bitsPerSymbol` bits from a seeded generator. */
+export class RandomSymbolSource implements Stage {
+  readonly name = 'random symbols';
+  readonly inputs = [] as const;
+  readonly outputs = ['symbols'] as const;
+  private readonly random: Random;
+  private readonly shift: number;
+  private readonly count: number;
+  private position = 0;
+
+  constructor(count: number, bitsPerSymbol: number, seed?: number) {
+    this.random = new Random(seed);
+    this.shift = 32 - bitsPerSymbol;
+    this.count = count;
+  }
+
+  process(_inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const output = outputs[0];
+    while (output.length < output.capacity && this.position < this.count) {
+      output.data[output.length++] = this.random.nextUint32() >>> this.shift;
+      this.position++;
+    }
+    return this.position >= this.count;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Bit and symbol framing
+// ---------------------------------------------------------------------------
+
+/** Groups `bitsPerSymbol` bits (MSB first) into one symbol; a short final group is zero-padded. */
+export class SymbolMapper implements Stage {
+  readonly name = 'symbol mapper';
+  readonly inputs = ['bits'] as const;
+  readonly outputs = ['symbols'] as const;
+  private readonly bitsPerSymbol: number;
+  private symbol = 0;
+  private collected = 0;
+
+  constructor(bitsPerSymbol: number) {
+    this.bitsPerSymbol = bitsPerSymbol;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const bits = input.data;
+    const symbols = output.data;
+
+    while (output.length < output.capacity) {
+      if (input.offset < input.length) {
+        this.symbol = this.symbol * 2 + bits[input.offset++];
+        this.collected++;
+        if (this.collected === this.bitsPerSymbol) {
+          symbols[output.length++] = this.symbol;
+          this.symbol = 0;
+          this.collected = 0;
+        }
+      } else if (input.ended) {
+        if (this.collected > 0) {
+          symbols[output.length++] = this.symbol << (this.bitsPerSymbol - this.collected);
+          this.collected = 0;
+        }
+        return true;
+      } else {
+        return false;
+      }
+    }
+    return false;
+  }
+}
+
+/** Splits each symbol back into `bitsPerSymbol` bits, MSB first. */
+export class SymbolSerializer implements Stage {
+  readonly name = 'symbol serializer';
+  readonly inputs = ['symbols'] as const;
+  readonly outputs = ['bits'] as const;
+  private readonly bitsPerSymbol: number;
+  private symbol = 0;
+  private remaining = 0;
+
+  constructor(bitsPerSymbol: number) {
+    this.bitsPerSymbol = bitsPerSymbol;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const bits = output.data;
+
+    for (;;) {
+      while (this.remaining > 0 && output.length < output.capacity) {
+        this.remaining--;
+        bits[output.length++] = (this.symbol >> this.remaining) & 1;
+      }
+      if (this.remaining > 0) return false;
+      if (input.offset < input.length) {
+        this.symbol = input.data[input.offset++];
+        this.remaining = this.bitsPerSymbol;
+      } else {
+        return input.ended;
+      }
+    }
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Channels
+// ---------------------------------------------------------------------------
+
+/** Additive white Gaussian noise with standard deviation `sigma`. */
+export class AwgnChannel implements Stage {
+  readonly name = 'AWGN channel';
+  readonly inputs: readonly PortType[];
+  readonly outputs: readonly PortType[];
+  private readonly sigma: number;
+  private readonly random: Random;
+
+  /** On a complex stream `sigma` applies to each of I and Q. */
+  constructor(sigma: number, seed?: number, type: 'real' | 'complex' = 'real') {
+    this.sigma = sigma;
+    this.random = new Random(seed);
+    this.inputs = [type];
+    this.outputs = [type];
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    const x = input.data;
+    const y = output.data;
+    for (let i = 0; i < count; i++) {
+      y[output.length + i] = x[input.offset + i] + this.sigma * this.random.gaussian();
+    }
+    if (input.imag && output.imag) {
+      for (let i = 0; i < count; i++) {
+        output.imag[output.length + i] = input.imag[input.offset + i] + this.sigma * this.random.gaussian();
+      }
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Sampling and reconstruction
+// ---------------------------------------------------------------------------
+
+/**
+ * Samples a uniformly spaced signal at `outputRate` using linear interpolation.
+ * Sample instants are rounded to the microsecond and run up to the last input sample,
+ * which is held for instants past it.
+ */
+export class Resampler implements Stage {
+  readonly name = 'sampler';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly inputRate: number;
+  private readonly interval: number;
+  private index = 0;
+  private received = 0;
+  // The two most recent input samples (indices received - 2 and received - 1)
+  private previous = 0;
+  private latest = 0;
+
+  constructor(inputRate: number, outputRate: number) {
+    this.inputRate = inputRate;
+    this.interval = 1 / outputRate;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const samples = output.data;
+
+    while (output.length < output.capacity) {
+      const time = Math.round(this.index * this.interval * 1000000) / 1000000;
+      const latestTime = (this.received - 1) / this.inputRate;
+
+      if (this.received === 0 || latestTime < time) {
+        // Read ahead until the input segment (previous, latest] contains the sample instant
+        if (input.offset < input.length) {
+          this.previous = this.latest;
+          this.latest = input.data[input.offset++];
+          this.received++;
+          continue;
+        }
+        if (!input.ended) return false;
+        if (this.received === 0 || this.index * this.interval > latestTime) return true;
+        samples[output.length++] = this.latest;
+      } else if (this.received === 1) {
+        samples[output.length++] = this.latest;
+      } else {
+        const previousTime = (this.received - 2) / this.inputRate;
+        const ratio = (time - previousTime) / (latestTime - previousTime);
+        samples[output.length++] = this.previous + ratio * (this.latest - this.previous);
+      }
+      this.index++;
+    }
+    return false;
+  }
+}
+
+/**
+ * Zero-phase anti-alias low-pass (cutoff normalised to the input rate).
+ * The stream is extended at both ends by point reflection and the FIR group delay
+ * is removed, so output sample n lines up with input sample n.
+ */
+export class AntiAliasFilterStage implements Stage {
+  readonly name = 'anti-alias filter';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly taps: Float64Array;
+  private readonly delay: number;
+  // Scratch below is drawn from the run's arena in setup()
+  private filter!: FirFilter;
+  private history!: FloatArray;
+  private head!: FloatArray;
+  private headLength = 0;
+  // Reflected edges and the buffered head waiting to be filtered
+  private backlog!: FloatArray;
+  private backlogLength = 0;
+  private backlogPosition = 0;
+  private scratch!: FloatArray;
+  private received = 0;
+  private skip: number;
+  private primed = false;
+  private flushed = false;
+
+  constructor(cutoff: number) {
+    this.taps = designLowpass(cutoff, lowpassLength(cutoff / 2));
+    this.delay = (this.taps.length - 1) / 2;
+    this.skip = 2 * this.delay;
+  }
+
+  setup(arena: Arena, precision: SamplePrecision): void {
+    const taps = tapsInPrecision(this.taps, precision);
+    this.filter = new FirFilter(taps, arena.float(precision, taps.length * 2));
+    this.history = arena.float(precision, this.delay + 1);
+    this.head = arena.float(precision, this.delay + 1);
+    this.backlog = arena.float(precision, 2 * this.delay + 1);
+    this.scratch = arena.float(precision, 1);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    for (;;) {
+      while (this.backlogPosition < this.backlogLength) {
+        if (output.length >= output.capacity) return false;
+        this.feed(this.backlog[this.backlogPosition++], output);
+      }
+      this.backlogLength = 0;
+      this.backlogPosition = 0;
+      if (this.flushed) return true;
+
+      if (input.offset < input.length) {
+        if (this.primed && output.length >= output.capacity) return false;
+        const x = input.data[input.offset++];
+        this.history[this.received % this.history.length] = x;
+        this.received++;
+        if (this.primed) {
+          this.feed(x, output);
+        } else {
+          this.head[this.headLength++] = x;
+          if (this.headLength === this.delay + 1) this.prime();
+        }
+      } else if (input.ended) {
+        if (this.received === 0) return true;
+        if (!this.primed) this.prime();
+        this.extendTail();
+        this.flushed = true;
+      } else {
+        return false;
+      }
+    }
+  }
+
+  private feed(x: number, output: OutputPort): void {
+    this.scratch[0] = x;
+    this.filter.process(this.scratch, this.scratch, 1);
+    if (this.skip > 0) {
+      this.skip--;
+    } else {
+      output.data[output.length++] = this.scratch[0];
+    }
+  }
+
+  private prime(): void {
+    const head = this.head;
+    const count = this.headLength;
+    for (let n = 0; n < this.delay; n++) {
+      this.backlog[this.backlogLength++] = 2 * head[0] - head[Math.min(count - 1, this.delay - n)];
+    }
+    for (let n = 0; n < count; n++) {
+      this.backlog[this.backlogLength++] = head[n];
+    }
+    this.headLength = 0;
+    this.primed = true;
+  }
+
+  private extendTail(): void {
+    const length = this.received;
+    const history = this.history;
+    const last = history[(length - 1) % history.length];
+    for (let n = 0; n < this.delay; n++) {
+      this.backlog[this.backlogLength++] = 2 * last - history[Math.max(0, length - 2 - n) % history.length];
+    }
+  }
+}
+
+/** Reconstructs samples taken at `sampleRate` on the display grid up to `endTime`. */
+export class ReconstructionStage implements Stage {
+  readonly name = 'reconstruction';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly method: ReconstructionMethod;
+  private readonly sampleRate: number;
+  private readonly displayRate: number;
+  private readonly endTime: number;
+  private reconstructor!: Reconstructor;
+
+  constructor(method: ReconstructionMethod, sampleRate: number, displayRate: number, endTime: number) {
+    this.method = method;
+    this.sampleRate = sampleRate;
+    this.displayRate = displayRate;
+    this.endTime = endTime;
+  }
+
+  setup(arena: Arena, precision: SamplePrecision): void {
+    const ring = arena.float(precision, Reconstructor.ringLength(this.method, this.sampleRate, this.displayRate));
+    this.reconstructor = new Reconstructor(this.method, this.sampleRate, this.displayRate, undefined, ring);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    for (;;) {
+      while (output.length < output.capacity) {
+        const value = this.reconstructor.next(this.endTime);
+        if (value === null) break;
+        output.data[output.length++] = value;
+      }
+      if (output.length >= output.capacity) return false;
+
+      if (input.offset < input.length) {
+        this.reconstructor.push(input.data[input.offset++]);
+      } else if (input.ended) {
+        this.reconstructor.end();
+        const value = this.reconstructor.next(this.endTime);
+        if (value === null) return true;
+        output.data[output.length++] = value;
+      } else {
+        return false;
+      }
+    }
+  }
+}
+
+/** Causal FIR filter stage (group delay not removed). */
+export class FirStage implements Stage {
+  readonly name = 'FIR filter';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly taps: Float64Array;
+  private filter!: FirFilter;
+
+  constructor(taps: Float64Array) {
+    this.taps = taps;
+  }
+
+  setup(arena: Arena, precision: SamplePrecision): void {
+    const taps = tapsInPrecision(this.taps, precision);
+    this.filter = new FirFilter(taps, arena.float(precision, taps.length * 2));
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let i = 0; i < count; i++) {
+      output.data[output.length + i] = this.filter.step(input.data[input.offset + i]);
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+/** Gain applied per FFT bin; `frequency` is normalised to the sample rate (0 to 0.5). */
+export type SpectralResponse = (frequency: number) => number;
+
+/**
+ * FFT filter for input the caller knows repeats every `period` samples, such as the
+ * carrier presets' whole-period message tones. The first `period` samples (the whole
+ * record, if it is shorter) are transformed as one circular frame, weighted by
+ * `response` and transformed back, which is exact because the input repeats with that
+ * period; later frames are filtered the same way. A short final frame is transformed
+ * together with the end of the frame before it, so it sees a full period too. Input
+ * that does not repeat is wrapped around its frame, so it takes `OverlapSaveFilterStage`.
+ *
+ * With `quadrature` set the output is the complex analytic signal: I is the input
+ * unchanged and Q is its Hilbert transform (−j·sgn f per bin) weighted by `response`.
+ */
+export class PeriodicSpectralFilterStage implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs: readonly PortType[];
+  private readonly frameLength: number;
+  private readonly response: SpectralResponse;
+  private readonly quadrature: boolean;
+  // Scratch below is drawn from the run's arena in setup()
+  private frame!: Float64Array;
+  private re!: Float64Array;
+  private im!: Float64Array;
+  private filled = 0;
+  private emitted = 0;
+  private ready = 0;
+  // Offset of the newest samples inside a rotated (short final) frame
+  private shift = 0;
+  private frames = 0;
+
+  constructor(period: number, response: SpectralResponse, quadrature = false) {
+    if (period < 1) throw new Error('Spectral filter period must hold at least one sample');
+    this.name = quadrature ? 'Hilbert transformer' : 'spectral filter';
+    this.outputs = [quadrature ? 'complex' : 'real'];
+    this.frameLength = period;
+    this.response = response;
+    this.quadrature = quadrature;
+  }
+
+  setup(arena: Arena): void {
+    this.frame = arena.float64(this.frameLength);
+    this.re = arena.float64(this.frameLength);
+    this.im = arena.float64(this.frameLength);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    for (;;) {
+      while (this.emitted < this.ready) {
+        if (output.length >= output.capacity) return false;
+        const k = this.emitted++;
+        if (this.quadrature) {
+          output.data[output.length] = this.frame[k];
+          output.imag![output.length] = this.re[this.shift + k];
+        } else {
+          output.data[output.length] = this.re[this.shift + k];
+        }
+        output.length++;
+      }
+      if (this.ready > 0) {
+        this.ready = 0;
+        this.emitted = 0;
+        this.filled = 0;
+      }
+
+      while (this.filled < this.frameLength && input.offset < input.length) {
+        this.frame[this.filled++] = input.data[input.offset++];
+      }
+      if (this.filled === this.frameLength || (input.ended && this.filled > 0)) {
+        this.transform();
+      } else {
+        return input.ended;
+      }
+    }
+  }
+
+  private transform(): void {
+    const count = this.filled;
+    // A short final frame is rotated in behind the previous frame's tail
+    const length = count < this.frameLength && this.frames > 0 ? this.frameLength : count;
+    this.shift = length - count;
+    for (let k = 0; k < length; k++) {
+      this.re[k] = this.frame[(k + count) % length];
+      this.im[k] = 0;
+    }
+
+    fft(this.re, this.im, length);
+    for (let k = 0; k < length; k++) {
+      const folded = Math.min(k, length - k) / length;
+      const gain = this.response(folded);
+      if (this.quadrature) {
+        // −j·sgn(f); DC and Nyquist have no quadrature part
+        const sign = k === 0 || 2 * k === length ? 0 : k < length / 2 ? 1 : -1;
+        const r = this.re[k];
+        this.re[k] = sign * gain * this.im[k];
+        this.im[k] = -sign * gain * r;
+      } else {
+        this.re[k] *= gain;
+        this.im[k] *= gain;
+      }
+    }
+    fft(this.re, this.im, length, true);
+    for (let k = 0; k < length; k++) this.re[k] /= length;
+
+    this.ready = count;
+    this.frames++;
+  }
+}
+
+/**
+ * Streaming FFT filter for any input: the linear-phase FIR `designFromResponse` makes
+ * from `response`, applied by overlap-save one frame of new samples at a time. The
+ * filter's group delay is taken back out, so output n lines up with input n and the
+ * stream keeps its length; the ends of the record see the zeros around it. Input known
+ * to repeat is filtered exactly by `PeriodicSpectralFilterStage` instead.
+ *
+ * With `quadrature` set the output is the complex analytic signal: I is the input
+ * unchanged and Q is its FIR Hilbert transform weighted by `response`.
+ */
+export class OverlapSaveFilterStage implements Stage {
+  readonly name: string;
+  readonly inputs = ['real'] as const;
+  readonly outputs: readonly PortType[];
+  private readonly taps: Float64Array;
+  private readonly delay: number;
+  private readonly history: number;
+  private readonly frameLength: number;
+  private readonly step: number;
+  private readonly quadrature: boolean;
+  // Scratch below is drawn from the run's arena in setup()
+  private spectrumRe!: Float64Array;
+  private spectrumIm!: Float64Array;
+  private frame!: Float64Array;
+  private re!: Float64Array;
+  private im!: Float64Array;
+  // New samples in the frame, behind `history` samples carried over from the last one
+  private filled = 0;
+  private emitted = 0;
+  private ready = 0;
+  // Filter outputs still to drop before output 0 lines up with input 0
+  private skip: number;
+  // Zeros still to feed after the input ends, pushing the delayed tail out
+  private flush: number;
+
+  constructor(response: SpectralResponse, numTaps: number, quadrature = false) {
+    this.name = quadrature ? 'Hilbert transformer' : 'spectral filter';
+    this.outputs = [quadrature ? 'complex' : 'real'];
+    this.taps = designFromResponse(response, numTaps, quadrature);
+    this.delay = (numTaps - 1) / 2;
+    this.history = numTaps - 1;
+    // At least three quarters of each frame is new samples
+    this.frameLength = 2 ** Math.ceil(Math.log2(4 * numTaps));
+    this.step = this.frameLength - this.history;
+    this.quadrature = quadrature;
+    this.skip = this.delay;
+    this.flush = this.delay;
+  }
+
+  setup(arena: Arena): void {
+    const n = this.frameLength;
+    this.spectrumRe = arena.float64(n);
+    this.spectrumIm = arena.float64(n);
+    this.frame = arena.float64(n);
+    this.re = arena.float64(n);
+    this.im = arena.float64(n);
+    this.spectrumRe.set(this.taps);
+    fft(this.spectrumRe, this.spectrumIm, n);
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+
+    for (;;) {
+      while (this.emitted < this.ready) {
+        if (output.length >= output.capacity) return false;
+        const p = this.history + this.emitted++;
+        if (this.quadrature) {
+          output.data[output.length] = this.frame[p - this.delay];
+          output.imag![output.length] = this.re[p];
+        } else {
+          output.data[output.length] = this.re[p];
+        }
+        output.length++;
+      }
+      if (this.ready > 0) {
+        // The newest samples become the next frame's history
+        this.frame.copyWithin(0, this.ready, this.ready + this.history);
+        this.frame.fill(0, this.history);
+        this.ready = 0;
+        this.emitted = 0;
+        this.filled = 0;
+      }
+
+      const start = this.history;
+      while (this.filled < this.step && input.offset < input.length) {
+        this.frame[start + this.filled++] = input.data[input.offset++];
+      }
+      if (input.ended) {
+        while (this.filled < this.step && this.flush > 0) {
+          this.frame[start + this.filled++] = 0;
+          this.flush--;
+        }
+      }
+      if (this.filled === this.step || (input.ended && this.filled > 0)) {
+        this.transform();
+      } else {
+        return input.ended;
+      }
+    }
+  }
+
+  private transform(): void {
+    const n = this.frameLength;
+    this.re.set(this.frame);
+    this.im.fill(0);
+    fft(this.re, this.im, n);
+    for (let k = 0; k < n; k++) {
+      const r = this.re[k];
+      this.re[k] = r * this.spectrumRe[k] - this.im[k] * this.spectrumIm[k];
+      this.im[k] = r * this.spectrumIm[k] + this.im[k] * this.spectrumRe[k];
+    }
+    fft(this.re, this.im, n, true);
+    // Only the positions after the history are free of circular wrap-around
+    for (let k = this.history; k < this.history + this.filled; k++) this.re[k] /= n;
+
+    const dropped = Math.min(this.skip, this.filled);
+    this.skip -= dropped;
+    this.emitted = dropped;
+    this.ready = this.filled;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Carrier mixing
+// ---------------------------------------------------------------------------
+
+/**
+ * Mixes a complex envelope up to a real carrier at the same sample rate:
+ * s = I·cos(2π fc t) − Q·sin(2π fc t).
+ */
+export class Upconverter implements Stage {
+  readonly name = 'upconverter';
+  readonly inputs = ['complex'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly carrierFrequency: number;
+  private readonly sampleRate: number;
+  private sampleIndex = 0;
+
+  constructor(carrierFrequency: number, sampleRate: number) {
+    this.carrierFrequency = carrierFrequency;
+    this.sampleRate = sampleRate;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let k = 0; k < count; k++) {
+      const phase = (2 * Math.PI * this.carrierFrequency * this.sampleIndex++) / this.sampleRate;
+      const i = input.data[input.offset + k];
+      const q = input.imag![input.offset + k];
+      output.data[output.length + k] = i * Math.cos(phase) - q * Math.sin(phase);
+    }
+    if (__SIGNAL_COUNTERS__) {
+      hotCounters.samplesEmitted += count;
+      hotCounters.transcendentals += 2 * count;
+    }
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+/**
+ * Product detector for a sine carrier: multiplies by 2·sin(2π fc t), leaving the
+ * component in phase with the carrier at baseband plus images around 2fc that a
+ * following lowpass removes.
+ */
+export class CoherentDetector implements Stage {
+  readonly name = 'coherent detector';
+  readonly inputs = ['real'] as const;
+  readonly outputs = ['real'] as const;
+  private readonly carrierFrequency: number;
+  private readonly sampleRate: number;
+  private sampleIndex = 0;
+
+  constructor(carrierFrequency: number, sampleRate: number) {
+    this.carrierFrequency = carrierFrequency;
+    this.sampleRate = sampleRate;
+  }
+
+  process(inputs: InputPort[], outputs: OutputPort[]): boolean {
+    const input = inputs[0];
+    const output = outputs[0];
+    const count = Math.min(input.length - input.offset, output.capacity - output.length);
+    for (let k = 0; k < count; k++) {
+      const phase = (2 * Math.PI * this.carrierFrequency * this.sampleIndex++) / this.sampleRate;
+      output.data[output.length + k] = 2 * input.data[input.offset + k] * Math.sin(phase);
+    }
+    if (__SIGNAL_COUNTERS__) hotCounters.transcendentals += count;
+    input.offset += count;
+    output.length += count;
+    return input.ended;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Measurement
+// ---------------------------------------------------------------------------
+
+/**
+ * Compares a reference stream (port 0) with a received one (port 1), item by item.
+ * On symbol streams `bits` and `errors` count symbols.
+ */
+export class BitErrorCounter implements Stage {
+  readonly name = 'bit error counter';
+  readonly inputs: readonly PortType[];
+  readonly outputs = [] as const;
+  bits = 0;
+  errors = 0;
+
+  constructor(type: 'bits' | 'symbols' = 'bits') {
+    this.inputs = [type, type];
+  }
+
+  get errorRate(): number {
+    return this.bits > 0 ? this.errors / this.bits : 0;
+  }
+
+  process(inputs: InputPort[]): boolean {
+    const [reference, received] = inputs;
+    const count = Math.min(reference.length - reference.offset, received.length - received.offset);
+    for (let i = 0; i < count; i++) {
+      if (reference.data[reference.offset + i] !== received.data[received.offset + i]) this.errors++;
+    }
+    this.bits += count;
+    reference.offset += count;
+    received.offset += count;
+
+    // A stream that ends early leaves the rest of the other one uncompared
+    if (reference.ended || received.ended) {
+      reference.offset = reference.length;
+      received.offset = received.length;
+      return reference.ended && received.ended;
+    }
+    return false;
+  }
+}
+
+// ---------------------------------------------------------------------------
+// Sinks
+// ---------------------------------------------------------------------------
+
+/** One chart point per item at `x = index / rate`, optionally rounded to the microsecond. */
+export class PointSink implements Stage {
+  readonly name = 'point sink';
+  readonly inputs: readonly PortType[];
+  readonly outputs = [] as const;
+  readonly points: DataPoint[] = [];
+  private readonly interval: number;
+  private readonly roundTime: boolean;
+  private readonly period: number;
+  private index = 0;
+  private blockSample = 0;
+
+  /**
+   * With a `period`, the stream arrives in blocks of `period + 1` samples whose last
+   * sample falls on the same instant as the next block's first.
+   */
+  constructor(type: PortType, rate: number, roundTime = false, period = 0) {
+    this.inputs = [type];
+    this.interval = 1 / rate;
+    this.roundTime = roundTime;
+    this.period = period;
+  }
+
+  process(inputs: InputPort[]): boolean {
+    const input = inputs[0];
+    while (input.offset < input.length) {
+      const t = this.index * this.interval;
+      const x = this.roundTime ? Math.round(t * 1000000) / 1000000 : t;
+      this.points.push({ x, y: input.data[input.offset++] });
+      if (this.period > 0 && this.blockSample++ === this.period) {
+        this.blockSample = 0;
+      } else {
+        this.index++;
+      }
+    }
+    return input.ended;
+  }
+}
+
+/** Holds each item for `1 / rate` seconds, emitting a start and end point per item. */
+export class StepSink implements Stage {
+  readonly name = 'step sink';
+  readonly inputs: readonly PortType[];
+  readonly outputs = [] as const;
+  readonly points: DataPoint[] = [];
+  private readonly rate: number;
+  private index = 0;
+
+  constructor(type: PortType, rate: number) {
+    this.inputs = [type];
+    this.rate = rate;
+  }
+
+  process(inputs: InputPort[]): boolean {
+    const input = inputs[0];
+    while (input.offset < input.length) {
+      const y = input.data[input.offset++];
+      this.points.push({ x: this.index / this.rate, y });
+      this.points.push({ x: (this.index + 1) / this.rate, y });
+      this.index++;
+    }
+    return input.ended;
+  }
+}
+
+/**
+ * Staircase rendering of a held signal starting from `initial` at t = 0: each new
+ * value steps in at its (microsecond-rounded) sample instant and the last one is
+ * held until `endTime`.
+ */
+export class StaircaseSink implements Stage {
+  readonly name = 'staircase sink';
+  readonly inputs = ['real'] as const;
+  readonly outputs = [] as const;
+  readonly points: DataPoint[];
+  private readonly interval: number;
+  private readonly endTime: number;
+  private index = 0;
+
+  constructor(rate: number, endTime: number, initial = 0) {
+    this.interval = 1 / rate;
+    this.endTime = endTime;
+    this.points = [{ x: 0, y: initial }];
+  }
+
+  process(inputs: InputPort[]): boolean {
+    const input = inputs[0];
+    const points = this.points;
+    while (input.offset < input.length) {
+      const time = Math.round(this.index * this.interval * 1000000) / 1000000;
+      points.push({ x: time - 0.001, y: points[points.length - 1].y });
+      points.push({ x: time, y: input.data[input.offset++] });
+      this.index++;
+    }
+    if (input.ended) {
+      points.push({ x: this.endTime, y: points[points.length - 1].y });
+      return true;
+    }
+    return false;
+  }
+}
+
+/** Collects a stream into growable typed arrays (split I/Q for complex ports). */
+export class CollectSink implements Stage {
+  readonly name = 'collect sink';
+  readonly inputs: readonly PortType[];
+  readonly outputs = [] as const;
+  private buffer: FloatArray = new Float64Array(0);
+  private imagBuffer: FloatArray | null = null;
+  private count = 0;
+
+  constructor(type: PortType) {
+    this.inputs = [type];
+  }
+
+  setup(_arena: Arena, precision: SamplePrecision): void {
+    // The collected stream outlives the run, so it is not drawn from the arena
+    this.buffer = allocateFloat(precision, 1024);
+    if (this.inputs[0] === 'complex') this.imagBuffer = allocateFloat(precision, 1024);
+  }
+
+  /** Collected items (the in-phase part for complex ports). */
+  get values(): FloatArray {
+    return this.buffer.subarray(0, this.count);
+  }
+
+  /** Quadrature part of a complex stream; empty for other port types. */
+  get imagValues(): FloatArray {
+    return this.imagBuffer ? this.imagBuffer.subarray(0, this.count) : this.buffer.subarray(0, 0);
+  }
+
+  process(inputs: InputPort[]): boolean {
+    const input = inputs[0];
+    const available = input.length - input.offset;
+    if (this.count + available > this.buffer.length) {
+      const length = Math.max(this.buffer.length * 2, this.count + available);
+      this.buffer = grow(this.buffer, this.count, length);
+      if (this.imagBuffer) this.imagBuffer = grow(this.imagBuffer, this.count, length);
+    }
+    if (this.imagBuffer && input.imag) {
+      for (let i = 0; i < available; i++) {
+        this.imagBuffer[this.count + i] = input.imag[input.offset + i];
+      }
+    }
+    for (let i = 0; i < available; i++) {
+      this.buffer[this.count++] = input.data[input.offset++];
+    }
+    return input.ended;
+  }
+}
+
+function grow(buffer: FloatArray, count: number, length: number): FloatArray {
+  if (__SIGNAL_COUNTERS__) hotCounters.bufferGrowths++;
+  const grown = allocateFloat(buffer instanceof Float32Array ? 'float32' : 'float64', length);
+  grown.set(buffer.subarray(0, count));
+  return grown;
+}
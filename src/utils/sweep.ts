@@ -0,0 +1,312 @@
+import { AnalogToDigitalAlgorithm, ReconstructionMethod } from '../types';
+import { Pipeline, Stage } from './pipeline';
+import { ArraySource, CollectSink, Resampler, ToneSource } from './stages';
+import { DeltaIntegrator, levelValue, quantizeSample } from './analogToDigital';
+import { Reconstructor } from './filters';
+import { FloatArray } from './bufferPool';
+import { WorkerPool, sharedCopy } from './workerPool';
+
+/**
+ * Parameter sweeps for PCM (sampling rate × quantisation levels) and delta modulation
+ * (sampling rate × step size). Each cell runs the simulation's own quantiser, delta
+ * integrator and reconstruction kernels and scores the result by SQNR against the input
+ * and by bit rate.
+ *
+ * The input tone is generated once on a fine reference grid and shared by every cell,
+ * and each sampling rate's samples are taken once and shared by the whole row. Rows are
+ * spread over a worker pool.
+ */
+
+export interface SweepAxis {
+  min: number;
+  max: number;
+  steps: number;
+}
+
+export interface SweepOptions {
+  /** Receiver reconstruction for PCM; delta modulation always holds its staircase */
+  reconstruction?: ReconstructionMethod;
+}
+
+/** Input shared by every cell of a sweep. */
+export interface SweepInput {
+  /** The input signal on the reference grid */
+  reference: Float64Array;
+  referenceRate: number;
+  amplitude: number;
+  /** Reference samples SQNR is measured over: the middle, clear of start-up and edge effects */
+  window: [number, number];
+}
+
+export interface SweepResult {
+  algorithm: AnalogToDigitalAlgorithm;
+  /** Sampling rates (rows), in Hz */
+  rates: number[];
+  /** Quantisation levels or delta step sizes (columns) */
+  values: number[];
+  /** SQNR of cell (row, column) at `row * values.length + column`, in dB */
+  sqnrDb: Float64Array;
+  /** Bit rate of each cell, in bit/s */
+  bitRates: Float64Array;
+  /** Cells on the Pareto frontier (no other cell has a lower bit rate and at least the same SQNR), by bit rate */
+  frontier: number[];
+  elapsedMs: number;
+}
+
+// Error is measured on this grid; it resolves the reconstruction of any sampling rate up to 200 Hz
+const referenceRate = 200;
+const referenceDuration = 6;
+// The tone starts a little after t = 0, so a sampling rate commensurate with it does not
+// sample only its zero crossings and peaks (which a few levels would represent exactly)
+const phaseOffset = 0.0737;
+// Sinc reconstruction reaches 8 samples either side; at 4 Hz that is 2 s of edge effects
+const guardDuration = 2;
+
+export const defaultSweepAxes: Record<AnalogToDigitalAlgorithm, { rate: SweepAxis; value: SweepAxis }> = {
+  PCM: { rate: { min: 4, max: 40, steps: 64 }, value: { min: 2, max: 256, steps: 32 } },
+  'Delta Modulation': { rate: { min: 10, max: 80, steps: 64 }, value: { min: 0.01, max: 0.4, steps: 40 } },
+};
+
+/** Bit rate of one configuration: ⌈log2 levels⌉ bits per PCM sample, one bit per DM sample. */
+export function sweepBitRate(algorithm: AnalogToDigitalAlgorithm, rate: number, value: number): number {
+  return algorithm === 'PCM' ? rate * Math.ceil(Math.log2(value)) : rate;
+}
+
+/**
+ * Grid points of an axis: evenly spaced sampling rates and step sizes, and integer
+ * quantisation levels spaced geometrically (repeats after rounding dropped).
+ */
+export function axisValues(axis: SweepAxis, kind: 'rate' | 'levels' | 'step'): number[] {
+  const steps = Math.max(1, Math.round(axis.steps));
+  const values: number[] = [];
+  for (let i = 0; i < steps; i++) {
+    const fraction = steps === 1 ? 0 : i / (steps - 1);
+    if (kind === 'levels') {
+      const levels = Math.round(axis.min * Math.pow(axis.max / axis.min, fraction));
+      if (levels !== values[values.length - 1]) values.push(Math.max(2, levels));
+    } else {
+      values.push(axis.min + fraction * (axis.max - axis.min));
+    }
+  }
+  return values;
+}
+
+/** Generates the swept input: a tone on the reference grid with its measurement window. */
+export function toneSweepInput(frequency: number, amplitude: number): SweepInput {
+  const count = referenceDuration * referenceRate;
+  const skip = Math.round(phaseOffset * referenceRate);
+  const sink = new CollectSink('real');
+  new Pipeline()
+    .add('source', new ToneSource(frequency, amplitude, referenceRate, skip + count))
+    .add('sink', sink)
+    .connect('source', 'sink')
+    .run();
+  const guard = guardDuration * referenceRate;
+  return { reference: Float64Array.from(sink.values.subarray(skip)), referenceRate, amplitude, window: [guard, count - guard] };
+}
+
+// Cells that reproduce the input exactly would score infinitely well
+const maxSqnrDb = 120;
+
+// Runs `values → stages… → collector` and returns what was collected
+function runChain(values: ArrayLike<number>, stages: Stage[]): FloatArray {
+  const sink = new CollectSink('real');
+  const pipeline = new Pipeline().add('source', new ArraySource(values)).add('sink', sink);
+  let previous = 'source';
+  stages.forEach((stage, index) => {
+    const id = `stage${index}`;
+    pipeline.add(id, stage).connect(previous, id);
+    previous = id;
+  });
+  pipeline.connect(previous, 'sink').run();
+  return sink.values;
+}
+
+/**
+ * Scores single configurations against one input. Each sampling rate's samples are taken
+ * once and kept, so further cells at that rate (the rest of a sweep row, or an optimiser
+ * revisiting it) only rerun the quantiser and the receiver, and the receiver only
+ * computes its output inside the measurement window.
+ */
+export class SweepEvaluator {
+  readonly input: SweepInput;
+  private readonly reconstruction: ReconstructionMethod;
+  private readonly sampled = new Map<number, Float64Array>();
+
+  constructor(input: SweepInput, options: SweepOptions = {}) {
+    this.input = input;
+    this.reconstruction = options.reconstruction ?? 'sinc';
+  }
+
+  /** The input sampled at `rate`, as the simulation's sampler takes it. */
+  samples(rate: number): Float64Array {
+    let samples = this.sampled.get(rate);
+    if (!samples) {
+      // Bounded: an optimiser can visit many distinct rates
+      if (this.sampled.size === 256) this.sampled.clear();
+      samples = Float64Array.from(runChain(this.input.reference, [new Resampler(this.input.referenceRate, rate)]));
+      this.sampled.set(rate, samples);
+    }
+    return samples;
+  }
+
+  /** SQNR in dB of `algorithm` at sampling rate `rate` with `value` levels (PCM) or step size (DM). */
+  sqnr(algorithm: AnalogToDigitalAlgorithm, rate: number, value: number): number {
+    const { reference, referenceRate, amplitude, window } = this.input;
+    const samples = this.samples(rate);
+    let signal = 0;
+    let noise = 0;
+    // Reference grid index of the receiver's next output
+    let k = 0;
+    const compare = (output: number) => {
+      if (k >= window[0]) {
+        const error = reference[k] - output;
+        signal += reference[k] * reference[k];
+        noise += error * error;
+      }
+      k++;
+    };
+
+    if (algorithm === 'PCM') {
+      // The receiver's reconstruction, computed only inside the window
+      const reconstructor = new Reconstructor(this.reconstruction, rate, referenceRate);
+      const endTime = (window[1] - 1) / referenceRate;
+      const drain = () => {
+        while (k < window[0] && reconstructor.skip(endTime)) k++;
+        if (k < window[0]) return;
+        for (let y = reconstructor.next(endTime); y !== null; y = reconstructor.next(endTime)) compare(y);
+      };
+      for (let j = 0; j < samples.length && k < window[1]; j++) {
+        reconstructor.push(levelValue(quantizeSample(samples[j], amplitude, value), amplitude, value));
+        drain();
+      }
+      reconstructor.end();
+      drain();
+    } else {
+      // Encoder and decoder integrate the same bits, so the encoder's staircase is the output;
+      // the value for sample j holds from j / rate until the next sample
+      const integrator = new DeltaIntegrator(amplitude, value);
+      let j = -1;
+      let level = 0;
+      while (k < window[1]) {
+        const sample = Math.min(samples.length - 1, Math.floor((k * rate) / referenceRate + 1e-9));
+        while (j < sample) {
+          j++;
+          level = integrator.step(samples[j] > integrator.approximation ? 1 : 0);
+        }
+        compare(level);
+      }
+    }
+    if (noise === 0) return maxSqnrDb;
+    return Math.min(maxSqnrDb, 10 * Math.log10(signal / noise));
+  }
+}
+
+/** Cells on the Pareto frontier of low bit rate and high SQNR, in order of bit rate. */
+export function paretoFrontier(bitRates: ArrayLike<number>, sqnrDb: ArrayLike<number>): number[] {
+  const order = Array.from({ length: bitRates.length }, (_, i) => i);
+  order.sort((a, b) => bitRates[a] - bitRates[b] || sqnrDb[b] - sqnrDb[a]);
+  const frontier: number[] = [];
+  let best = -Infinity;
+  for (const cell of order) {
+    if (sqnrDb[cell] > best) {
+      frontier.push(cell);
+      best = sqnrDb[cell];
+    }
+  }
+  return frontier;
+}
+
+// ---------------------------------------------------------------------------
+// Sweeps
+// ---------------------------------------------------------------------------
+
+/** One row of a sweep: every value at one sampling rate. */
+export interface SweepRowTask {
+  algorithm: AnalogToDigitalAlgorithm;
+  rate: number;
+  values: number[];
+  /** Shared by every row of a sweep where the page allows it */
+  input: SweepInput;
+  options: SweepOptions;
+}
+
+/** SQNR of every cell in one row. */
+export function sweepRow(task: SweepRowTask): Float64Array {
+  const evaluator = new SweepEvaluator(task.input, task.options);
+  return Float64Array.from(task.values, value => evaluator.sqnr(task.algorithm, task.rate, value));
+}
+
+function assemble(
+  algorithm: AnalogToDigitalAlgorithm,
+  rates: number[],
+  values: number[],
+  rows: Float64Array[],
+  start: number
+): SweepResult {
+  const sqnrDb = new Float64Array(rates.length * values.length);
+  const bitRates = new Float64Array(rates.length * values.length);
+  rates.forEach((rate, r) => {
+    sqnrDb.set(rows[r], r * values.length);
+    values.forEach((value, v) => {
+      bitRates[r * values.length + v] = sweepBitRate(algorithm, rate, value);
+    });
+  });
+  return {
+    algorithm,
+    rates,
+    values,
+    sqnrDb,
+    bitRates,
+    frontier: paretoFrontier(bitRates, sqnrDb),
+    elapsedMs: performance.now() - start,
+  };
+}
+
+function rowTasks(
+  algorithm: AnalogToDigitalAlgorithm,
+  input: SweepInput,
+  rates: number[],
+  values: number[],
+  options: SweepOptions
+): SweepRowTask[] {
+  return rates.map(rate => ({ algorithm, rate, values, input, options }));
+}
+
+/** Sweeps the grid `rates` × `values` on this thread. */
+export function runSweep(
+  algorithm: AnalogToDigitalAlgorithm,
+  input: SweepInput,
+  rates: number[],
+  values: number[],
+  options: SweepOptions = {}
+): SweepResult {
+  const start = performance.now();
+  return assemble(algorithm, rates, values, rowTasks(algorithm, input, rates, values, options).map(sweepRow), start);
+}
+
+/** Sweeps on a worker pool, one row per task, with the reference signal shared between the workers. */
+export class SweepPool {
+  private readonly pool = new WorkerPool<SweepRowTask, Float64Array>(
+    () => new Worker(new URL('./sweepWorker.ts', import.meta.url), { type: 'module' }),
+    'sweep worker',
+    sweepRow
+  );
+
+  async run(
+    algorithm: AnalogToDigitalAlgorithm,
+    input: SweepInput,
+    rates: number[],
+    values: number[],
+    options: SweepOptions = {}
+  ): Promise<SweepResult> {
+    const start = performance.now();
+    const shared = { ...input, reference: sharedCopy(Float64Array, input.reference) };
+    const rows = await this.pool.run(rowTasks(algorithm, shared, rates, values, options));
+    return assemble(algorithm, rates, values, rows, start);
+  }
+
+  terminate(): void {
+    this.pool.terminate();
+  }
+}
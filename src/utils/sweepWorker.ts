@@ -0,0 +1,9 @@
+import { SweepRowTask, sweepRow } from './sweep';
+import { serveTasks } from './workerPool';
+
+// Each row's SQNR array is transferred back, not copied
+serveTasks<SweepRowTask, Float64Array>(
+  task => `${task.algorithm} @ ${task.rate.toFixed(2)} Hz`,
+  sweepRow,
+  row => [row.buffer as ArrayBuffer]
+);
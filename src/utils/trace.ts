@@ -0,0 +1,174 @@
+import { sharedBufferPool } from './bufferPool';
+
+/**
+ * Chrome trace-event recording for loading simulation runs into Perfetto or
+ * chrome://tracing. While a trace is recording, pipeline steps, generator calls, chart
+ * renders, browser frames and buffer-pool allocation counters are captured as trace
+ * events; `stopTrace` returns the finished JSON document.
+ *
+ * Each thread keeps its own recording. A worker records with the same functions and
+ * posts `collectThreadTrace()` back, and the main thread adds it with
+ * `importThreadTrace` so the worker's spans land on their own track, aligned in time.
+ */
+
+/** One event in the Chrome trace-event format; times are microseconds. */
+export interface TraceEvent {
+  name: string;
+  cat?: string;
+  /** 'X' complete span, 'C' counter, 'M' metadata */
+  ph: 'X' | 'C' | 'M';
+  ts: number;
+  dur?: number;
+  pid: number;
+  tid: number;
+  args?: Record<string, unknown>;
+}
+
+/** Events recorded on another thread, as posted back to the main thread. */
+export interface ThreadTrace {
+  /** `performance.timeOrigin` of the recording thread */
+  timeOrigin: number;
+  events: TraceEvent[];
+}
+
+export interface TraceDocument {
+  traceEvents: TraceEvent[];
+  displayTimeUnit: 'ms';
+  otherData: { droppedEvents: number };
+}
+
+const PROCESS_ID = 1;
+const MAIN_THREAD = 1;
+const FRAME_THREAD = 2;
+const FIRST_WORKER_THREAD = 10;
+// About 20 MB of JSON; later events are counted but dropped
+const MAX_EVENTS = 200_000;
+
+let recording = false;
+let events: TraceEvent[] = [];
+let dropped = 0;
+let threadNames = new Map<number, string>();
+// Imported threads by name, so repeated imports from one worker share a track
+let importedThreads = new Map<string, number>();
+let frameHandle = 0;
+let lastFrame = 0;
+
+export function traceRecording(): boolean {
+  return recording;
+}
+
+function push(event: TraceEvent): void {
+  if (events.length < MAX_EVENTS) events.push(event);
+  else dropped++;
+}
+
+/** Adds a complete span; `startMs` and `durationMs` are `performance.now()` milliseconds. */
+export function traceSpan(
+  name: string,
+  category: string,
+  startMs: number,
+  durationMs: number,
+  args?: Record<string, unknown>,
+  tid = MAIN_THREAD
+): void {
+  if (!recording) return;
+  push({ name, cat: category, ph: 'X', ts: startMs * 1000, dur: durationMs * 1000, pid: PROCESS_ID, tid, args });
+}
+
+/** Adds a sample of one or more counters drawn as a stacked track named `name`. */
+export function traceCounter(name: string, values: Record<string, number>, atMs = performance.now()): void {
+  if (!recording) return;
+  push({ name, ph: 'C', ts: atMs * 1000, pid: PROCESS_ID, tid: MAIN_THREAD, args: values });
+}
+
+/** Samples the shared buffer pool's allocation counters. */
+export function traceAllocations(atMs = performance.now()): void {
+  if (!recording) return;
+  const { allocations, reuses, bytesAllocated } = sharedBufferPool.stats;
+  traceCounter('buffer pool', { allocations, reuses }, atMs);
+  traceCounter('buffer pool bytes', { bytesAllocated }, atMs);
+}
+
+// Frame spans go on their own track so they never have to nest with the work inside them
+function onFrame(now: number): void {
+  if (!recording) return;
+  traceSpan('frame', 'frame', lastFrame, now - lastFrame, undefined, FRAME_THREAD);
+  traceAllocations(now);
+  lastFrame = now;
+  frameHandle = requestAnimationFrame(onFrame);
+}
+
+/** Starts a new recording, discarding any previous one. */
+export function startTrace(): void {
+  recording = true;
+  events = [];
+  dropped = 0;
+  importedThreads = new Map();
+  threadNames = new Map([
+    [MAIN_THREAD, 'main'],
+    [FRAME_THREAD, 'frames'],
+  ]);
+  traceAllocations();
+  // Frames are the document's; a worker recording has none of its own
+  if (typeof document !== 'undefined' && typeof requestAnimationFrame === 'function') {
+    lastFrame = performance.now();
+    frameHandle = requestAnimationFrame(onFrame);
+  }
+}
+
+/** Ends a worker-side recording and returns its events for `importThreadTrace`. */
+export function collectThreadTrace(): ThreadTrace {
+  recording = false;
+  const trace = { timeOrigin: performance.timeOrigin, events };
+  events = [];
+  return trace;
+}
+
+/**
+ * Places a trace recorded on another thread on the track named `threadName` (created on
+ * first use), shifting its timestamps onto this thread's clock. Returns the track's thread id.
+ */
+export function importThreadTrace(threadName: string, trace: ThreadTrace): number {
+  let tid = importedThreads.get(threadName);
+  if (tid === undefined) {
+    tid = FIRST_WORKER_THREAD + importedThreads.size;
+    importedThreads.set(threadName, tid);
+  }
+  if (!recording) return tid;
+  threadNames.set(tid, threadName);
+  const shift = (trace.timeOrigin - performance.timeOrigin) * 1000;
+  for (const event of trace.events) push({ ...event, ts: event.ts + shift, tid });
+  return tid;
+}
+
+/** Ends the recording and returns it as a trace-event document. */
+export function stopTrace(): TraceDocument {
+  recording = false;
+  if (frameHandle) cancelAnimationFrame(frameHandle);
+  frameHandle = 0;
+
+  const metadata: TraceEvent[] = [
+    { name: 'process_name', ph: 'M', ts: 0, pid: PROCESS_ID, tid: MAIN_THREAD, args: { name: 'Signal simulator' } },
+  ];
+  for (const [tid, name] of threadNames) {
+    metadata.push({ name: 'thread_name', ph: 'M', ts: 0, pid: PROCESS_ID, tid, args: { name } });
+    metadata.push({ name: 'thread_sort_index', ph: 'M', ts: 0, pid: PROCESS_ID, tid, args: { sort_index: tid } });
+  }
+  const trace: TraceDocument = {
+    traceEvents: metadata.concat(events),
+    displayTimeUnit: 'ms',
+    otherData: { droppedEvents: dropped },
+  };
+  events = [];
+  return trace;
+}
+
+/** Saves a trace document as a `.json` download. */
+export function downloadTrace(trace: TraceDocument, fileName = `signal-trace-${Date.now()}.json`): void {
+  const url = URL.createObjectURL(new Blob([JSON.stringify(trace)], { type: 'application/json' }));
+  const link = document.createElement('a');
+  link.href = url;
+  link.download = fileName;
+  link.click();
+  setTimeout(() => URL.revokeObjectURL(url), 0);
+}
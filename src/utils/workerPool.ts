@@ -0,0 +1,159 @@
+import { ThreadTrace, collectThreadTrace, importThreadTrace, startTrace, traceRecording, traceSpan } from './trace';
+
+/**
+ * Fixed-size pool of module workers that runs a batch of independent tasks, each worker
+ * taking the next task as soon as it finishes one. Workers are started on first use
+ * and kept until `terminate`. Without Worker support the tasks run on this thread.
+ *
+ * Worker scripts answer the pool with `serveTasks`. While a trace is recording, each
+ * worker records its tasks and the spans are imported onto one track per worker.
+ */
+
+interface PoolMessage<T> {
+  id: number;
+  task: T;
+  trace: boolean;
+}
+
+type PoolReply<R> = { id: number; result: R; trace: ThreadTrace | null } | { id: number; error: string };
+
+/** Workers to start for `tasks` jobs: one per task, leaving a core for the page. */
+export function poolSize(tasks: number): number {
+  const cores = typeof navigator !== 'undefined' ? navigator.hardwareConcurrency || 2 : 2;
+  return Math.max(1, Math.min(tasks, cores - 1));
+}
+
+/** Whether typed arrays can be shared with workers instead of copied (the page is cross-origin isolated). */
+export function canShareMemory(): boolean {
+  return typeof SharedArrayBuffer !== 'undefined' && typeof crossOriginIsolated !== 'undefined' && crossOriginIsolated;
+}
+
+/**
+ * Copies `values` into a typed array every worker can read without a copy of its own
+ * where the page allows it, and into an ordinary one otherwise.
+ */
+export function sharedCopy<A extends Uint8Array | Float64Array>(
+  Type: { new (buffer: ArrayBufferLike): A; BYTES_PER_ELEMENT: number },
+  values: ArrayLike<number>
+): A {
+  const bytes = values.length * Type.BYTES_PER_ELEMENT;
+  const copy = new Type(canShareMemory() ? new SharedArrayBuffer(bytes) : new ArrayBuffer(bytes));
+  const view: Uint8Array | Float64Array = copy;
+  for (let i = 0; i < values.length; i++) view[i] = values[i];
+  return copy;
+}
+
+export class WorkerPool<T, R> {
+  private readonly create: () => Worker;
+  private readonly threadName: string;
+  private readonly fallback: (task: T) => R;
+  private readonly workers: Worker[] = [];
+  private readonly pending = new Map<number, (reply: PoolReply<R>) => void>();
+  private nextId = 0;
+
+  /**
+   * `create` must call `new Worker(new URL(..., import.meta.url))` itself so Vite can
+   * bundle the script; `fallback` runs a task here when workers are unavailable.
+   */
+  constructor(create: () => Worker, threadName: string, fallback: (task: T) => R) {
+    this.create = create;
+    this.threadName = threadName;
+    this.fallback = fallback;
+  }
+
+  /** Runs every task and resolves with the results in task order. */
+  run(tasks: T[]): Promise<R[]> {
+    if (typeof Worker === 'undefined') {
+      try {
+        return Promise.resolve(tasks.map(this.fallback));
+      } catch (error) {
+        return Promise.reject(error);
+      }
+    }
+    if (tasks.length === 0) return Promise.resolve([]);
+
+    const trace = traceRecording();
+    const size = poolSize(tasks.length);
+
+    return new Promise((resolve, reject) => {
+      const results = new Array<R>(tasks.length);
+      let next = 0;
+      let done = 0;
+
+      const post = (workerIndex: number) => {
+        if (next === tasks.length) return;
+        const slot = next++;
+        const id = this.nextId++;
+        this.pending.set(id, reply => {
+          if ('error' in reply) {
+            // Post nothing more; tasks already running finish unobserved
+            next = tasks.length;
+            reject(new Error(reply.error));
+            return;
+          }
+          if (reply.trace) importThreadTrace(`${this.threadName} ${workerIndex + 1}`, reply.trace);
+          results[slot] = reply.result;
+          if (++done === tasks.length) resolve(results);
+          else post(workerIndex);
+        });
+        const message: PoolMessage<T> = { id, task: tasks[slot], trace };
+        this.worker(workerIndex).postMessage(message);
+      };
+      for (let i = 0; i < size; i++) post(i);
+    });
+  }
+
+  /** Stops every worker; a later `run` starts new ones. Tasks in flight are dropped. */
+  terminate(): void {
+    for (const worker of this.workers) worker.terminate();
+    this.workers.length = 0;
+    this.pending.clear();
+  }
+
+  private worker(index: number): Worker {
+    let worker = this.workers[index];
+    if (!worker) {
+      worker = this.create();
+      worker.onmessage = (event: MessageEvent<PoolReply<R>>) => {
+        const handler = this.pending.get(event.data.id);
+        this.pending.delete(event.data.id);
+        handler?.(event.data);
+      };
+      // A worker that fails to load or throws outside a task fails everything waiting on the pool
+      worker.onerror = event => {
+        const handlers = [...this.pending.values()];
+        this.pending.clear();
+        for (const handler of handlers) handler({ id: -1, error: event.message || `${this.threadName} failed` });
+      };
+      this.workers[index] = worker;
+    }
+    return worker;
+  }
+}
+
+/**
+ * Worker side of a `WorkerPool`: answers each task with `handle(task)`, transferring
+ * the buffers `transfer` picks out of the result instead of copying them. `label`
+ * names the task's trace span.
+ */
+export function serveTasks<T, R>(
+  label: (task: T) => string,
+  handle: (task: T) => R,
+  transfer: (result: R) => Transferable[] = () => []
+): void {
+  self.onmessage = (event: MessageEvent<PoolMessage<T>>) => {
+    const { id, task, trace } = event.data;
+    try {
+      if (trace) startTrace();
+      const start = performance.now();
+      const result = handle(task);
+      traceSpan(label(task), 'worker task', start, performance.now() - start);
+      const reply: PoolReply<R> = { id, result, trace: trace ? collectThreadTrace() : null };
+      self.postMessage(reply, { transfer: transfer(result) });
+    } catch (error) {
+      if (trace) collectThreadTrace();
+      const reply: PoolReply<R> = { id, error: error instanceof Error ? error.message : String(error) };
+      self.postMessage(reply);
+    }
+  };
+}
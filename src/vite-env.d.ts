@@ -1 +1,7 @@
 /// <reference types="vite/client" />
+
+/** Set by the `define` in vite.config.ts: true only in `--mode instrumented` builds. */
+declare const __SIGNAL_COUNTERS__: boolean;
+
+/** Set by the `define` in vite.config.ts: a hash of src/utils, part of every result cache key. */
+declare const __CODE_VERSION__: string;
@@ -1,10 +1,44 @@
 import { defineConfig } from 'vite';
 import react from '@vitejs/plugin-react';
+import { createHash } from 'node:crypto';
+import { readFileSync, readdirSync } from 'node:fs';
+
+const isolationHeaders = {
+  'Cross-Origin-Opener-Policy': 'same-origin',
+  'Cross-Origin-Embedder-Policy': 'require-corp',
+};
+
+// Content hash of the simulation code. Results cached in IndexedDB (src/utils/resultCache.ts)
+// are keyed by it, so any change to src/utils invalidates them; the dev server takes it at start
+function codeVersion(): string {
+  const directory = new URL('./src/utils/', import.meta.url);
+  const hash = createHash('sha256');
+  for (const file of readdirSync(directory).sort()) hash.update(file).update(readFileSync(new URL(file, directory)));
+  return hash.digest('hex').slice(0, 16);
+}
 
 // https://vitejs.dev/config/
-export default defineConfig({
+export default defineConfig(({ mode }) => ({
   plugins: [react()],
+  define: {
+    // Hot-path operation counters (src/utils/counters.ts); constant false, and so
+    // stripped, outside `--mode instrumented`
+    __SIGNAL_COUNTERS__: JSON.stringify(mode === 'instrumented'),
+    __CODE_VERSION__: JSON.stringify(codeVersion()),
+  },
+  // React's production build drops <Profiler> callbacks, so an instrumented build takes
+  // its profiling build instead and chart render timings survive `vite build`. React 18
+  // has no scheduler/tracing module, so react-dom is the only module to swap
+  resolve: mode === 'instrumented'
+    ? { alias: [{ find: /^react-dom(\/client)?$/, replacement: 'react-dom/profiling' }] }
+    : {},
+  // Cross-origin isolation, so the comparison view can share its input with workers
+  // through a SharedArrayBuffer
+  server: { headers: isolationHeaders },
+  preview: { headers: isolationHeaders },
+  // Workers are loaded as modules (src/utils/comparison.ts)
+  worker: { format: 'es' },
   optimizeDeps: {
     exclude: ['lucide-react'],
   },
-});
+}));